@@ -20,11 +20,93 @@
 #define MIC_WS  GPIO_NUM_42
 #define MIC_DIN GPIO_NUM_2
 #endif
+// i2s DMA geometry: buffers divide the ESP-SR feed chunk and last at most
+// MIC_DMA_LATENCY_MS (one interrupt each), the ring also covers
+// MIC_DMA_HEADROOM_MS of reader delay. MIC_DMA_BENCH 1 times 2..32 ms and
+// the IDF default at boot and logs capture latency and interrupt rate
+#define MIC_DMA_LATENCY_MS  8
+#define MIC_DMA_HEADROOM_MS 64
+#define MIC_DMA_BENCH       0
 
 // analog microphone
 #define MIC_AR   GPIO_NUM_39
 #define MIC_OUT	 GPIO_NUM_4 // esp32-s3 range pin (0-20)
 #define MIC_GAIN GPIO_NUM_38
 
+#define DISPLAY_TYPE_SSD1306_I2C 0
+#define DISPLAY_TYPE_SH1106_I2C  1
+#define DISPLAY_TYPE_SSD1306_SPI 2
+#define DISPLAY_TYPE_PBM         3 // framed PBM images on Serial next to TokenLog, no panel
+
+// set the display panel and link
+#define DISPLAY_TYPE DISPLAY_TYPE_SSD1306_I2C
+
+// spi display (DMA, 10 MHz). Keep off GPIO 43/44, UART0 carries Serial
+#define DISPLAY_SCK  GPIO_NUM_7
+#define DISPLAY_MOSI GPIO_NUM_9
+#ifdef SEED_XIAO_ESP32S3
+#define DISPLAY_CS   GPIO_NUM_1
+#define DISPLAY_DC   GPIO_NUM_2
+#else
+#define DISPLAY_CS   GPIO_NUM_10
+#define DISPLAY_DC   GPIO_NUM_11
+#endif
+#define DISPLAY_RST  GPIO_NUM_NC
+#define DISPLAY_SPI_CLOCK 10000000
+
 #define SCREEN_WIDTH 128
-#define SCREEN_HEIGHT 64
\ No newline at end of file
+#define SCREEN_HEIGHT 64
+
+#define WAKEWORD_ENGINE_ESP_SR 0 // WakeNet inside ESP-SR
+#define WAKEWORD_ENGINE_KWS    1 // lib/Kws detectors only, WakeNet stays off
+#define WAKEWORD_ENGINE_BOTH   2 // WakeNet for its word and lib/Kws for the others, concurrently
+
+// The words themselves are WAKE_WORDS in src/boot/constants.h: "Hi ESP" and
+// "Computer" for WakeNet (both in model/target/srmodels.bin), the same two
+// for lib/Kws, which needs its kws_* containers in the model partition
+#define WAKEWORD_ENGINE WAKEWORD_ENGINE_ESP_SR
+// kwsTask load, in % of a core, above which its detectors take turns
+// instead of all running (0: never). Each turn lasts KWS_SLICE_MS
+#define KWS_LOAD_LIMIT 60
+#define KWS_SLICE_MS   2000
+// Detect task load with both WakeNet models, in % of a core, above which
+// only one runs (0: never; needs configGENERATE_RUN_TIME_STATS). With
+// WAKENET_ALTERNATE_S 0 the second word is dropped, otherwise the two take
+// turns of that many seconds, each turn restarts ESP-SR
+#define WAKENET_LOAD_LIMIT  70
+#define WAKENET_ALTERNATE_S 0
+
+// Wake word -> command handoff: the microphone history from where the wake
+// word ended is replayed into ESP-SR after the switch to command mode
+#define SR_HANDOFF_HISTORY_MS 1000 // history kept, 0 turns the replay off
+#define SR_HANDOFF_WAKENET_MS 300  // WakeNet fires about this long after the word
+#define SR_HANDOFF_KWS_MS     150  // lib/Kws smoothing delay after the word
+
+// ESP-SR front-end profiles: noise suppression and VAD of the AFE
+#define SR_PROFILE_OFF   0 // neither
+#define SR_PROFILE_LIGHT 1 // WebRTC NS and VAD, no models
+#define SR_PROFILE_FULL  2 // NSNet2 and VADNet1 from the model partition
+
+#define SR_PROFILE_MAX SR_PROFILE_FULL
+// Step down one profile after the noise floor stayed under
+// SR_PROFILE_QUIET_DBFS for SR_PROFILE_QUIET_S, back to SR_PROFILE_MAX once
+// it is SR_PROFILE_HYSTERESIS_DB above. 0 keeps the profile fixed
+#define SR_PROFILE_AUTO          1
+#define SR_PROFILE_QUIET_DBFS    -60
+#define SR_PROFILE_QUIET_S       180
+#define SR_PROFILE_HYSTERESIS_DB 6
+
+// SR pipeline watchdog: a stall is no fill call or no microphone audio for
+// SR_WATCHDOG_STALL_MS, or two seconds under SR_WATCHDOG_MIN_RATE % of
+// 16 kHz. Recovery restarts the microphone, then the microphone and ESP-SR
+// up to SR_WATCHDOG_ATTEMPTS times, SR_WATCHDOG_GRACE_MS apart, then reboots
+#define SR_WATCHDOG_STALL_MS    1500
+#define SR_WATCHDOG_MIN_RATE    50
+#define SR_WATCHDOG_GRACE_MS    2000
+#define SR_WATCHDOG_ATTEMPTS    2
+// An ESP-SR restart (watchdog or profile switch) that has not finished
+// after this long reboots, sr_stop() has no timeout of its own
+#define SR_RESTART_TIMEOUT_MS   10000
+
+// Command set MultiNet starts with (see setupCommandSets), "global" is every phrase
+#define SR_COMMAND_SET_DEFAULT "global"
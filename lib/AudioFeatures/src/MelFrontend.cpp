@@ -0,0 +1,373 @@
+#include "MelFrontend.h"
+#include "MelKernels.h"
+#include <math.h>
+#include <string.h>
+
+namespace {
+
+const double MEL_PI = 3.14159265358979323846;
+
+// E[m] is accumulated as |X|^2 / 4 of the int16 frame, 2^28 times the
+// energy of the frame at +-1.0 full scale; the 1e-6 floor in that unit
+const int32_t ENERGY_SHIFT = 28;
+const uint64_t ENERGY_FLOOR = 268;
+
+// Twiddles are Q30: Q15 ones leave a noise floor about 90 dB under the
+// strongest bin, which shows in the quiet bands of a loud frame
+const int32_t TWIDDLE_SHIFT = 30;
+const double TWIDDLE_ONE = 1073741824.0;
+
+// Extra fraction bits of the windowed samples, removed again in the power
+const int32_t GUARD_BITS = 4;
+
+// ln(2) in Q16
+const int32_t LN2_Q16 = 45426;
+
+// log2(1 + i / 64) in Q16
+const uint32_t LOG2_TABLE[65] = {
+	0, 1466, 2909, 4331, 5732, 7112, 8473, 9814,
+	11136, 12440, 13727, 14996, 16248, 17484, 18704, 19909,
+	21098, 22272, 23433, 24579, 25711, 26830, 27936, 29029,
+	30109, 31178, 32234, 33279, 34312, 35334, 36346, 37346,
+	38336, 39316, 40286, 41246, 42196, 43137, 44068, 44990,
+	45904, 46809, 47705, 48593, 49472, 50344, 51207, 52063,
+	52911, 53751, 54584, 55410, 56229, 57040, 57845, 58643,
+	59434, 60219, 60997, 61769, 62534, 63294, 64047, 64794,
+	65536,
+};
+
+// log2(x) in Q16 for x >= 1: exponent from the leading zeros, mantissa
+// from the table with linear interpolation (error below 2^-14)
+int32_t log2Q16(uint64_t x) {
+	int32_t e = 63 - __builtin_clzll(x);
+	uint64_t m = x << (63 - e);
+	uint32_t i = (uint32_t)(m >> 57) & 63;
+	uint32_t frac = (uint32_t)(m >> 41) & 0xFFFF;
+	uint32_t a = LOG2_TABLE[i], b = LOG2_TABLE[i + 1];
+	return (e << 16) + (int32_t)(a + (((b - a) * frac) >> 16));
+}
+
+inline int16_t clampInt16(int64_t v) {
+	if (v > 32767) return 32767;
+	if (v < -32768) return -32768;
+	return (int16_t)v;
+}
+
+inline int16_t toQ15(double v) {
+	return clampInt16(llround(v * 32768.0));
+}
+
+inline uint64_t square(int64_t v) {
+	return (uint64_t)(v * v);
+}
+
+double hzToMel(double hz) {
+	return 1127.0 * log(1.0 + hz / 700.0);
+}
+
+double melToHz(double mel) {
+	return 700.0 * (exp(mel / 1127.0) - 1.0);
+}
+
+// Bump allocation over the caller's block; with base == nullptr it only
+// counts, so memorySize() and begin() share one layout
+struct Carve {
+	uint8_t* base;
+	size_t size;
+	size_t used;
+
+	template <typename T>
+	T* take(size_t count) {
+		size_t at = (used + 15) & ~(size_t)15;
+		used = at + count * sizeof(T);
+		if (!base || used > size) return nullptr;
+		return (T*)(base + at);
+	}
+};
+
+}  // namespace
+
+MelFrontend::MelFrontend()
+	: _config(), _fftSize(0), _emphasis(0), _vector(false), _ready(false),
+	  _filled(0), _sinceHop(0), _frames(0),
+	  _history(nullptr), _frame(nullptr), _prev(nullptr), _window(nullptr),
+	  _re(nullptr), _im(nullptr), _cos(nullptr), _sin(nullptr), _reverse(nullptr),
+	  _power(nullptr), _melStart(nullptr), _melCount(nullptr), _melOffset(nullptr),
+	  _melWeight(nullptr), _dct(nullptr), _logMel(nullptr), _mfcc(nullptr) {}
+
+esp_err_t MelFrontend::validate(const MelConfig& config) {
+	if (!config.sampleRate || !config.hopSamples || config.windowSamples < config.hopSamples) return ESP_ERR_INVALID_ARG;
+	if (config.windowSamples > MAX_FFT || !config.melBins) return ESP_ERR_INVALID_ARG;
+	if (config.lowHz < 0.0f || config.highHz <= config.lowHz || config.highHz > config.sampleRate / 2) return ESP_ERR_INVALID_ARG;
+	if (config.preEmphasis < 0.0f || config.preEmphasis >= 1.0f) return ESP_ERR_INVALID_ARG;
+	if (config.mfccCount > config.melBins) return ESP_ERR_INVALID_ARG;
+	return ESP_OK;
+}
+
+size_t MelFrontend::memorySize(const MelConfig& config) {
+	if (validate(config) != ESP_OK) return 0;
+	MelFrontend probe;
+	probe._config = config;
+	return probe.layout(nullptr, 0) + 15;
+}
+
+size_t MelFrontend::layout(uint8_t* base, size_t bytes) {
+	_fftSize = 2;
+	while (_fftSize < _config.windowSamples) _fftSize <<= 1;
+	uint16_t half = _fftSize / 2;
+	uint16_t window = _config.windowSamples;
+
+	Carve carve = {base, bytes, 0};
+	_history = carve.take<int16_t>(window + 1);
+	_frame = carve.take<int16_t>(window);
+	_prev = carve.take<int16_t>(window);
+	_window = carve.take<int16_t>(window);
+	_re = carve.take<int32_t>(half);
+	_im = carve.take<int32_t>(half);
+	_cos = carve.take<int32_t>(half);
+	_sin = carve.take<int32_t>(half);
+	_reverse = carve.take<uint16_t>(half);
+	_power = carve.take<uint64_t>(half + 1);
+	_melStart = carve.take<uint16_t>(_config.melBins);
+	_melCount = carve.take<uint16_t>(_config.melBins);
+	_melOffset = carve.take<uint16_t>(_config.melBins);
+	// Neighbouring filters share their edges, so no bin is in more than two
+	_melWeight = carve.take<uint16_t>(2 * (half + 1));
+	_dct = carve.take<int16_t>((size_t)_config.mfccCount * _config.melBins);
+	_logMel = carve.take<int16_t>(_config.melBins);
+	_mfcc = carve.take<int16_t>(_config.mfccCount);
+	return carve.used;
+}
+
+esp_err_t MelFrontend::begin(const MelConfig& config, void* memory, size_t bytes) {
+	esp_err_t err = validate(config);
+	if (err != ESP_OK) return err;
+	if (!memory) return ESP_ERR_NO_MEM;
+
+	_config = config;
+	size_t skip = (16 - ((uintptr_t)memory & 15)) & 15;
+	if (bytes < skip || layout((uint8_t*)memory + skip, bytes - skip) > bytes - skip) {
+		_history = nullptr;
+		return ESP_ERR_NO_MEM;
+	}
+
+	buildTables();
+	_vector = MelKernels::vectorMatches();
+	reset();
+	return ESP_OK;
+}
+
+void MelFrontend::buildTables() {
+	uint16_t window = _config.windowSamples;
+	uint16_t half = _fftSize / 2;
+
+	_emphasis = toQ15(_config.preEmphasis);
+	for (uint16_t i = 0; i < window; i++) {
+		_window[i] = toQ15(0.5 - 0.5 * cos(2.0 * MEL_PI * i / window));
+	}
+	for (uint16_t k = 0; k < half; k++) {
+		_cos[k] = (int32_t)llround(TWIDDLE_ONE * cos(2.0 * MEL_PI * k / _fftSize));
+		_sin[k] = (int32_t)llround(TWIDDLE_ONE * -sin(2.0 * MEL_PI * k / _fftSize));
+	}
+	uint8_t bits = 0;
+	while ((1u << bits) < half) bits++;
+	for (uint16_t i = 0; i < half; i++) {
+		uint16_t r = 0;
+		for (uint8_t b = 0; b < bits; b++) {
+			if (i & (1 << b)) r |= 1 << (bits - 1 - b);
+		}
+		_reverse[i] = r;
+	}
+
+	// Filter corners on the mel scale, rounded to FFT bins
+	double low = hzToMel(_config.lowHz);
+	double high = hzToMel(_config.highHz);
+	uint16_t edge[3];
+	uint16_t offset = 0;
+	for (uint16_t m = 0; m < _config.melBins + 2; m++) {
+		double hz = melToHz(low + (high - low) * m / (_config.melBins + 1));
+		long bin = lround(hz * _fftSize / _config.sampleRate);
+		edge[m < 3 ? m : 2] = bin > half ? half : (uint16_t)bin;
+		if (m < 2) continue;
+
+		uint16_t left = edge[0], center = edge[1], right = edge[2];
+		uint16_t f = m - 2;
+		_melStart[f] = left;
+		_melCount[f] = right - left;
+		_melOffset[f] = offset;
+		for (uint16_t k = left; k < center; k++) {
+			_melWeight[offset++] = (uint16_t)llround(32768.0 * (k - left) / (center - left));
+		}
+		for (uint16_t k = center; k < right; k++) {
+			_melWeight[offset++] = (uint16_t)llround(32768.0 * (right - k) / (right - center));
+		}
+		edge[0] = edge[1];
+		edge[1] = edge[2];
+	}
+
+	for (uint8_t i = 0; i < _config.mfccCount; i++) {
+		double scale = sqrt((i ? 2.0 : 1.0) / _config.melBins);
+		for (uint16_t m = 0; m < _config.melBins; m++) {
+			_dct[i * _config.melBins + m] = toQ15(scale * cos(MEL_PI * i * (m + 0.5) / _config.melBins));
+		}
+	}
+}
+
+void MelFrontend::reset() {
+	if (!_history) return;
+	memset(_history, 0, (_config.windowSamples + 1) * sizeof(int16_t));
+	_filled = 0;
+	_sinceHop = 0;
+	_ready = false;
+	_frames = 0;
+}
+
+size_t MelFrontend::push(const int16_t* samples, size_t count) {
+	_ready = false;
+	if (!_history) return count;
+
+	uint16_t window = _config.windowSamples;
+	uint16_t hop = _config.hopSamples;
+	size_t used = 0;
+
+	while (used < count) {
+		// Up to the next hop boundary
+		size_t n = hop - _sinceHop;
+		if (n > count - used) n = count - used;
+
+		memmove(_history, _history + n, (window + 1 - n) * sizeof(int16_t));
+		memcpy(_history + window + 1 - n, samples + used, n * sizeof(int16_t));
+		used += n;
+		_sinceHop += n;
+		if (_filled < window) _filled = _filled + n > window ? window : _filled + n;
+
+		if (_sinceHop == hop) {
+			_sinceHop = 0;
+			if (_filled == window) {
+				compute();
+				_frames++;
+				_ready = true;
+				break;
+			}
+		}
+	}
+	return used;
+}
+
+void MelFrontend::compute() {
+	uint16_t window = _config.windowSamples;
+	uint16_t half = _fftSize / 2;
+
+	const int16_t* frame = _history + 1;
+	int32_t bias = 0;
+	if (_emphasis) {
+		// Aligned copies for the vector kernel
+		memcpy(_frame, _history + 1, window * sizeof(int16_t));
+		memcpy(_prev, _history, window * sizeof(int16_t));
+#if AUDIOFEATURES_PIE
+		if (_vector) MelKernels::preEmphasisVector(_frame, _frame, _prev, window, _emphasis);
+		else
+#endif
+		MelKernels::preEmphasisPortable(_frame, _frame, _prev, window, _emphasis);
+		frame = _frame;
+		// The truncating product leaves the output half a step high on
+		// average, a DC offset that would leak into the lowest filters
+		bias = 1;
+	}
+
+	// Real FFT of N points as a complex FFT of N/2: even samples real, odd
+	// imaginary, loaded in bit reversed order. The window is applied here,
+	// on samples doubled to take the bias off, in int32 so its rounding
+	// stays below the int16 step of the input
+	const int32_t shift = 16 - GUARD_BITS;
+	for (uint16_t i = 0; i < half; i++) {
+		uint16_t s = 2 * _reverse[i];
+		_re[i] = s < window ? ((2 * (int32_t)frame[s] - bias) * _window[s]) >> shift : 0;
+		_im[i] = s + 1 < window ? ((2 * (int32_t)frame[s + 1] - bias) * _window[s + 1]) >> shift : 0;
+	}
+	fft();
+	spectrum();
+	filterbank();
+	if (_config.mfccCount) dct();
+}
+
+void MelFrontend::fft() {
+	// Radix-2 decimation in time on bit reversed input. Samples grow by at
+	// most 2x per stage: below 2^19 in, below 2^28 out for 512 points, so
+	// the Q30 products fit in int64
+	uint16_t n = _fftSize / 2;
+	for (uint16_t len = 2; len <= n; len <<= 1) {
+		uint16_t span = len / 2;
+		uint16_t step = _fftSize / len;
+
+		// k = 0: the twiddle is exactly 1
+		for (uint16_t a = 0; a < n; a += len) {
+			uint16_t b = a + span;
+			int32_t tr = _re[b], ti = _im[b];
+			_re[b] = _re[a] - tr;
+			_im[b] = _im[a] - ti;
+			_re[a] += tr;
+			_im[a] += ti;
+		}
+
+		for (uint16_t k = 1; k < span; k++) {
+			int32_t wr = _cos[k * step], wi = _sin[k * step];
+			for (uint16_t a = k; a < n; a += len) {
+				uint16_t b = a + span;
+				int32_t tr = (int32_t)(((int64_t)_re[b] * wr - (int64_t)_im[b] * wi) >> TWIDDLE_SHIFT);
+				int32_t ti = (int32_t)(((int64_t)_re[b] * wi + (int64_t)_im[b] * wr) >> TWIDDLE_SHIFT);
+				_re[b] = _re[a] - tr;
+				_im[b] = _im[a] - ti;
+				_re[a] += tr;
+				_im[a] += ti;
+			}
+		}
+	}
+}
+
+void MelFrontend::spectrum() {
+	// Split the half length spectrum Z into X[k] = E[k] + W^k O[k] with
+	// E = (Z[k] + Z*[n-k]) / 2 and O = (Z[k] - Z*[n-k]) / 2i, kept doubled
+	// so nothing is rounded before the square
+	uint16_t n = _fftSize / 2;
+	int64_t r0 = _re[0], i0 = _im[0];
+	_power[0] = square(r0 + i0) >> (2 + 2 * GUARD_BITS);
+	_power[n] = square(r0 - i0) >> (2 + 2 * GUARD_BITS);
+
+	for (uint16_t k = 1; k < n; k++) {
+		int64_t ar = _re[k], ai = _im[k];
+		int64_t br = _re[n - k], bi = -(int64_t)_im[n - k];
+		int64_t er = ar + br, ei = ai + bi;
+		int64_t or_ = ai - bi, oi = br - ar;
+		int64_t wr = _cos[k], wi = _sin[k];
+		int64_t xr = er + ((wr * or_ - wi * oi) >> TWIDDLE_SHIFT);
+		int64_t xi = ei + ((wr * oi + wi * or_) >> TWIDDLE_SHIFT);
+		_power[k] = (square(xr) + square(xi)) >> (4 + 2 * GUARD_BITS);
+	}
+}
+
+void MelFrontend::filterbank() {
+	for (uint16_t m = 0; m < _config.melBins; m++) {
+		const uint64_t* power = _power + _melStart[m];
+		const uint16_t* weight = _melWeight + _melOffset[m];
+		uint64_t energy = ENERGY_FLOOR;
+		for (uint16_t k = 0; k < _melCount[m]; k++) {
+			energy += (power[k] * weight[k]) >> 15;
+		}
+		// ln(energy / 2^28) in Q8
+		int64_t log2 = log2Q16(energy) - (ENERGY_SHIFT << 16);
+		_logMel[m] = clampInt16((log2 * LN2_Q16) >> (32 - OUTPUT_SHIFT));
+	}
+}
+
+void MelFrontend::dct() {
+	uint16_t bins = _config.melBins;
+	for (uint8_t i = 0; i < _config.mfccCount; i++) {
+		const int16_t* basis = _dct + i * bins;
+		int64_t acc = 0;
+		for (uint16_t m = 0; m < bins; m++) {
+			acc += (int32_t)_logMel[m] * basis[m];
+		}
+		_mfcc[i] = clampInt16(acc >> 15);
+	}
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef ESP_PLATFORM
+#include "esp_err.h"
+#elif !defined(ESP_OK)
+// Host builds (tools, tests) only need the status codes
+typedef int esp_err_t;
+#define ESP_OK 0
+#define ESP_FAIL -1
+#define ESP_ERR_NO_MEM 0x101
+#define ESP_ERR_INVALID_ARG 0x102
+#define ESP_ERR_INVALID_STATE 0x103
+#define ESP_ERR_INVALID_SIZE 0x104
+#define ESP_ERR_NOT_FOUND 0x105
+#define ESP_ERR_NOT_SUPPORTED 0x106
+#define ESP_ERR_INVALID_CRC 0x109
+#define ESP_ERR_INVALID_VERSION 0x10A
+#endif
+
+struct MelConfig {
+	uint16_t sampleRate;
+	uint16_t windowSamples;  // analysis window, e.g. 400 (25 ms at 16 kHz)
+	uint16_t hopSamples;     // e.g. 160 (10 ms)
+	uint16_t melBins;
+	float lowHz;
+	float highHz;
+	float preEmphasis;       // y[n] = x[n] - a * x[n - 1], 0 turns it off
+	uint8_t mfccCount;       // DCT-II coefficients per frame, 0 for log-mel only
+};
+
+/**
+ * Streaming fixed-point log-mel / MFCC front-end.
+ *
+ * Samples are pushed in chunks of any size. Every hopSamples the last
+ * windowSamples samples go through pre-emphasis, a Hann window, a real FFT
+ * (a half length complex FFT plus a split step), triangular mel filters, a
+ * natural log and optionally an orthonormal DCT-II.
+ *
+ * Every stage is integer arithmetic on tables built once in begin()
+ * (window, twiddles, bit reversal, filter weights, DCT), so a frame gives
+ * the same bits on the host and on the device. Pre-emphasis, the int16
+ * stage, uses the PIE kernel of MelKernels when it passes its self test;
+ * the FFT needs 32-bit products and stays scalar.
+ *
+ * Outputs are Q8 (value / 256):
+ * - logMel[m] = ln(E[m] + 1e-6), with E[m] the filter-weighted |X[k]|^2 of
+ *   the frame scaled to +-1.0 full scale
+ * - mfcc[i] = sum(m) logMel[m] * c(i) * cos(pi * i * (m + 0.5) / melBins)
+ */
+class MelFrontend {
+public:
+	static const uint16_t MAX_FFT = 1024;
+	static const uint8_t OUTPUT_SHIFT = 8;
+
+	MelFrontend();
+
+	static esp_err_t validate(const MelConfig& config);
+	// Bytes of memory begin() needs, including alignment slack; 0 when invalid
+	static size_t memorySize(const MelConfig& config);
+
+	// memory holds every buffer and table and must outlive the front-end
+	esp_err_t begin(const MelConfig& config, void* memory, size_t bytes);
+	// Clears the audio history, the tables are kept
+	void reset();
+
+	// Consumes up to count samples and stops early when a frame is ready.
+	// Returns the number consumed; frameReady() tells if a frame was made
+	size_t push(const int16_t* samples, size_t count);
+	bool frameReady() const { return _ready; }
+
+	const int16_t* logMel() const { return _logMel; }
+	const int16_t* mfcc() const { return _mfcc; }
+	// |X[k]|^2 / 4 of the int16 frame, fftSize / 2 + 1 bins
+	const uint64_t* power() const { return _power; }
+
+	const MelConfig& config() const { return _config; }
+	uint16_t fftSize() const { return _fftSize; }
+	uint32_t frames() const { return _frames; }
+	bool vectorized() const { return _vector; }
+
+private:
+	MelConfig _config;
+	uint16_t _fftSize;
+	int16_t _emphasis;       // Q15
+	bool _vector;
+	bool _ready;
+	uint16_t _filled;        // samples in the history, up to windowSamples
+	uint16_t _sinceHop;
+	uint32_t _frames;
+
+	int16_t* _history;       // [windowSamples + 1], one sample before the window first
+	int16_t* _frame;         // [windowSamples] after pre-emphasis
+	int16_t* _prev;          // [windowSamples], the frame delayed by one sample
+	int16_t* _window;        // [windowSamples] Q15
+	int32_t* _re;            // [fftSize / 2]
+	int32_t* _im;
+	int32_t* _cos;           // [fftSize / 2] Q30, e^(-2 pi i k / fftSize)
+	int32_t* _sin;
+	uint16_t* _reverse;      // [fftSize / 2] bit reversal permutation
+	uint64_t* _power;        // [fftSize / 2 + 1]
+	uint16_t* _melStart;     // [melBins] first FFT bin of each filter
+	uint16_t* _melCount;     // [melBins]
+	uint16_t* _melOffset;    // [melBins] into _melWeight
+	uint16_t* _melWeight;    // Q15, 32768 = 1.0
+	int16_t* _dct;           // [mfccCount][melBins] Q15
+	int16_t* _logMel;        // [melBins]
+	int16_t* _mfcc;          // [mfccCount]
+
+	size_t layout(uint8_t* base, size_t bytes);
+	void buildTables();
+	void compute();
+	void fft();
+	void spectrum();
+	void filterbank();
+	void dct();
+};
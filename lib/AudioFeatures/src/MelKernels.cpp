@@ -0,0 +1,61 @@
+#include "MelKernels.h"
+
+namespace MelKernels {
+
+void preEmphasisPortable(int16_t* out, const int16_t* in, const int16_t* prev, size_t n, int16_t coeff) {
+	for (size_t i = 0; i < n; i++) {
+		int32_t v = (int32_t)in[i] - (((int32_t)prev[i] * coeff) >> 15);
+		if (v > 32767) v = 32767;
+		if (v < -32768) v = -32768;
+		out[i] = (int16_t)v;
+	}
+}
+
+#if AUDIOFEATURES_PIE
+void preEmphasisVector(int16_t* out, const int16_t* in, const int16_t* prev, size_t n, int16_t coeff) {
+	uint32_t shift = 15;
+	asm volatile("ee.vldbc.16 q3, %0" :: "r"(&coeff));
+	for (size_t i = n / 8; i; i--) {
+		// SAR is set in every block: the compiler uses it for variable shifts
+		asm volatile(
+			"wsr.sar %3\n"
+			"ee.vld.128.ip q0, %1, 16\n"
+			"ee.vmul.s16 q0, q0, q3\n"
+			"ee.vld.128.ip q1, %0, 16\n"
+			"ee.vsubs.s16 q1, q1, q0\n"
+			"ee.vst.128.ip q1, %2, 16\n"
+			: "+r"(in), "+r"(prev), "+r"(out) : "r"(shift) : "memory");
+	}
+	preEmphasisPortable(out, in, prev, n & 7, coeff);
+}
+#endif
+
+bool vectorMatches() {
+#if AUDIOFEATURES_PIE
+	static const size_t N = 40;  // five vectors, no tail
+	static const int16_t COEFF = 31785;  // 0.97
+	alignas(16) int16_t in[N], prev[N], expected[N], actual[N];
+
+	uint32_t seed = 0x2545F491;
+	for (size_t i = 0; i < N; i++) {
+		seed = seed * 1664525 + 1013904223;
+		in[i] = (int16_t)(seed >> 16);
+		prev[i] = (int16_t)seed;
+	}
+	// Both saturation directions and the most negative product
+	in[0] = 32767; prev[0] = -32768;
+	in[1] = -32768; prev[1] = 32767;
+	in[2] = 0; prev[2] = -32768;
+
+	preEmphasisPortable(expected, in, prev, N, COEFF);
+	preEmphasisVector(actual, in, prev, N, COEFF);
+	for (size_t i = 0; i < N; i++) {
+		if (expected[i] != actual[i]) return false;
+	}
+	return true;
+#else
+	return false;
+#endif
+}
+
+}  // namespace MelKernels
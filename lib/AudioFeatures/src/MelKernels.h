@@ -0,0 +1,40 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * int16 stages of the mel front-end.
+ *
+ * Every kernel has a portable version and, on the ESP32-S3, a PIE version
+ * that processes eight samples per instruction. Both give the same bits:
+ * products are (a * b) >> 15 with an arithmetic shift and differences
+ * saturate to int16. Vector versions need 16-byte aligned pointers and run
+ * the portable code on the last n % 8 samples.
+ */
+
+// CONFIG_IDF_TARGET_* is only defined once sdkconfig.h is in
+#ifdef ESP_PLATFORM
+#include "sdkconfig.h"
+#endif
+
+#if defined(CONFIG_IDF_TARGET_ESP32S3) && !defined(AUDIOFEATURES_NO_PIE)
+#define AUDIOFEATURES_PIE 1
+#else
+#define AUDIOFEATURES_PIE 0
+#endif
+
+namespace MelKernels {
+
+// out[i] = sat16(in[i] - ((prev[i] * coeff) >> 15)), coeff in Q15
+void preEmphasisPortable(int16_t* out, const int16_t* in, const int16_t* prev, size_t n, int16_t coeff);
+
+#if AUDIOFEATURES_PIE
+void preEmphasisVector(int16_t* out, const int16_t* in, const int16_t* prev, size_t n, int16_t coeff);
+#endif
+
+// Runs both versions on a fixed pattern with full-scale values. True when
+// they agree; always false without a vector unit
+bool vectorMatches();
+
+}  // namespace MelKernels
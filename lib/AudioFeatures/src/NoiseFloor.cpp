@@ -0,0 +1,58 @@
+#include "NoiseFloor.h"
+#include <math.h>
+#include <string.h>
+
+NoiseFloor::NoiseFloor() {
+	begin(512, 32, 8);
+}
+
+void NoiseFloor::begin(uint16_t frameSamples, uint16_t blockFrames, uint8_t blockCount) {
+	_frameSamples = frameSamples ? frameSamples : 1;
+	_blockFrames = blockFrames ? blockFrames : 1;
+	_blockCount = blockCount < 1 ? 1 : blockCount > MAX_BLOCKS ? MAX_BLOCKS : blockCount;
+	_frameEnergy = 0;
+	_frameFill = 0;
+	_frames = 0;
+	_blockMin = UINT64_MAX;
+	memset(_history, 0, sizeof(_history));
+	_head = 0;
+	_blocks = 0;
+	_floorDb = SILENCE_DB;
+	_blockDb = SILENCE_DB;
+}
+
+float NoiseFloor::toDb(uint64_t energy) const {
+	// Mean square relative to 32768^2, floored at SILENCE_DB
+	double meanSquare = (double)energy / _frameSamples / (32768.0 * 32768.0);
+	float db = meanSquare > 0.0 ? 10.0f * log10f((float)meanSquare) : SILENCE_DB;
+	return db < SILENCE_DB ? SILENCE_DB : db;
+}
+
+void NoiseFloor::update(const int16_t* samples, size_t count) {
+	for (size_t i = 0; i < count; i++) {
+		int32_t s = samples[i];
+		_frameEnergy += (uint64_t)(s * s);
+		if (++_frameFill < _frameSamples) continue;
+
+		if (_frameEnergy < _blockMin) _blockMin = _frameEnergy;
+		_frameEnergy = 0;
+		_frameFill = 0;
+		if (++_frames == _blockFrames) endBlock();
+	}
+}
+
+void NoiseFloor::endBlock() {
+	_history[_head] = _blockMin;
+	_head = (_head + 1) % _blockCount;
+	_blocks++;
+
+	uint8_t kept = _blocks < _blockCount ? (uint8_t)_blocks : _blockCount;
+	uint64_t floor = UINT64_MAX;
+	for (uint8_t i = 0; i < kept; i++) {
+		if (_history[i] < floor) floor = _history[i];
+	}
+	_blockDb = toDb(_blockMin);
+	_floorDb = toDb(floor);
+	_blockMin = UINT64_MAX;
+	_frames = 0;
+}
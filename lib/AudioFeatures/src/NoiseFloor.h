@@ -0,0 +1,53 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * Background noise level of a 16-bit PCM stream by minimum statistics.
+ *
+ * The stream is cut into frames of frameSamples; the quietest frame of each
+ * block of blockFrames frames is kept, and the floor is the quietest block
+ * of the last blockCount. Speech only raises the frames it covers, so the
+ * floor follows the room, not the talker, and reacts to a lasting rise in
+ * noise within blockCount blocks.
+ *
+ * Levels are dBFS of the frame RMS (a full-scale square wave is 0 dBFS).
+ * update() runs on the audio path; floorDb() may be read from any task.
+ */
+class NoiseFloor {
+public:
+	static const uint8_t MAX_BLOCKS = 16;
+	static constexpr float SILENCE_DB = -96.0f;
+
+	NoiseFloor();
+
+	void begin(uint16_t frameSamples, uint16_t blockFrames, uint8_t blockCount);
+	void update(const int16_t* samples, size_t count);
+
+	// SILENCE_DB until the first block is complete
+	float floorDb() const { return _floorDb; }
+	// Quietest frame of the last complete block
+	float blockDb() const { return _blockDb; }
+	uint32_t blocks() const { return _blocks; }
+	// The floor covers the full blockCount window
+	bool ready() const { return _blocks >= _blockCount; }
+
+private:
+	uint16_t _frameSamples;
+	uint16_t _blockFrames;
+	uint8_t _blockCount;
+
+	uint64_t _frameEnergy;  // sum of squares of the current frame
+	uint16_t _frameFill;
+	uint16_t _frames;       // frames in the current block
+	uint64_t _blockMin;     // quietest frame energy of the current block
+	uint64_t _history[MAX_BLOCKS];
+	uint8_t _head;
+	uint32_t _blocks;
+	volatile float _floorDb;
+	volatile float _blockDb;
+
+	float toDb(uint64_t energy) const;
+	void endBlock();
+};
@@ -0,0 +1,110 @@
+#include "AudioReplay.h"
+#include <string.h>
+
+AudioReplay::AudioReplay()
+	: _data(nullptr), _capacity(0), _written(0), _cursor(0), _head(0), _kept(0), _replaying(false), _finished(false),
+	  _requestFrom(0), _requestUs(0), _requested(false), _startUs(0) {
+	memset(&_stats, 0, sizeof(_stats));
+}
+
+void AudioReplay::begin(int16_t* storage, size_t capacity) {
+	_data = storage;
+	_capacity = storage ? capacity : 0;
+	_written = 0;
+	_cursor = 0;
+	_head = 0;
+	_kept = 0;
+	_replaying = false;
+	_finished = false;
+	__atomic_store_n(&_requested, false, __ATOMIC_RELEASE);
+	memset(&_stats, 0, sizeof(_stats));
+}
+
+void AudioReplay::write(const int16_t* samples, size_t count) {
+	if (!_capacity) {
+		_written += count;
+		return;
+	}
+	// Only the newest capacity samples can be kept
+	if (count > _capacity) {
+		samples += count - _capacity;
+		_written += count - _capacity;
+		count = _capacity;
+	}
+
+	uint32_t end = _written + (uint32_t)count;
+	if (_replaying && end - _cursor > _capacity) {
+		// The backlog fell out of the history: skip ahead, audio is lost
+		uint32_t lost = end - _cursor - (uint32_t)_capacity;
+		_stats.overruns += lost;
+		_cursor += lost;
+	}
+
+	size_t first = _capacity - _head < count ? _capacity - _head : count;
+	memcpy(_data + _head, samples, first * sizeof(int16_t));
+	memcpy(_data, samples + first, (count - first) * sizeof(int16_t));
+	_head = (_head + count) % _capacity;
+	_kept = _kept + count < _capacity ? _kept + count : _capacity;
+	_written = end;
+}
+
+void AudioReplay::request(uint32_t from, uint32_t nowUs) {
+	_requestFrom = from;
+	_requestUs = nowUs;
+	__atomic_store_n(&_requested, true, __ATOMIC_RELEASE);
+}
+
+void AudioReplay::apply(uint32_t nowUs) {
+	if (!__atomic_load_n(&_requested, __ATOMIC_ACQUIRE)) return;
+	uint32_t from = _requestFrom;
+	_startUs = _requestUs;
+	__atomic_store_n(&_requested, false, __ATOMIC_RELAXED);
+
+	// A point in the future means "from now"
+	uint32_t lookback = _written - from;
+	if ((int32_t)lookback < 0) lookback = 0;
+	if (lookback > _kept) {
+		_stats.clipped++;
+		lookback = _kept;
+	}
+
+	_stats.handoffs++;
+	_stats.lookback = lookback;
+	_stats.replayed = 0;
+	_stats.switchUs = 0;
+	_stats.drainUs = 0;
+	_cursor = _written - lookback;
+	_replaying = lookback > 0;
+	if (!_replaying) {
+		_stats.drainUs = nowUs - _startUs;
+		_finished = true;
+	}
+}
+
+size_t AudioReplay::read(int16_t* out, size_t count, uint32_t nowUs) {
+	apply(nowUs);
+	if (!_replaying) return 0;
+
+	uint32_t backlog = pending();
+	size_t n = count < backlog ? count : backlog;
+	size_t at = (_head + _capacity - backlog) % _capacity;
+	size_t first = _capacity - at < n ? _capacity - at : n;
+	memcpy(out, _data + at, first * sizeof(int16_t));
+	memcpy(out + first, _data, (n - first) * sizeof(int16_t));
+
+	if (!_stats.replayed) _stats.switchUs = nowUs - _startUs;
+	_stats.replayed += n;
+	_cursor += n;
+	if (!pending()) {
+		_replaying = false;
+		_stats.drainUs = nowUs - _startUs;
+		_finished = true;
+	}
+	return n;
+}
+
+bool AudioReplay::finished() {
+	bool done = _finished;
+	_finished = false;
+	return done;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * Microphone history with a replay cursor, for handing audio captured
+ * before a mode switch to the recognizer that takes over.
+ *
+ * The fill path write()s every live chunk. Samples are numbered from the
+ * first write (position()), so another task can name a point in the stream
+ * and ask for it with request(): the next read() on the fill path starts
+ * serving the history from that sample, oldest first, until it has caught
+ * up with the live stream. Live audio keeps being written meanwhile and is
+ * served after the backlog, so nothing is lost or reordered.
+ *
+ * write() and read() belong to one task (the fill callback). request() may
+ * come from any task or core: it only stores the position, the fill path
+ * applies it on its next read().
+ */
+struct AudioReplayStats {
+	uint32_t handoffs;       // requests applied
+	uint32_t clipped;        // requests that reached past the history
+	uint32_t overruns;       // backlog samples overwritten before they were served
+	// Last handoff
+	uint32_t replayed;       // samples served from the history
+	uint32_t lookback;       // samples between the requested point and the live stream
+	uint32_t switchUs;       // request() to the first replayed sample
+	uint32_t drainUs;        // request() to caught up with the live stream
+};
+
+class AudioReplay {
+public:
+	AudioReplay();
+
+	// capacity samples of history in caller memory
+	void begin(int16_t* storage, size_t capacity);
+	size_t capacity() const { return _capacity; }
+
+	// Live samples, in order
+	void write(const int16_t* samples, size_t count);
+	// Samples written since begin(), wraps at 2^32
+	uint32_t position() const { return _written; }
+
+	// Replay from stream position `from`, clamped to the oldest sample kept.
+	// nowUs timestamps the request for the latency figures
+	void request(uint32_t from, uint32_t nowUs);
+
+	// Fill path: up to count backlog samples, 0 when live. nowUs is the
+	// current time for the statistics
+	size_t read(int16_t* out, size_t count, uint32_t nowUs);
+	// Backlog samples not served yet
+	uint32_t pending() const { return _replaying ? _written - _cursor : 0; }
+	bool replaying() const { return _replaying; }
+	// A handoff is being served or waits for the next read(): the fill path
+	// should write what the microphone has without blocking, then read()
+	bool active() const { return _replaying || __atomic_load_n(&_requested, __ATOMIC_ACQUIRE); }
+	// True once per handoff, on the read() that caught up
+	bool finished();
+
+	const AudioReplayStats& stats() const { return _stats; }
+
+private:
+	int16_t* _data;
+	size_t _capacity;
+	volatile uint32_t _written;
+	uint32_t _cursor;        // stream position of the next sample to serve
+	size_t _head;            // ring index of the next write
+	size_t _kept;            // samples in the history, up to capacity
+	bool _replaying;
+	bool _finished;
+
+	// Set by request(), taken by read()
+	volatile uint32_t _requestFrom;
+	volatile uint32_t _requestUs;
+	volatile bool _requested;
+	uint32_t _startUs;       // request time of the handoff being served
+
+	AudioReplayStats _stats;
+
+	void apply(uint32_t nowUs);
+};
@@ -0,0 +1,109 @@
+#include "BootGraph.h"
+#include <esp_timer.h>
+
+BootGraph::BootGraph(UBaseType_t priority) {
+	memset(_steps, 0, sizeof(_steps));
+	_count = 0;
+	_priority = priority;
+	_done = xEventGroupCreate();
+	_failed = 0;
+	_startUs = 0;
+	_endUs = 0;
+	_started = false;
+}
+
+BootGraph::~BootGraph() {
+	if (_done) {
+		vEventGroupDelete(_done);
+		_done = nullptr;
+	}
+}
+
+BootStepMask BootGraph::add(const char* name, BootStepFunction fn, BootStepMask deps, BaseType_t core, uint32_t stackSize) {
+	BootStepMask known = (1u << _count) - 1;
+	if (_started || !fn || _count >= MAX_STEPS || (deps & ~known)) return 0;
+
+	Step& s = _steps[_count];
+	s.info.name = name;
+	s.info.deps = deps;
+	s.info.result = ESP_OK;
+	s.info.core = -1;
+	s.fn = fn;
+	s.mask = 1u << _count;
+	s.core = core;
+	s.stackSize = stackSize;
+	s.graph = this;
+	_count++;
+	return s.mask;
+}
+
+esp_err_t BootGraph::run(TickType_t timeout) {
+	if (!_done || _started) return ESP_ERR_INVALID_STATE;
+	_started = true;
+	_startUs = (uint32_t)esp_timer_get_time();
+
+	for (size_t i = 0; i < _count; i++) {
+		Step& s = _steps[i];
+		BaseType_t ok = xTaskCreatePinnedToCore(stepTask, s.info.name, s.stackSize, &s, _priority, nullptr, s.core);
+		if (ok != pdPASS) {
+			s.info.result = ESP_ERR_NO_MEM;
+			finish(s);
+		}
+	}
+
+	BootStepMask all = (1u << _count) - 1;
+	EventBits_t bits = all ? xEventGroupWaitBits(_done, all, pdFALSE, pdTRUE, timeout) : 0;
+	_endUs = (uint32_t)esp_timer_get_time();
+
+	if ((bits & all) != all) return ESP_ERR_TIMEOUT;
+	return _failed.load() ? ESP_FAIL : ESP_OK;
+}
+
+void BootGraph::stepTask(void* param) {
+	Step& s = *(Step*)param;
+	BootGraph* graph = s.graph;
+
+	if (s.info.deps) {
+		xEventGroupWaitBits(graph->_done, s.info.deps, pdFALSE, pdTRUE, portMAX_DELAY);
+	}
+
+	s.info.core = xPortGetCoreID();
+	s.info.startUs = (uint32_t)esp_timer_get_time();
+	if (graph->_failed.load() & s.info.deps) {
+		s.info.skipped = true;
+		s.info.result = ESP_ERR_INVALID_STATE;
+	} else {
+		s.info.result = s.fn();
+	}
+	s.info.endUs = (uint32_t)esp_timer_get_time();
+
+	graph->finish(s);
+	vTaskDelete(NULL);
+}
+
+void BootGraph::finish(Step& step) {
+	if (step.info.result != ESP_OK) {
+		_failed.fetch_or(step.mask);
+	}
+	xEventGroupSetBits(_done, step.mask);
+}
+
+const BootStepInfo* BootGraph::step(size_t index) const {
+	return index < _count ? &_steps[index].info : nullptr;
+}
+
+const BootStepInfo* BootGraph::step(const char* name) const {
+	for (size_t i = 0; i < _count; i++) {
+		if (name && strcmp(_steps[i].info.name, name) == 0) return &_steps[i].info;
+	}
+	return nullptr;
+}
+
+uint32_t BootGraph::busyUs() const {
+	uint32_t total = 0;
+	for (size_t i = 0; i < _count; i++) {
+		const BootStepInfo& info = _steps[i].info;
+		if (info.core >= 0) total += info.endUs - info.startUs;
+	}
+	return total;
+}
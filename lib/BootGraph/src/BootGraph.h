@@ -0,0 +1,83 @@
+#pragma once
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/event_groups.h>
+#include <atomic>
+
+/**
+ * Dependency-graph boot orchestrator.
+ *
+ * Each init step is added with the mask of the steps it depends on and an
+ * optional core. run() starts one short-lived task per step; a step waits
+ * for its dependencies' bits in an event group, so independent steps run
+ * concurrently on both cores. Dependencies can only name steps added
+ * earlier, which keeps the graph acyclic. A step whose dependency failed is
+ * skipped and counts as failed itself.
+ *
+ * Every step records its start/end time (esp_timer, microseconds since
+ * boot) and the core it ran on.
+ */
+
+typedef uint32_t BootStepMask;
+typedef esp_err_t (*BootStepFunction)();
+
+struct BootStepInfo {
+	const char* name;
+	BootStepMask deps;
+	uint32_t startUs;
+	uint32_t endUs;
+	esp_err_t result;
+	int8_t core;      // core the step ran on, -1 if it never ran
+	bool skipped;     // a dependency failed
+};
+
+class BootGraph {
+public:
+	static const size_t MAX_STEPS = 16;
+
+	BootGraph(UBaseType_t priority = 5);
+	~BootGraph();
+
+	// Returns the step's mask for use as a dependency, 0 if the step was
+	// rejected (graph full, unknown dependency or already running)
+	BootStepMask add(const char* name, BootStepFunction fn, BootStepMask deps = 0,
+		BaseType_t core = tskNO_AFFINITY, uint32_t stackSize = 4096);
+
+	// Blocks until every step finished; ESP_FAIL if any step failed. Steps
+	// still running after a timeout keep a pointer to the graph, so it has
+	// to outlive them.
+	esp_err_t run(TickType_t timeout = portMAX_DELAY);
+
+	size_t count() const { return _count; }
+	const BootStepInfo* step(size_t index) const;
+	const BootStepInfo* step(const char* name) const;
+	BootStepMask failed() const { return _failed.load(); }
+
+	uint32_t startUs() const { return _startUs; }
+	uint32_t endUs() const { return _endUs; }
+	// Sum of all step durations, compare with endUs() - startUs()
+	uint32_t busyUs() const;
+
+private:
+	struct Step {
+		BootStepInfo info;
+		BootStepFunction fn;
+		BootStepMask mask;
+		BaseType_t core;
+		uint32_t stackSize;
+		BootGraph* graph;
+	};
+
+	Step _steps[MAX_STEPS];
+	size_t _count;
+	UBaseType_t _priority;
+	EventGroupHandle_t _done;
+	std::atomic<uint32_t> _failed;
+	uint32_t _startUs;
+	uint32_t _endUs;
+	bool _started;
+
+	static void stepTask(void* param);
+	void finish(Step& step);
+};
@@ -0,0 +1,120 @@
+#include "CommandDispatcher.h"
+
+static inline uint32_t cyclesToUs(uint32_t cycles) {
+	return cycles / getCpuFrequencyMhz();
+}
+
+CommandDispatcher::CommandDispatcher(size_t queueLength) {
+	_queue = xQueueCreate(queueLength, sizeof(SRCommandEvent));
+	memset(_events, 0, sizeof(_events));
+	memset(_commands, 0, sizeof(_commands));
+	_unknown = {nullptr, nullptr};
+	resetStats();
+}
+
+CommandDispatcher::~CommandDispatcher() {
+	if (_queue) {
+		vQueueDelete(_queue);
+		_queue = nullptr;
+	}
+}
+
+bool CommandDispatcher::onEvent(sr_event_t event, SRCommandHandler handler, void* arg) {
+	if ((size_t)event >= MAX_EVENT) return false;
+	_events[event] = {handler, arg};
+	return true;
+}
+
+bool CommandDispatcher::onCommand(int commandId, SRCommandHandler handler, void* arg) {
+	if (commandId < 0 || (size_t)commandId >= MAX_COMMAND_ID) return false;
+	_commands[commandId] = {handler, arg};
+	return true;
+}
+
+void CommandDispatcher::onUnknown(SRCommandHandler handler, void* arg) {
+	_unknown = {handler, arg};
+}
+
+bool CommandDispatcher::post(sr_event_t event, int commandId, int phraseId) {
+	SRCommandEvent evt = {
+		.event = event,
+		.commandId = (int16_t)commandId,
+		.phraseId = (int16_t)phraseId,
+		.postedAt = ESP.getCycleCount(),
+	};
+
+	if (!_queue || xQueueSend(_queue, &evt, 0) != pdTRUE) {
+		_dropped++;
+		return false;
+	}
+	_posted++;
+	return true;
+}
+
+void CommandDispatcher::recordCallback(uint32_t cycles) {
+	_callbackLastCycles = cycles;
+	if (cycles > _callbackMaxCycles) {
+		_callbackMaxCycles = cycles;
+	}
+}
+
+bool CommandDispatcher::process(TickType_t wait) {
+	SRCommandEvent evt;
+	if (!_queue || xQueueReceive(_queue, &evt, wait) != pdTRUE) {
+		return false;
+	}
+
+	uint32_t start = ESP.getCycleCount();
+	uint32_t queued = start - evt.postedAt;
+	if (queued > _queueMaxCycles) _queueMaxCycles = queued;
+
+	dispatch(evt);
+
+	uint32_t elapsed = ESP.getCycleCount() - start;
+	if (elapsed > _handlerMaxCycles) _handlerMaxCycles = elapsed;
+	_dispatched++;
+	return true;
+}
+
+void CommandDispatcher::dispatch(const SRCommandEvent& evt) {
+	bool handled = false;
+
+	if ((size_t)evt.event < MAX_EVENT && _events[evt.event].handler) {
+		_events[evt.event].handler(evt, _events[evt.event].arg);
+		handled = true;
+	}
+
+	if (evt.event == SR_EVENT_COMMAND) {
+		handled = false;
+		if (evt.commandId >= 0 && (size_t)evt.commandId < MAX_COMMAND_ID && _commands[evt.commandId].handler) {
+			_commands[evt.commandId].handler(evt, _commands[evt.commandId].arg);
+			handled = true;
+		}
+	}
+
+	if (!handled && _unknown.handler) {
+		_unknown.handler(evt, _unknown.arg);
+	}
+}
+
+CommandDispatcherStats CommandDispatcher::getStats() const {
+	return {
+		.posted = _posted,
+		.dropped = _dropped,
+		.dispatched = _dispatched,
+		.callbackMaxUs = cyclesToUs(_callbackMaxCycles),
+		.callbackLastUs = cyclesToUs(_callbackLastCycles),
+		.queueMaxUs = cyclesToUs(_queueMaxCycles),
+		.handlerMaxUs = cyclesToUs(_handlerMaxCycles),
+	};
+}
+
+void CommandDispatcher::resetStats() {
+	_posted = 0;
+	_dropped = 0;
+	_dispatched = 0;
+	_callbackMaxCycles = 0;
+	_callbackLastCycles = 0;
+	_queueMaxCycles = 0;
+	_handlerMaxCycles = 0;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include "esp32-hal-sr.h"
+
+/**
+ * Deferred SR event dispatcher.
+ *
+ * The ESP-SR event callback runs on the SR detect task, so it should only
+ * post() the event and return. A worker task calls process() to run the
+ * handler registered for the event (and for SR_EVENT_COMMAND, the handler
+ * registered for its command_id) through a constant-time table lookup.
+ */
+struct SRCommandEvent {
+	sr_event_t event;
+	int16_t commandId;
+	int16_t phraseId;
+	uint32_t postedAt;  // cycle count at post()
+};
+
+typedef void (*SRCommandHandler)(const SRCommandEvent& evt, void* arg);
+
+struct CommandDispatcherStats {
+	uint32_t posted;
+	uint32_t dropped;
+	uint32_t dispatched;
+	uint32_t callbackMaxUs;
+	uint32_t callbackLastUs;
+	uint32_t queueMaxUs;   // post() -> handler start
+	uint32_t handlerMaxUs;
+};
+
+class CommandDispatcher {
+public:
+	static const size_t MAX_COMMAND_ID = 32;
+	static const size_t MAX_EVENT = SR_EVENT_TIMEOUT + 1;
+
+	CommandDispatcher(size_t queueLength = 8);
+	~CommandDispatcher();
+
+	// Registration: must happen before sr_start(), tables are not locked
+	bool onEvent(sr_event_t event, SRCommandHandler handler, void* arg = nullptr);
+	bool onCommand(int commandId, SRCommandHandler handler, void* arg = nullptr);
+	void onUnknown(SRCommandHandler handler, void* arg = nullptr);
+
+	// Producer side (SR callback): never blocks
+	bool post(sr_event_t event, int commandId, int phraseId);
+	void recordCallback(uint32_t cycles);
+
+	// Consumer side (worker task): waits up to `wait` for one event
+	bool process(TickType_t wait = portMAX_DELAY);
+
+	CommandDispatcherStats getStats() const;
+	void resetStats();
+
+private:
+	struct Slot {
+		SRCommandHandler handler;
+		void* arg;
+	};
+
+	QueueHandle_t _queue;
+	Slot _events[MAX_EVENT];
+	Slot _commands[MAX_COMMAND_ID];
+	Slot _unknown;
+
+	volatile uint32_t _posted;
+	volatile uint32_t _dropped;
+	volatile uint32_t _dispatched;
+	volatile uint32_t _callbackMaxCycles;
+	volatile uint32_t _callbackLastCycles;
+	volatile uint32_t _queueMaxCycles;
+	volatile uint32_t _handlerMaxCycles;
+
+	void dispatch(const SRCommandEvent& evt);
+};
@@ -0,0 +1,69 @@
+#include "CommandSets.h"
+
+CommandSets::CommandSets(const sr_cmd_t* table, size_t size, CommandSetLoader loader)
+	: _table(table), _size(size), _loader(loader), _count(0), _selected(0), _active(0), _openedMs(0), _open(false) {
+	memset(_sets, 0, sizeof(_sets));
+	memset(_stats, 0, sizeof(_stats));
+}
+
+bool CommandSets::add(const char* name, uint16_t first, uint16_t count) {
+	if (_count >= MAX_SETS || !count || (size_t)first + count > _size || find(name)) return false;
+	_sets[_count++] = {name, first, count};
+	return true;
+}
+
+const CommandSet* CommandSets::find(const char* name) const {
+	for (size_t i = 0; i < _count; i++) {
+		if (!strcmp(_sets[i].name, name)) return &_sets[i];
+	}
+	return nullptr;
+}
+
+bool CommandSets::select(const char* name) {
+	const CommandSet* set = find(name);
+	if (!set) return false;
+	_selected = set - _sets;
+	return true;
+}
+
+void CommandSets::started() {
+	_active = _selected;
+}
+
+esp_err_t CommandSets::apply() {
+	size_t selected = _selected;
+	if (selected == _active || selected >= _count) return ESP_OK;
+
+	uint32_t start = micros();
+	esp_err_t err = _loader(_table + _sets[selected].first, _sets[selected].count);
+	if (err != ESP_OK) return err;
+	_active = selected;
+	_stats[selected].loads++;
+	_stats[selected].loadUs = micros() - start;
+	return ESP_OK;
+}
+
+int CommandSets::toTable(int phraseId) const {
+	if (_active >= _count || phraseId < 0 || phraseId >= _sets[_active].count) return -1;
+	return _sets[_active].first + phraseId;
+}
+
+void CommandSets::windowOpened(uint32_t nowMs) {
+	if (_active >= _count) return;
+	_stats[_active].windows++;
+	_openedMs = nowMs;
+	_open = true;
+}
+
+void CommandSets::windowClosed(bool command, uint32_t nowMs) {
+	if (!_open || _active >= _count) return;
+	_open = false;
+	if (!command) return;
+
+	CommandSetStats& stats = _stats[_active];
+	uint32_t latency = nowMs - _openedMs;
+	stats.commands++;
+	stats.latencyLastMs = latency;
+	stats.latencySumMs += latency;
+	if (latency > stats.latencyMaxMs) stats.latencyMaxMs = latency;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <Arduino.h>
+#include "esp32-hal-sr.h"
+
+/**
+ * Named subsets of the voice command table for MultiNet.
+ *
+ * A set is a contiguous range of one sr_cmd_t table, so the phoneme strings
+ * are compiled into flash once and a set is only a pointer and a length.
+ * select() may be called from any task and just swaps the selected index.
+ * The recognizer graph is rebuilt by apply(), which must run where MultiNet
+ * is not detecting: on the ESP-SR detect task (the event callback) or
+ * before the switch to SR_MODE_COMMAND. It does nothing unless the
+ * selection changed, so the cost is paid on the first wake word after a
+ * switch, not on every command window.
+ *
+ * MultiNet numbers phrases within the loaded set; toTable() turns that
+ * phrase_id back into an index of the full table so handlers keep one
+ * numbering whatever set was active.
+ */
+struct CommandSet {
+	const char* name;
+	uint16_t first;  // index in the table
+	uint16_t count;
+};
+
+struct CommandSetStats {
+	uint32_t loads;      // graph rebuilds
+	uint32_t loadUs;     // last rebuild
+	uint32_t windows;    // command windows opened with this set
+	uint32_t commands;   // windows that ended with a command
+	uint32_t latencyLastMs;  // wake word to command
+	uint32_t latencyMaxMs;
+	uint32_t latencySumMs;
+};
+
+// Rebuilds the recognizer with count commands
+typedef esp_err_t (*CommandSetLoader)(const sr_cmd_t* commands, size_t count);
+
+class CommandSets {
+public:
+	static const size_t MAX_SETS = 8;
+
+	CommandSets(const sr_cmd_t* table, size_t size, CommandSetLoader loader);
+
+	// Registration: before sr_start(), the table is not locked
+	bool add(const char* name, uint16_t first, uint16_t count);
+
+	// Any task: takes effect at the next apply()
+	bool select(const char* name);
+	const CommandSet* selected() const { return set(_selected); }
+	// The set MultiNet holds
+	const CommandSet* active() const { return set(_active); }
+	const CommandSet* find(const char* name) const;
+	const CommandSet* set(size_t index) const { return index < _count ? &_sets[index] : nullptr; }
+	size_t count() const { return _count; }
+	const sr_cmd_t* commands(const CommandSet* set) const { return _table + set->first; }
+
+	// The active set was loaded by sr_start() with commands(active())
+	void started();
+	// Detect task: load the selected set if it is not the active one
+	esp_err_t apply();
+	// Detect task: phrase_id of the active set -> index in the table, -1 if out of range
+	int toTable(int phraseId) const;
+
+	// Detect task: window timing for the active set's statistics
+	void windowOpened(uint32_t nowMs);
+	void windowClosed(bool command, uint32_t nowMs);
+	const CommandSetStats* stats(const CommandSet* set) const { return &_stats[set - _sets]; }
+
+private:
+	const sr_cmd_t* _table;
+	size_t _size;
+	CommandSetLoader _loader;
+
+	CommandSet _sets[MAX_SETS];
+	CommandSetStats _stats[MAX_SETS];
+	size_t _count;
+	volatile size_t _selected;
+	size_t _active;
+	uint32_t _openedMs;
+	bool _open;
+};
@@ -1,6 +1,7 @@
 #pragma once
-#include <U8g2lib.h>
+#include "DisplayBackend.h"
 
-extern U8G2_SSD1306_128X64_NONAME_F_HW_I2C* display;
+extern DisplayBackend* display;
 
-void setupDisplay(int sda = SDA, int scl = SCL);
\ No newline at end of file
+// Takes ownership of backend and begins it, false if the panel did not start
+bool setupDisplay(DisplayBackend* backend);
@@ -0,0 +1,65 @@
+#include "DisplayBackend.h"
+#include <string.h>
+
+void DisplayBackend::flush() {
+	uint32_t start = micros();
+	_lastFlushTiles = transfer();
+	_lastFlushUs = micros() - start;
+	_flushes++;
+}
+
+void DisplayBackend::setDirtyFlush(bool enabled) {
+	_dirtyFlush = enabled;
+	_sentValid = false;
+}
+
+uint16_t DisplayBackend::transfer() {
+	if (_dirtyFlush) return transferDirty();
+	_gfx->sendBuffer();
+	return _gfx->getBufferTileWidth() * _gfx->getBufferTileHeight();
+}
+
+uint16_t DisplayBackend::transferDirty() {
+	uint8_t tilesX = _gfx->getBufferTileWidth();
+	uint8_t tilesY = _gfx->getBufferTileHeight();
+	size_t size = (size_t)tilesX * tilesY * 8;
+	const uint8_t* frame = _gfx->getBufferPtr();
+
+	if (!_sent) {
+		_sent = new uint8_t[size];
+		_sentValid = false;
+	}
+	if (!_sent || !_sentValid) {
+		_gfx->sendBuffer();
+		if (_sent) {
+			memcpy(_sent, frame, size);
+			_sentValid = true;
+		}
+		return tilesX * tilesY;
+	}
+
+	uint16_t sent = 0;
+	for (uint8_t ty = 0; ty < tilesY; ty++) {
+		const uint8_t* row = frame + ty * tilesX * 8;
+		uint8_t* shadow = _sent + ty * tilesX * 8;
+
+		// A tile is 8 column bytes, compare them as one word
+		int16_t first = -1, last = -1;
+		for (uint8_t tx = 0; tx < tilesX; tx++) {
+			uint64_t a, b;
+			memcpy(&a, row + tx * 8, 8);
+			memcpy(&b, shadow + tx * 8, 8);
+			if (a != b) {
+				if (first < 0) first = tx;
+				last = tx;
+			}
+		}
+		if (first < 0) continue;
+
+		uint8_t count = last - first + 1;
+		_gfx->updateDisplayArea(first, ty, count, 1);
+		memcpy(shadow + first * 8, row + first * 8, count * 8);
+		sent += count;
+	}
+	return sent;
+}
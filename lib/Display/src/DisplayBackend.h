@@ -0,0 +1,54 @@
+#pragma once
+
+#include <Arduino.h>
+#include <U8g2lib.h>
+
+/**
+ * A display is a U8g2 full-frame drawing surface plus the link that moves
+ * the frame to a panel (or somewhere else). Drawing code uses gfx(), which
+ * is the panel independent U8G2 base class, and calls flush() instead of
+ * U8G2::sendBuffer() so each backend can pick its own transfer path.
+ * Panels only get the tiles that changed since the last flush, so a
+ * screen where only a level bar moves costs a few tiles instead of 128.
+ */
+class DisplayBackend {
+public:
+	virtual ~DisplayBackend() { delete[] _sent; }
+
+	virtual bool begin() = 0;
+	virtual const char* name() const = 0;
+
+	U8G2& gfx() { return *_gfx; }
+	uint8_t* buffer() { return _gfx->getBufferPtr(); }
+	uint16_t width() { return _gfx->getBufferTileWidth() * 8; }
+	uint16_t height() { return _gfx->getBufferTileHeight() * 8; }
+
+	// Send the frame buffer, timing the transfer
+	void flush();
+
+	// Only send the 8x8 tiles that changed since the last flush, per page
+	// from the first to the last changed tile. Keeps a copy of the sent
+	// frame (width * height / 8 bytes). On by default
+	void setDirtyFlush(bool enabled);
+	// Next flush sends the whole frame, e.g. after talking to the panel directly
+	void invalidate() { _sentValid = false; }
+
+	uint32_t lastFlushUs() const { return _lastFlushUs; }
+	uint16_t lastFlushTiles() const { return _lastFlushTiles; }
+	uint32_t flushes() const { return _flushes; }
+
+protected:
+	// Moves the frame out, returns how many tiles were sent
+	virtual uint16_t transfer();
+	uint16_t transferDirty();
+
+	U8G2* _gfx = nullptr;
+	uint32_t _lastFlushUs = 0;
+	uint16_t _lastFlushTiles = 0;
+	uint32_t _flushes = 0;
+
+private:
+	bool _dirtyFlush = true;
+	bool _sentValid = false;
+	uint8_t* _sent = nullptr;
+};
@@ -0,0 +1,25 @@
+#include "I2CDisplay.h"
+
+I2CDisplay::I2CDisplay(I2CPanel panel, int sda, int scl, uint32_t busClock)
+	: _panel(panel), _sda(sda), _scl(scl), _busClock(busClock) {}
+
+I2CDisplay::~I2CDisplay() {
+	delete _gfx;
+}
+
+bool I2CDisplay::begin() {
+	if (!_gfx) {
+		if (_panel == I2CPanel::SH1106) {
+			_gfx = new U8G2_SH1106_128X64_NONAME_F_HW_I2C(U8G2_R0, U8X8_PIN_NONE, _scl, _sda);
+		} else {
+			_gfx = new U8G2_SSD1306_128X64_NONAME_F_HW_I2C(U8G2_R0, U8X8_PIN_NONE, _scl, _sda);
+		}
+		if (!_gfx) return false;
+	}
+	_gfx->setBusClock(_busClock);
+	return _gfx->begin();
+}
+
+const char* I2CDisplay::name() const {
+	return _panel == I2CPanel::SH1106 ? "sh1106-i2c" : "ssd1306-i2c";
+}
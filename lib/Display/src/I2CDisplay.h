@@ -0,0 +1,24 @@
+#pragma once
+
+#include "DisplayBackend.h"
+
+enum class I2CPanel : uint8_t {
+	SSD1306,
+	SH1106,
+};
+
+// 128x64 SSD1306 or SH1106 on the Arduino Wire bus through U8g2's HW I2C driver
+class I2CDisplay : public DisplayBackend {
+public:
+	I2CDisplay(I2CPanel panel, int sda, int scl, uint32_t busClock = 400000);
+	~I2CDisplay() override;
+
+	bool begin() override;
+	const char* name() const override;
+
+private:
+	I2CPanel _panel;
+	int _sda;
+	int _scl;
+	uint32_t _busClock;
+};
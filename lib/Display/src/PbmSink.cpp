@@ -0,0 +1,87 @@
+#include "PbmSink.h"
+#include <PageBuffer.h>
+#include <stdio.h>
+
+namespace {
+
+inline uint8_t reverseBits(uint8_t b) {
+	b = (b & 0xF0) >> 4 | (b & 0x0F) << 4;
+	b = (b & 0xCC) >> 2 | (b & 0x33) << 2;
+	b = (b & 0xAA) >> 1 | (b & 0x55) << 1;
+	return b;
+}
+
+// Full buffer SSD1306 setup, nothing behind the byte and GPIO callbacks
+class U8G2_NULL_128X64 : public U8G2 {
+public:
+	U8G2_NULL_128X64() : U8G2() {
+		u8g2_Setup_ssd1306_128x64_noname_f(&u8g2, U8G2_R0, u8x8_byte_empty, u8x8_dummy_cb);
+	}
+};
+
+}  // namespace
+
+PbmSink::PbmSink(Print& out) : _out(out) {}
+
+PbmSink::~PbmSink() {
+	delete _gfx;
+}
+
+bool PbmSink::begin() {
+	if (!_gfx) {
+		_gfx = new U8G2_NULL_128X64();
+		if (!_gfx) return false;
+	}
+	// Only sets up the buffer, the display init sequence goes nowhere
+	_gfx->initDisplay();
+	_gfx->clearBuffer();
+	return true;
+}
+
+size_t PbmSink::encode(const uint8_t* pages, uint16_t width, uint16_t height, uint8_t* out) {
+	int header = sprintf((char*)out, "P4\n%u %u\n", width, height);
+	uint8_t* row = out + header;
+	uint16_t stride = (width + 7) / 8;
+
+	for (uint16_t page = 0; page < height / 8; page++) {
+		const uint8_t* in = pages + page * width;
+		for (uint16_t x = 0; x < width; x += 8) {
+			// byte c = column c, bit r = row r
+			uint64_t m = 0;
+			uint8_t cols = width - x < 8 ? width - x : 8;
+			for (uint8_t c = 0; c < cols; c++) {
+				m |= (uint64_t)in[x + c] << (c * 8);
+			}
+			m = PageBuffer::transpose8x8(m);
+
+			// PBM rows are MSB first and 1 is black, lit pixels come out white
+			for (uint8_t r = 0; r < 8; r++) {
+				uint8_t b = (uint8_t)(m >> (r * 8));
+				row[(page * 8 + r) * stride + x / 8] = (uint8_t)~reverseBits(b);
+			}
+		}
+	}
+	return header + stride * height;
+}
+
+size_t PbmSink::frame(const uint8_t* pages, uint16_t width, uint16_t height, uint8_t* out) {
+	uint16_t len = encode(pages, width, height, out + 4);
+	out[0] = 0xFE;
+	out[1] = 0xFB;
+	out[2] = len & 0xFF;
+	out[3] = len >> 8;
+
+	uint8_t sum = 0;
+	for (size_t i = 2; i < 4 + (size_t)len; i++) sum ^= out[i];
+	out[4 + len] = sum;
+	return 4 + len + 1;
+}
+
+uint16_t PbmSink::transfer() {
+	// Always whole frames, a capture has to stand on its own
+	static uint8_t image[4 + 16 + 128 * 64 / 8 + 1];
+	if (width() > 128 || height() > 64) return 0;
+	size_t n = frame(buffer(), width(), height(), image);
+	_out.write(image, n);
+	return width() * height() / 64;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "DisplayBackend.h"
+
+/**
+ * Display without a panel: each flush writes the 128x64 frame as a binary
+ * PBM (P4) image to a stream, for example Serial, so frames can be
+ * captured on the host and compared or turned into a video.
+ *
+ * Serial also carries the TokenLog frames, so every image is framed the
+ * same way and goes out in one write() (the Arduino serial drivers hold
+ * their lock for a whole write, so it never lands inside a log frame).
+ * `tools/tokenlog.py decode --pbm-dir DIR` keeps the log readable and
+ * saves the images.
+ *
+ * Wire frame (little endian):
+ *   FE FB | len:u16 | P4 image (len bytes) | xor:u8 over len and image
+ */
+class PbmSink : public DisplayBackend {
+public:
+	explicit PbmSink(Print& out);
+	~PbmSink() override;
+
+	bool begin() override;
+	const char* name() const override { return "pbm-sink"; }
+
+	// Encode a page layout frame as P4 into out, returns the bytes written.
+	// out needs 16 + width * height / 8 bytes
+	static size_t encode(const uint8_t* pages, uint16_t width, uint16_t height, uint8_t* out);
+	// encode() wrapped in the wire frame, out needs 5 bytes more
+	static size_t frame(const uint8_t* pages, uint16_t width, uint16_t height, uint8_t* out);
+
+protected:
+	uint16_t transfer() override;
+
+private:
+	Print& _out;
+};
@@ -0,0 +1,129 @@
+#include "SpiDmaDisplay.h"
+#include <driver/gpio.h>
+#include <esp_log.h>
+#include <string.h>
+
+static const char* TAG = "SpiDmaDisplay";
+
+// Longer runs go through DMA, shorter ones fit the transaction's own buffer
+static const size_t INLINE_BYTES = 4;
+
+SpiDmaDisplay* SpiDmaDisplay::_instance = nullptr;
+
+namespace {
+
+// Panel driver setup of U8G2_SSD1306_128X64_NONAME_F_4W_HW_SPI with our callbacks
+class U8G2_SSD1306_128X64_SPI_DMA : public U8G2 {
+public:
+	U8G2_SSD1306_128X64_SPI_DMA(u8x8_msg_cb byteCb, u8x8_msg_cb gpioCb) : U8G2() {
+		u8g2_Setup_ssd1306_128x64_noname_f(&u8g2, U8G2_R0, byteCb, gpioCb);
+	}
+};
+
+}  // namespace
+
+SpiDmaDisplay::SpiDmaDisplay(const Pins& pins, uint32_t clockHz, spi_host_device_t host)
+	: _pins(pins), _clockHz(clockHz), _host(host) {}
+
+SpiDmaDisplay::~SpiDmaDisplay() {
+	if (_device) spi_bus_remove_device(_device);
+	if (_busReady) spi_bus_free(_host);
+	if (_instance == this) _instance = nullptr;
+	delete _gfx;
+}
+
+bool SpiDmaDisplay::begin() {
+	if (_instance && _instance != this) {
+		ESP_LOGE(TAG, "only one SPI DMA display is supported");
+		return false;
+	}
+	_instance = this;
+
+	if (!_busReady) {
+		spi_bus_config_t bus = {};
+		bus.mosi_io_num = _pins.mosi;
+		bus.miso_io_num = -1;
+		bus.sclk_io_num = _pins.sck;
+		bus.quadwp_io_num = -1;
+		bus.quadhd_io_num = -1;
+		bus.max_transfer_sz = 1024;
+		esp_err_t err = spi_bus_initialize(_host, &bus, SPI_DMA_CH_AUTO);
+		if (err != ESP_OK) {
+			ESP_LOGE(TAG, "spi_bus_initialize: %s", esp_err_to_name(err));
+			return false;
+		}
+		_busReady = true;
+	}
+
+	if (!_device) {
+		spi_device_interface_config_t dev = {};
+		dev.mode = 0;
+		dev.clock_speed_hz = (int)_clockHz;
+		dev.spics_io_num = _pins.cs;
+		dev.queue_size = 1;
+		esp_err_t err = spi_bus_add_device(_host, &dev, &_device);
+		if (err != ESP_OK) {
+			ESP_LOGE(TAG, "spi_bus_add_device: %s", esp_err_to_name(err));
+			return false;
+		}
+	}
+
+	if (!_gfx) {
+		_gfx = new U8G2_SSD1306_128X64_SPI_DMA(byteCallback, gpioCallback);
+		if (!_gfx) return false;
+	}
+	return _gfx->begin();
+}
+
+esp_err_t SpiDmaDisplay::send(const uint8_t* data, size_t len) {
+	spi_transaction_t t = {};
+	t.length = len * 8;
+	if (len <= INLINE_BYTES) {
+		t.flags = SPI_TRANS_USE_TXDATA;
+		memcpy(t.tx_data, data, len);
+		return spi_device_polling_transmit(_device, &t);
+	}
+	t.tx_buffer = data;
+	return spi_device_transmit(_device, &t);
+}
+
+uint8_t SpiDmaDisplay::byteCallback(u8x8_t* u8x8, uint8_t msg, uint8_t argInt, void* argPtr) {
+	SpiDmaDisplay* self = _instance;
+	switch (msg) {
+	case U8X8_MSG_BYTE_SEND:
+		return self && self->send((const uint8_t*)argPtr, argInt) == ESP_OK;
+	case U8X8_MSG_BYTE_SET_DC:
+		u8x8_gpio_SetDC(u8x8, argInt);
+		return 1;
+	case U8X8_MSG_BYTE_INIT:
+	case U8X8_MSG_BYTE_START_TRANSFER:
+	case U8X8_MSG_BYTE_END_TRANSFER:
+		// Bus set up in begin(), CS driven by the SPI peripheral
+		return 1;
+	default:
+		return 0;
+	}
+}
+
+uint8_t SpiDmaDisplay::gpioCallback(u8x8_t* u8x8, uint8_t msg, uint8_t argInt, void* argPtr) {
+	SpiDmaDisplay* self = _instance;
+	if (!self) return 0;
+	switch (msg) {
+	case U8X8_MSG_GPIO_AND_DELAY_INIT:
+		gpio_set_direction((gpio_num_t)self->_pins.dc, GPIO_MODE_OUTPUT);
+		if (self->_pins.reset >= 0) gpio_set_direction((gpio_num_t)self->_pins.reset, GPIO_MODE_OUTPUT);
+		return 1;
+	case U8X8_MSG_GPIO_DC:
+		// Transactions are blocking, so DC never changes under a transfer
+		gpio_set_level((gpio_num_t)self->_pins.dc, argInt);
+		return 1;
+	case U8X8_MSG_GPIO_RESET:
+		if (self->_pins.reset >= 0) gpio_set_level((gpio_num_t)self->_pins.reset, argInt);
+		return 1;
+	case U8X8_MSG_DELAY_MILLI:
+		delay(argInt);
+		return 1;
+	default:
+		return 1;
+	}
+}
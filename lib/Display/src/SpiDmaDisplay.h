@@ -0,0 +1,43 @@
+#pragma once
+
+#include "DisplayBackend.h"
+#include <driver/spi_master.h>
+
+/**
+ * 128x64 SSD1306 on 4-wire SPI through the ESP-IDF SPI master with DMA.
+ *
+ * U8g2 still drives the panel protocol. Its byte callback is replaced so
+ * each page of 128 data bytes goes out as one DMA transaction, and the
+ * short command runs use polling transactions. At 10 MHz a full frame is
+ * about 1 ms on the wire, against about 25 ms for I2C at 400 kHz.
+ * Only one instance can exist, because the U8g2 callbacks are static.
+ */
+class SpiDmaDisplay : public DisplayBackend {
+public:
+	struct Pins {
+		int sck;
+		int mosi;
+		int cs;
+		int dc;
+		int reset;  // -1 if not wired
+	};
+
+	SpiDmaDisplay(const Pins& pins, uint32_t clockHz = 10000000, spi_host_device_t host = SPI2_HOST);
+	~SpiDmaDisplay() override;
+
+	bool begin() override;
+	const char* name() const override { return "ssd1306-spi-dma"; }
+
+private:
+	Pins _pins;
+	uint32_t _clockHz;
+	spi_host_device_t _host;
+	spi_device_handle_t _device = nullptr;
+	bool _busReady = false;
+
+	esp_err_t send(const uint8_t* data, size_t len);
+
+	static SpiDmaDisplay* _instance;
+	static uint8_t byteCallback(u8x8_t* u8x8, uint8_t msg, uint8_t argInt, void* argPtr);
+	static uint8_t gpioCallback(u8x8_t* u8x8, uint8_t msg, uint8_t argInt, void* argPtr);
+};
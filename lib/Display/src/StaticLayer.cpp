@@ -0,0 +1,25 @@
+#include "StaticLayer.h"
+#include <string.h>
+
+void StaticLayer::draw(DisplayBackend& display) {
+	U8G2& gfx = display.gfx();
+	size_t size = (size_t)display.width() * display.height() / 8;
+
+	if (_valid && _owner == &display && _size == size) {
+		memcpy(display.buffer(), _pixels, size);
+		return;
+	}
+
+	gfx.clearBuffer();
+	_paint(gfx);
+
+	if (_size != size) {
+		delete[] _pixels;
+		_pixels = new uint8_t[size];
+		_size = _pixels ? size : 0;
+	}
+	if (!_pixels) return;
+	memcpy(_pixels, display.buffer(), size);
+	_owner = &display;
+	_valid = true;
+}
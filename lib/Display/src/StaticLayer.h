@@ -0,0 +1,30 @@
+#pragma once
+
+#include "DisplayBackend.h"
+
+/**
+ * Cached background for screens that redraw the same text every frame.
+ *
+ * The first draw() clears the frame, runs paint() and keeps a copy of the
+ * result. Later calls copy the cached frame back instead of running the
+ * font code again, and the caller draws only what changes on top. The
+ * cache is rebuilt after invalidate() or when used with another display.
+ */
+class StaticLayer {
+public:
+	typedef void (*Painter)(U8G2& gfx);
+
+	explicit StaticLayer(Painter paint) : _paint(paint) {}
+	~StaticLayer() { delete[] _pixels; }
+
+	// Leaves the display buffer holding the static layer
+	void draw(DisplayBackend& display);
+	void invalidate() { _valid = false; }
+
+private:
+	Painter _paint;
+	DisplayBackend* _owner = nullptr;
+	uint8_t* _pixels = nullptr;
+	size_t _size = 0;
+	bool _valid = false;
+};
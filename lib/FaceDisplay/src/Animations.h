@@ -14,6 +14,7 @@ You should have received a copy of the GNU Affero General Public License along w
 #define _ANIMATIONS_h
 
 #include <Arduino.h>
+#include "FrameClock.h"
 
 class IAnimation {
 public:
@@ -27,13 +28,13 @@ private:
 
 class AnimationBase : IAnimation {
   public:
-	  AnimationBase(unsigned long interval) : Interval(interval), StarTime(millis()) {}
+	  AnimationBase(unsigned long interval) : Interval(interval), StarTime(FrameClock::Now()) {}
 
 	  unsigned long Interval;
 	  unsigned long StarTime;
 
 	  virtual void Restart() {
-		  StarTime = millis();
+		  StarTime = FrameClock::Now();
 	  }
 	  float GetValue() override final {
 		  return GetValue(GetElapsed());
@@ -42,7 +43,7 @@ class AnimationBase : IAnimation {
 		  return Calculate(elapsedMillis);
 	  }
 	  unsigned long GetElapsed() override {
-		  return static_cast<unsigned long> (millis() - StarTime);
+		  return static_cast<unsigned long> (FrameClock::Now() - StarTime);
 	  }
 
   protected:
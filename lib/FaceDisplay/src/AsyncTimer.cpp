@@ -25,7 +25,7 @@ void AsyncTimer::Start() {
 }
 
 void AsyncTimer::Reset() {
-	_startTime = millis();
+	_startTime = FrameClock::Now();
 }
 
 void AsyncTimer::Stop() {
@@ -36,7 +36,7 @@ bool AsyncTimer::Update() {
 	if (_isActive == false) return false;
 
 	_isExpired = false;
-	if (static_cast<unsigned long>(millis() - _startTime) >= Interval) {
+	if (static_cast<unsigned long>(FrameClock::Now() - _startTime) >= Interval) {
 		_isExpired = true;
 		if (OnFinish != nullptr) OnFinish();
 		Reset();
@@ -53,11 +53,11 @@ unsigned long AsyncTimer::GetStartTime() {
 }
 
 unsigned long AsyncTimer::GetElapsedTime() {
-	return millis() - _startTime;
+	return FrameClock::Now() - _startTime;
 }
 
 unsigned long AsyncTimer::GetRemainingTime() {
-	return Interval - millis() + _startTime;
+	return Interval - FrameClock::Now() + _startTime;
 }
 
 bool AsyncTimer::IsActive() const {
@@ -14,6 +14,7 @@ You should have received a copy of the GNU Affero General Public License along w
 #define _ASYNCTIMER_h
 
 #include <Arduino.h>
+#include "FrameClock.h"
 
 typedef void(*AsyncTimerCallback)();
 
@@ -41,8 +42,8 @@ class AsyncTimer {
 	AsyncTimerCallback OnFinish;
 
 private:
-	bool _isActive;
-	bool _isExpired;
-	unsigned long _startTime;
+	bool _isActive = false;
+	bool _isExpired = false;
+	unsigned long _startTime = 0;
 };
 #endif
\ No newline at end of file
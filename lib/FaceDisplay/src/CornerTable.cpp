@@ -0,0 +1,55 @@
+#include "CornerTable.h"
+
+namespace {
+
+constexpr int32_t Start(int32_t r) {
+	return r * (r + 1) / 2;
+}
+
+struct Table {
+	CornerSpan Spans[Start(CornerTable::MaxRadius + 1)];
+};
+
+// Same loops as EyeDrawer::FillEllipseCorner with rx == ry == r, keeping
+// the widest drawHLine per row offset of each pass
+constexpr Table Build() {
+	Table table{};
+	for (int32_t r = 2; r <= CornerTable::MaxRadius; r++) {
+		CornerSpan* spans = table.Spans + Start(r);
+		int32_t x = 0, y = 0;
+		int32_t r2 = r * r;
+		int32_t f2 = 4 * r2;
+		int32_t s = 0;
+
+		for (x = 0, y = r, s = 2 * r2 + r2 * (1 - 2 * r); r2 * x <= r2 * y; x++) {
+			if (x > spans[y].First) spans[y].First = x;
+			if (s >= 0) {
+				s += f2 * (1 - y);
+				y--;
+			}
+			s += r2 * ((4 * x) + 6);
+		}
+		for (x = r, y = 0, s = 2 * r2 + r2 * (1 - 2 * r); r2 * y <= r2 * x; y++) {
+			if (x > spans[y].Second) spans[y].Second = x;
+			if (s >= 0) {
+				s += f2 * (1 - x);
+				x--;
+			}
+			s += r2 * ((4 * y) + 6);
+		}
+	}
+	return table;
+}
+
+constexpr Table table = Build();
+
+// Spot checks against the midpoint loops
+static_assert(table.Spans[Start(2) + 2].First == 1 && table.Spans[Start(2)].Second == 2, "radius 2");
+static_assert(table.Spans[Start(CornerTable::MaxRadius)].Second == CornerTable::MaxRadius, "full width at the centre row");
+
+}  // namespace
+
+const CornerSpan* CornerTable::Spans(int32_t r) {
+	if (r < 2 || r > MaxRadius) return nullptr;
+	return table.Spans + Start(r);
+}
@@ -0,0 +1,30 @@
+#ifndef _CORNERTABLE_h
+#define _CORNERTABLE_h
+
+#include <Arduino.h>
+
+// Widest span the midpoint quarter circle of EyeDrawer::FillEllipseCorner
+// draws at one row offset, for its first (x stepping) and second
+// (y stepping) pass. The passes are kept apart because B_L places them
+// on different rows
+struct CornerSpan {
+	uint8_t First;
+	uint8_t Second;
+};
+
+/**
+ * Quarter circle spans for every radius up to the screen height, built
+ * at compile time by running the midpoint algorithm of
+ * EyeDrawer::FillEllipseCorner and stored in flash. Drawing a corner
+ * becomes one span per row offset instead of a midpoint loop per frame.
+ */
+class CornerTable {
+public:
+	static const int16_t MaxRadius = 64;
+
+	// Spans of radius r indexed by row offset 0..r, nullptr if r < 2
+	// (no corner drawn) or r > MaxRadius
+	static const CornerSpan* Spans(int32_t r);
+};
+
+#endif
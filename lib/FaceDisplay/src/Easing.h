@@ -0,0 +1,50 @@
+#ifndef _EASING_h
+#define _EASING_h
+
+#include <Arduino.h>
+
+// Easing curves for EyeTransition. Every curve maps progress t in [0, 1]
+// to [0, 1] with f(0) = 0 and f(1) = 1, and depends on t only, so a
+// transition evaluated at the same time gives the same result regardless
+// of how many frames were drawn before it.
+enum eEasing {
+	Linear,
+	EaseInQuad,
+	EaseOutQuad,
+	EaseInOutQuad,
+	EaseOutCubic,
+	EaseInOutCubic,
+	SmoothStep,
+
+	EASING_COUNT
+};
+
+static inline float Ease(eEasing easing, float t) {
+	if (t <= 0.0f) return 0.0f;
+	if (t >= 1.0f) return 1.0f;
+
+	float u;
+	switch (easing) {
+	case EaseInQuad:
+		return t * t;
+	case EaseOutQuad:
+		return t * (2.0f - t);
+	case EaseInOutQuad:
+		if (t < 0.5f) return 2.0f * t * t;
+		u = 1.0f - t;
+		return 1.0f - 2.0f * u * u;
+	case EaseOutCubic:
+		u = 1.0f - t;
+		return 1.0f - u * u * u;
+	case EaseInOutCubic:
+		if (t < 0.5f) return 4.0f * t * t * t;
+		u = 1.0f - t;
+		return 1.0f - 4.0f * u * u * u;
+	case SmoothStep:
+		return t * t * (3.0f - 2.0f * t);
+	default:
+		return t;
+	}
+}
+
+#endif
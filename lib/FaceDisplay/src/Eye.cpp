@@ -11,8 +11,10 @@ You should have received a copy of the GNU Affero General Public License along w
 ****************************************************/
 
 #include "Eye.h"
+#include "Face.h"
+#include "EyeRaster.h"
 
-Eye::Eye(Face& face) : _face(face) {
+Eye::Eye(Face& face) : _face(face), Config() {
 
   this->IsMirrored = false;
 
@@ -49,8 +51,17 @@ void Eye::Update() {
 	BlinkTransformation.Update();
 }
 
-void Eye::Draw(U8G2_SSD1306_128X64_NONAME_F_HW_I2C *_u8g2) {
+void Eye::Draw(U8G2 *_u8g2) {
 	Update();
+	Render(_u8g2);
+}
+
+void Eye::Render(U8G2 *_u8g2) {
+	if (_face.SpanRaster) {
+		int16_t width = _u8g2->getBufferTileWidth() * 8;
+		int16_t height = _u8g2->getBufferTileHeight() * 8;
+		if (EyeRaster::Draw(_u8g2->getBufferPtr(), width, height, CenterX, CenterY, FinalConfig)) return;
+	}
 	EyeDrawer::Draw(_u8g2, CenterX, CenterY, FinalConfig);
 }
 
@@ -66,10 +77,13 @@ void Eye::ApplyPreset(const EyeConfig config) {
 	Config.Inverse_Radius_Top = config.Inverse_Radius_Top;
 	Config.Inverse_Radius_Bottom = config.Inverse_Radius_Bottom;
 
-	Transition.Animation.Restart();
+	Transition.Begin();
 }
 
 void Eye::TransitionTo(const EyeConfig config) {
+	// Start from where the eye is now, not where the last frame left it
+	Transition.Update();
+
 	Transition.Destin.OffsetX = this->IsMirrored ? -config.OffsetX : config.OffsetX;
 	Transition.Destin.OffsetY = -config.OffsetY;
 	Transition.Destin.Height = config.Height;
@@ -81,5 +95,5 @@ void Eye::TransitionTo(const EyeConfig config) {
 	Transition.Destin.Inverse_Radius_Top = config.Inverse_Radius_Top;
 	Transition.Destin.Inverse_Radius_Bottom = config.Inverse_Radius_Bottom;
 
-	Transition.Animation.Restart();
+	Transition.Begin();
 }
\ No newline at end of file
@@ -29,7 +29,6 @@ class Eye {
   protected:
     Face& _face;
 
-    void Update();
     void ChainOperators();
 
   public:
@@ -50,7 +49,12 @@ class Eye {
 
     void ApplyPreset(const EyeConfig preset);
     void TransitionTo(const EyeConfig preset);
-    void Draw(U8G2_SSD1306_128X64_NONAME_F_HW_I2C *_u8g2);
+    // Run the operator chain one by one (see EyeChain for the fused version)
+    void Update();
+    // Update() then Render()
+    void Draw(U8G2 *_u8g2);
+    // Draw FinalConfig as left by the last update
+    void Render(U8G2 *_u8g2);
 };
 
 #endif
\ No newline at end of file
@@ -13,7 +13,7 @@ You should have received a copy of the GNU Affero General Public License along w
 #include "EyeBlink.h"
 
 
-EyeBlink::EyeBlink() : Animation(40, 100, 40) { }
+EyeBlink::EyeBlink() : Output(), Animation(40, 100, 40) { }
 
 void EyeBlink::Update() {
 	auto t = Animation.GetValue();
@@ -0,0 +1,194 @@
+#include "EyeChain.h"
+#include "Eye.h"
+
+// Lane of field F for eye e is F + e
+enum EyeChainLane {
+	OffsetX = 0,
+	OffsetY = 2,
+	Height = 4,
+	Width = 6,
+	Radius_Top = 8,
+	Radius_Bottom = 10,
+	Inverse_Radius_Top = 12,
+	Inverse_Radius_Bottom = 14,
+	Inverse_Offset_Top = 16,
+	Inverse_Offset_Bottom = 18,
+	Slope_Top = 20,
+	Slope_Bottom = 22,
+};
+
+static void Gather(float* lanes, const EyeConfig& config, int e) {
+	lanes[OffsetX + e] = config.OffsetX;
+	lanes[OffsetY + e] = config.OffsetY;
+	lanes[Height + e] = config.Height;
+	lanes[Width + e] = config.Width;
+	lanes[Radius_Top + e] = config.Radius_Top;
+	lanes[Radius_Bottom + e] = config.Radius_Bottom;
+	lanes[Inverse_Radius_Top + e] = config.Inverse_Radius_Top;
+	lanes[Inverse_Radius_Bottom + e] = config.Inverse_Radius_Bottom;
+	lanes[Inverse_Offset_Top + e] = config.Inverse_Offset_Top;
+	lanes[Inverse_Offset_Bottom + e] = config.Inverse_Offset_Bottom;
+	lanes[Slope_Top + e] = config.Slope_Top;
+	lanes[Slope_Bottom + e] = config.Slope_Bottom;
+}
+
+static void GatherInt(int16_t* lanes, const EyeConfig& config, int e) {
+	lanes[OffsetX + e] = config.OffsetX;
+	lanes[OffsetY + e] = config.OffsetY;
+	lanes[Height + e] = config.Height;
+	lanes[Width + e] = config.Width;
+	lanes[Radius_Top + e] = config.Radius_Top;
+	lanes[Radius_Bottom + e] = config.Radius_Bottom;
+	lanes[Inverse_Radius_Top + e] = config.Inverse_Radius_Top;
+	lanes[Inverse_Radius_Bottom + e] = config.Inverse_Radius_Bottom;
+	lanes[Inverse_Offset_Top + e] = config.Inverse_Offset_Top;
+	lanes[Inverse_Offset_Bottom + e] = config.Inverse_Offset_Bottom;
+}
+
+static void Scatter(EyeConfig& config, const int16_t* lanes, const float* slopes, int e) {
+	config.OffsetX = lanes[OffsetX + e];
+	config.OffsetY = lanes[OffsetY + e];
+	config.Height = lanes[Height + e];
+	config.Width = lanes[Width + e];
+	config.Radius_Top = lanes[Radius_Top + e];
+	config.Radius_Bottom = lanes[Radius_Bottom + e];
+	config.Inverse_Radius_Top = lanes[Inverse_Radius_Top + e];
+	config.Inverse_Radius_Bottom = lanes[Inverse_Radius_Bottom + e];
+	config.Inverse_Offset_Top = lanes[Inverse_Offset_Top + e];
+	config.Inverse_Offset_Bottom = lanes[Inverse_Offset_Bottom + e];
+	config.Slope_Top = slopes[Slope_Top - EyeChain::IntLanes + e];
+	config.Slope_Bottom = slopes[Slope_Bottom - EyeChain::IntLanes + e];
+}
+
+void EyeChain::Update(Eye& first, Eye& second) {
+	Eye* eyes[2] = {&first, &second};
+	EyeChainFrame frame;
+	Sample(eyes, frame);
+	Evaluate(eyes, frame);
+}
+
+// Same animation reads, in the same order, as the operators' Update()
+void EyeChain::Sample(Eye* eyes[2], EyeChainFrame& frame) {
+	for (int e = 0; e < 2; e++) {
+		Eye& eye = *eyes[e];
+
+		frame.Transition[e] = eye.Transition.Progress();
+
+		EyeTransformation& tr = eye.Transformation;
+		tr.Interpolate(tr.Animation.GetValue());
+		frame.MoveX[e] = tr.Current.MoveX;
+		frame.MoveY[e] = tr.Current.MoveY;
+		frame.ScaleX[e] = tr.Current.ScaleX;
+		frame.ScaleY[e] = tr.Current.ScaleY;
+
+		frame.Variation1[e] = 2.0 * eye.Variation1.Animation.GetValue() - 1.0;
+		frame.Variation2[e] = 2.0 * eye.Variation2.Animation.GetValue() - 1.0;
+
+		auto b = eye.BlinkTransformation.Animation.GetValue();
+		if (eye.BlinkTransformation.Animation.GetElapsed() > eye.BlinkTransformation.Animation.Interval) b = 0.0;
+		frame.Blink[e] = b * b;
+		frame.BlinkKeep[e] = 1.0 - frame.Blink[e];
+	}
+}
+
+static uint8_t ActiveLanes(uint8_t* lanes, const float* inputs) {
+	uint8_t count = 0;
+	for (int i = 0; i < EyeChain::IntLanes; i++) {
+		if (inputs[i] != 0.0f) lanes[count++] = i;
+	}
+	return count;
+}
+
+// Rebuild the input lanes of an eye whose transition or variations changed
+void EyeChain::Load(Eye* eyes[2]) {
+	bool rebuilt = false;
+	for (int e = 0; e < 2; e++) {
+		const EyeConfig* inputs[4] = {
+			&eyes[e]->Transition.Start, &eyes[e]->Transition.Destin,
+			&eyes[e]->Variation1.Values, &eyes[e]->Variation2.Values,
+		};
+		bool changed = !_isLoaded;
+		for (int k = 0; k < 4; k++) {
+			if (memcmp(&_loaded[e][k], inputs[k], sizeof(EyeConfig)) == 0) continue;
+			_loaded[e][k] = *inputs[k];
+			changed = true;
+		}
+		if (!changed) continue;
+
+		Gather(_start, *inputs[0], e);
+		Gather(_delta, *inputs[1], e);
+		Gather(_values1, *inputs[2], e);
+		Gather(_values2, *inputs[3], e);
+		GatherInt(_origin, *inputs[0], e);
+		GatherInt(_destin, *inputs[1], e);
+		// Whole numbers for the int16 fields, so the same as subtracting in int
+		for (int i = e; i < Lanes; i += 2) _delta[i] -= _start[i];
+		rebuilt = true;
+	}
+	_isLoaded = true;
+	if (!rebuilt) return;
+
+	_transitionCount = ActiveLanes(_transitionLanes, _delta);
+	_variation1Count = ActiveLanes(_variation1Lanes, _values1);
+	_variation2Count = ActiveLanes(_variation2Lanes, _values2);
+}
+
+// Every stage runs its int16 lanes, assigned like in Apply(), then the
+// float lanes
+void EyeChain::Evaluate(Eye* eyes[2], const EyeChainFrame& f) {
+	Load(eyes);
+	int16_t* __restrict v = _value;
+	float* __restrict slope = _slope;
+	const float* slopeStart = _start + IntLanes;
+	const float* slopeDelta = _delta + IntLanes;
+	const float* slopeValues1 = _values1 + IntLanes;
+	const float* slopeValues2 = _values2 + IntLanes;
+
+	// Transition. The lanes left out are at their start value, and at 1
+	// every int16 lane is at its destination
+	if (f.Transition[0] == 1.0f && f.Transition[1] == 1.0f) {
+		memcpy(v, _destin, sizeof(_value));
+	} else {
+		memcpy(v, _origin, sizeof(_value));
+		for (int n = 0; n < _transitionCount; n++) {
+			int i = _transitionLanes[n];
+			v[i] = _start[i] + _delta[i] * f.Transition[i & 1];
+		}
+	}
+	for (int i = 0; i < FloatLanes; i++) slope[i] = slopeStart[i] + slopeDelta[i] * f.Transition[i & 1];
+	Scatter(eyes[0]->Config, v, slope, 0);
+	Scatter(eyes[1]->Config, v, slope, 1);
+
+	// Transformation, the other fields pass through
+	for (int e = 0; e < 2; e++) {
+		v[OffsetX + e] = v[OffsetX + e] + f.MoveX[e];
+		v[OffsetY + e] = v[OffsetY + e] - f.MoveY[e];
+		v[Height + e] = v[Height + e] * f.ScaleY[e];
+		v[Width + e] = v[Width + e] * f.ScaleX[e];
+	}
+
+	// Variation1 and Variation2
+	for (int n = 0; n < _variation1Count; n++) {
+		int i = _variation1Lanes[n];
+		v[i] = v[i] + _values1[i] * f.Variation1[i & 1];
+	}
+	for (int i = 0; i < FloatLanes; i++) slope[i] = slope[i] + slopeValues1[i] * f.Variation1[i & 1];
+	for (int n = 0; n < _variation2Count; n++) {
+		int i = _variation2Lanes[n];
+		v[i] = v[i] + _values2[i] * f.Variation2[i & 1];
+	}
+	for (int i = 0; i < FloatLanes; i++) slope[i] = slope[i] + slopeValues2[i] * f.Variation2[i & 1];
+
+	// BlinkTransformation: offsets pass through, height and width close on
+	// the blink size, the shape fields scale down. At 0 it changes nothing
+	for (int e = 0; e < 2; e++) {
+		if (f.Blink[e] == 0.0f) continue;
+		const EyeBlink& blink = eyes[e]->BlinkTransformation;
+		v[Height + e] = (blink.BlinkHeight - v[Height + e]) * f.Blink[e] + v[Height + e];
+		v[Width + e] = (blink.BlinkWidth - v[Width + e]) * f.Blink[e] + v[Width + e];
+		for (int i = Radius_Top + e; i < IntLanes; i += 2) v[i] = v[i] * f.BlinkKeep[e];
+		for (int i = e; i < FloatLanes; i += 2) slope[i] = slope[i] * f.BlinkKeep[e];
+	}
+	Scatter(*eyes[0]->FinalConfig, v, slope, 0);
+	Scatter(*eyes[1]->FinalConfig, v, slope, 1);
+}
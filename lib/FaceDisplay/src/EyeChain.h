@@ -0,0 +1,87 @@
+#ifndef _EYECHAIN_h
+#define _EYECHAIN_h
+
+#include <Arduino.h>
+#include "EyeConfig.h"
+
+class Eye;
+
+// Per frame coefficients of every operator, one slot per eye
+struct EyeChainFrame {
+	float Transition[2];       // eased progress, EyeTransition::Progress
+	float MoveX[2];
+	float MoveY[2];
+	float ScaleX[2];
+	float ScaleY[2];
+	float Variation1[2];
+	float Variation2[2];
+	float Blink[2];
+	double BlinkKeep[2];       // 1.0 - Blink, in double like EyeBlink::Apply
+};
+
+/**
+ * Fused evaluation of Transition -> Transformation -> Variation1 ->
+ * Variation2 -> BlinkTransformation for both eyes.
+ *
+ * The 12 EyeConfig fields of both eyes are kept as a structure of arrays:
+ * one array per field, one lane per eye, laid out field by field so that
+ * lane i belongs to eye i & 1. The ten int16 fields come first, then the
+ * two float slopes; their running values are int16 and float lanes, so
+ * every stage assigns to int16 like its Apply() does. Each stage is one
+ * loop over the lanes it changes and updates the running values in place;
+ * fields a stage passes through are not touched. Only Eye::Config (the
+ * transition output) and Eye::FinalConfig are written back.
+ *
+ * The operators' inputs (transition start and destination, variation
+ * values) change with the expression, not per frame: their lanes are
+ * rebuilt only when they differ from the copies of the last frame, along
+ * with the list of int16 lanes each stage can change. An int16 lane whose
+ * transition delta or variation value is 0 keeps its value exactly, so
+ * it is left out; so are all int16 lanes once both transitions are done,
+ * and the blink of an eye that is not blinking. The float lanes always
+ * run, adding 0 can still change the sign of a zero.
+ *
+ * Each stage keeps the arithmetic and int16 truncation of its operator's
+ * Apply(), so the result matches Eye::Update() exactly.
+ */
+class EyeChain {
+public:
+	static constexpr int Fields = 12;
+	static constexpr int IntFields = 10;
+	static constexpr int Lanes = Fields * 2;
+	static constexpr int IntLanes = IntFields * 2;
+	static constexpr int FloatLanes = Lanes - IntLanes;
+
+	void Update(Eye& first, Eye& second);
+
+	// Exposed for benchmarks
+	static void Sample(Eye* eyes[2], EyeChainFrame& frame);
+	void Evaluate(Eye* eyes[2], const EyeChainFrame& frame);
+
+private:
+	void Load(Eye* eyes[2]);
+
+	// Stage inputs, rebuilt by Load()
+	float _start[Lanes];
+	float _delta[Lanes];       // Destin - Start
+	float _values1[Lanes];
+	float _values2[Lanes];
+	int16_t _origin[IntLanes]; // Start and Destin of the int16 lanes
+	int16_t _destin[IntLanes];
+	// int16 lanes with a non zero delta or value
+	uint8_t _transitionLanes[IntLanes];
+	uint8_t _variation1Lanes[IntLanes];
+	uint8_t _variation2Lanes[IntLanes];
+	uint8_t _transitionCount = 0;
+	uint8_t _variation1Count = 0;
+	uint8_t _variation2Count = 0;
+	// Running values, stage after stage
+	int16_t _value[IntLanes];
+	float _slope[FloatLanes];
+
+	// Inputs the lanes were built from, per eye: start, destin, values 1 and 2
+	EyeConfig _loaded[2][4] = {};
+	bool _isLoaded = false;
+};
+
+#endif
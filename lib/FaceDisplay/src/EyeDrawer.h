@@ -16,15 +16,26 @@ You should have received a copy of the GNU Affero General Public License along w
 #include <Arduino.h>
 #include <U8g2lib.h>
 #include "EyeConfig.h"
+#include "CornerTable.h"
 
 enum CornerType {T_R, T_L, B_L, B_R};
 
+// Inside corners of an eye (TL, TR, BL, BR) before slope or rounded corners are applied
+struct EyeLayout {
+  int32_t TLc_x, TLc_y;
+  int32_t TRc_x, TRc_y;
+  int32_t BLc_x, BLc_y;
+  int32_t BRc_x, BRc_y;
+};
+
 /**
  * Contains all functions to draw eye based on supplied (expression-based) config
  */
 class EyeDrawer {
   public:
-    static void Draw(U8G2_SSD1306_128X64_NONAME_F_HW_I2C *_u8g2, int16_t centerX, int16_t centerY, EyeConfig *config) {
+    // Corner geometry of an eye. Also clamps config's radii when they don't fit the height
+    static EyeLayout Layout(int16_t centerX, int16_t centerY, EyeConfig *config) {
+      EyeLayout l;
       // Amount by which corners will be shifted up/down based on requested "slope"
       int32_t delta_y_top = config->Height * config->Slope_Top / 2.0;
       int32_t delta_y_bottom = config->Height * config->Slope_Bottom / 2.0;
@@ -39,14 +50,21 @@ class EyeDrawer {
       }
 
       // Calculate _inside_ corners of eye (TL, TR, BL, and BR) before any slope or rounded corners are applied
-      int32_t TLc_y = centerY + config->OffsetY - config->Height/2 + config->Radius_Top - delta_y_top;
-      int32_t TLc_x = centerX + config->OffsetX - config->Width/2 + config->Radius_Top;
-      int32_t TRc_y = centerY + config->OffsetY - config->Height/2 + config->Radius_Top + delta_y_top;
-      int32_t TRc_x = centerX + config->OffsetX + config->Width/2 - config->Radius_Top;
-      int32_t BLc_y = centerY + config->OffsetY + config->Height/2 - config->Radius_Bottom - delta_y_bottom;
-      int32_t BLc_x = centerX + config->OffsetX - config->Width/2 + config->Radius_Bottom;
-      int32_t BRc_y = centerY + config->OffsetY + config->Height/2 - config->Radius_Bottom + delta_y_bottom;
-      int32_t BRc_x = centerX + config->OffsetX + config->Width/2 - config->Radius_Bottom;
+      l.TLc_y = centerY + config->OffsetY - config->Height/2 + config->Radius_Top - delta_y_top;
+      l.TLc_x = centerX + config->OffsetX - config->Width/2 + config->Radius_Top;
+      l.TRc_y = centerY + config->OffsetY - config->Height/2 + config->Radius_Top + delta_y_top;
+      l.TRc_x = centerX + config->OffsetX + config->Width/2 - config->Radius_Top;
+      l.BLc_y = centerY + config->OffsetY + config->Height/2 - config->Radius_Bottom - delta_y_bottom;
+      l.BLc_x = centerX + config->OffsetX - config->Width/2 + config->Radius_Bottom;
+      l.BRc_y = centerY + config->OffsetY + config->Height/2 - config->Radius_Bottom + delta_y_bottom;
+      l.BRc_x = centerX + config->OffsetX + config->Width/2 - config->Radius_Bottom;
+      return l;
+    }
+
+    static void Draw(U8G2 *_u8g2, int16_t centerX, int16_t centerY, EyeConfig *config) {
+      EyeLayout l = Layout(centerX, centerY, config);
+      int32_t TLc_y = l.TLc_y, TLc_x = l.TLc_x, TRc_y = l.TRc_y, TRc_x = l.TRc_x;
+      int32_t BLc_y = l.BLc_y, BLc_x = l.BLc_x, BRc_y = l.BRc_y, BRc_x = l.BRc_x;
         
       // Calculate interior extents
       int32_t min_c_x = min(TLc_x, BLc_x);
@@ -95,9 +113,28 @@ class EyeDrawer {
     }
 
     // Draw rounded corners
-    static void FillEllipseCorner(U8G2_SSD1306_128X64_NONAME_F_HW_I2C *_u8g2, CornerType corner, int16_t x0, int16_t y0, int32_t rx, int32_t ry, uint16_t color) {
+    static void FillEllipseCorner(U8G2 *_u8g2, CornerType corner, int16_t x0, int16_t y0, int32_t rx, int32_t ry, uint16_t color) {
       if (rx < 2) return;
       if (ry < 2) return;
+
+      // Circular corners come from the precomputed table
+      const CornerSpan* spans = rx == ry ? CornerTable::Spans(rx) : nullptr;
+      if (spans) {
+        for (int32_t dy = 0; dy <= ry; dy++) {
+          int32_t w = max(spans[dy].First, spans[dy].Second);
+          switch (corner) {
+            case T_R: _u8g2->drawHLine(x0, y0 - dy, w); break;
+            case T_L: _u8g2->drawHLine(x0 - w, y0 - dy, w); break;
+            case B_R: _u8g2->drawHLine(x0, y0 + dy - 1, w); break;
+            case B_L:
+              _u8g2->drawHLine(x0 - spans[dy].First, y0 + dy - 1, spans[dy].First);
+              _u8g2->drawHLine(x0 - spans[dy].Second, y0 + dy, spans[dy].Second);
+              break;
+          }
+        }
+        return;
+      }
+
       int32_t x, y;
       int32_t rx2 = rx * rx;
       int32_t ry2 = ry * ry;
@@ -183,7 +220,7 @@ class EyeDrawer {
     }
 
     // Fill a solid rectangle between specified coordinates
-    static void FillRectangle(U8G2_SSD1306_128X64_NONAME_F_HW_I2C *_u8g2, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t color) {
+    static void FillRectangle(U8G2 *_u8g2, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t color) {
       // Always draw from TL->BR
       int32_t l = min(x0, x1);
       int32_t r = max(x0, x1);
@@ -196,13 +233,13 @@ class EyeDrawer {
       _u8g2->setDrawColor(1);
     }
 
-    static void FillRectangularTriangle(U8G2_SSD1306_128X64_NONAME_F_HW_I2C *_u8g2, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t color) {
+    static void FillRectangularTriangle(U8G2 *_u8g2, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t color) {
       _u8g2->setDrawColor(color);
       _u8g2->drawTriangle(x0, y0, x1, y1, x1, y0);
       _u8g2->setDrawColor(1);
     }
 
-    static void FillTriangle(U8G2_SSD1306_128X64_NONAME_F_HW_I2C *_u8g2, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t color) {
+    static void FillTriangle(U8G2 *_u8g2, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t color) {
         _u8g2->setDrawColor(color);
         _u8g2->drawTriangle(x0, y0, x1, y1, x2, y2);
         _u8g2->setDrawColor(1);
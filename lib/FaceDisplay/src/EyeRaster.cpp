@@ -0,0 +1,319 @@
+#include "EyeRaster.h"
+#include "EyeDrawer.h"
+#include "CornerTable.h"
+
+namespace {
+
+// Row-major scratch canvas, bit x of Rows[y] is pixel (x, y). Only the
+// rows and columns inside the dirty bounds are non-zero between draws
+struct RowCanvas {
+	uint64_t Rows[EyeRaster::MaxHeight][2];
+	int16_t Width;
+	int16_t Height;
+	int16_t RowLo, RowHi;  // dirty rows [RowLo, RowHi)
+	int16_t ColLo, ColHi;  // dirty columns [ColLo, ColHi)
+
+	void Begin(int16_t width, int16_t height) {
+		Width = width;
+		Height = height;
+		RowLo = height;
+		RowHi = 0;
+		ColLo = width;
+		ColHi = 0;
+	}
+
+	static uint64_t WordMask(int32_t x0, int32_t x1, int32_t base) {
+		if (x0 < base) x0 = base;
+		if (x1 > base + 64) x1 = base + 64;
+		if (x0 >= x1) return 0;
+		uint32_t n = x1 - x0;
+		uint64_t bits = n == 64 ? ~0ULL : (1ULL << n) - 1;
+		return bits << (x0 - base);
+	}
+
+	// Pixels [x0, x1) of row y, clipped like u8g2_DrawHVLine
+	void Set(int32_t y, int32_t x0, int32_t x1) {
+		if (y < 0 || y >= Height) return;
+		if (x0 < 0) x0 = 0;
+		if (x1 > Width) x1 = Width;
+		if (x0 >= x1) return;
+		Rows[y][0] |= WordMask(x0, x1, 0);
+		Rows[y][1] |= WordMask(x0, x1, 64);
+		if (y < RowLo) RowLo = y;
+		if (y >= RowHi) RowHi = y + 1;
+		if (x0 < ColLo) ColLo = x0;
+		if (x1 > ColHi) ColHi = x1;
+	}
+
+	void Clear(int32_t y, int32_t x0, int32_t x1) {
+		if (y < 0 || y >= Height) return;
+		Rows[y][0] &= ~WordMask(x0, x1, 0);
+		Rows[y][1] &= ~WordMask(x0, x1, 64);
+	}
+
+	void Span(bool color, int32_t y, int32_t x0, int32_t x1) {
+		if (color) Set(y, x0, x1);
+		else Clear(y, x0, x1);
+	}
+
+	// Same as EyeDrawer::FillRectangle
+	void Rectangle(int32_t x0, int32_t y0, int32_t x1, int32_t y1) {
+		int32_t l = min(x0, x1);
+		int32_t r = max(x0, x1);
+		int32_t t = max(min(y0, y1), (int32_t)0);
+		int32_t b = min(max(y0, y1), (int32_t)Height);
+		for (int32_t y = t; y < b; y++) Set(y, l, r);
+	}
+
+	// OR the dirty block into the page buffer and leave the canvas blank
+	void Flush(uint8_t *buffer) {
+		if (RowLo >= RowHi) return;
+		for (int16_t page = RowLo / 8; page * 8 < RowHi; page++) {
+			uint8_t *out = buffer + page * Width;
+			const uint64_t *rows = Rows[page * 8];
+			for (int16_t block = ColLo / 8; block * 8 < ColHi; block++) {
+				// 8x8 bit block: byte r = row r, bit c = column c
+				uint64_t m = 0;
+				for (int r = 0; r < 8; r++) {
+					uint64_t word = rows[r * 2 + (block >> 3)];
+					m |= ((word >> ((block & 7) * 8)) & 0xFF) << (r * 8);
+				}
+				if (!m) continue;
+				// Transpose so that byte c = column c, bit r = row r
+				uint64_t t;
+				t = (m ^ (m >> 7)) & 0x00AA00AA00AA00AAULL;
+				m = m ^ t ^ (t << 7);
+				t = (m ^ (m >> 14)) & 0x0000CCCC0000CCCCULL;
+				m = m ^ t ^ (t << 14);
+				t = (m ^ (m >> 28)) & 0x00000000F0F0F0F0ULL;
+				m = m ^ t ^ (t << 28);
+				for (int c = 0; c < 8; c++) {
+					out[block * 8 + c] |= (uint8_t)(m >> (c * 8));
+				}
+			}
+		}
+		for (int16_t y = RowLo; y < RowHi; y++) {
+			Rows[y][0] = 0;
+			Rows[y][1] = 0;
+		}
+		RowLo = Height;
+		RowHi = 0;
+	}
+};
+
+RowCanvas canvas;
+
+// Edge walker of u8g2_polygon.c, used by u8g2_DrawTriangle
+struct TriangleEdge {
+	int16_t XDirection, Height, XOffset, ErrorOffset;
+	int16_t Y, MaxY, X, Error;
+
+	void Init(int16_t x1, int16_t y1, int16_t x2, int16_t y2) {
+		int16_t dx = x2 - x1;
+		int16_t width;
+		Height = y2 - y1;
+		// A flat edge is only reached after the last scan line
+		if (Height == 0) Height = 1;
+		MaxY = y2;
+		Y = y1;
+		X = x1;
+		if (dx >= 0) {
+			XDirection = 1;
+			width = dx;
+			Error = 0;
+		} else {
+			XDirection = -1;
+			width = -dx;
+			Error = 1 - Height;
+		}
+		XOffset = dx / Height;
+		ErrorOffset = width % Height;
+	}
+
+	bool Next() {
+		if (Y >= MaxY) return false;
+		X += XOffset;
+		Error += ErrorOffset;
+		if (Error > 0) {
+			X += XDirection;
+			Error -= Height;
+		}
+		Y++;
+		return true;
+	}
+};
+
+// Same pixels as u8g2_DrawTriangle(x0, y0, x1, y1, x2, y2) in the given color
+void Triangle(bool color, int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2) {
+	const int16_t xs[3] = {x0, x1, x2};
+	const int16_t ys[3] = {y0, y1, y2};
+
+	int16_t minY = ys[0], maxY = ys[0];
+	uint8_t top = 0;
+	for (uint8_t i = 1; i < 3; i++) {
+		if (maxY < ys[i]) maxY = ys[i];
+		if (minY > ys[i]) {
+			top = i;
+			minY = ys[i];
+		}
+	}
+	int16_t lines = maxY - minY;
+	if (lines == 0) return;
+
+	// Left edge walks the points backwards, right edge forwards
+	uint8_t left = top, right = top;
+	for (;;) {
+		uint8_t i = right == 2 ? 0 : right + 1;
+		if (ys[i] != minY) break;
+		right = i;
+	}
+	for (;;) {
+		uint8_t i = left == 0 ? 2 : left - 1;
+		if (ys[i] != minY) break;
+		left = i;
+	}
+	bool pointed = xs[left] == xs[right];
+
+	TriangleEdge l, r;
+	auto initLeft = [&]() {
+		uint8_t next = left == 0 ? 2 : left - 1;
+		l.Init(xs[left], ys[left], xs[next], ys[next]);
+		left = next;
+	};
+	auto initRight = [&]() {
+		uint8_t next = right == 2 ? 0 : right + 1;
+		r.Init(xs[right], ys[right], xs[next], ys[next]);
+		right = next;
+	};
+	initLeft();
+	initRight();
+	if (pointed) {
+		l.Next();
+		r.Next();
+	}
+
+	do {
+		int16_t a = l.X, b = r.X;
+		if (a < b) {
+			canvas.Span(color, r.Y, a, b);
+		} else {
+			canvas.Span(color, r.Y, b, a);
+		}
+		while (!l.Next()) initLeft();
+		while (!r.Next()) initRight();
+		lines--;
+	} while (lines > 0);
+}
+
+void FillRectangularTriangle(bool color, int32_t x0, int32_t y0, int32_t x1, int32_t y1) {
+	Triangle(color, x0, y0, x1, y1, x1, y0);
+}
+
+// One drawHLine of EyeDrawer::FillEllipseCorner
+inline void CornerLine(CornerType corner, int16_t x0, int16_t y0, int32_t x, int32_t y, bool second) {
+	switch (corner) {
+	case T_R: canvas.Set(y0 - y, x0, x0 + x); break;
+	case T_L: canvas.Set(y0 - y, x0 - x, x0); break;
+	case B_R: canvas.Set(y0 + y - 1, x0, x0 + x); break;
+	case B_L: canvas.Set(second ? y0 + y : y0 + y - 1, x0 - x, x0); break;
+	}
+}
+
+// Midpoint quarter ellipse of EyeDrawer::FillEllipseCorner, for radii
+// beyond CornerTable
+void CornerMidpoint(CornerType corner, int16_t x0, int16_t y0, int32_t rx, int32_t ry) {
+	if (rx < 2) return;
+	if (ry < 2) return;
+	int32_t x, y;
+	int32_t rx2 = rx * rx;
+	int32_t ry2 = ry * ry;
+	int32_t fx2 = 4 * rx2;
+	int32_t fy2 = 4 * ry2;
+	int32_t s;
+
+	for (x = 0, y = ry, s = 2 * ry2 + rx2 * (1 - 2 * ry); ry2 * x <= rx2 * y; x++) {
+		CornerLine(corner, x0, y0, x, y, false);
+		if (s >= 0) {
+			s += fx2 * (1 - y);
+			y--;
+		}
+		s += ry2 * ((4 * x) + 6);
+	}
+	for (x = rx, y = 0, s = 2 * rx2 + ry2 * (1 - 2 * rx); rx2 * y <= ry2 * x; y++) {
+		CornerLine(corner, x0, y0, x, y, true);
+		if (s >= 0) {
+			s += fy2 * (1 - x);
+			x--;
+		}
+		s += rx2 * ((4 * y) + 6);
+	}
+}
+
+// Quarter circle of radius r from the CornerTable spans
+void Corner(CornerType corner, int16_t x0, int16_t y0, int32_t r) {
+	const CornerSpan* spans = CornerTable::Spans(r);
+	if (!spans) {
+		CornerMidpoint(corner, x0, y0, r, r);
+		return;
+	}
+	for (int32_t dy = 0; dy <= r; dy++) {
+		int32_t w = max(spans[dy].First, spans[dy].Second);
+		switch (corner) {
+		case T_R: canvas.Set(y0 - dy, x0, x0 + w); break;
+		case T_L: canvas.Set(y0 - dy, x0 - w, x0); break;
+		case B_R: canvas.Set(y0 + dy - 1, x0, x0 + w); break;
+		case B_L:
+			canvas.Set(y0 + dy - 1, x0 - spans[dy].First, x0);
+			canvas.Set(y0 + dy, x0 - spans[dy].Second, x0);
+			break;
+		}
+	}
+}
+
+}  // namespace
+
+bool EyeRaster::Draw(uint8_t *buffer, int16_t width, int16_t height, int16_t centerX, int16_t centerY, EyeConfig *config) {
+	if (!buffer || width > MaxWidth || height > MaxHeight) return false;
+
+	EyeLayout l = EyeDrawer::Layout(centerX, centerY, config);
+	const int32_t rt = config->Radius_Top;
+	const int32_t rb = config->Radius_Bottom;
+
+	canvas.Begin(width, height);
+
+	// Centre, then outwards to meet the edges of the rounded corners
+	canvas.Rectangle(min(l.TLc_x, l.BLc_x), min(l.TLc_y, l.TRc_y), max(l.TRc_x, l.BRc_x), max(l.BLc_y, l.BRc_y));
+	canvas.Rectangle(l.TRc_x, l.TRc_y, l.BRc_x + rb, l.BRc_y);
+	canvas.Rectangle(l.TLc_x - rt, l.TLc_y, l.BLc_x, l.BLc_y);
+	canvas.Rectangle(l.TLc_x, l.TLc_y - rt, l.TRc_x, l.TRc_y);
+	canvas.Rectangle(l.BLc_x, l.BLc_y, l.BRc_x, l.BRc_y + rb);
+
+	// Slanted edges at top and bottom
+	if (config->Slope_Top > 0) {
+		FillRectangularTriangle(false, l.TLc_x, l.TLc_y - rt, l.TRc_x, l.TRc_y - rt);
+		FillRectangularTriangle(true, l.TRc_x, l.TRc_y - rt, l.TLc_x, l.TLc_y - rt);
+	} else if (config->Slope_Top < 0) {
+		FillRectangularTriangle(false, l.TRc_x, l.TRc_y - rt, l.TLc_x, l.TLc_y - rt);
+		FillRectangularTriangle(true, l.TLc_x, l.TLc_y - rt, l.TRc_x, l.TRc_y - rt);
+	}
+	if (config->Slope_Bottom > 0) {
+		FillRectangularTriangle(false, l.BRc_x + rb, l.BRc_y + rb, l.BLc_x - rb, l.BLc_y + rb);
+		FillRectangularTriangle(true, l.BLc_x - rb, l.BLc_y + rb, l.BRc_x + rb, l.BRc_y + rb);
+	} else if (config->Slope_Bottom < 0) {
+		FillRectangularTriangle(false, l.BLc_x - rb, l.BLc_y + rb, l.BRc_x + rb, l.BRc_y + rb);
+		FillRectangularTriangle(true, l.BRc_x + rb, l.BRc_y + rb, l.BLc_x - rb, l.BLc_y + rb);
+	}
+
+	// Rounded corners
+	if (rt > 0) {
+		Corner(T_L, l.TLc_x, l.TLc_y, rt);
+		Corner(T_R, l.TRc_x, l.TRc_y, rt);
+	}
+	if (rb > 0) {
+		Corner(B_L, l.BLc_x, l.BLc_y, rb);
+		Corner(B_R, l.BRc_x, l.BRc_y, rb);
+	}
+
+	canvas.Flush(buffer);
+	return true;
+}
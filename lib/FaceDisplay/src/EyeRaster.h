@@ -0,0 +1,29 @@
+#ifndef _EYERASTER_h
+#define _EYERASTER_h
+
+#include <Arduino.h>
+#include "EyeConfig.h"
+
+/**
+ * Span rasterizer for the eye shape of EyeDrawer::Draw.
+ *
+ * The same primitives (five rectangles, the slope triangles and the four
+ * rounded corners) are applied in the same order and with U8g2's fill
+ * rules, but each one only produces one span per row on a row-major 1bpp
+ * scratch canvas, where a span is a couple of word operations instead of
+ * a pixel loop. The finished rows are transposed 8x8 bits at a time into
+ * the vertical-byte pages of the SSD1306 frame buffer and ORed in, so each
+ * buffer byte under the eye is written once.
+ */
+class EyeRaster {
+public:
+	static const int16_t MaxWidth = 128;
+	static const int16_t MaxHeight = 64;
+
+	// buffer is a U8g2 full frame buffer of width x height pixels, one byte
+	// per column and 8 rows per page. Returns false without drawing when the
+	// panel is larger than MaxWidth x MaxHeight
+	static bool Draw(uint8_t *buffer, int16_t width, int16_t height, int16_t centerX, int16_t centerY, EyeConfig *config);
+};
+
+#endif
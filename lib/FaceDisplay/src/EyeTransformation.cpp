@@ -13,19 +13,22 @@ You should have received a copy of the GNU Affero General Public License along w
 #include "EyeTransformation.h"
 
 
-EyeTransformation::EyeTransformation() : Animation(200)
+EyeTransformation::EyeTransformation() : Output(), Animation(200)
 {
 }
 
 void EyeTransformation::Update()
 {
-	auto t = Animation.GetValue();
+	Interpolate(Animation.GetValue());
+	Apply();
+}
+
+void EyeTransformation::Interpolate(float t)
+{
 	Current.MoveX = (Destin.MoveX - Origin.MoveX) * t + Origin.MoveX;
 	Current.MoveY = (Destin.MoveY - Origin.MoveY) * t + Origin.MoveY;
 	Current.ScaleX = (Destin.ScaleX - Origin.ScaleX) * t + Origin.ScaleX;
 	Current.ScaleY = (Destin.ScaleY - Origin.ScaleY) * t + Origin.ScaleY;
-
-	Apply();
 }
 
 void EyeTransformation::Apply()
@@ -47,6 +50,8 @@ void EyeTransformation::Apply()
 
 void EyeTransformation::SetDestin(Transformation transformation)
 {
+	Interpolate(Animation.GetValue());
+
 	Origin.MoveX =  Current.MoveX;
 	Origin.MoveY =  Current.MoveY;
 	Origin.ScaleX = Current.ScaleX;
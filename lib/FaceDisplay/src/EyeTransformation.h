@@ -40,7 +40,10 @@ public:
 	RampAnimation Animation;
 
 	void Update();
+	// Current at progress t between Origin and Destin
+	void Interpolate(float t);
 	void Apply();
+	// Starts from Current at the frame time, not at the last Update()
 	void SetDestin(Transformation transformation);
 };
 
@@ -12,24 +12,32 @@ You should have received a copy of the GNU Affero General Public License along w
 
 #include "EyeTransition.h"
 
-EyeTransition::EyeTransition() : Animation(500){}
+EyeTransition::EyeTransition() : Start(), Destin(), Animation(500) {}
+
+void EyeTransition::Begin() {
+	Start = *Origin;
+	Animation.Restart();
+}
+
+float EyeTransition::Progress() {
+	return Ease(Easing, Animation.GetValue());
+}
 
 void EyeTransition::Update() {
-	float t = Animation.GetValue();
-	Apply(t);
+	Apply(Progress());
 }
 
 void EyeTransition::Apply(float t) {
-	Origin->OffsetX = Origin->OffsetX * (1.0 - t) + Destin.OffsetX * t;
-	Origin->OffsetY = Origin->OffsetY * (1.0 - t) + Destin.OffsetY * t;
-	Origin->Height = Origin->Height * (1.0 - t) + Destin.Height * t;
-	Origin->Width = Origin->Width * (1.0 - t) + Destin.Width * t;
-	Origin->Slope_Top = Origin->Slope_Top * (1.0 - t) + Destin.Slope_Top * t;
-	Origin->Slope_Bottom = Origin->Slope_Bottom * (1.0 - t) + Destin.Slope_Bottom * t;
-	Origin->Radius_Top = Origin->Radius_Top * (1.0 - t) + Destin.Radius_Top * t;
-	Origin->Radius_Bottom = Origin->Radius_Bottom * (1.0 - t) + Destin.Radius_Bottom * t;
-	Origin->Inverse_Radius_Top = Origin->Inverse_Radius_Top * (1.0 - t) + Destin.Inverse_Radius_Top * t;
-	Origin->Inverse_Radius_Bottom = Origin->Inverse_Radius_Bottom * (1.0 - t) + Destin.Inverse_Radius_Bottom * t;
-	Origin->Inverse_Offset_Top = Origin->Inverse_Offset_Top * (1.0 - t) + Destin.Inverse_Offset_Top * t;
-	Origin->Inverse_Offset_Bottom = Origin->Inverse_Offset_Bottom * (1.0 - t) + Destin.Inverse_Offset_Bottom * t;
-}
\ No newline at end of file
+	Origin->OffsetX = Start.OffsetX + (Destin.OffsetX - Start.OffsetX) * t;
+	Origin->OffsetY = Start.OffsetY + (Destin.OffsetY - Start.OffsetY) * t;
+	Origin->Height = Start.Height + (Destin.Height - Start.Height) * t;
+	Origin->Width = Start.Width + (Destin.Width - Start.Width) * t;
+	Origin->Slope_Top = Start.Slope_Top + (Destin.Slope_Top - Start.Slope_Top) * t;
+	Origin->Slope_Bottom = Start.Slope_Bottom + (Destin.Slope_Bottom - Start.Slope_Bottom) * t;
+	Origin->Radius_Top = Start.Radius_Top + (Destin.Radius_Top - Start.Radius_Top) * t;
+	Origin->Radius_Bottom = Start.Radius_Bottom + (Destin.Radius_Bottom - Start.Radius_Bottom) * t;
+	Origin->Inverse_Radius_Top = Start.Inverse_Radius_Top + (Destin.Inverse_Radius_Top - Start.Inverse_Radius_Top) * t;
+	Origin->Inverse_Radius_Bottom = Start.Inverse_Radius_Bottom + (Destin.Inverse_Radius_Bottom - Start.Inverse_Radius_Bottom) * t;
+	Origin->Inverse_Offset_Top = Start.Inverse_Offset_Top + (Destin.Inverse_Offset_Top - Start.Inverse_Offset_Top) * t;
+	Origin->Inverse_Offset_Bottom = Start.Inverse_Offset_Bottom + (Destin.Inverse_Offset_Bottom - Start.Inverse_Offset_Bottom) * t;
+}
@@ -16,16 +16,27 @@ You should have received a copy of the GNU Affero General Public License along w
 #include <Arduino.h>
 #include "Animations.h"
 #include "EyeConfig.h"
+#include "Easing.h"
 
+// Eases *Origin from the config it had at Begin() to Destin. The value is
+// a closed-form function of the time elapsed since Begin(), so the face
+// looks the same at any frame rate and frames can be skipped.
 class EyeTransition {
 public:
 	EyeTransition();
 
 	EyeConfig* Origin;
+	EyeConfig Start;
 	EyeConfig Destin;
 
 	RampAnimation Animation;
+	eEasing Easing = EaseOutCubic;
 
+	// Snapshot *Origin as the start point and restart the animation.
+	// Call Update() first when *Origin may be behind the frame time
+	void Begin();
+	// Eased progress at the current frame time
+	float Progress();
 	void Update();
 	void Apply(float t);
 };
@@ -12,7 +12,7 @@ You should have received a copy of the GNU Affero General Public License along w
 
 #include "EyeVariation.h"
 
-EyeVariation::EyeVariation() : Animation(0, 1000, 0, 1000, 0){}
+EyeVariation::EyeVariation() : Output(), Animation(0, 1000, 0, 1000, 0), Values() {}
 
 void EyeVariation::Clear() {
 	Values.OffsetX = 0;
@@ -13,8 +13,8 @@ You should have received a copy of the GNU Affero General Public License along w
 
 #include "Face.h"
 
-Face::Face(U8G2_SSD1306_128X64_NONAME_F_HW_I2C *_u8g2, uint16_t screenWidth, uint16_t screenHeight, uint16_t eyeSize) 
-	: _u8g2(_u8g2), LeftEye(*this), RightEye(*this), Blink(*this), Look(*this), Behavior(*this), Expression(*this) {
+Face::Face(DisplayBackend *display, uint16_t screenWidth, uint16_t screenHeight, uint16_t eyeSize) 
+	: _display(display), LeftEye(*this), RightEye(*this), Blink(*this), Look(*this), Behavior(*this), Expression(*this) {
 	Width = screenWidth;
 	Height = screenHeight;
 	EyeSize = eyeSize;
@@ -49,11 +49,12 @@ void Face::LookBottom() {
 }
 
 void Face::Wait(unsigned long milliseconds) {
-	unsigned long start;
-	start = millis();
-	while (millis() - start < milliseconds) {
-		Draw(_u8g2);
+	unsigned long start = FrameClock::Read();
+	while (FrameClock::BeginFrame() - start < milliseconds) {
+		Draw(_display ? &_display->gfx() : nullptr);
+		FrameClock::EndFrame();
 	}
+	FrameClock::EndFrame();
 }
 
 void Face::DoBlink() {
@@ -61,23 +62,31 @@ void Face::DoBlink() {
 }
 
 void Face::Update() {
+	// One time sample for every timer and animation in this frame
+	FrameClock::BeginFrame();
 	if(RandomBehavior) Behavior.Update();
 	if(RandomLook) Look.Update();
 	if(RandomBlink)	Blink.Update();
-	Draw(_u8g2);
+	Draw(_display ? &_display->gfx() : nullptr);
+	FrameClock::EndFrame();
 }
 
-void Face::Draw(U8G2_SSD1306_128X64_NONAME_F_HW_I2C *_u8g2) {
+void Face::Draw(U8G2 *_u8g2) {
 	if (!_u8g2) return;
 	
-	// Draw left eye
 	LeftEye.CenterX = CenterX - EyeSize / 2 - EyeInterDistance;
 	LeftEye.CenterY = CenterY;
-	LeftEye.Draw(_u8g2);
-	// Draw right eye
 	RightEye.CenterX = CenterX + EyeSize / 2 + EyeInterDistance;
 	RightEye.CenterY = CenterY;
-	RightEye.Draw(_u8g2);
+
+	if (FusedChain) {
+		Chain.Update(LeftEye, RightEye);
+	} else {
+		LeftEye.Update();
+		RightEye.Update();
+	}
+	LeftEye.Render(_u8g2);
+	RightEye.Render(_u8g2);
 	// Transfer the redrawn buffer to the display
-	_u8g2->sendBuffer();
+	if (AutoFlush) _display->flush();
 }
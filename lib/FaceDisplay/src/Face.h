@@ -15,6 +15,7 @@ You should have received a copy of the GNU Affero General Public License along w
 
 #include <Arduino.h>
 #include <U8g2lib.h>
+#include <DisplayBackend.h>
 #include "Animations.h"
 #include "EyePresets.h"
 #include "EyeConfig.h"
@@ -23,11 +24,12 @@ You should have received a copy of the GNU Affero General Public License along w
 #include "LookAssistant.h"
 #include "BlinkAssistant.h"
 #include "Eye.h"
+#include "EyeChain.h"
 
 class Face {
 
 public:
-    Face(U8G2_SSD1306_128X64_NONAME_F_HW_I2C *_u8g2, uint16_t screenWidth, uint16_t screenHeight, uint16_t eyeSize);
+    Face(DisplayBackend *display, uint16_t screenWidth, uint16_t screenHeight, uint16_t eyeSize);
 
     uint16_t Width;
     uint16_t Height;
@@ -42,6 +44,7 @@ public:
     LookAssistant Look;
     FaceBehavior Behavior;
     FaceExpression Expression;
+    EyeChain Chain;
 
     void Update();
     void DoBlink();
@@ -49,6 +52,12 @@ public:
     bool RandomBehavior = true;
     bool RandomLook = true;
     bool RandomBlink = true;
+    // Evaluate both eyes with Chain instead of Eye::Update
+    bool FusedChain = true;
+    // Draw eyes with EyeRaster instead of U8g2 primitives (EyeDrawer)
+    bool SpanRaster = true;
+    // Flush the display after each drawn frame, off when the caller flushes
+    bool AutoFlush = true;
 
     void LookLeft();
     void LookRight();
@@ -58,10 +67,10 @@ public:
     void Wait(unsigned long milliseconds);
 
 private:
-    U8G2_SSD1306_128X64_NONAME_F_HW_I2C *_u8g2;
+    DisplayBackend *_display;
 
 protected:
-    void Draw(U8G2_SSD1306_128X64_NONAME_F_HW_I2C *_u8g2);
+    void Draw(U8G2 *_u8g2);
 };
 
 #endif
\ No newline at end of file
@@ -14,7 +14,7 @@ You should have received a copy of the GNU Affero General Public License along w
 #include "FaceBehavior.h"
 #include "FaceEmotions.hpp"
 
-FaceBehavior::FaceBehavior(Face& face) : _face(face), Timer(500) {
+FaceBehavior::FaceBehavior(Face& face) : _face(face), CurrentEmotion(eEmotions::Normal), Timer(500) {
 	Timer.Start();
 	Clear();
 	Emotions[(int)eEmotions::Normal] = 1.0;
@@ -78,26 +78,6 @@ void FaceBehavior::GoToEmotion(eEmotions emotion) {
   // Set the currentEmotion to the desired emotion
 	CurrentEmotion = emotion;
 
-  // Call the appropriate expression transition function 
-	switch (CurrentEmotion) {
-    case eEmotions::Normal: _face.Expression.GoTo_Normal(); break;
-    case eEmotions::Angry: _face.Expression.GoTo_Angry(); break;
-    case eEmotions::Glee: _face.Expression.GoTo_Glee(); break;
-    case eEmotions::Happy: _face.Expression.GoTo_Happy(); break;
-    case eEmotions::Sad: _face.Expression.GoTo_Sad(); break;
-    case eEmotions::Worried: _face.Expression.GoTo_Worried(); break;
-    case eEmotions::Focused: _face.Expression.GoTo_Focused(); break;
-    case eEmotions::Annoyed: _face.Expression.GoTo_Annoyed(); break;
-    case eEmotions::Surprised: _face.Expression.GoTo_Surprised(); break;
-    case eEmotions::Skeptic: _face.Expression.GoTo_Skeptic(); break;
-    case eEmotions::Frustrated: _face.Expression.GoTo_Frustrated(); break;
-    case eEmotions::Unimpressed: _face.Expression.GoTo_Unimpressed(); break;
-    case eEmotions::Sleepy: _face.Expression.GoTo_Sleepy(); break;
-    case eEmotions::Suspicious: _face.Expression.GoTo_Suspicious(); break;
-    case eEmotions::Squint: _face.Expression.GoTo_Squint(); break;
-    case eEmotions::Furious: _face.Expression.GoTo_Furious(); break;
-    case eEmotions::Scared: _face.Expression.GoTo_Scared(); break;
-    case eEmotions::Awe: _face.Expression.GoTo_Awe(); break;
-    default: break;
-	}
+  // Apply the expression table entry for it
+	_face.Expression.GoTo(emotion);
 }
\ No newline at end of file
@@ -27,155 +27,61 @@ void FaceExpression::ClearVariations()
 	_face.LeftEye.Variation1.Animation.Restart();
 }
 
-void FaceExpression::GoTo_Normal()
-{
-	ClearVariations();
-
-	_face.RightEye.Variation1.Values.Height = 3;
-	_face.RightEye.Variation2.Values.Width = 1;
-	_face.LeftEye.Variation1.Values.Height = 2;
-	_face.LeftEye.Variation2.Values.Width = 2;
-	_face.RightEye.Variation1.Animation.SetTriangle(1000, 0);
-	_face.LeftEye.Variation1.Animation.SetTriangle(1000, 0);
-
-	_face.RightEye.TransitionTo(Preset_Normal);
-	_face.LeftEye.TransitionTo(Preset_Normal);
-
-}
-
-void FaceExpression::GoTo_Angry()
-{
-	ClearVariations();
-	_face.RightEye.Variation1.Values.OffsetY = 2;
-	_face.LeftEye.Variation1.Values.OffsetY = 2;
-	_face.RightEye.Variation1.Animation.SetTriangle(300, 0);
-	_face.LeftEye.Variation1.Animation.SetTriangle(300, 0);
-
-	_face.RightEye.TransitionTo(Preset_Angry);
-	_face.LeftEye.TransitionTo(Preset_Angry);
-}
-
-void FaceExpression::GoTo_Glee()
-{
-	ClearVariations();
-	_face.RightEye.Variation1.Values.OffsetY = 5;
-	_face.LeftEye.Variation1.Values.OffsetY = 5;
-	_face.RightEye.Variation1.Animation.SetTriangle(300, 0);
-	_face.LeftEye.Variation1.Animation.SetTriangle(300, 0);
-
-	_face.RightEye.TransitionTo(Preset_Glee);
-	_face.LeftEye.TransitionTo(Preset_Glee);
-}
-
-void FaceExpression::GoTo_Happy()
-{
-	ClearVariations();
-	_face.RightEye.TransitionTo(Preset_Happy);
-	_face.LeftEye.TransitionTo(Preset_Happy);
-}
-
-void FaceExpression::GoTo_Sad()
-{
-	ClearVariations();
-	_face.RightEye.TransitionTo(Preset_Sad);
-	_face.LeftEye.TransitionTo(Preset_Sad);
-}
-
-void FaceExpression::GoTo_Worried()
-{
-	ClearVariations();
-	_face.RightEye.TransitionTo(Preset_Worried);
-	_face.LeftEye.TransitionTo(Preset_Worried_Alt);
-}
-
-void FaceExpression::GoTo_Focused()
-{
-	ClearVariations();
-	_face.RightEye.TransitionTo(Preset_Focused);
-	_face.LeftEye.TransitionTo(Preset_Focused);
-}
-
-void FaceExpression::GoTo_Annoyed()
-{
-	ClearVariations();
-	_face.RightEye.TransitionTo(Preset_Annoyed);
-	_face.LeftEye.TransitionTo(Preset_Annoyed_Alt);
-}
-
-void FaceExpression::GoTo_Surprised()
-{
-	ClearVariations();
-	_face.RightEye.TransitionTo(Preset_Surprised);
-	_face.LeftEye.TransitionTo(Preset_Surprised);
-}
-
-void FaceExpression::GoTo_Skeptic()
-{
-	ClearVariations();
-	_face.RightEye.TransitionTo(Preset_Skeptic);
-	_face.LeftEye.TransitionTo(Preset_Skeptic_Alt);
-}
-
-void FaceExpression::GoTo_Frustrated()
-{
-	ClearVariations();
-	_face.RightEye.TransitionTo(Preset_Frustrated);
-	_face.LeftEye.TransitionTo(Preset_Frustrated);
-}
-
-void FaceExpression::GoTo_Unimpressed()
-{
-	ClearVariations();
-	_face.RightEye.TransitionTo(Preset_Unimpressed);
-	_face.LeftEye.TransitionTo(Preset_Unimpressed_Alt);
-}
-
-void FaceExpression::GoTo_Sleepy()
-{
-	ClearVariations();
-	_face.RightEye.TransitionTo(Preset_Sleepy);
-	_face.LeftEye.TransitionTo(Preset_Sleepy_Alt);
-}
-
-void FaceExpression::GoTo_Suspicious()
-{
-	ClearVariations();
-	_face.RightEye.TransitionTo(Preset_Suspicious);
-	_face.LeftEye.TransitionTo(Preset_Suspicious_Alt);
-}
-
-void FaceExpression::GoTo_Squint()
-{
-	ClearVariations();
-
-	_face.LeftEye.Variation1.Values.OffsetX = 6;
-	_face.LeftEye.Variation2.Values.OffsetY = 6;
-
-	_face.RightEye.TransitionTo(Preset_Squint);
-	_face.LeftEye.TransitionTo(Preset_Squint_Alt);
-
-}
-
-void FaceExpression::GoTo_Furious()
-{
-	ClearVariations();
-
-	_face.RightEye.TransitionTo(Preset_Furious);
-	_face.LeftEye.TransitionTo(Preset_Furious);
-}
-
-void FaceExpression::GoTo_Scared()
-{
-	ClearVariations();
-
-	_face.RightEye.TransitionTo(Preset_Scared);
-	_face.LeftEye.TransitionTo(Preset_Scared);
-}
-
-void FaceExpression::GoTo_Awe()
-{
-	ClearVariations();
-
-	_face.RightEye.TransitionTo(Preset_Awe);
-	_face.LeftEye.TransitionTo(Preset_Awe);
+// Rows in eEmotions order. To add an emotion: enum value, preset(s) in
+// EyePresets.h and one row here.
+//   { right preset, left preset, right var1, right var2, left var1, left var2, var1 triangle ms }
+//   variations: { OffsetX, OffsetY, Height, Width }
+static constexpr ExpressionEntry Expressions[] = {
+	/* Normal      */ { &Preset_Normal,      nullptr,                 {0, 0, 3, 0}, {0, 0, 0, 1}, {0, 0, 2, 0}, {0, 0, 0, 2}, 1000 },
+	/* Angry       */ { &Preset_Angry,       nullptr,                 {0, 2, 0, 0}, {0, 0, 0, 0}, {0, 2, 0, 0}, {0, 0, 0, 0}, 300 },
+	/* Glee        */ { &Preset_Glee,        nullptr,                 {0, 5, 0, 0}, {0, 0, 0, 0}, {0, 5, 0, 0}, {0, 0, 0, 0}, 300 },
+	/* Happy       */ { &Preset_Happy,       nullptr,                 {0, 0, 0, 0}, {0, 0, 0, 0}, {0, 0, 0, 0}, {0, 0, 0, 0}, 0 },
+	/* Sad         */ { &Preset_Sad,         nullptr,                 {0, 0, 0, 0}, {0, 0, 0, 0}, {0, 0, 0, 0}, {0, 0, 0, 0}, 0 },
+	/* Worried     */ { &Preset_Worried,     &Preset_Worried_Alt,     {0, 0, 0, 0}, {0, 0, 0, 0}, {0, 0, 0, 0}, {0, 0, 0, 0}, 0 },
+	/* Focused     */ { &Preset_Focused,     nullptr,                 {0, 0, 0, 0}, {0, 0, 0, 0}, {0, 0, 0, 0}, {0, 0, 0, 0}, 0 },
+	/* Annoyed     */ { &Preset_Annoyed,     &Preset_Annoyed_Alt,     {0, 0, 0, 0}, {0, 0, 0, 0}, {0, 0, 0, 0}, {0, 0, 0, 0}, 0 },
+	/* Surprised   */ { &Preset_Surprised,   nullptr,                 {0, 0, 0, 0}, {0, 0, 0, 0}, {0, 0, 0, 0}, {0, 0, 0, 0}, 0 },
+	/* Skeptic     */ { &Preset_Skeptic,     &Preset_Skeptic_Alt,     {0, 0, 0, 0}, {0, 0, 0, 0}, {0, 0, 0, 0}, {0, 0, 0, 0}, 0 },
+	/* Frustrated  */ { &Preset_Frustrated,  nullptr,                 {0, 0, 0, 0}, {0, 0, 0, 0}, {0, 0, 0, 0}, {0, 0, 0, 0}, 0 },
+	/* Unimpressed */ { &Preset_Unimpressed, &Preset_Unimpressed_Alt, {0, 0, 0, 0}, {0, 0, 0, 0}, {0, 0, 0, 0}, {0, 0, 0, 0}, 0 },
+	/* Sleepy      */ { &Preset_Sleepy,      &Preset_Sleepy_Alt,      {0, 0, 0, 0}, {0, 0, 0, 0}, {0, 0, 0, 0}, {0, 0, 0, 0}, 0 },
+	/* Suspicious  */ { &Preset_Suspicious,  &Preset_Suspicious_Alt,  {0, 0, 0, 0}, {0, 0, 0, 0}, {0, 0, 0, 0}, {0, 0, 0, 0}, 0 },
+	/* Squint      */ { &Preset_Squint,      &Preset_Squint_Alt,      {0, 0, 0, 0}, {0, 0, 0, 0}, {6, 0, 0, 0}, {0, 6, 0, 0}, 0 },
+	/* Furious     */ { &Preset_Furious,     nullptr,                 {0, 0, 0, 0}, {0, 0, 0, 0}, {0, 0, 0, 0}, {0, 0, 0, 0}, 0 },
+	/* Scared      */ { &Preset_Scared,      nullptr,                 {0, 0, 0, 0}, {0, 0, 0, 0}, {0, 0, 0, 0}, {0, 0, 0, 0}, 0 },
+	/* Awe         */ { &Preset_Awe,         nullptr,                 {0, 0, 0, 0}, {0, 0, 0, 0}, {0, 0, 0, 0}, {0, 0, 0, 0}, 0 },
+};
+
+static_assert(sizeof(Expressions) / sizeof(Expressions[0]) == eEmotions::EMOTIONS_COUNT, "one expression row per emotion");
+
+static void ApplyVariation(EyeVariation& variation, const ExpressionVariation& values) {
+	variation.Values.OffsetX = values.OffsetX;
+	variation.Values.OffsetY = values.OffsetY;
+	variation.Values.Height = values.Height;
+	variation.Values.Width = values.Width;
+}
+
+const ExpressionEntry* FaceExpression::Entry(eEmotions emotion) {
+	if (emotion < 0 || emotion >= eEmotions::EMOTIONS_COUNT) return nullptr;
+	return &Expressions[emotion];
+}
+
+void FaceExpression::GoTo(eEmotions emotion)
+{
+	const ExpressionEntry* entry = Entry(emotion);
+	if (!entry) return;
+
+	ClearVariations();
+
+	ApplyVariation(_face.RightEye.Variation1, entry->Right1);
+	ApplyVariation(_face.RightEye.Variation2, entry->Right2);
+	ApplyVariation(_face.LeftEye.Variation1, entry->Left1);
+	ApplyVariation(_face.LeftEye.Variation2, entry->Left2);
+	if (entry->Variation1Triangle) {
+		_face.RightEye.Variation1.Animation.SetTriangle(entry->Variation1Triangle, 0);
+		_face.LeftEye.Variation1.Animation.SetTriangle(entry->Variation1Triangle, 0);
+	}
+
+	_face.RightEye.TransitionTo(*entry->Right);
+	_face.LeftEye.TransitionTo(entry->Left ? *entry->Left : *entry->Right);
 }
@@ -14,9 +14,28 @@ You should have received a copy of the GNU Affero General Public License along w
 #define _FACEEXPRESSION_h
 
 #include <Arduino.h>
+#include "EyeConfig.h"
+#include "FaceEmotions.hpp"
 
 class Face;
 
+// Per eye offsets for the two variation operators (see EyeVariation::Values)
+struct ExpressionVariation {
+  int8_t OffsetX;
+  int8_t OffsetY;
+  int8_t Height;
+  int8_t Width;
+};
+
+// One row of the expression table: what GoTo(emotion) applies
+struct ExpressionEntry {
+  const EyeConfig* Right;
+  const EyeConfig* Left;          // nullptr: same preset as the right eye, mirrored by Eye
+  ExpressionVariation Right1, Right2;
+  ExpressionVariation Left1, Left2;
+  uint16_t Variation1Triangle;    // Variation1 SetTriangle period in ms, 0 keeps the current one
+};
+
 class FaceExpression {
   protected:
     Face&  _face;
@@ -26,24 +45,28 @@ class FaceExpression {
 
     void ClearVariations();
 
-    void GoTo_Normal();
-    void GoTo_Angry();
-    void GoTo_Glee();
-    void GoTo_Happy();
-    void GoTo_Sad();
-    void GoTo_Worried();
-    void GoTo_Focused();
-    void GoTo_Annoyed();
-    void GoTo_Surprised();
-    void GoTo_Skeptic();
-    void GoTo_Frustrated();
-    void GoTo_Unimpressed();
-    void GoTo_Sleepy();
-    void GoTo_Suspicious();
-    void GoTo_Squint();
-    void GoTo_Furious();
-    void GoTo_Scared();
-    void GoTo_Awe();
+    // Apply the table entry for an emotion
+    void GoTo(eEmotions emotion);
+    static const ExpressionEntry* Entry(eEmotions emotion);
+
+    void GoTo_Normal() { GoTo(eEmotions::Normal); }
+    void GoTo_Angry() { GoTo(eEmotions::Angry); }
+    void GoTo_Glee() { GoTo(eEmotions::Glee); }
+    void GoTo_Happy() { GoTo(eEmotions::Happy); }
+    void GoTo_Sad() { GoTo(eEmotions::Sad); }
+    void GoTo_Worried() { GoTo(eEmotions::Worried); }
+    void GoTo_Focused() { GoTo(eEmotions::Focused); }
+    void GoTo_Annoyed() { GoTo(eEmotions::Annoyed); }
+    void GoTo_Surprised() { GoTo(eEmotions::Surprised); }
+    void GoTo_Skeptic() { GoTo(eEmotions::Skeptic); }
+    void GoTo_Frustrated() { GoTo(eEmotions::Frustrated); }
+    void GoTo_Unimpressed() { GoTo(eEmotions::Unimpressed); }
+    void GoTo_Sleepy() { GoTo(eEmotions::Sleepy); }
+    void GoTo_Suspicious() { GoTo(eEmotions::Suspicious); }
+    void GoTo_Squint() { GoTo(eEmotions::Squint); }
+    void GoTo_Furious() { GoTo(eEmotions::Furious); }
+    void GoTo_Scared() { GoTo(eEmotions::Scared); }
+    void GoTo_Awe() { GoTo(eEmotions::Awe); }
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,7 @@
+#include "FrameClock.h"
+
+FrameClock::Source FrameClock::_source = nullptr;
+unsigned long FrameClock::_frameTime = 0;
+unsigned long FrameClock::_virtualTime = 0;
+unsigned long FrameClock::_reads = 0;
+bool FrameClock::_inFrame = false;
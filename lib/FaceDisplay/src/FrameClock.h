@@ -0,0 +1,67 @@
+#ifndef _FRAMECLOCK_h
+#define _FRAMECLOCK_h
+
+#include <Arduino.h>
+
+// Shared time base for animations, timers and assistants.
+// Face::Update samples the source once (BeginFrame) and every Now() call
+// until EndFrame returns that same value, so both eyes see one timestamp.
+// Outside a frame Now() reads the source directly.
+// The source is millis() unless replaced, e.g. by the virtual clock for
+// deterministic replays on the host.
+class FrameClock {
+public:
+	typedef unsigned long (*Source)();
+
+	static unsigned long Now() {
+		return _inFrame ? _frameTime : Read();
+	}
+
+	static unsigned long BeginFrame() {
+		_frameTime = Read();
+		_inFrame = true;
+		return _frameTime;
+	}
+
+	static void EndFrame() {
+		_inFrame = false;
+	}
+
+	static unsigned long Read() {
+		_reads++;
+		return _source ? _source() : millis();
+	}
+
+	// nullptr restores millis()
+	static void SetSource(Source source) {
+		_source = source;
+	}
+
+	// Virtual clock: time only moves through Advance()
+	static void UseVirtual(unsigned long start = 0) {
+		_virtualTime = start;
+		_source = VirtualSource;
+	}
+
+	static void Advance(unsigned long milliseconds) {
+		_virtualTime += milliseconds;
+	}
+
+	// Number of source reads, for checking the one-read-per-frame budget
+	static unsigned long Reads() {
+		return _reads;
+	}
+
+private:
+	static Source _source;
+	static unsigned long _frameTime;
+	static unsigned long _virtualTime;
+	static unsigned long _reads;
+	static bool _inFrame;
+
+	static unsigned long VirtualSource() {
+		return _virtualTime;
+	}
+};
+
+#endif
@@ -0,0 +1,57 @@
+#include "I2SDmaBench.h"
+#include <esp_timer.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Settling time after start(): the first buffers have no history to time
+static const uint32_t WARMUP_MS = 100;
+
+esp_err_t i2sDmaBench(I2SDmaMicrophone& mic, uint32_t sampleRate, const I2SDmaGeometry& geometry,
+	uint16_t chunkSamples, uint32_t durationMs, I2SDmaBenchResult& result) {
+	memset(&result, 0, sizeof(result));
+	result.geometry = geometry;
+
+	int16_t* chunk = (int16_t*)malloc(chunkSamples * sizeof(int16_t));
+	if (!chunk) return ESP_ERR_NO_MEM;
+
+	mic.deinit();
+	esp_err_t err = mic.init(sampleRate, I2S_DATA_BIT_WIDTH_16BIT, I2S_SLOT_MODE_MONO, geometry);
+	if (err == ESP_OK) err = mic.start();
+	if (err != ESP_OK) {
+		free(chunk);
+		return err;
+	}
+
+	uint32_t chunkMs = chunkSamples * 1000 / sampleRate;
+	int64_t warmup = esp_timer_get_time() + WARMUP_MS * 1000;
+	while (esp_timer_get_time() < warmup) mic.readSamples(chunk, chunkSamples, chunkMs * 2);
+	mic.resetStats();
+
+	int64_t start = esp_timer_get_time();
+	int64_t end = start + (int64_t)durationMs * 1000;
+	uint64_t readUs = 0;
+	uint32_t reads = 0;
+	while (esp_timer_get_time() < end) {
+		int64_t before = esp_timer_get_time();
+		int n = mic.readSamples(chunk, chunkSamples, chunkMs * 2);
+		readUs += esp_timer_get_time() - before;
+		if (n < 0) {
+			err = ESP_FAIL;
+			break;
+		}
+		reads++;
+		if (n < chunkSamples) result.partialReads++;
+	}
+	uint32_t elapsedMs = (uint32_t)((esp_timer_get_time() - start) / 1000);
+
+	const I2SDmaStats& stats = mic.stats();
+	result.interruptsPerSec = elapsedMs ? (uint32_t)((uint64_t)stats.interrupts * 1000 / elapsedMs) : 0;
+	result.avgLatencyUs = stats.reads ? (uint32_t)(stats.sumLatencyUs / stats.reads) : 0;
+	result.maxLatencyUs = stats.maxLatencyUs;
+	result.avgReadUs = reads ? (uint32_t)(readUs / reads) : 0;
+	result.overflows = stats.overflows;
+
+	mic.deinit();
+	free(chunk);
+	return err;
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "I2SDmaMicrophone.h"
+
+/**
+ * Capture latency and interrupt rate of one DMA geometry on the real
+ * microphone: re-init with the geometry, read chunkSamples blocks for
+ * durationMs the way the ESP-SR fill callback does, deinit. The microphone
+ * must not be in use by anything else meanwhile.
+ */
+struct I2SDmaBenchResult {
+	I2SDmaGeometry geometry;
+	uint32_t interruptsPerSec;   // measured DMA completions
+	uint32_t avgLatencyUs;       // capture to return, oldest sample of each read
+	uint32_t maxLatencyUs;
+	uint32_t avgReadUs;          // time blocked in readSamples()
+	uint32_t overflows;
+	uint32_t partialReads;       // reads that returned less than a chunk
+};
+
+esp_err_t i2sDmaBench(I2SDmaMicrophone& mic, uint32_t sampleRate, const I2SDmaGeometry& geometry,
+	uint16_t chunkSamples, uint32_t durationMs, I2SDmaBenchResult& result);
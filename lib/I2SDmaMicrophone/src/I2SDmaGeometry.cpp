@@ -0,0 +1,37 @@
+#include "I2SDmaGeometry.h"
+
+I2SDmaGeometry i2sDmaGeometry(const I2SDmaTarget& target) {
+	uint32_t chunk = target.chunkSamples ? target.chunkSamples : 1;
+	uint32_t maxFrames = (uint32_t)target.sampleRate * target.latencyMs / 1000;
+	uint32_t maxBuffer = I2S_DMA_MAX_BUFFER_BYTES / (target.bytesPerFrame ? target.bytesPerFrame : 1);
+	if (maxFrames > maxBuffer) maxFrames = maxBuffer;
+	if (!maxFrames) maxFrames = 1;
+
+	// Largest divisor of the chunk within the limit; 1 always divides
+	uint32_t frames = 1;
+	for (uint32_t d = chunk < maxFrames ? chunk : maxFrames; d > 1; d--) {
+		if (chunk % d == 0) {
+			frames = d;
+			break;
+		}
+	}
+	// A chunk with no usable divisor (a prime, say) would mean one interrupt
+	// per sample: better a partial buffer per read
+	if (frames < maxFrames / 4) frames = maxFrames;
+
+	uint32_t ring = chunk + (uint32_t)target.sampleRate * target.headroomMs / 1000;
+	uint32_t desc = (ring + frames - 1) / frames + 1;  // + the buffer being filled
+	if (desc < 2) desc = 2;
+	if (desc > I2S_DMA_MAX_DESC) desc = I2S_DMA_MAX_DESC;
+
+	I2SDmaGeometry geometry = {(uint16_t)desc, (uint16_t)frames};
+	return geometry;
+}
+
+uint32_t i2sDmaBufferUs(const I2SDmaGeometry& geometry, uint32_t sampleRate) {
+	return sampleRate ? (uint32_t)((uint64_t)geometry.frameNum * 1000000 / sampleRate) : 0;
+}
+
+uint32_t i2sDmaInterruptsPerSec(const I2SDmaGeometry& geometry, uint32_t sampleRate) {
+	return geometry.frameNum ? sampleRate / geometry.frameNum : 0;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * I2S RX DMA geometry from the reader's chunk size and a latency target.
+ *
+ * The driver fills dmaDescNum buffers of dmaFrameNum frames in a ring and
+ * raises one interrupt per buffer. A read only returns once whole buffers
+ * hold the samples it asks for, so:
+ * - a frame count that divides the chunk makes every read end on a buffer
+ *   boundary (no partial buffer carried into the next read);
+ * - the buffer length is the delay a sample waits before it can be read,
+ *   and sampleRate / frameNum the interrupt rate;
+ * - the ring must hold one chunk plus however long the reader may be late.
+ *
+ * i2sDmaGeometry() picks the largest frame count that divides the chunk,
+ * is no longer than latencyMs and fits one DMA buffer (4092 bytes), then
+ * enough descriptors for the chunk plus headroomMs.
+ */
+struct I2SDmaGeometry {
+	uint16_t descNum;
+	uint16_t frameNum;
+};
+
+struct I2SDmaTarget {
+	uint32_t sampleRate;
+	uint8_t bytesPerFrame;   // 2 for 16-bit mono
+	uint16_t chunkSamples;   // what the reader asks for per read
+	uint16_t latencyMs;      // longest DMA buffer
+	uint16_t headroomMs;     // reader delay the ring must absorb
+};
+
+static const uint16_t I2S_DMA_MAX_BUFFER_BYTES = 4092;
+static const uint16_t I2S_DMA_MAX_DESC = 32;
+
+I2SDmaGeometry i2sDmaGeometry(const I2SDmaTarget& target);
+
+// Buffer length and interrupt rate of a geometry
+uint32_t i2sDmaBufferUs(const I2SDmaGeometry& geometry, uint32_t sampleRate);
+uint32_t i2sDmaInterruptsPerSec(const I2SDmaGeometry& geometry, uint32_t sampleRate);
@@ -0,0 +1,157 @@
+#include "I2SDmaMicrophone.h"
+#include <esp_attr.h>
+#include <esp_log.h>
+#include <esp_timer.h>
+#include <string.h>
+
+static const char* TAG = "I2SDmaMicrophone";
+
+I2SDmaMicrophone::I2SDmaMicrophone(gpio_num_t din, gpio_num_t sck, gpio_num_t ws, i2s_port_t port)
+	: _din(din), _sck(sck), _ws(ws), _port(port) {
+	memset(&_stats, 0, sizeof(_stats));
+}
+
+I2SDmaMicrophone::~I2SDmaMicrophone() {
+	deinit();
+}
+
+esp_err_t I2SDmaMicrophone::init(uint32_t sampleRate, i2s_data_bit_width_t bits, i2s_slot_mode_t slots, const I2SDmaGeometry& geometry) {
+	if (_channel) return ESP_ERR_INVALID_STATE;
+	if (bits != I2S_DATA_BIT_WIDTH_16BIT || slots != I2S_SLOT_MODE_MONO) return ESP_ERR_NOT_SUPPORTED;
+	if (geometry.descNum < 2 || geometry.descNum > I2S_DMA_MAX_DESC || !geometry.frameNum ||
+		geometry.frameNum * _bytesPerSample > I2S_DMA_MAX_BUFFER_BYTES) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	i2s_chan_config_t chan = I2S_CHANNEL_DEFAULT_CONFIG(_port, I2S_ROLE_MASTER);
+	chan.dma_desc_num = geometry.descNum;
+	chan.dma_frame_num = geometry.frameNum;
+	esp_err_t err = i2s_new_channel(&chan, nullptr, &_channel);
+	if (err != ESP_OK) {
+		ESP_LOGE(TAG, "i2s_new_channel: %s", esp_err_to_name(err));
+		_channel = nullptr;
+		return err;
+	}
+
+	if (_ws == GPIO_NUM_NC) {
+		i2s_pdm_rx_config_t pdm = {};
+		pdm.clk_cfg = I2S_PDM_RX_CLK_DEFAULT_CONFIG(sampleRate);
+		pdm.slot_cfg = I2S_PDM_RX_SLOT_DEFAULT_CONFIG(bits, slots);
+		pdm.gpio_cfg.clk = _sck;
+		pdm.gpio_cfg.din = _din;
+		err = i2s_channel_init_pdm_rx_mode(_channel, &pdm);
+	} else {
+		i2s_std_config_t std = {};
+		std.clk_cfg = I2S_STD_CLK_DEFAULT_CONFIG(sampleRate);
+		std.slot_cfg = I2S_STD_PHILIPS_SLOT_DEFAULT_CONFIG(bits, slots);
+		std.gpio_cfg.mclk = I2S_GPIO_UNUSED;
+		std.gpio_cfg.bclk = _sck;
+		std.gpio_cfg.ws = _ws;
+		std.gpio_cfg.dout = I2S_GPIO_UNUSED;
+		std.gpio_cfg.din = _din;
+		err = i2s_channel_init_std_mode(_channel, &std);
+	}
+
+	i2s_event_callbacks_t callbacks = {};
+	callbacks.on_recv = onRecv;
+	callbacks.on_recv_q_ovf = onRecvOverflow;
+	if (err == ESP_OK) err = i2s_channel_register_event_callback(_channel, &callbacks, this);
+	if (err != ESP_OK) {
+		ESP_LOGE(TAG, "channel setup: %s", esp_err_to_name(err));
+		i2s_del_channel(_channel);
+		_channel = nullptr;
+		return err;
+	}
+
+	_geometry = geometry;
+	_sampleRate = sampleRate;
+	return ESP_OK;
+}
+
+void I2SDmaMicrophone::deinit() {
+	if (!_channel) return;
+	stop();
+	i2s_del_channel(_channel);
+	_channel = nullptr;
+}
+
+esp_err_t I2SDmaMicrophone::start() {
+	if (!_channel) return ESP_ERR_INVALID_STATE;
+	if (_active) return ESP_OK;
+	// Buffer numbering restarts with the DMA
+	_completed = 0;
+	_dropped = 0;
+	_consumed = 0;
+	_droppedSeen = 0;
+	esp_err_t err = i2s_channel_enable(_channel);
+	_active = err == ESP_OK;
+	return err;
+}
+
+esp_err_t I2SDmaMicrophone::stop() {
+	if (!_channel || !_active) return ESP_OK;
+	_active = false;
+	return i2s_channel_disable(_channel);
+}
+
+void I2SDmaMicrophone::resetStats() {
+	memset(&_stats, 0, sizeof(_stats));
+}
+
+int I2SDmaMicrophone::readSamples(int16_t* out, size_t samples, uint32_t timeoutMs) {
+	if (!_active) return -1;
+	size_t bytes = 0;
+	esp_err_t err = i2s_channel_read(_channel, out, samples * _bytesPerSample, &bytes, timeoutMs);
+	if (err != ESP_OK && err != ESP_ERR_TIMEOUT) return -1;
+	uint32_t count = bytes / _bytesPerSample;
+	if (!count) return 0;
+
+	// Whole buffers the reader never saw moved the stream ahead
+	uint32_t dropped = _dropped;
+	_consumed += (dropped - _droppedSeen) * _geometry.frameNum;
+	_droppedSeen = dropped;
+
+	uint32_t latency = captureLatencyUs(_consumed, (uint32_t)esp_timer_get_time());
+	_consumed += count;
+	_stats.reads++;
+	_stats.lastLatencyUs = latency;
+	_stats.sumLatencyUs += latency;
+	if (latency > _stats.maxLatencyUs) _stats.maxLatencyUs = latency;
+
+	int peak = 0;
+	for (uint32_t i = 0; i < count; i++) {
+		int v = out[i] < 0 ? -out[i] : out[i];
+		if (v > peak) peak = v;
+	}
+	_level = peak >> 3;
+	return (int)count;
+}
+
+// The sample was captured frame offset / rate after its buffer started,
+// and the buffer started one buffer length before its completion interrupt
+uint32_t I2SDmaMicrophone::captureLatencyUs(uint32_t firstSample, uint32_t nowUs) const {
+	uint32_t buffer = firstSample / _geometry.frameNum;
+	uint32_t completed = _completed;
+	if (buffer >= completed || completed - buffer > DMA_RING_SLOTS) return 0;
+	uint32_t doneUs = _doneUs[buffer % DMA_RING_SLOTS];
+	uint32_t offset = firstSample % _geometry.frameNum;
+	uint32_t capturedUs = doneUs - i2sDmaBufferUs(_geometry, _sampleRate) +
+		(uint32_t)((uint64_t)offset * 1000000 / _sampleRate);
+	return nowUs - capturedUs;
+}
+
+bool IRAM_ATTR I2SDmaMicrophone::onRecv(i2s_chan_handle_t channel, i2s_event_data_t* event, void* ctx) {
+	I2SDmaMicrophone* self = (I2SDmaMicrophone*)ctx;
+	uint32_t n = self->_completed;
+	self->_doneUs[n % DMA_RING_SLOTS] = (uint32_t)esp_timer_get_time();
+	self->_completed = n + 1;
+	self->_stats.interrupts++;
+	return false;
+}
+
+bool IRAM_ATTR I2SDmaMicrophone::onRecvOverflow(i2s_chan_handle_t channel, i2s_event_data_t* event, void* ctx) {
+	I2SDmaMicrophone* self = (I2SDmaMicrophone*)ctx;
+	self->_dropped = self->_dropped + 1;
+	self->_stats.overflows++;
+	return false;
+}
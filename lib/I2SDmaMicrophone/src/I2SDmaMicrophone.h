@@ -0,0 +1,77 @@
+#pragma once
+
+#include "I2SDmaGeometry.h"
+#include <driver/i2s_std.h>
+#include <driver/i2s_pdm.h>
+
+/**
+ * I2S microphone on the ESP-IDF 5 channel driver with caller-chosen DMA
+ * geometry (see I2SDmaGeometry.h).
+ *
+ * Same calls as the I2SMicrophone lib_dep, plus the geometry argument to
+ * init(). A word select pin of GPIO_NUM_NC selects PDM RX, sck being the
+ * PDM clock (I2S_NUM_0 only), otherwise standard Philips mode.
+ *
+ * Every DMA buffer completion is an interrupt; the driver counts them and
+ * timestamps the last DMA_RING_SLOTS, so each read can tell how long ago
+ * its oldest sample was captured. Overflowed buffers (the reader fell more
+ * than the whole ring behind) are counted and skipped in that bookkeeping.
+ * readSamples() belongs to one task at a time.
+ */
+struct I2SDmaStats {
+	uint32_t interrupts;     // DMA buffers completed since start()
+	uint32_t overflows;      // buffers dropped because nobody read them
+	uint32_t reads;          // readSamples() calls that returned audio
+	uint32_t lastLatencyUs;  // capture to return, oldest sample of the last read
+	uint32_t maxLatencyUs;
+	uint64_t sumLatencyUs;   // over reads, for the average
+};
+
+class I2SDmaMicrophone {
+public:
+	I2SDmaMicrophone(gpio_num_t din, gpio_num_t sck, gpio_num_t ws, i2s_port_t port = I2S_NUM_0);
+	~I2SDmaMicrophone();
+
+	esp_err_t init(uint32_t sampleRate, i2s_data_bit_width_t bits, i2s_slot_mode_t slots, const I2SDmaGeometry& geometry);
+	void deinit();
+	esp_err_t start();
+	esp_err_t stop();
+	bool isInitialized() const { return _channel != nullptr; }
+	bool isActive() const { return _active; }
+
+	// Up to samples 16-bit samples, fewer when timeoutMs runs out (0 takes
+	// what the DMA already has). Returns the count, 0 on timeout, -1 on error
+	int readSamples(int16_t* out, size_t samples, uint32_t timeoutMs);
+	// Peak of the last read, 0..4096
+	int readLevel() const { return _level; }
+
+	const I2SDmaGeometry& geometry() const { return _geometry; }
+	uint32_t sampleRate() const { return _sampleRate; }
+	const I2SDmaStats& stats() const { return _stats; }
+	void resetStats();
+
+private:
+	static const uint8_t DMA_RING_SLOTS = 64;  // > I2S_DMA_MAX_DESC
+
+	gpio_num_t _din, _sck, _ws;
+	i2s_port_t _port;
+	i2s_chan_handle_t _channel = nullptr;
+	bool _active = false;
+	I2SDmaGeometry _geometry = {0, 0};
+	uint32_t _sampleRate = 0;
+	uint8_t _bytesPerSample = 2;
+	int _level = 0;
+
+	// Written by the DMA interrupt
+	volatile uint32_t _completed = 0;
+	volatile uint32_t _dropped = 0;
+	volatile uint32_t _doneUs[DMA_RING_SLOTS];
+	// Samples handed out since start(), plus those dropped with overflowed buffers
+	uint32_t _consumed = 0;
+	uint32_t _droppedSeen = 0;
+	I2SDmaStats _stats;
+
+	uint32_t captureLatencyUs(uint32_t firstSample, uint32_t nowUs) const;
+	static bool onRecv(i2s_chan_handle_t channel, i2s_event_data_t* event, void* ctx);
+	static bool onRecvOverflow(i2s_chan_handle_t channel, i2s_event_data_t* event, void* ctx);
+};
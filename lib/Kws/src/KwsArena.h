@@ -0,0 +1,46 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * Bump allocator over one caller owned block. Every tensor and state ring of
+ * a KwsEngine comes from it, so the engine does one allocation (or none, with
+ * a static block) and never frees anything while it runs.
+ */
+class KwsArena {
+public:
+	KwsArena() : _base(nullptr), _size(0), _used(0), _needed(0) {}
+	KwsArena(void* base, size_t size) : _base((uint8_t*)base), _size(size), _used(0), _needed(0) {}
+
+	// nullptr when the block is full; needed() still grows so a dry run
+	// with an empty arena measures the size to allocate
+	void* alloc(size_t bytes, size_t align = 16) {
+		size_t at = (_needed + align - 1) & ~(align - 1);
+		_needed = at + bytes;
+		if (!_base) return nullptr;
+
+		uintptr_t p = ((uintptr_t)_base + _used + align - 1) & ~(uintptr_t)(align - 1);
+		size_t end = p - (uintptr_t)_base + bytes;
+		if (end > _size) return nullptr;
+		_used = end;
+		return (void*)p;
+	}
+
+	template <typename T>
+	T* allocArray(size_t count, size_t align = 16) {
+		return (T*)alloc(count * sizeof(T), align);
+	}
+
+	void reset() { _used = 0; _needed = 0; }
+	size_t used() const { return _used; }
+	// Bytes a block must have (plus 15 for its own alignment) to hold everything asked for
+	size_t needed() const { return _needed; }
+	size_t size() const { return _size; }
+
+private:
+	uint8_t* _base;
+	size_t _size;
+	size_t _used;
+	size_t _needed;
+};
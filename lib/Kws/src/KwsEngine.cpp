@@ -0,0 +1,283 @@
+#include "KwsEngine.h"
+#include "NnKernels.h"
+#include <math.h>
+#include <string.h>
+
+using NnQuant::clampInt8;
+using NnQuant::requantize;
+
+MelConfig kwsMelConfig(const KwsModel& model) {
+	MelConfig config = {};
+	config.sampleRate = model.sampleRate;
+	config.windowSamples = model.windowSamples;
+	config.hopSamples = model.hopSamples;
+	config.melBins = model.melBins;
+	config.lowHz = model.melLowHz;
+	config.highHz = model.melHighHz;
+	return config;
+}
+
+esp_err_t kwsValidate(const KwsModel& model, int* badLayer) {
+	if (badLayer) *badLayer = -1;
+	if (!model.layers || !model.layerCount || model.layerCount > KwsEngine::MAX_LAYERS) return ESP_ERR_INVALID_ARG;
+	if (MelFrontend::validate(kwsMelConfig(model)) != ESP_OK) return ESP_ERR_INVALID_ARG;
+	if (model.inputScale <= 0.0f) return ESP_ERR_INVALID_ARG;
+
+	uint16_t channels = model.melBins;
+	for (uint8_t i = 0; i < model.layerCount; i++) {
+		const KwsLayer& layer = model.layers[i];
+		bool ok = layer.inChannels == channels && layer.kernel && layer.stride && layer.outChannels;
+		switch (layer.op) {
+		case KWS_OP_CONV:
+			ok = ok && layer.weights && layer.multiplier && layer.shift && layer.kernel <= NN_MAX_KERNEL;
+			break;
+		case KWS_OP_DEPTHWISE:
+			ok = ok && layer.weights && layer.multiplier && layer.shift && layer.outChannels == layer.inChannels &&
+				layer.kernel <= NN_MAX_KERNEL;
+			break;
+		case KWS_OP_AVGPOOL:
+			ok = ok && layer.outChannels == layer.inChannels;
+			break;
+		case KWS_OP_FC:
+			ok = ok && layer.weights && layer.multiplier && layer.shift && layer.kernel == 1;
+			break;
+		default:
+			ok = false;
+		}
+		if (!ok) {
+			if (badLayer) *badLayer = i;
+			return ESP_ERR_INVALID_ARG;
+		}
+		channels = layer.outChannels;
+	}
+	if (channels != model.labelCount) {
+		if (badLayer) *badLayer = model.layerCount - 1;
+		return ESP_ERR_INVALID_ARG;
+	}
+	return ESP_OK;
+}
+
+KwsEngine::KwsEngine()
+	: _model(nullptr), _config(), _inputMultiplier(0), _inputShift(0), _input(nullptr), _posteriors(nullptr) {
+	memset(_layers, 0, sizeof(_layers));
+	memset(&_stats, 0, sizeof(_stats));
+}
+
+size_t KwsEngine::arenaSize(const KwsModel& model) {
+	if (kwsValidate(model) != ESP_OK) return 0;
+	KwsEngine probe;
+	probe._model = &model;
+	KwsArena dry;
+	probe.allocate(dry);
+	return dry.needed() + 15;
+}
+
+bool KwsEngine::allocate(KwsArena& arena) {
+	MelConfig mel = kwsMelConfig(*_model);
+	size_t melBytes = MelFrontend::memorySize(mel);
+	void* melMemory = arena.alloc(melBytes);
+	bool ok = melMemory && _features.begin(mel, melMemory, melBytes) == ESP_OK;
+	_input = arena.allocArray<int8_t>(_model->melBins);
+	_posteriors = arena.allocArray<float>(_model->labelCount);
+	ok = ok && _input && _posteriors;
+
+	for (uint8_t i = 0; i < _model->layerCount; i++) {
+		const KwsLayer& layer = _model->layers[i];
+		LayerState& state = _layers[i];
+		bool weighted = layer.op != KWS_OP_AVGPOOL;
+		// Ring slots start 16-byte aligned for the vector dot product
+		state.pitch = (layer.inChannels + 15) & ~15;
+		state.ring = arena.allocArray<int8_t>((size_t)layer.kernel * state.pitch);
+		state.out = arena.allocArray<int8_t>(layer.outChannels);
+		state.sum = weighted ? nullptr : arena.allocArray<int32_t>(layer.inChannels);
+		state.kernelSum = weighted ? arena.allocArray<int32_t>(layer.outChannels) : nullptr;
+		ok = ok && state.ring && state.out && (weighted ? state.kernelSum != nullptr : state.sum != nullptr);
+	}
+	return ok;
+}
+
+void KwsEngine::prepare() {
+	for (uint8_t i = 0; i < _model->layerCount; i++) {
+		const KwsLayer& layer = _model->layers[i];
+		LayerState& state = _layers[i];
+		NnConv& conv = state.conv;
+		conv = NnConv();
+		if (layer.op == KWS_OP_AVGPOOL) continue;
+
+		conv.inChannels = layer.inChannels;
+		conv.outChannels = layer.outChannels;
+		conv.kernel = layer.kernel;
+		conv.weights = layer.weights;
+		conv.bias = layer.bias;
+		conv.multiplier = layer.multiplier;
+		conv.shift = layer.shift;
+		conv.inputZero = layer.inputZero;
+		conv.outputZero = layer.outputZero;
+		conv.activationMin = layer.relu ? layer.outputZero : -128;
+		conv.activationMax = 127;
+		if (layer.op == KWS_OP_DEPTHWISE) {
+			nnDepthwiseKernelSums(conv, state.kernelSum);
+		} else {
+			nnKernelSums(conv.weights, conv.outChannels, (uint32_t)conv.kernel * conv.inChannels, conv.bias, conv.inputZero, state.kernelSum);
+		}
+		conv.kernelSum = state.kernelSum;
+	}
+}
+
+esp_err_t KwsEngine::begin(const KwsModel& model, const KwsConfig& config, void* arena, size_t arenaBytes) {
+	esp_err_t err = kwsValidate(model);
+	if (err != ESP_OK) return err;
+	if (config.keyword >= model.labelCount || !config.smoothFrames || config.smoothFrames > MAX_SMOOTH) {
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	_model = &model;
+	_config = config;
+	_arena = KwsArena(arena, arenaBytes);
+	if (!arena || !allocate(_arena)) return ESP_ERR_NO_MEM;
+	nnInit();
+	prepare();
+	NnQuant::quantizeMultiplier(1.0 / ((1 << MelFrontend::OUTPUT_SHIFT) * (double)model.inputScale), &_inputMultiplier, &_inputShift);
+
+	reset();
+	return ESP_OK;
+}
+
+void KwsEngine::reset() {
+	if (!_model) return;
+	_features.reset();
+
+	for (uint8_t i = 0; i < _model->layerCount; i++) {
+		const KwsLayer& layer = _model->layers[i];
+		LayerState& state = _layers[i];
+		// Silence before the stream starts: every past input frame is "zero"
+		memset(state.ring, layer.inputZero, (size_t)layer.kernel * state.pitch);
+		memset(state.out, layer.outputZero, layer.outChannels);
+		state.head = 0;
+		state.phase = 0;
+		if (state.sum) {
+			for (uint16_t c = 0; c < layer.inChannels; c++) state.sum[c] = (int32_t)layer.inputZero * layer.kernel;
+		}
+	}
+
+	for (uint8_t i = 0; i < _model->labelCount; i++) _posteriors[i] = 0.0f;
+	memset(_smooth, 0, sizeof(_smooth));
+	_smoothHead = 0;
+	_smoothSum = 0.0f;
+	_refractory = 0;
+	_last = {false, 0, 0.0f};
+	memset(&_stats, 0, sizeof(_stats));
+}
+
+bool KwsEngine::process(const int16_t* samples, size_t count, KwsResult* result) {
+	bool detected = false;
+	if (!_model) return false;
+
+	_stats.samples += count;
+	while (count) {
+		size_t used = _features.push(samples, count);
+		samples += used;
+		count -= used;
+		if (!_features.frameReady()) continue;
+
+		const int16_t* logMel = _features.logMel();
+		for (uint16_t m = 0; m < _model->melBins; m++) {
+			_input[m] = clampInt8(requantize(logMel[m], _inputMultiplier, _inputShift) + _model->inputZero);
+		}
+
+		_stats.frames++;
+		if (_refractory) _refractory--;
+		if (step(_input)) {
+			_stats.outputs++;
+			score(&detected);
+		}
+	}
+
+	if (result) {
+		*result = _last;
+		result->detected = detected;
+	}
+	return detected;
+}
+
+bool KwsEngine::step(const int8_t* features) {
+	const int8_t* in = features;
+	const int8_t* rows[NN_MAX_KERNEL];
+
+	for (uint8_t i = 0; i < _model->layerCount; i++) {
+		const KwsLayer& layer = _model->layers[i];
+		LayerState& state = _layers[i];
+		uint16_t inCh = layer.inChannels;
+		uint8_t kernel = layer.kernel;
+
+		// Push the new frame into the ring, dropping the oldest
+		int8_t* slot = state.ring + (size_t)state.head * state.pitch;
+		if (state.sum) {
+			for (uint16_t c = 0; c < inCh; c++) state.sum[c] += in[c] - slot[c];
+		}
+		memcpy(slot, in, inCh);
+		state.head = state.head + 1 == kernel ? 0 : state.head + 1;
+
+		if (++state.phase < layer.stride) return false;
+		state.phase = 0;
+
+		int8_t* out = state.out;
+		if (layer.op == KWS_OP_AVGPOOL) {
+			int32_t low = layer.relu ? layer.outputZero : -128;
+			for (uint16_t c = 0; c < inCh; c++) {
+				// Rounded mean, then moved from the input to the output zero point
+				int32_t sum = state.sum[c];
+				int32_t mean = (sum >= 0 ? sum + kernel / 2 : sum - kernel / 2) / kernel;
+				out[c] = clampInt8(mean - layer.inputZero + layer.outputZero, low);
+			}
+		} else {
+			// Oldest frame first
+			for (uint8_t k = 0; k < kernel; k++) {
+				uint8_t s = state.head + k < kernel ? state.head + k : state.head + k - kernel;
+				rows[k] = state.ring + (size_t)s * state.pitch;
+			}
+			if (layer.op == KWS_OP_DEPTHWISE) nnDepthwiseFrame(state.conv, rows, out);
+			else nnConvFrame(state.conv, rows, out);
+		}
+		in = out;
+	}
+	return true;
+}
+
+void KwsEngine::score(bool* detected) {
+	const int8_t* logits = _layers[_model->layerCount - 1].out;
+	uint8_t labels = _model->labelCount;
+
+	// Softmax of the dequantized logits
+	float best = -1e30f;
+	uint8_t bestLabel = 0;
+	for (uint8_t i = 0; i < labels; i++) {
+		float v = (logits[i] - _model->outputZero) * _model->outputScale;
+		_posteriors[i] = v;
+		if (v > best) {
+			best = v;
+			bestLabel = i;
+		}
+	}
+	float total = 0.0f;
+	for (uint8_t i = 0; i < labels; i++) {
+		_posteriors[i] = expf(_posteriors[i] - best);
+		total += _posteriors[i];
+	}
+	for (uint8_t i = 0; i < labels; i++) _posteriors[i] /= total;
+
+	// Moving average of the keyword posterior
+	float p = _posteriors[_config.keyword];
+	_smoothSum += p - _smooth[_smoothHead];
+	_smooth[_smoothHead] = p;
+	_smoothHead = _smoothHead + 1 == _config.smoothFrames ? 0 : _smoothHead + 1;
+	float score = _smoothSum / _config.smoothFrames;
+
+	_last.label = bestLabel;
+	_last.score = score;
+	if (score >= _config.threshold && !_refractory) {
+		_refractory = _config.refractoryFrames;
+		_stats.detections++;
+		*detected = true;
+	}
+}
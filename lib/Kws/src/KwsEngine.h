@@ -0,0 +1,95 @@
+#pragma once
+
+#include "KwsArena.h"
+#include "KwsModel.h"
+#include "MelFrontend.h"
+#include "NnKernels.h"
+
+/**
+ * Streaming keyword spotter: log-mel front-end, a KwsModel network evaluated
+ * one frame at a time, and posterior smoothing with a detection threshold.
+ *
+ * All tensors, state rings and front-end tables come from one arena, sized
+ * with arenaSize(). The engine never allocates after begin() and has no
+ * platform dependencies, so the same code runs in the device task and in
+ * the host benchmark.
+ */
+struct KwsConfig {
+	uint8_t keyword;           // label index that triggers a detection
+	float threshold;           // smoothed posterior, 0..1
+	uint8_t smoothFrames;      // posterior moving average, in network outputs
+	uint16_t refractoryFrames; // feature frames ignored after a detection
+};
+
+struct KwsResult {
+	bool detected;
+	uint8_t label;      // best label of the last network output
+	float score;        // smoothed posterior of config.keyword
+};
+
+struct KwsStats {
+	uint32_t samples;
+	uint32_t frames;       // feature frames
+	uint32_t outputs;      // network outputs (frames / total stride)
+	uint32_t detections;
+};
+
+class KwsEngine {
+public:
+	static const uint8_t MAX_LAYERS = 16;
+	static const uint8_t MAX_SMOOTH = 64;
+
+	KwsEngine();
+
+	// Arena bytes needed for model (including alignment slack)
+	static size_t arenaSize(const KwsModel& model);
+
+	esp_err_t begin(const KwsModel& model, const KwsConfig& config, void* arena, size_t arenaBytes);
+	// Clears the audio history, layer state and smoothing
+	void reset();
+
+	// Feeds samples, result reports the last network output. Returns true if
+	// the keyword was detected somewhere in this chunk
+	bool process(const int16_t* samples, size_t count, KwsResult* result = nullptr);
+
+	// Posteriors of the last network output, labelCount values
+	const float* posteriors() const { return _posteriors; }
+	const KwsStats& stats() const { return _stats; }
+	const KwsModel* model() const { return _model; }
+	size_t arenaUsed() const { return _arena.used(); }
+
+private:
+	struct LayerState {
+		int8_t* ring;      // [kernel][pitch], oldest first from head
+		uint16_t pitch;    // inChannels rounded up to 16
+		uint8_t head;      // slot of the oldest frame
+		uint8_t phase;     // inputs since the last output, for stride
+		int32_t* sum;      // avgpool running sums [channels]
+		int32_t* kernelSum;  // weighted layers, bias with the input zero point folded in [outChannels]
+		NnConv conv;
+		int8_t* out;       // [outChannels]
+	};
+
+	const KwsModel* _model;
+	KwsConfig _config;
+	KwsArena _arena;
+	MelFrontend _features;
+	int32_t _inputMultiplier;  // Q8 log-mel to the model input scale
+	int8_t _inputShift;
+	LayerState _layers[MAX_LAYERS];
+	int8_t* _input;
+	float* _posteriors;
+	float _smooth[MAX_SMOOTH];
+	uint8_t _smoothHead;
+	float _smoothSum;
+	uint16_t _refractory;
+	KwsResult _last;
+	KwsStats _stats;
+
+	bool allocate(KwsArena& arena);
+	// Kernel parameters and folded sums of every weighted layer
+	void prepare();
+	// Runs the network on one feature frame, true if the last layer produced output
+	bool step(const int8_t* features);
+	void score(bool* detected);
+};
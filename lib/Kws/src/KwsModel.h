@@ -0,0 +1,94 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "MelFrontend.h"
+
+#ifdef ESP_PLATFORM
+#include "esp_err.h"
+#elif !defined(ESP_OK)
+// Host builds (tools, tests) only need the status codes
+typedef int esp_err_t;
+#define ESP_OK 0
+#define ESP_FAIL -1
+#define ESP_ERR_NO_MEM 0x101
+#define ESP_ERR_INVALID_ARG 0x102
+#define ESP_ERR_INVALID_STATE 0x103
+#define ESP_ERR_INVALID_SIZE 0x104
+#define ESP_ERR_NOT_FOUND 0x105
+#define ESP_ERR_NOT_SUPPORTED 0x106
+#define ESP_ERR_INVALID_CRC 0x109
+#define ESP_ERR_INVALID_VERSION 0x10A
+#endif
+
+/**
+ * Streaming keyword-spotting network description.
+ *
+ * The network runs over time, one feature frame (one 10 ms hop) at a time.
+ * Every layer sees one input frame per step and keeps the last `kernel`
+ * input frames as state, so a step only computes the newest output column
+ * instead of the whole window. A layer with stride s emits one frame every
+ * s inputs and the layers after it only run on those steps.
+ *
+ * Tensors are int8 with one scale and zero point per activation. Weights are
+ * symmetric int8 with a per output channel scale folded into a fixed-point
+ * multiplier and shift (see NnQuant), biases are int32 in accumulator
+ * scale. Nothing here is copied: weights may live in flash.
+ */
+
+enum KwsOp : uint8_t {
+	// out[o] = sum(k, i) w[o][k][i] * in[t - kernel + 1 + k][i]
+	KWS_OP_CONV = 0,
+	// out[c] = sum(k) w[c][k] * in[t - kernel + 1 + k][c]
+	KWS_OP_DEPTHWISE = 1,
+	// out[c] = mean of in[c] over the last `kernel` frames
+	KWS_OP_AVGPOOL = 2,
+	// out[o] = sum(i) w[o][i] * in[i], kernel must be 1
+	KWS_OP_FC = 3,
+};
+
+struct KwsLayer {
+	KwsOp op;
+	uint8_t kernel;    // frames of input kept in state
+	uint8_t stride;    // 1 = an output for every input frame
+	uint8_t relu;      // clamp the output at its zero point
+	uint16_t inChannels;
+	uint16_t outChannels;  // = inChannels for depthwise and pooling
+
+	const int8_t* weights;       // conv [out][kernel][in], depthwise [ch][kernel], fc [out][in]
+	const int32_t* bias;         // [out], may be null
+	const int32_t* multiplier;   // [out] requantization, Q31
+	const int8_t* shift;         // [out] requantization, left shift (negative: right)
+
+	int8_t inputZero;
+	int8_t outputZero;
+};
+
+struct KwsModel {
+	// Front-end: log-mel features of a 16 kHz stream (MelFrontend, no
+	// pre-emphasis)
+	uint16_t sampleRate;
+	uint16_t windowSamples;  // analysis window, e.g. 480 (30 ms)
+	uint16_t hopSamples;     // step, e.g. 160 (10 ms)
+	uint16_t melBins;        // = layers[0].inChannels
+	float melLowHz;
+	float melHighHz;
+	// log-mel value = (q - inputZero) * inputScale
+	float inputScale;
+	int8_t inputZero;
+
+	const KwsLayer* layers;
+	uint8_t layerCount;
+
+	// Last layer output: logits, dequantized with outputScale / outputZero
+	float outputScale;
+	int8_t outputZero;
+	uint8_t labelCount;       // = last layer outChannels
+	const char* const* labels;
+};
+
+// Front-end configuration of the model
+MelConfig kwsMelConfig(const KwsModel& model);
+
+// Checks shapes and chaining, ESP_ERR_INVALID_ARG with the first bad layer in badLayer
+esp_err_t kwsValidate(const KwsModel& model, int* badLayer = nullptr);
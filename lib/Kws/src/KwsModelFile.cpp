@@ -0,0 +1,96 @@
+#include "KwsModelFile.h"
+#include <stdio.h>
+#include <string.h>
+
+// Constant tensor of the given type and element count, nullptr if it does not match
+static const void* constant(const NnModelFile& file, uint16_t index, uint8_t type, uint32_t elements) {
+	const NnTensorRecord* t = file.tensor(index);
+	if (!t || t->type != type || file.tensorElements(index) != elements) return nullptr;
+	return file.tensorData(index);
+}
+
+static bool activation(const NnModelFile& file, uint16_t index, uint16_t* channels) {
+	const NnTensorRecord* t = file.tensor(index);
+	if (!t || t->type != NN_TENSOR_INT8 || file.tensorData(index) || t->rank != 1) return false;
+	if (t->zeroPoint < -128 || t->zeroPoint > 127 || t->dims[0] > 0xFFFF) return false;
+	*channels = (uint16_t)t->dims[0];
+	return true;
+}
+
+static esp_err_t buildLayer(const NnModelFile& file, const NnOpRecord& op, KwsLayer& layer) {
+	uint16_t in, out;
+	if (!activation(file, op.inputs[0], &in) || !activation(file, op.output, &out)) return ESP_ERR_INVALID_ARG;
+
+	memset(&layer, 0, sizeof(layer));
+	layer.op = (KwsOp)op.type;
+	layer.kernel = op.kernel;
+	layer.stride = op.stride;
+	layer.relu = op.flags & NN_OP_FLAG_RELU ? 1 : 0;
+	layer.inChannels = in;
+	layer.outChannels = out;
+	layer.inputZero = (int8_t)file.tensor(op.inputs[0])->zeroPoint;
+	layer.outputZero = (int8_t)file.tensor(op.output)->zeroPoint;
+	if (op.type == NN_OP_AVGPOOL) return ESP_OK;
+
+	if (op.inputCount != 5) return ESP_ERR_INVALID_ARG;
+	uint32_t weights = op.type == NN_OP_DEPTHWISE ? (uint32_t)in * op.kernel : (uint32_t)out * op.kernel * in;
+	layer.weights = (const int8_t*)constant(file, op.inputs[1], NN_TENSOR_INT8, weights);
+	if (op.inputs[2] != NN_NO_TENSOR) {
+		layer.bias = (const int32_t*)constant(file, op.inputs[2], NN_TENSOR_INT32, out);
+		if (!layer.bias) return ESP_ERR_INVALID_ARG;
+	}
+	layer.multiplier = (const int32_t*)constant(file, op.inputs[3], NN_TENSOR_INT32, out);
+	layer.shift = (const int8_t*)constant(file, op.inputs[4], NN_TENSOR_INT8, out);
+	return layer.weights && layer.multiplier && layer.shift ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t kwsModelFromFile(const NnModelFile& file, KwsModelStorage& storage, int* badOp) {
+	if (badOp) *badOp = -1;
+	if (!file.isOpen()) return ESP_ERR_INVALID_STATE;
+	if (file.opCount() > KwsEngine::MAX_LAYERS) return ESP_ERR_NOT_SUPPORTED;
+
+	memset(&storage, 0, sizeof(storage));
+	KwsModel& model = storage.model;
+
+	for (uint16_t i = 0; i < file.opCount(); i++) {
+		const NnOpRecord& op = *file.op(i);
+		esp_err_t err = ESP_OK;
+		if (op.type > NN_OP_FC) err = ESP_ERR_NOT_SUPPORTED;
+		else if (i && op.inputs[0] != file.op(i - 1)->output) err = ESP_ERR_NOT_SUPPORTED;
+		else err = buildLayer(file, op, storage.layers[i]);
+		if (err != ESP_OK) {
+			if (badOp) *badOp = i;
+			return err;
+		}
+	}
+
+	const NnTensorRecord* input = file.tensor(file.op(0)->inputs[0]);
+	const NnTensorRecord* logits = file.tensor(file.op(file.opCount() - 1)->output);
+	model.sampleRate = (uint16_t)file.metaInt("mel.sample_rate", 16000);
+	model.windowSamples = (uint16_t)file.metaInt("mel.window", 0);
+	model.hopSamples = (uint16_t)file.metaInt("mel.hop", 0);
+	model.melBins = storage.layers[0].inChannels;
+	model.melLowHz = file.metaFloat("mel.low_hz", 20.0f);
+	model.melHighHz = file.metaFloat("mel.high_hz", 7600.0f);
+	model.inputScale = input->scale;
+	model.inputZero = (int8_t)input->zeroPoint;
+	model.layers = storage.layers;
+	model.layerCount = (uint8_t)file.opCount();
+	model.outputScale = logits->scale;
+	model.outputZero = (int8_t)logits->zeroPoint;
+	model.labelCount = (uint8_t)logits->dims[0];
+	model.labels = storage.labels;
+
+	if (logits->dims[0] > KwsModelStorage::MAX_LABELS) return ESP_ERR_NOT_SUPPORTED;
+	for (uint8_t i = 0; i < model.labelCount; i++) {
+		char key[16];
+		snprintf(key, sizeof(key), "label.%u", i);
+		storage.labels[i] = file.meta(key);
+		if (!storage.labels[i]) return ESP_ERR_NOT_FOUND;
+	}
+
+	int bad;
+	esp_err_t err = kwsValidate(model, &bad);
+	if (err != ESP_OK && badOp) *badOp = bad;
+	return err;
+}
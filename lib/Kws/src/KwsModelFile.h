@@ -0,0 +1,30 @@
+#pragma once
+
+#include "KwsEngine.h"
+#include "NnModelFile.h"
+
+/**
+ * KwsModel view of an .nnm container.
+ *
+ * The graph must be a chain of conv / depthwise / avgpool / fc ops, each
+ * taking the previous output. Layer zero points come from the activation
+ * tensors, the model input and logit quantization from the first input and
+ * the last output. Front-end settings and labels are metadata:
+ *   mel.sample_rate, mel.window, mel.hop, mel.low_hz, mel.high_hz
+ *   label.0 .. label.N-1
+ * Weights, biases, requantization tables and label strings stay in the
+ * container; storage only holds the small layer and label tables, so the
+ * container (or its mapping) must outlive the model.
+ */
+struct KwsModelStorage {
+	static const uint8_t MAX_LABELS = 32;
+
+	KwsModel model;
+	KwsLayer layers[KwsEngine::MAX_LAYERS];
+	const char* labels[MAX_LABELS];
+};
+
+// ESP_ERR_NOT_SUPPORTED for ops the streaming engine has no kernel for
+// (GRU) or a graph that is not a chain, ESP_ERR_INVALID_ARG for shapes
+// or types that do not match, with the first bad op in badOp
+esp_err_t kwsModelFromFile(const NnModelFile& file, KwsModelStorage& storage, int* badOp = nullptr);
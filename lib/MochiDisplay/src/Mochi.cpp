@@ -1,15 +1,22 @@
 #include "Mochi.h"
+#include "PageBuffer.h"
 
 namespace Mochi {
 	int frame = 0;
 
-	void sendBuffer(U8G2_SSD1306_128X64_NONAME_F_HW_I2C* display){
-		display->clearBuffer();					// clear the internal memory
-		display->drawXBMP(0, 0, 128, 64, epd_bitmap_allArray[frame]); // draw fullscreen image generated by image2cpp website
-		display->sendBuffer();					// transfer internal memory to the display
+	void loadFrame(DisplayBackend* display, int index) {
+		// fullscreen image generated by image2cpp website, rotated into the
+		// page buffer 8x8 at a time (same as clearBuffer + drawXBMP)
+		PageBuffer buffer(display->buffer(), display->width(), display->height());
+		buffer.loadXbm(epd_bitmap_allArray[index % epd_bitmap_allArray_LEN], 128, 64);
 	}
 
-	void drawFrame(U8G2_SSD1306_128X64_NONAME_F_HW_I2C* display) { // main loop
+	void sendBuffer(DisplayBackend* display){
+		loadFrame(display, frame);
+		display->flush();						// transfer internal memory to the display
+	}
+
+	void drawFrame(DisplayBackend* display) { // main loop
 		frame = 0;
 
 		do{
@@ -17,6 +24,6 @@ namespace Mochi {
 			taskYIELD();
 		}
 		
-		while(90 > ++frame); // increase the frame number
+		while(epd_bitmap_allArray_LEN > ++frame); // increase the frame number
 	}
 }
\ No newline at end of file
@@ -1,8 +1,11 @@
 #pragma once
 
 #include "Frame.h"
-#include <U8g2lib.h>
+#include <DisplayBackend.h>
 
 namespace Mochi {
-	void drawFrame(U8G2_SSD1306_128X64_NONAME_F_HW_I2C* display);
+	// Plays all frames, blocking until the last one is sent
+	void drawFrame(DisplayBackend* display);
+	// Puts frame index into the buffer without sending it
+	void loadFrame(DisplayBackend* display, int index);
 }
\ No newline at end of file
@@ -0,0 +1,233 @@
+#include "ModelLoader.h"
+#include <string.h>
+#include <stdlib.h>
+
+#ifdef ESP_PLATFORM
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#else
+#include <time.h>
+#endif
+
+static inline uint32_t nowUs() {
+#ifdef ESP_PLATFORM
+	return (uint32_t)esp_timer_get_time();
+#else
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint32_t)(ts.tv_sec * 1000000ull + ts.tv_nsec / 1000);
+#endif
+}
+
+ModelLoader::ModelLoader(const ModelPack& pack, ModelLoadPolicy policy) : _pack(pack), _policy(policy) {
+	memset(_slots, 0, sizeof(_slots));
+	_count = 0;
+#ifdef ESP_PLATFORM
+	_mutex = xSemaphoreCreateMutex();
+#endif
+
+	for (size_t i = 0; i < pack.modelCount() && _count < MAX_MODELS; i++) {
+		Slot& slot = _slots[_count];
+		uint32_t offset, size;
+		slot.stats.name = pack.modelName(i);
+		if (!pack.locateModel(slot.stats.name, &offset, &size)) continue;
+
+		slot.offset = offset;
+		slot.stats.size = pack.modelSize(slot.stats.name);
+		slot.stats.status = ESP_OK;
+		_count++;
+	}
+}
+
+ModelLoader::~ModelLoader() {
+	for (size_t i = 0; i < _count; i++) {
+		unload(_slots[i]);
+	}
+#ifdef ESP_PLATFORM
+	if (_mutex) vSemaphoreDelete(_mutex);
+#endif
+}
+
+void ModelLoader::lock() const {
+#ifdef ESP_PLATFORM
+	if (_mutex) xSemaphoreTake(_mutex, portMAX_DELAY);
+#endif
+}
+
+void ModelLoader::unlock() const {
+#ifdef ESP_PLATFORM
+	if (_mutex) xSemaphoreGive(_mutex);
+#endif
+}
+
+ModelLoader::Slot* ModelLoader::findSlot(const char* model) {
+	if (!model) return nullptr;
+	for (size_t i = 0; i < _count; i++) {
+		if (strncmp(_slots[i].stats.name, model, 32) == 0) return &_slots[i];
+	}
+	return nullptr;
+}
+
+const ModelLoader::Slot* ModelLoader::findSlot(const char* model) const {
+	return const_cast<ModelLoader*>(this)->findSlot(model);
+}
+
+esp_err_t ModelLoader::acquire(const char* model) {
+	lock();
+	Slot* slot = findSlot(model);
+	if (!slot) {
+		unlock();
+		return ESP_ERR_NOT_FOUND;
+	}
+
+	esp_err_t ret = ESP_OK;
+	if (slot->stats.refs == 0) {
+		ret = load(*slot);
+		if (ret == ESP_OK && !slot->stats.verified) {
+			ret = verify(*slot);
+		}
+		if (ret != ESP_OK) {
+			unload(*slot);
+		}
+	}
+
+	if (ret == ESP_OK) slot->stats.refs++;
+	slot->stats.status = ret;
+	unlock();
+	return ret;
+}
+
+esp_err_t ModelLoader::release(const char* model) {
+	lock();
+	Slot* slot = findSlot(model);
+	esp_err_t ret = ESP_OK;
+	if (!slot) {
+		ret = ESP_ERR_NOT_FOUND;
+	} else if (slot->stats.refs == 0) {
+		ret = ESP_ERR_INVALID_STATE;
+	} else if (--slot->stats.refs == 0) {
+		unload(*slot);
+	}
+	unlock();
+	return ret;
+}
+
+bool ModelLoader::isLoaded(const char* model) const {
+	const Slot* slot = findSlot(model);
+	return slot && slot->data;
+}
+
+ModelSpan ModelLoader::file(const char* model, const char* file) const {
+	const Slot* slot = findSlot(model);
+	uint32_t offset, size;
+	if (!slot || !slot->data || !_pack.locate(model, file, &offset, &size)) return {nullptr, 0};
+	return {slot->data + (offset - slot->offset), size};
+}
+
+const ModelStats* ModelLoader::stats(size_t index) const {
+	return index < _count ? &_slots[index].stats : nullptr;
+}
+
+const ModelStats* ModelLoader::stats(const char* model) const {
+	const Slot* slot = findSlot(model);
+	return slot ? &slot->stats : nullptr;
+}
+
+size_t ModelLoader::residentBytes() const {
+	size_t total = 0;
+	for (size_t i = 0; i < _count; i++) {
+		total += _slots[i].stats.resident;
+	}
+	return total;
+}
+
+esp_err_t ModelLoader::load(Slot& slot) {
+	uint32_t offset, size;
+	if (!_pack.locateModel(slot.stats.name, &offset, &size)) return ESP_ERR_NOT_FOUND;
+
+	uint32_t start = nowUs();
+
+	// Already accessible: host images and fully mapped partitions
+	ModelSpan whole = _pack.span(offset, size);
+	if (!whole.empty() && _policy == MODEL_LOAD_MAP) {
+		slot.data = whole.data;
+		slot.stats.resident = 0;
+	}
+#ifdef ESP_PLATFORM
+	else if (_pack.partition() && _policy == MODEL_LOAD_MAP) {
+		// esp_partition_mmap() wants a page aligned offset
+		uint32_t base = offset & ~(ModelPack::MMU_PAGE_SIZE - 1);
+		uint32_t length = offset - base + size;
+		const void* ptr = nullptr;
+		esp_err_t ret = esp_partition_mmap(_pack.partition(), base, length, ESP_PARTITION_MMAP_DATA, &ptr, &slot.handle);
+		if (ret != ESP_OK) return ret;
+		slot.mapped = true;
+		slot.data = (const uint8_t*)ptr + (offset - base);
+		slot.stats.resident = (length + ModelPack::MMU_PAGE_SIZE - 1) & ~(ModelPack::MMU_PAGE_SIZE - 1);
+	}
+	else if (_pack.partition()) {
+		// 16-byte aligned like a mapping, for in-place tensors (NnModelFile)
+		slot.buffer = (uint8_t*)heap_caps_aligned_alloc(16, size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+		if (!slot.buffer) return ESP_ERR_NO_MEM;
+		esp_err_t ret = esp_partition_read(_pack.partition(), offset, slot.buffer, size);
+		if (ret != ESP_OK) return ret;
+		slot.data = slot.buffer;
+		slot.stats.resident = size;
+	}
+#else
+	else if (!whole.empty()) {
+		slot.buffer = (uint8_t*)aligned_alloc(16, (size + 15) & ~(size_t)15);
+		if (!slot.buffer) return ESP_ERR_NO_MEM;
+		memcpy(slot.buffer, whole.data, size);
+		slot.data = slot.buffer;
+		slot.stats.resident = size;
+	}
+#endif
+	else {
+		return ESP_ERR_INVALID_STATE;
+	}
+
+	slot.offset = offset;
+	slot.stats.loadUs = nowUs() - start;
+	slot.stats.loads++;
+	return ESP_OK;
+}
+
+esp_err_t ModelLoader::verify(Slot& slot) {
+	if (_pack.version() < ModelPack::VERSION) {
+		// Nothing to check against
+		return ESP_OK;
+	}
+
+	uint32_t start = nowUs();
+	bool found = false;
+	for (size_t i = 0; i < _pack.fileCount(); i++) {
+		const ModelPackEntry* e = _pack.entry(i);
+		if (strncmp(e->model, slot.stats.name, sizeof(e->model)) != 0) continue;
+		found = true;
+		const uint8_t* data = slot.data + (e->offset - slot.offset);
+		if (ModelPack::crc32(0, data, e->size) != e->crc32) {
+			return ESP_ERR_INVALID_CRC;
+		}
+	}
+	if (!found) return ESP_ERR_NOT_FOUND;
+
+	slot.stats.verifyUs = nowUs() - start;
+	slot.stats.verified = true;
+	return ESP_OK;
+}
+
+void ModelLoader::unload(Slot& slot) {
+#ifdef ESP_PLATFORM
+	if (slot.mapped) {
+		esp_partition_munmap(slot.handle);
+		slot.mapped = false;
+	}
+#endif
+	if (slot.buffer) {
+		free(slot.buffer);
+		slot.buffer = nullptr;
+	}
+	slot.data = nullptr;
+	slot.stats.resident = 0;
+}
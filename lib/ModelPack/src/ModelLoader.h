@@ -0,0 +1,89 @@
+#pragma once
+
+#include "ModelPack.h"
+
+#ifdef ESP_PLATFORM
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#endif
+
+/**
+ * Lazy, reference counted access to the models of a ModelPack.
+ *
+ * Nothing is brought in at construction: acquire() maps (or copies) the byte
+ * range of one model on first use, checks every file against the CRC32 in the
+ * pack index and keeps it until the last release(). The CRC check runs once
+ * per boot, a model that is released and acquired again is only remapped.
+ *
+ * MODEL_LOAD_MAP maps the range through the flash MMU (no RAM, data is read
+ * through the cache). MODEL_LOAD_COPY reads it into PSRAM, trading RAM for
+ * flash cache pressure while the model runs.
+ */
+
+enum ModelLoadPolicy {
+	MODEL_LOAD_MAP = 0,
+	MODEL_LOAD_COPY,
+};
+
+struct ModelStats {
+	const char* name;
+	uint32_t size;       // sum of the model's files
+	uint32_t resident;   // mapped or allocated bytes while loaded, else 0
+	uint32_t loadUs;     // last map/copy time
+	uint32_t verifyUs;   // CRC check time, 0 until verified
+	uint16_t refs;
+	uint16_t loads;
+	bool verified;       // false for version 1 packs (no checksums)
+	esp_err_t status;    // result of the last acquire()
+};
+
+class ModelLoader {
+public:
+	static const size_t MAX_MODELS = 16;
+
+	ModelLoader(const ModelPack& pack, ModelLoadPolicy policy = MODEL_LOAD_MAP);
+	~ModelLoader();
+
+	// Load on first use; ESP_ERR_INVALID_CRC if a file does not match the index
+	esp_err_t acquire(const char* model);
+	// Unload when the last reference is dropped
+	esp_err_t release(const char* model);
+	bool isLoaded(const char* model) const;
+
+	// Valid between acquire() and the matching release()
+	ModelSpan file(const char* model, const char* file) const;
+
+	ModelLoadPolicy policy() const { return _policy; }
+	size_t count() const { return _count; }
+	const ModelStats* stats(size_t index) const;
+	const ModelStats* stats(const char* model) const;
+	size_t residentBytes() const;
+
+private:
+	struct Slot {
+		ModelStats stats;
+		uint32_t offset;
+		const uint8_t* data;
+		uint8_t* buffer;
+#ifdef ESP_PLATFORM
+		esp_partition_mmap_handle_t handle;
+		bool mapped;
+#endif
+	};
+
+	const ModelPack& _pack;
+	ModelLoadPolicy _policy;
+	Slot _slots[MAX_MODELS];
+	size_t _count;
+#ifdef ESP_PLATFORM
+	SemaphoreHandle_t _mutex;
+#endif
+
+	Slot* findSlot(const char* model);
+	const Slot* findSlot(const char* model) const;
+	esp_err_t load(Slot& slot);
+	esp_err_t verify(Slot& slot);
+	void unload(Slot& slot);
+	void lock() const;
+	void unlock() const;
+};
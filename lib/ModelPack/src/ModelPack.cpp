@@ -0,0 +1,323 @@
+#include "ModelPack.h"
+#include <string.h>
+
+#ifdef ESP_PLATFORM
+#include "esp_rom_crc.h"
+#endif
+
+static const size_t NAME_LEN = 32;
+static const size_t PACK_HEADER_LEN = 20;
+
+static inline uint32_t readU32(const uint8_t* p) {
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline uint16_t readU16(const uint8_t* p) {
+	return (uint16_t)p[0] | ((uint16_t)p[1] << 8);
+}
+
+// Compare a NUL padded char[32] field with a C string
+static inline int compareName(const char* field, const char* name) {
+	return strncmp(field, name, NAME_LEN);
+}
+
+ModelPack::ModelPack() {
+	_image = nullptr;
+#ifdef ESP_PLATFORM
+	_partition = nullptr;
+	_mapped = false;
+#endif
+	close();
+}
+
+ModelPack::~ModelPack() {
+	close();
+}
+
+esp_err_t ModelPack::open(const void* image, size_t size) {
+	close();
+	if (!image || size < 4) return ESP_ERR_INVALID_ARG;
+
+	_image = (const uint8_t*)image;
+	_size = size;
+	_mappedSize = size;
+
+	esp_err_t ret = parse();
+	if (ret != ESP_OK) close();
+	return ret;
+}
+
+#ifdef ESP_PLATFORM
+esp_err_t ModelPack::mapRange(const char* label, size_t length) {
+	close();
+
+	const esp_partition_t* part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, label);
+	if (!part) return ESP_ERR_NOT_FOUND;
+	if (length > part->size) length = part->size;
+
+	const void* ptr = nullptr;
+	esp_err_t ret = esp_partition_mmap(part, 0, length, ESP_PARTITION_MMAP_DATA, &ptr, &_mmapHandle);
+	if (ret != ESP_OK) return ret;
+
+	_partition = part;
+	_mapped = true;
+	_image = (const uint8_t*)ptr;
+	_size = part->size;
+	_mappedSize = length;
+
+	ret = parse();
+	if (ret != ESP_OK) close();
+	return ret;
+}
+
+esp_err_t ModelPack::map(const char* label) {
+	return mapRange(label, SIZE_MAX);
+}
+
+esp_err_t ModelPack::mapIndex(const char* label) {
+	esp_err_t ret = mapRange(label, MMU_PAGE_SIZE);
+	if (ret == ESP_ERR_INVALID_SIZE) {
+		// Header and index larger than one page
+		ret = map(label);
+	}
+	return ret;
+}
+#endif
+
+void ModelPack::close() {
+#ifdef ESP_PLATFORM
+	if (_mapped) {
+		esp_partition_munmap(_mmapHandle);
+		_mapped = false;
+	}
+	_partition = nullptr;
+#endif
+	_image = nullptr;
+	_size = 0;
+	_mappedSize = 0;
+	_version = 0;
+	_alignment = 0;
+	_modelCount = 0;
+	_fileCount = 0;
+	_headerLen = 0;
+	_entries = nullptr;
+}
+
+esp_err_t ModelPack::parse() {
+	// Walk the ESP-SR header to find where it ends. Header bytes must be
+	// mapped, file offsets only have to fall inside the image.
+	const uint8_t* p = _image;
+	const uint8_t* end = _image + _mappedSize;
+
+	uint32_t models = readU32(p);
+	p += 4;
+	size_t files = 0;
+	for (uint32_t i = 0; i < models; i++) {
+		if (p + NAME_LEN + 4 > end) return ESP_ERR_INVALID_SIZE;
+		uint32_t count = readU32(p + NAME_LEN);
+		p += NAME_LEN + 4;
+		if (count > (size_t)(end - p) / (NAME_LEN + 8)) return ESP_ERR_INVALID_SIZE;
+		for (uint32_t j = 0; j < count; j++) {
+			uint32_t start = readU32(p + NAME_LEN);
+			uint32_t len = readU32(p + NAME_LEN + 4);
+			if (start > _size || len > _size - start) return ESP_ERR_INVALID_SIZE;
+			p += NAME_LEN + 8;
+		}
+		files += count;
+	}
+
+	_modelCount = models;
+	_fileCount = files;
+	_headerLen = p - _image;
+	_version = 1;
+	_alignment = 1;
+
+	// Version 2 index follows the ESP-SR header
+	if (p + PACK_HEADER_LEN > end || readU32(p) != MAGIC) {
+		return ESP_OK;
+	}
+
+	uint16_t version = readU16(p + 4);
+	uint16_t entryLen = readU16(p + 6);
+	uint32_t count = readU32(p + 8);
+	uint32_t alignment = readU32(p + 12);
+	uint32_t indexCrc = readU32(p + 16);
+	const uint8_t* entries = p + PACK_HEADER_LEN;
+
+	if (version != VERSION || entryLen != sizeof(ModelPackEntry)) return ESP_ERR_INVALID_VERSION;
+	if (count != files || entries + (size_t)count * entryLen > end) return ESP_ERR_INVALID_SIZE;
+	if (crc32(0, entries, (size_t)count * entryLen) != indexCrc) return ESP_ERR_INVALID_CRC;
+
+	_entries = (const ModelPackEntry*)entries;
+	for (size_t i = 0; i < count; i++) {
+		const ModelPackEntry& e = _entries[i];
+		if (e.offset > _size || e.size > _size - e.offset) return ESP_ERR_INVALID_SIZE;
+		if (alignment && e.offset % alignment) return ESP_ERR_INVALID_SIZE;
+	}
+
+	_version = version;
+	_alignment = alignment;
+	_headerLen = entries + (size_t)count * entryLen - _image;
+	return ESP_OK;
+}
+
+const ModelPackEntry* ModelPack::entry(size_t index) const {
+	if (!_entries || index >= _fileCount) return nullptr;
+	return &_entries[index];
+}
+
+const ModelPackEntry* ModelPack::findEntry(const char* model, const char* file) const {
+	if (!_entries || !model || !file) return nullptr;
+
+	size_t lo = 0;
+	size_t hi = _fileCount;
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		const ModelPackEntry& e = _entries[mid];
+		int cmp = compareName(e.model, model);
+		if (cmp == 0) cmp = compareName(e.file, file);
+		if (cmp == 0) return &e;
+		if (cmp < 0) lo = mid + 1;
+		else hi = mid;
+	}
+	return nullptr;
+}
+
+const char* ModelPack::modelName(size_t index) const {
+	if (!_image || index >= _modelCount) return nullptr;
+
+	const uint8_t* p = _image + 4;
+	for (size_t i = 0; i < index; i++) {
+		uint32_t count = readU32(p + NAME_LEN);
+		p += NAME_LEN + 4 + count * (NAME_LEN + 8);
+	}
+	return (const char*)p;
+}
+
+bool ModelPack::locate(const char* model, const char* file, uint32_t* offset, uint32_t* size) const {
+	if (!_image || !model || !file) return false;
+	if (_entries) {
+		const ModelPackEntry* e = findEntry(model, file);
+		if (!e) return false;
+		*offset = e->offset;
+		*size = e->size;
+		return true;
+	}
+	return locateLegacy(model, file, offset, size);
+}
+
+bool ModelPack::locateLegacy(const char* model, const char* file, uint32_t* offset, uint32_t* size) const {
+	const uint8_t* p = _image + 4;
+	for (size_t i = 0; i < _modelCount; i++) {
+		bool match = compareName((const char*)p, model) == 0;
+		uint32_t count = readU32(p + NAME_LEN);
+		p += NAME_LEN + 4;
+		for (uint32_t j = 0; j < count; j++) {
+			if (match && compareName((const char*)p, file) == 0) {
+				*offset = readU32(p + NAME_LEN);
+				*size = readU32(p + NAME_LEN + 4);
+				return true;
+			}
+			p += NAME_LEN + 8;
+		}
+	}
+	return false;
+}
+
+bool ModelPack::locateModel(const char* model, uint32_t* offset, uint32_t* size) const {
+	if (!_image || !model) return false;
+
+	uint32_t start = UINT32_MAX;
+	uint32_t end = 0;
+	const uint8_t* p = _image + 4;
+	for (size_t i = 0; i < _modelCount; i++) {
+		bool match = compareName((const char*)p, model) == 0;
+		uint32_t count = readU32(p + NAME_LEN);
+		p += NAME_LEN + 4;
+		for (uint32_t j = 0; j < count; j++) {
+			if (match) {
+				uint32_t fileStart = readU32(p + NAME_LEN);
+				uint32_t fileEnd = fileStart + readU32(p + NAME_LEN + 4);
+				if (fileStart < start) start = fileStart;
+				if (fileEnd > end) end = fileEnd;
+			}
+			p += NAME_LEN + 8;
+		}
+	}
+
+	if (start >= end) return false;
+	*offset = start;
+	*size = end - start;
+	return true;
+}
+
+ModelSpan ModelPack::span(uint32_t offset, uint32_t size) const {
+	if ((size_t)offset + size > _mappedSize) return {nullptr, 0};
+	return {_image + offset, size};
+}
+
+ModelSpan ModelPack::find(const char* model, const char* file) const {
+	uint32_t offset, size;
+	if (!locate(model, file, &offset, &size)) return {nullptr, 0};
+	return span(offset, size);
+}
+
+size_t ModelPack::modelSize(const char* model) const {
+	size_t total = 0;
+	if (!_image || !model) return 0;
+
+	const uint8_t* p = _image + 4;
+	for (size_t i = 0; i < _modelCount; i++) {
+		bool match = compareName((const char*)p, model) == 0;
+		uint32_t count = readU32(p + NAME_LEN);
+		p += NAME_LEN + 4;
+		for (uint32_t j = 0; j < count; j++) {
+			if (match) total += readU32(p + NAME_LEN + 4);
+			p += NAME_LEN + 8;
+		}
+	}
+	return total;
+}
+
+esp_err_t ModelPack::verify(const ModelPackEntry* e) const {
+	if (!_entries) return ESP_ERR_NOT_SUPPORTED;
+	if (!e) return ESP_ERR_NOT_FOUND;
+
+	ModelSpan data = span(e->offset, e->size);
+	if (data.empty()) return ESP_ERR_INVALID_STATE;
+	return crc32(0, data.data, data.size) == e->crc32 ? ESP_OK : ESP_ERR_INVALID_CRC;
+}
+
+esp_err_t ModelPack::verify(const char* model, const char* file) const {
+	if (!_entries) return ESP_ERR_NOT_SUPPORTED;
+	return verify(findEntry(model, file));
+}
+
+esp_err_t ModelPack::verifyModel(const char* model) const {
+	if (!_entries) return ESP_ERR_NOT_SUPPORTED;
+
+	bool found = false;
+	for (size_t i = 0; i < _fileCount; i++) {
+		if (compareName(_entries[i].model, model) != 0) continue;
+		found = true;
+		esp_err_t ret = verify(&_entries[i]);
+		if (ret != ESP_OK) return ret;
+	}
+	return found ? ESP_OK : ESP_ERR_NOT_FOUND;
+}
+
+uint32_t ModelPack::crc32(uint32_t crc, const uint8_t* data, size_t len) {
+#ifdef ESP_PLATFORM
+	return esp_rom_crc32_le(crc, data, len);
+#else
+	// Same polynomial and conditioning as zlib.crc32()
+	crc = ~crc;
+	while (len--) {
+		crc ^= *data++;
+		for (int k = 0; k < 8; k++) {
+			crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+		}
+	}
+	return ~crc;
+#endif
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef ESP_PLATFORM
+#include "esp_err.h"
+#include "esp_partition.h"
+#elif !defined(ESP_OK)
+// Host builds (tools, tests) only need the status codes
+typedef int esp_err_t;
+#define ESP_OK 0
+#define ESP_FAIL -1
+#define ESP_ERR_NO_MEM 0x101
+#define ESP_ERR_INVALID_ARG 0x102
+#define ESP_ERR_INVALID_STATE 0x103
+#define ESP_ERR_INVALID_SIZE 0x104
+#define ESP_ERR_NOT_FOUND 0x105
+#define ESP_ERR_NOT_SUPPORTED 0x106
+#define ESP_ERR_INVALID_CRC 0x109
+#define ESP_ERR_INVALID_VERSION 0x10A
+#endif
+
+/**
+ * Reader for srmodels.bin as written by model/pack_model.py.
+ *
+ * Format version 1 is the original ESP-SR layout (unaligned, no checksums).
+ * Version 2 keeps that header for ESP-SR and adds a sorted, fixed-width index
+ * with per-file CRC32; every file starts on a 64 KB flash MMU page. Spans
+ * returned by find() point straight into the image, nothing is copied.
+ */
+
+struct ModelSpan {
+	const uint8_t* data;
+	size_t size;
+
+	bool empty() const { return data == nullptr; }
+};
+
+struct ModelPackEntry {
+	char model[32];
+	char file[32];
+	uint32_t offset;
+	uint32_t size;
+	uint32_t crc32;
+	uint32_t reserved;
+};
+
+class ModelPack {
+public:
+	static const uint32_t MAGIC = 0x504d5253;  // "SRMP"
+	static const uint16_t VERSION = 2;
+	static const uint32_t MMU_PAGE_SIZE = 0x10000;
+
+	ModelPack();
+	~ModelPack();
+
+	// Parse an image already in memory (host tools, tests)
+	esp_err_t open(const void* image, size_t size);
+#ifdef ESP_PLATFORM
+	// Map the whole partition through the flash MMU and parse it
+	esp_err_t map(const char* label = "model");
+	// Map only the first MMU page (header and index); file spans stay
+	// unavailable until mapped separately, see ModelLoader
+	esp_err_t mapIndex(const char* label = "model");
+	const esp_partition_t* partition() const { return _partition; }
+#endif
+	void close();
+
+	bool isOpen() const { return _image != nullptr; }
+	bool isFullyMapped() const { return _mappedSize >= _size; }
+	size_t imageSize() const { return _size; }
+	uint16_t version() const { return _version; }
+	uint32_t alignment() const { return _alignment; }
+	size_t modelCount() const { return _modelCount; }
+	size_t fileCount() const { return _fileCount; }
+
+	// Version 2 only: entries are sorted by (model, file)
+	const ModelPackEntry* entry(size_t index) const;
+	const ModelPackEntry* findEntry(const char* model, const char* file) const;
+
+	const char* modelName(size_t index) const;
+
+	// Location of a file relative to the start of the image, works without
+	// the data being mapped
+	bool locate(const char* model, const char* file, uint32_t* offset, uint32_t* size) const;
+	// Byte range covering all files of a model
+	bool locateModel(const char* model, uint32_t* offset, uint32_t* size) const;
+
+	ModelSpan find(const char* model, const char* file) const;
+	// Bytes at an image offset, empty if that range is not mapped
+	ModelSpan span(uint32_t offset, uint32_t size) const;
+	// Sum of all file sizes of a model
+	size_t modelSize(const char* model) const;
+
+	// ESP_ERR_NOT_SUPPORTED for version 1 images
+	esp_err_t verify(const ModelPackEntry* entry) const;
+	esp_err_t verify(const char* model, const char* file) const;
+	esp_err_t verifyModel(const char* model) const;
+
+	static uint32_t crc32(uint32_t crc, const uint8_t* data, size_t len);
+
+private:
+	const uint8_t* _image;
+	size_t _size;
+	size_t _mappedSize;
+	uint16_t _version;
+	uint32_t _alignment;
+	size_t _modelCount;
+	size_t _fileCount;
+	size_t _headerLen;
+	const ModelPackEntry* _entries;
+#ifdef ESP_PLATFORM
+	const esp_partition_t* _partition;
+	esp_partition_mmap_handle_t _mmapHandle;
+	bool _mapped;
+#endif
+
+	esp_err_t parse();
+#ifdef ESP_PLATFORM
+	esp_err_t mapRange(const char* label, size_t length);
+#endif
+	bool locateLegacy(const char* model, const char* file, uint32_t* offset, uint32_t* size) const;
+};
@@ -0,0 +1,289 @@
+#include "NnKernels.h"
+#include <string.h>
+
+#if NNKERNELS_SSE
+#include <smmintrin.h>
+#endif
+
+using NnQuant::clampInt8;
+using NnQuant::clampInt16;
+using NnQuant::requantize;
+
+namespace {
+
+NnBackend s_backend = NN_BACKEND_C;
+
+// tanh(x) in Q15 for x = -8 + i / 16, i = 0..256
+const int16_t TANH_Q15[257] = {
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768,
+	-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768, -32767, -32767,
+	-32767, -32767, -32767, -32767, -32767, -32767, -32767, -32766, -32766, -32766, -32766, -32765,
+	-32765, -32765, -32764, -32764, -32763, -32762, -32762, -32761, -32760, -32759, -32758, -32756,
+	-32755, -32753, -32751, -32749, -32746, -32743, -32740, -32736, -32732, -32727, -32721, -32715,
+	-32708, -32700, -32691, -32681, -32670, -32657, -32642, -32625, -32606, -32584, -32560, -32532,
+	-32501, -32466, -32426, -32381, -32329, -32271, -32206, -32132, -32048, -31953, -31846, -31726,
+	-31589, -31435, -31262, -31067, -30847, -30600, -30322, -30010, -29660, -29268, -28830, -28341,
+	-27797, -27191, -26519, -25776, -24956, -24054, -23066, -21986, -20813, -19542, -18173, -16706,
+	-15143, -13486, -11743, -9919, -8025, -6073, -4075, -2045, 0, 2045, 4075, 6073,
+	8025, 9919, 11743, 13486, 15143, 16706, 18173, 19542, 20813, 21986, 23066, 24054,
+	24956, 25776, 26519, 27191, 27797, 28341, 28830, 29268, 29660, 30010, 30322, 30600,
+	30847, 31067, 31262, 31435, 31589, 31726, 31846, 31953, 32048, 32132, 32206, 32271,
+	32329, 32381, 32426, 32466, 32501, 32532, 32560, 32584, 32606, 32625, 32642, 32657,
+	32670, 32681, 32691, 32700, 32708, 32715, 32721, 32727, 32732, 32736, 32740, 32743,
+	32746, 32749, 32751, 32753, 32755, 32756, 32758, 32759, 32760, 32761, 32762, 32762,
+	32763, 32764, 32764, 32765, 32765, 32765, 32766, 32766, 32766, 32766, 32767, 32767,
+	32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767,
+	32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767,
+	32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767,
+	32767, 32767, 32767, 32767, 32767,
+};
+
+#if NNKERNELS_PIE
+// n a multiple of 16, a and b 16-byte aligned. ACCX is 40 bits wide and
+// read back saturated to 32, far above any int8 row this library runs
+int32_t dotVector(const int8_t* a, const int8_t* b, size_t n) {
+	int32_t acc;
+	uint32_t shift = 0;
+	asm volatile("ee.zero.accx");
+	for (size_t i = n / 16; i; i--) {
+		asm volatile(
+			"ee.vld.128.ip q0, %0, 16\n"
+			"ee.vld.128.ip q1, %1, 16\n"
+			"ee.vmulas.s8.accx q0, q1\n"
+			: "+r"(a), "+r"(b) :: "memory");
+	}
+	asm volatile("ee.srs.accx %0, %1, 0" : "=r"(acc) : "r"(shift));
+	return acc;
+}
+#elif NNKERNELS_SSE
+// n a multiple of 16, no alignment needed
+int32_t dotVector(const int8_t* a, const int8_t* b, size_t n) {
+	__m128i acc = _mm_setzero_si128();
+	for (size_t i = 0; i < n; i += 16) {
+		__m128i va = _mm_loadu_si128((const __m128i*)(a + i));
+		__m128i vb = _mm_loadu_si128((const __m128i*)(b + i));
+		acc = _mm_add_epi32(acc, _mm_madd_epi16(_mm_cvtepi8_epi16(va), _mm_cvtepi8_epi16(vb)));
+		acc = _mm_add_epi32(acc, _mm_madd_epi16(_mm_cvtepi8_epi16(_mm_srli_si128(va, 8)), _mm_cvtepi8_epi16(_mm_srli_si128(vb, 8))));
+	}
+	acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, 0x4E));
+	acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, 0xB1));
+	return _mm_cvtsi128_si32(acc);
+}
+#endif
+
+// Same test on every target: aligned, odd offsets and lengths, and the
+// extreme products
+bool vectorMatches() {
+#if NNKERNELS_PIE || NNKERNELS_SSE
+	static const size_t N = 96;
+	alignas(16) int8_t a[N + 16], b[N + 16];
+	uint32_t seed = 0x9E3779B9;
+	for (size_t i = 0; i < N + 16; i++) {
+		seed = seed * 1664525 + 1013904223;
+		a[i] = (int8_t)(seed >> 24);
+		b[i] = (int8_t)(seed >> 16);
+	}
+	a[0] = -128; b[0] = -128;
+	a[1] = -128; b[1] = 127;
+	a[2] = 127; b[2] = 127;
+	for (size_t n = 0; n <= N; n += 16) {
+		if (dotVector(a, b, n) != nnDotReference(a, b, n)) return false;
+	}
+	// All -128: the largest sum the accumulator sees here
+	memset(a, -128, N);
+	memset(b, -128, N);
+	if (dotVector(a, b, N) != nnDotReference(a, b, N)) return false;
+	return true;
+#else
+	return false;
+#endif
+}
+
+// Q12 gate input, clamped to the table range [-8, 8)
+int16_t tanhQ12(int32_t x) {
+	if (x < -32768) x = -32768;
+	if (x > 32767) x = 32767;
+	uint32_t at = (uint32_t)(x + 32768);
+	uint32_t i = at >> 8;
+	int32_t frac = (int32_t)(at & 255);
+	int32_t low = TANH_Q15[i];
+	return (int16_t)(low + (((TANH_Q15[i + 1] - low) * frac) >> 8));
+}
+
+// Gate math shared by both GRU paths; gx and gh hold the Q12 matrix
+// products [z | r | n] of the input and of the hidden state
+void gruGates(uint16_t hidden, const int16_t* gx, const int16_t* gh, int8_t* h) {
+	for (uint16_t j = 0; j < hidden; j++) {
+		int32_t z = nnSigmoidQ15(gx[j] + gh[j]);
+		int32_t r = nnSigmoidQ15(gx[hidden + j] + gh[hidden + j]);
+		int32_t n = nnTanhQ15(gx[2 * hidden + j] + ((r * gh[2 * hidden + j]) >> 15));
+		// h and n in Q15, h = n + z * (h - n)
+		int32_t previous = (int32_t)h[j] << 8;
+		int32_t next = n + ((z * (previous - n)) >> 15);
+		h[j] = clampInt8((next + 128) >> 8);
+	}
+}
+
+}  // namespace
+
+NnBackend nnInit() {
+	static bool tested = false;
+	if (!tested) {
+		tested = true;
+		if (vectorMatches()) s_backend = NNKERNELS_PIE ? NN_BACKEND_PIE : NN_BACKEND_SSE;
+	}
+	return s_backend;
+}
+
+NnBackend nnBackend() {
+	return s_backend;
+}
+
+const char* nnBackendName(NnBackend backend) {
+	switch (backend) {
+	case NN_BACKEND_PIE: return "PIE";
+	case NN_BACKEND_SSE: return "SSE4.1";
+	default: return "C";
+	}
+}
+
+void nnKernelSums(const int8_t* weights, uint16_t rows, uint32_t rowLength, const int32_t* bias, int32_t inputZero, int32_t* out) {
+	for (uint16_t r = 0; r < rows; r++) {
+		int32_t sum = 0;
+		const int8_t* w = weights + (size_t)r * rowLength;
+		for (uint32_t i = 0; i < rowLength; i++) sum += w[i];
+		out[r] = (bias ? bias[r] : 0) - inputZero * sum;
+	}
+}
+
+int32_t nnDotReference(const int8_t* a, const int8_t* b, size_t n) {
+	int32_t acc = 0;
+	for (size_t i = 0; i < n; i++) acc += (int32_t)a[i] * b[i];
+	return acc;
+}
+
+int32_t nnDot(const int8_t* a, const int8_t* b, size_t n) {
+	size_t vector = 0;
+#if NNKERNELS_PIE
+	if (s_backend == NN_BACKEND_PIE && !(((uintptr_t)a | (uintptr_t)b) & 15)) vector = n & ~(size_t)15;
+#elif NNKERNELS_SSE
+	if (s_backend == NN_BACKEND_SSE) vector = n & ~(size_t)15;
+#endif
+	int32_t acc = 0;
+#if NNKERNELS_PIE || NNKERNELS_SSE
+	if (vector) acc = dotVector(a, b, vector);
+#endif
+	return acc + nnDotReference(a + vector, b + vector, n - vector);
+}
+
+void nnConvFrameReference(const NnConv& p, const int8_t* const* rows, int8_t* out) {
+	for (uint16_t o = 0; o < p.outChannels; o++) {
+		int32_t acc = p.bias ? p.bias[o] : 0;
+		const int8_t* w = p.weights + (size_t)o * p.kernel * p.inChannels;
+		for (uint8_t k = 0; k < p.kernel; k++) {
+			const int8_t* x = rows[k];
+			for (uint16_t c = 0; c < p.inChannels; c++) acc += (int32_t)w[c] * (x[c] - p.inputZero);
+			w += p.inChannels;
+		}
+		out[o] = clampInt8(requantize(acc, p.multiplier[o], p.shift[o]) + p.outputZero, p.activationMin, p.activationMax);
+	}
+}
+
+void nnConvFrame(const NnConv& p, const int8_t* const* rows, int8_t* out) {
+	if (!p.kernelSum) {
+		nnConvFrameReference(p, rows, out);
+		return;
+	}
+	for (uint16_t o = 0; o < p.outChannels; o++) {
+		int32_t acc = p.kernelSum[o];
+		const int8_t* w = p.weights + (size_t)o * p.kernel * p.inChannels;
+		for (uint8_t k = 0; k < p.kernel; k++) {
+			acc += nnDot(w, rows[k], p.inChannels);
+			w += p.inChannels;
+		}
+		out[o] = clampInt8(requantize(acc, p.multiplier[o], p.shift[o]) + p.outputZero, p.activationMin, p.activationMax);
+	}
+}
+
+void nnDepthwiseFrameReference(const NnConv& p, const int8_t* const* rows, int8_t* out) {
+	for (uint16_t c = 0; c < p.inChannels; c++) {
+		int32_t acc = p.bias ? p.bias[c] : 0;
+		const int8_t* w = p.weights + (size_t)c * p.kernel;
+		for (uint8_t k = 0; k < p.kernel; k++) acc += (int32_t)w[k] * (rows[k][c] - p.inputZero);
+		out[c] = clampInt8(requantize(acc, p.multiplier[c], p.shift[c]) + p.outputZero, p.activationMin, p.activationMax);
+	}
+}
+
+// Products run along the kernel, a handful of taps per channel, so there is
+// nothing for a 16 lane dot product; only the zero point fold applies
+void nnDepthwiseFrame(const NnConv& p, const int8_t* const* rows, int8_t* out) {
+	if (!p.kernelSum) {
+		nnDepthwiseFrameReference(p, rows, out);
+		return;
+	}
+	for (uint16_t c = 0; c < p.inChannels; c++) {
+		int32_t acc = p.kernelSum[c];
+		const int8_t* w = p.weights + (size_t)c * p.kernel;
+		for (uint8_t k = 0; k < p.kernel; k++) acc += (int32_t)w[k] * rows[k][c];
+		out[c] = clampInt8(requantize(acc, p.multiplier[c], p.shift[c]) + p.outputZero, p.activationMin, p.activationMax);
+	}
+}
+
+size_t nnConv1d(const NnConv& p, const int8_t* input, size_t frames, uint8_t stride, int8_t* output) {
+	if (!p.kernel || p.kernel > NN_MAX_KERNEL || !stride || frames < p.kernel) return 0;
+	const int8_t* rows[NN_MAX_KERNEL];
+	size_t outputs = (frames - p.kernel) / stride + 1;
+	for (size_t t = 0; t < outputs; t++) {
+		const int8_t* first = input + t * stride * p.inChannels;
+		for (uint8_t k = 0; k < p.kernel; k++) rows[k] = first + (size_t)k * p.inChannels;
+		nnConvFrame(p, rows, output + t * p.outChannels);
+	}
+	return outputs;
+}
+
+int16_t nnTanhQ15(int32_t q12) {
+	return tanhQ12(q12);
+}
+
+// sigmoid(x) = (1 + tanh(x / 2)) / 2
+int16_t nnSigmoidQ15(int32_t q12) {
+	return (int16_t)((tanhQ12(q12 >> 1) + 32768) >> 1);
+}
+
+void nnGruStepReference(const NnGru& p, const int8_t* x, int8_t* h, int16_t* scratch) {
+	uint16_t gates = 3 * p.hiddenSize;
+	int16_t* gx = scratch;
+	int16_t* gh = scratch + gates;
+	for (uint16_t j = 0; j < gates; j++) {
+		int32_t acc = p.inputBias ? p.inputBias[j] : 0;
+		const int8_t* w = p.inputWeights + (size_t)j * p.inputSize;
+		for (uint16_t i = 0; i < p.inputSize; i++) acc += (int32_t)w[i] * (x[i] - p.inputZero);
+		gx[j] = clampInt16(requantize(acc, p.inputMultiplier[j], p.inputShift[j]));
+
+		acc = p.hiddenBias ? p.hiddenBias[j] : 0;
+		const int8_t* u = p.hiddenWeights + (size_t)j * p.hiddenSize;
+		for (uint16_t i = 0; i < p.hiddenSize; i++) acc += (int32_t)u[i] * h[i];
+		gh[j] = clampInt16(requantize(acc, p.hiddenMultiplier[j], p.hiddenShift[j]));
+	}
+	gruGates(p.hiddenSize, gx, gh, h);
+}
+
+void nnGruStep(const NnGru& p, const int8_t* x, int8_t* h, int16_t* scratch) {
+	if (!p.inputKernelSum) {
+		nnGruStepReference(p, x, h, scratch);
+		return;
+	}
+	uint16_t gates = 3 * p.hiddenSize;
+	int16_t* gx = scratch;
+	int16_t* gh = scratch + gates;
+	for (uint16_t j = 0; j < gates; j++) {
+		int32_t acc = p.inputKernelSum[j] + nnDot(p.inputWeights + (size_t)j * p.inputSize, x, p.inputSize);
+		gx[j] = clampInt16(requantize(acc, p.inputMultiplier[j], p.inputShift[j]));
+
+		// The hidden state has no zero point, the bias is the whole fold
+		acc = (p.hiddenBias ? p.hiddenBias[j] : 0) + nnDot(p.hiddenWeights + (size_t)j * p.hiddenSize, h, p.hiddenSize);
+		gh[j] = clampInt16(requantize(acc, p.hiddenMultiplier[j], p.hiddenShift[j]));
+	}
+	gruGates(p.hiddenSize, gx, gh, h);
+}
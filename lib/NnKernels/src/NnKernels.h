@@ -0,0 +1,137 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "NnQuant.h"
+
+/**
+ * int8 inference kernels with per output channel quantization.
+ *
+ * Tensors are channels last: a sequence is [frames][channels]. Weights are
+ * symmetric int8, activations int8 with a zero point, accumulators int32
+ * requantized with NnQuant (Q31 multiplier and shift per output channel).
+ *
+ * Every kernel has two paths that give the same bits:
+ * - the reference (the *Reference functions): plain loops over
+ *   sum(w * (x - inputZero)) + bias, the definition
+ * - the fast path: the input zero point is folded into a precomputed
+ *   kernelSum = bias - inputZero * sum(w) (nnKernelSums), so the inner loop
+ *   is a raw int8 dot product. The dot product runs on the ESP32-S3 PIE
+ *   (16 products per instruction, 16-byte aligned operands) or SSE4.1 on
+ *   the host, and in C elsewhere
+ *
+ * The fast path is taken when the parameters carry a kernelSum, otherwise
+ * the reference runs. nnInit() checks the vector dot product against C
+ * once and turns it off if they disagree.
+ */
+
+// CONFIG_IDF_TARGET_* is only defined once sdkconfig.h is in
+#ifdef ESP_PLATFORM
+#include "sdkconfig.h"
+#endif
+
+#if defined(CONFIG_IDF_TARGET_ESP32S3) && !defined(NNKERNELS_NO_PIE)
+#define NNKERNELS_PIE 1
+#else
+#define NNKERNELS_PIE 0
+#endif
+
+#if defined(__SSE4_1__) && !defined(NNKERNELS_NO_SSE)
+#define NNKERNELS_SSE 1
+#else
+#define NNKERNELS_SSE 0
+#endif
+
+// Longest kernel nnConv1d takes
+static const uint8_t NN_MAX_KERNEL = 32;
+
+// Convolution over `kernel` input frames; kernel 1 is a fully connected or
+// pointwise layer
+struct NnConv {
+	uint16_t inChannels;
+	uint16_t outChannels;       // = inChannels for depthwise
+	uint8_t kernel;
+
+	const int8_t* weights;      // conv / fc [out][kernel][in], depthwise [channel][kernel]
+	const int32_t* bias;        // [out], may be null
+	const int32_t* multiplier;  // [out] Q31
+	const int8_t* shift;        // [out] left shift, negative for right
+	const int32_t* kernelSum;   // [out] from nnKernelSums, null for the reference path
+
+	int32_t inputZero;
+	int32_t outputZero;
+	int32_t activationMin;      // output clamp, -128 or outputZero for ReLU
+	int32_t activationMax;
+};
+
+// GRU cell, gates in the order update (z), reset (r), candidate (n):
+//   z = sigmoid(Wz x + Uz h + bz)
+//   r = sigmoid(Wr x + Ur h + br)
+//   n = tanh(Wn x + bxn + r * (Un h + bhn))
+//   h = n + z * (h - n)
+// The hidden state is int8 with scale 1/128 and zero point 0. Both matrix
+// products are requantized to Q12 gate inputs (value * 4096) per row.
+struct NnGru {
+	uint16_t inputSize;
+	uint16_t hiddenSize;
+
+	const int8_t* inputWeights;       // [3 * hidden][input]
+	const int8_t* hiddenWeights;      // [3 * hidden][hidden]
+	const int32_t* inputBias;         // [3 * hidden], may be null
+	const int32_t* hiddenBias;        // [3 * hidden], may be null
+	const int32_t* inputMultiplier;   // [3 * hidden] accumulator to Q12
+	const int8_t* inputShift;
+	const int32_t* hiddenMultiplier;
+	const int8_t* hiddenShift;
+	const int32_t* inputKernelSum;    // [3 * hidden] from nnKernelSums, null for the reference path
+
+	int32_t inputZero;
+};
+
+enum NnBackend : uint8_t {
+	NN_BACKEND_C = 0,
+	NN_BACKEND_PIE,
+	NN_BACKEND_SSE,
+};
+
+// Runs the vector self test once; returns the backend the fast path uses
+NnBackend nnInit();
+NnBackend nnBackend();
+const char* nnBackendName(NnBackend backend);
+
+// out[r] = bias[r] - inputZero * sum(weights[r][0..rowLength))
+void nnKernelSums(const int8_t* weights, uint16_t rows, uint32_t rowLength, const int32_t* bias, int32_t inputZero, int32_t* out);
+// Depthwise weights are [channel][kernel], the sum runs over the kernel
+inline void nnDepthwiseKernelSums(const NnConv& p, int32_t* out) {
+	nnKernelSums(p.weights, p.inChannels, p.kernel, p.bias, p.inputZero, out);
+}
+
+// sum(a[i] * b[i]) over raw int8 values
+int32_t nnDot(const int8_t* a, const int8_t* b, size_t n);
+int32_t nnDotReference(const int8_t* a, const int8_t* b, size_t n);
+
+// One output frame. rows[k] is input frame k of the kernel, oldest first,
+// inChannels values each
+void nnConvFrame(const NnConv& p, const int8_t* const* rows, int8_t* out);
+void nnConvFrameReference(const NnConv& p, const int8_t* const* rows, int8_t* out);
+void nnDepthwiseFrame(const NnConv& p, const int8_t* const* rows, int8_t* out);
+void nnDepthwiseFrameReference(const NnConv& p, const int8_t* const* rows, int8_t* out);
+
+inline void nnFullyConnected(const NnConv& p, const int8_t* in, int8_t* out) {
+	nnConvFrame(p, &in, out);
+}
+inline void nnFullyConnectedReference(const NnConv& p, const int8_t* in, int8_t* out) {
+	nnConvFrameReference(p, &in, out);
+}
+
+// Whole sequence, valid padding: frames input frames give
+// (frames - kernel) / stride + 1 output frames. Returns that count
+size_t nnConv1d(const NnConv& p, const int8_t* input, size_t frames, uint8_t stride, int8_t* output);
+
+// One time step, h updated in place. scratch holds 6 * hiddenSize int16
+void nnGruStep(const NnGru& p, const int8_t* x, int8_t* h, int16_t* scratch);
+void nnGruStepReference(const NnGru& p, const int8_t* x, int8_t* h, int16_t* scratch);
+
+// Activations on Q12 input, Q15 output
+int16_t nnSigmoidQ15(int32_t q12);
+int16_t nnTanhQ15(int32_t q12);
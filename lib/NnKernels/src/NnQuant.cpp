@@ -0,0 +1,27 @@
+#include "NnQuant.h"
+#include <math.h>
+
+namespace NnQuant {
+
+void quantizeMultiplier(double real, int32_t* multiplier, int8_t* shift) {
+	if (real <= 0.0) {
+		*multiplier = 0;
+		*shift = 0;
+		return;
+	}
+	int exponent;
+	double mantissa = frexp(real, &exponent);  // real = mantissa * 2^exponent, mantissa in [0.5, 1)
+	int64_t q = (int64_t)llround(mantissa * (double)(1LL << 31));
+	if (q == (1LL << 31)) {
+		q /= 2;
+		exponent++;
+	}
+	if (exponent < -31) {
+		q = 0;
+		exponent = 0;
+	}
+	*multiplier = (int32_t)q;
+	*shift = (int8_t)exponent;
+}
+
+}  // namespace NnQuant
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * Fixed-point requantization, the TFLite Micro scheme: a real multiplier
+ * m = inputScale * weightScale / outputScale becomes a Q31 mantissa and a
+ * power of two shift, and acc * m is evaluated with one 64-bit product and
+ * a rounding shift. The host and the device give the same bits.
+ */
+namespace NnQuant {
+
+// real > 0; multiplier in [2^30, 2^31), real = multiplier * 2^(shift - 31)
+void quantizeMultiplier(double real, int32_t* multiplier, int8_t* shift);
+
+static inline int32_t requantize(int32_t acc, int32_t multiplier, int8_t shift) {
+	int64_t v = (int64_t)acc * multiplier;
+	int right = 31 - shift;
+	if (right <= 0) return (int32_t)(v << -right);
+	int64_t round = (int64_t)1 << (right - 1);
+	return (int32_t)((v + round) >> right);
+}
+
+static inline int8_t clampInt8(int32_t v, int32_t low = -128, int32_t high = 127) {
+	if (v < low) return (int8_t)low;
+	if (v > high) return (int8_t)high;
+	return (int8_t)v;
+}
+
+static inline int16_t clampInt16(int32_t v) {
+	if (v < -32768) return -32768;
+	if (v > 32767) return 32767;
+	return (int16_t)v;
+}
+
+}  // namespace NnQuant
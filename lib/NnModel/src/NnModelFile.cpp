@@ -0,0 +1,241 @@
+#include "NnModelFile.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef ESP_PLATFORM
+#include <stdio.h>
+#endif
+
+static_assert(sizeof(NnTensorRecord) == 48, "tensor record layout");
+static_assert(sizeof(NnOpRecord) == 32, "op record layout");
+static_assert(sizeof(NnMetaRecord) == 8, "meta record layout");
+
+static inline uint32_t readU32(const uint8_t* p) {
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline uint16_t readU16(const uint8_t* p) {
+	return (uint16_t)p[0] | ((uint16_t)p[1] << 8);
+}
+
+// [offset, offset + count * size) inside the file, records 4-byte aligned
+static inline bool tableFits(uint32_t offset, uint32_t count, uint32_t size, size_t fileLen) {
+	return !(offset & 3) && offset <= fileLen && (uint64_t)count * size <= fileLen - offset;
+}
+
+NnModelFile::NnModelFile() : _data(nullptr), _owned(nullptr) {
+	close();
+}
+
+NnModelFile::~NnModelFile() {
+	close();
+}
+
+void NnModelFile::close() {
+	free(_owned);
+	_owned = nullptr;
+	_data = nullptr;
+	_size = 0;
+	_version = 0;
+	_tensorCount = 0;
+	_opCount = 0;
+	_metaCount = 0;
+	_tensors = nullptr;
+	_ops = nullptr;
+	_meta = nullptr;
+	_strings = nullptr;
+	_stringsLen = 0;
+}
+
+esp_err_t NnModelFile::open(const void* data, size_t size) {
+	close();
+	if (!data || size < HEADER_LEN) return ESP_ERR_INVALID_ARG;
+	if ((uintptr_t)data & (ALIGNMENT - 1)) return ESP_ERR_INVALID_ARG;
+
+	_data = (const uint8_t*)data;
+	_size = size;
+	esp_err_t ret = parse();
+	if (ret != ESP_OK) {
+		_data = nullptr;
+		close();
+	}
+	return ret;
+}
+
+#ifndef ESP_PLATFORM
+esp_err_t NnModelFile::load(const char* path) {
+	close();
+	FILE* f = fopen(path, "rb");
+	if (!f) return ESP_ERR_NOT_FOUND;
+
+	fseek(f, 0, SEEK_END);
+	long length = ftell(f);
+	fseek(f, 0, SEEK_SET);
+	if (length < (long)HEADER_LEN) {
+		fclose(f);
+		return ESP_ERR_INVALID_SIZE;
+	}
+
+	size_t rounded = ((size_t)length + ALIGNMENT - 1) & ~(size_t)(ALIGNMENT - 1);
+	uint8_t* buffer = (uint8_t*)aligned_alloc(ALIGNMENT, rounded);
+	if (!buffer) {
+		fclose(f);
+		return ESP_ERR_NO_MEM;
+	}
+	size_t got = fread(buffer, 1, (size_t)length, f);
+	fclose(f);
+	if (got != (size_t)length) {
+		free(buffer);
+		return ESP_FAIL;
+	}
+
+	esp_err_t ret = open(buffer, (size_t)length);
+	if (ret != ESP_OK) {
+		free(buffer);
+		return ret;
+	}
+	_owned = buffer;
+	return ESP_OK;
+}
+#endif
+
+esp_err_t NnModelFile::parse() {
+	const uint8_t* h = _data;
+	if (readU32(h) != MAGIC) return ESP_ERR_INVALID_ARG;
+	_version = readU16(h + 4);
+	if (_version != VERSION) return ESP_ERR_INVALID_VERSION;
+	if (readU16(h + 6) != HEADER_LEN || readU32(h + 44) != ALIGNMENT) return ESP_ERR_INVALID_ARG;
+	uint32_t fileLen = readU32(h + 8);
+	if (fileLen > _size) return ESP_ERR_INVALID_SIZE;
+	// A mapped span may be longer than the container, never shorter
+	_size = fileLen;
+
+	_tensorCount = readU16(h + 16);
+	_opCount = readU16(h + 18);
+	_metaCount = readU16(h + 20);
+	uint32_t tensorsOffset = readU32(h + 24);
+	uint32_t opsOffset = readU32(h + 28);
+	uint32_t metaOffset = readU32(h + 32);
+	uint32_t stringsOffset = readU32(h + 36);
+	_stringsLen = readU32(h + 40);
+
+	if (!tableFits(tensorsOffset, _tensorCount, sizeof(NnTensorRecord), _size) ||
+		!tableFits(opsOffset, _opCount, sizeof(NnOpRecord), _size) ||
+		!tableFits(metaOffset, _metaCount, sizeof(NnMetaRecord), _size) ||
+		stringsOffset > _size || _stringsLen > _size - stringsOffset) {
+		return ESP_ERR_INVALID_SIZE;
+	}
+	if (!_tensorCount || _tensorCount == NN_NO_TENSOR || !_opCount) return ESP_ERR_INVALID_ARG;
+	// Every name and value is NUL terminated inside the table
+	if (!_stringsLen || _data[stringsOffset + _stringsLen - 1] != 0) return ESP_ERR_INVALID_ARG;
+
+	_tensors = (const NnTensorRecord*)(_data + tensorsOffset);
+	_ops = (const NnOpRecord*)(_data + opsOffset);
+	_meta = (const NnMetaRecord*)(_data + metaOffset);
+	_strings = (const char*)(_data + stringsOffset);
+
+	for (uint16_t i = 0; i < _tensorCount; i++) {
+		const NnTensorRecord& t = _tensors[i];
+		size_t element = typeSize(t.type);
+		if (!element || !t.rank || t.rank > 4 || !validString(t.name)) return ESP_ERR_INVALID_ARG;
+		uint64_t count = 1;
+		for (uint8_t d = 0; d < 4; d++) {
+			if (!t.dims[d] || (d >= t.rank && t.dims[d] != 1)) return ESP_ERR_INVALID_ARG;
+			count *= t.dims[d];
+		}
+		if (!t.dataOffset) {
+			if (t.dataSize) return ESP_ERR_INVALID_ARG;
+			continue;
+		}
+		if (t.dataOffset & (ALIGNMENT - 1) || t.dataOffset < HEADER_LEN) return ESP_ERR_INVALID_ARG;
+		if (t.dataOffset > _size || t.dataSize > _size - t.dataOffset) return ESP_ERR_INVALID_SIZE;
+		if (count * element != t.dataSize) return ESP_ERR_INVALID_SIZE;
+	}
+
+	for (uint16_t i = 0; i < _opCount; i++) {
+		const NnOpRecord& o = _ops[i];
+		if (o.output >= _tensorCount || _tensors[o.output].dataOffset) return ESP_ERR_INVALID_ARG;
+		if (!o.inputCount || o.inputCount > 12) return ESP_ERR_INVALID_ARG;
+		for (uint16_t k = 0; k < o.inputCount; k++) {
+			if (o.inputs[k] != NN_NO_TENSOR && o.inputs[k] >= _tensorCount) return ESP_ERR_INVALID_ARG;
+		}
+		if (o.inputs[0] == NN_NO_TENSOR) return ESP_ERR_INVALID_ARG;
+	}
+
+	for (uint16_t i = 0; i < _metaCount; i++) {
+		if (!validString(_meta[i].key) || !validString(_meta[i].value)) return ESP_ERR_INVALID_ARG;
+	}
+	return ESP_OK;
+}
+
+bool NnModelFile::validString(uint32_t offset) const {
+	return offset < _stringsLen;
+}
+
+esp_err_t NnModelFile::verify() const {
+	if (!_data) return ESP_ERR_INVALID_STATE;
+	uint32_t expected = readU32(_data + 12);
+	return ModelPack::crc32(0, _data + HEADER_LEN, _size - HEADER_LEN) == expected ? ESP_OK : ESP_ERR_INVALID_CRC;
+}
+
+size_t NnModelFile::typeSize(uint8_t type) {
+	switch (type) {
+	case NN_TENSOR_INT8: return 1;
+	case NN_TENSOR_INT32: return 4;
+	case NN_TENSOR_FLOAT32: return 4;
+	default: return 0;
+	}
+}
+
+const NnTensorRecord* NnModelFile::tensor(uint16_t index) const {
+	return index < _tensorCount ? &_tensors[index] : nullptr;
+}
+
+const char* NnModelFile::tensorName(uint16_t index) const {
+	return index < _tensorCount ? _strings + _tensors[index].name : nullptr;
+}
+
+uint16_t NnModelFile::findTensor(const char* name) const {
+	for (uint16_t i = 0; i < _tensorCount; i++) {
+		if (!strcmp(_strings + _tensors[i].name, name)) return i;
+	}
+	return NN_NO_TENSOR;
+}
+
+const void* NnModelFile::tensorData(uint16_t index) const {
+	if (index >= _tensorCount || !_tensors[index].dataOffset) return nullptr;
+	return _data + _tensors[index].dataOffset;
+}
+
+uint32_t NnModelFile::tensorElements(uint16_t index) const {
+	if (index >= _tensorCount) return 0;
+	const NnTensorRecord& t = _tensors[index];
+	return t.dims[0] * t.dims[1] * t.dims[2] * t.dims[3];
+}
+
+const NnOpRecord* NnModelFile::op(uint16_t index) const {
+	return index < _opCount ? &_ops[index] : nullptr;
+}
+
+const char* NnModelFile::meta(const char* key) const {
+	for (uint16_t i = 0; i < _metaCount; i++) {
+		if (!strcmp(_strings + _meta[i].key, key)) return _strings + _meta[i].value;
+	}
+	return nullptr;
+}
+
+int32_t NnModelFile::metaInt(const char* key, int32_t fallback) const {
+	const char* value = meta(key);
+	if (!value || !*value) return fallback;
+	char* end;
+	long v = strtol(value, &end, 0);
+	return *end ? fallback : (int32_t)v;
+}
+
+float NnModelFile::metaFloat(const char* key, float fallback) const {
+	const char* value = meta(key);
+	if (!value || !*value) return fallback;
+	char* end;
+	float v = strtof(value, &end);
+	return *end ? fallback : v;
+}
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "ModelPack.h"
+
+/**
+ * Reader for .nnm model containers as written by model/pack_nnm.py.
+ *
+ * A container holds a network as tensors (shape, type, quantization,
+ * optional constant data) and an operator graph over them, plus string
+ * metadata. Constant data starts on a 16-byte boundary of the file, and
+ * files in srmodels.bin start on a 64 KB page, so once ModelLoader has
+ * mapped the model the weights are used in place: nothing is copied or
+ * converted, the tables point into flash.
+ *
+ * Layout (little endian, version 1):
+ * {
+ *     magic: char[4]              // "NNMF"
+ *     version: uint16             // 1
+ *     header_len: uint16          // 64
+ *     file_len: uint32
+ *     crc32: uint32               // of bytes [header_len, file_len)
+ *     tensor_count: uint16
+ *     op_count: uint16
+ *     meta_count: uint16
+ *     reserved: uint16
+ *     tensors_offset: uint32      // NnTensorRecord[tensor_count]
+ *     ops_offset: uint32          // NnOpRecord[op_count]
+ *     meta_offset: uint32         // NnMetaRecord[meta_count]
+ *     strings_offset: uint32      // NUL terminated names and values
+ *     strings_len: uint32
+ *     alignment: uint32           // 16, of every data_offset
+ *     reserved: uint32[4]
+ * }
+ *
+ * The same reader runs on the device over a mapped span and on the host
+ * over a file read with load(), so host tools check exactly what ships.
+ */
+
+enum NnTensorType : uint8_t {
+	NN_TENSOR_INT8 = 1,
+	NN_TENSOR_INT32 = 2,
+	NN_TENSOR_FLOAT32 = 3,
+};
+
+// Numbered like KwsOp for the first four
+enum NnOpType : uint8_t {
+	// inputs: x, weights [out][kernel][in], bias, multiplier, shift
+	NN_OP_CONV = 0,
+	// inputs: x, weights [channels][kernel], bias, multiplier, shift
+	NN_OP_DEPTHWISE = 1,
+	// inputs: x
+	NN_OP_AVGPOOL = 2,
+	// inputs: x, weights [out][in], bias, multiplier, shift
+	NN_OP_FC = 3,
+	// inputs: x, input weights [3h][in], hidden weights [3h][h], input bias,
+	// hidden bias, input multiplier, input shift, hidden multiplier, hidden shift
+	NN_OP_GRU = 4,
+};
+
+static const uint16_t NN_NO_TENSOR = 0xFFFF;
+static const uint8_t NN_OP_FLAG_RELU = 0x01;
+
+struct NnTensorRecord {
+	uint32_t name;         // strings offset
+	uint8_t type;          // NnTensorType
+	uint8_t rank;
+	uint16_t flags;
+	uint32_t dims[4];      // unused dims are 1
+	uint32_t dataOffset;   // from the file start, 0 for activations
+	uint32_t dataSize;
+	float scale;           // real = (q - zeroPoint) * scale, 0 for raw integers
+	int32_t zeroPoint;
+	uint32_t reserved[2];
+};
+
+struct NnOpRecord {
+	uint8_t type;          // NnOpType
+	uint8_t kernel;
+	uint8_t stride;
+	uint8_t flags;         // NN_OP_FLAG_*
+	uint16_t output;
+	uint16_t inputCount;
+	uint16_t inputs[12];   // tensor indices, NN_NO_TENSOR for an absent optional input
+};
+
+struct NnMetaRecord {
+	uint32_t key;          // strings offset
+	uint32_t value;
+};
+
+class NnModelFile {
+public:
+	static const uint32_t MAGIC = 0x464d4e4e;  // "NNMF"
+	static const uint16_t VERSION = 1;
+	static const uint32_t HEADER_LEN = 64;
+	static const uint32_t ALIGNMENT = 16;
+
+	NnModelFile();
+	~NnModelFile();
+
+	// Parse a container in memory, base 16-byte aligned. Checks every
+	// offset, size and index; the CRC is left to verify()
+	esp_err_t open(const void* data, size_t size);
+	esp_err_t open(const ModelSpan& span) { return open(span.data, span.size); }
+#ifndef ESP_PLATFORM
+	// Host: read a whole file into an owned aligned buffer and open it
+	esp_err_t load(const char* path);
+#endif
+	void close();
+	// CRC32 of the body against the header
+	esp_err_t verify() const;
+
+	bool isOpen() const { return _data != nullptr; }
+	size_t size() const { return _size; }
+	uint16_t version() const { return _version; }
+
+	uint16_t tensorCount() const { return _tensorCount; }
+	const NnTensorRecord* tensor(uint16_t index) const;
+	const char* tensorName(uint16_t index) const;
+	// NN_NO_TENSOR if absent
+	uint16_t findTensor(const char* name) const;
+	// Constant data in place, nullptr for activations
+	const void* tensorData(uint16_t index) const;
+	uint32_t tensorElements(uint16_t index) const;
+
+	uint16_t opCount() const { return _opCount; }
+	const NnOpRecord* op(uint16_t index) const;
+
+	uint16_t metaCount() const { return _metaCount; }
+	const char* meta(const char* key) const;
+	int32_t metaInt(const char* key, int32_t fallback) const;
+	float metaFloat(const char* key, float fallback) const;
+
+	static size_t typeSize(uint8_t type);
+
+private:
+	const uint8_t* _data;
+	size_t _size;
+	uint8_t* _owned;
+	uint16_t _version;
+	uint16_t _tensorCount;
+	uint16_t _opCount;
+	uint16_t _metaCount;
+	const NnTensorRecord* _tensors;
+	const NnOpRecord* _ops;
+	const NnMetaRecord* _meta;
+	const char* _strings;
+	uint32_t _stringsLen;
+
+	esp_err_t parse();
+	bool validString(uint32_t offset) const;
+};
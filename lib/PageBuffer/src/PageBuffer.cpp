@@ -0,0 +1,244 @@
+#include "PageBuffer.h"
+#include <string.h>
+
+namespace {
+
+// Word access to byte buffers
+typedef uint32_t __attribute__((may_alias)) word_t;
+
+inline bool aligned(const void* p, uintptr_t n) {
+	return ((uintptr_t)p & (n - 1)) == 0;
+}
+
+inline void applyByte(uint8_t* p, uint8_t mask, PageOp op) {
+	switch (op) {
+	case PageOp::Clear: *p &= ~mask; break;
+	case PageOp::Set: *p |= mask; break;
+	case PageOp::Xor: *p ^= mask; break;
+	}
+}
+
+#if PAGEBUFFER_PIE
+// One asm statement per op, so nothing the compiler schedules in between
+// can clobber q1: broadcast the mask byte into q1, then chunks x 16 bytes
+// from p (16-byte aligned) through OP with it
+#define PAGEBUFFER_VECTOR_LOOP(OP) \
+	asm volatile( \
+		"ee.vldbc.8 q1, %2\n" \
+		"beqz %1, 2f\n" \
+		"1:\n" \
+		"ee.vld.128.ip q0, %0, 0\n" \
+		OP " q0, q0, q1\n" \
+		"ee.vst.128.ip q0, %0, 16\n" \
+		"addi %1, %1, -1\n" \
+		"bnez %1, 1b\n" \
+		"2:\n" \
+		: "+r"(p), "+r"(chunks) : "r"(&value) : "memory")
+
+void applyVectors(uint8_t*& p, size_t chunks, uint8_t mask, PageOp op) {
+	uint8_t value = op == PageOp::Clear ? (uint8_t)~mask : mask;
+	switch (op) {
+	case PageOp::Clear: PAGEBUFFER_VECTOR_LOOP("ee.andq"); break;
+	case PageOp::Set: PAGEBUFFER_VECTOR_LOOP("ee.orq"); break;
+	case PageOp::Xor: PAGEBUFFER_VECTOR_LOOP("ee.xorq"); break;
+	}
+}
+
+#undef PAGEBUFFER_VECTOR_LOOP
+#endif
+
+void applyWords(uint8_t*& p, size_t words, uint8_t mask, PageOp op) {
+	uint32_t m = mask * 0x01010101u;
+	word_t* w = (word_t*)p;
+	switch (op) {
+	case PageOp::Clear: for (size_t i = 0; i < words; i++) w[i] &= ~m; break;
+	case PageOp::Set: for (size_t i = 0; i < words; i++) w[i] |= m; break;
+	case PageOp::Xor: for (size_t i = 0; i < words; i++) w[i] ^= m; break;
+	}
+	p += words * 4;
+}
+
+// Clamp [a, a + len) to [0, limit), false if nothing is left
+inline bool clip(int16_t& a, int16_t& len, int16_t limit) {
+	int32_t lo = a, hi = (int32_t)a + len;
+	if (lo < 0) lo = 0;
+	if (hi > limit) hi = limit;
+	if (lo >= hi) return false;
+	a = lo;
+	len = hi - lo;
+	return true;
+}
+
+}  // namespace
+
+PageBuffer::PageBuffer(uint8_t* data, uint16_t width, uint16_t height)
+	: _data(data), _width(width), _height(height) {}
+
+void PageBuffer::apply(uint8_t* p, size_t n, uint8_t mask, PageOp op) {
+	if (op == PageOp::Set && mask == 0xFF) {
+		memset(p, 0xFF, n);
+		return;
+	}
+	if (op == PageOp::Clear && mask == 0xFF) {
+		memset(p, 0, n);
+		return;
+	}
+
+#if PAGEBUFFER_PIE
+	while (n && !aligned(p, 16)) {
+		applyByte(p++, mask, op);
+		n--;
+	}
+	applyVectors(p, n / 16, mask, op);
+	n &= 15;
+#else
+	while (n && !aligned(p, 4)) {
+		applyByte(p++, mask, op);
+		n--;
+	}
+#endif
+	applyWords(p, n / 4, mask, op);
+	n &= 3;
+	while (n--) applyByte(p++, mask, op);
+}
+
+void PageBuffer::clear(uint8_t value) {
+	memset(_data, value, size());
+}
+
+void PageBuffer::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, PageOp op) {
+	if (!clip(x, w, _width) || !clip(y, h, _height)) return;
+
+	int16_t end = y + h;
+	for (int16_t page = y / 8; page * 8 < end; page++) {
+		int16_t top = page * 8;
+		uint8_t mask = 0xFF;
+		if (y > top) mask &= 0xFF << (y - top);
+		if (end < top + 8) mask &= 0xFF >> (top + 8 - end);
+		apply(_data + page * _width + x, w, mask, op);
+	}
+}
+
+void PageBuffer::hspan(int16_t x, int16_t y, int16_t w, PageOp op) {
+	if (y < 0 || y >= _height || !clip(x, w, _width)) return;
+	apply(_data + (y / 8) * _width + x, w, 1 << (y & 7), op);
+}
+
+void PageBuffer::vspan(int16_t x, int16_t y, int16_t h, PageOp op) {
+	if (x < 0 || x >= _width || !clip(y, h, _height)) return;
+
+	int16_t end = y + h;
+	for (int16_t page = y / 8; page * 8 < end; page++) {
+		int16_t top = page * 8;
+		uint8_t mask = 0xFF;
+		if (y > top) mask &= 0xFF << (y - top);
+		if (end < top + 8) mask &= 0xFF >> (top + 8 - end);
+		applyByte(_data + page * _width + x, mask, op);
+	}
+}
+
+void PageBuffer::xorWith(const uint8_t* src) {
+	uint8_t* p = _data;
+	size_t n = size();
+#if PAGEBUFFER_PIE
+	if (aligned(p, 16) && aligned(src, 16)) {
+		for (size_t i = n / 16; i; i--) {
+			asm volatile(
+				"ee.vld.128.ip q0, %0, 0\n"
+				"ee.vld.128.ip q1, %1, 16\n"
+				"ee.xorq q0, q0, q1\n"
+				"ee.vst.128.ip q0, %0, 16\n"
+				: "+r"(p), "+r"(src) :: "memory");
+		}
+		n &= 15;
+	}
+#endif
+#ifdef ESP_PLATFORM
+	if (aligned(p, 4) && aligned(src, 4)) {
+		for (; n >= 4; n -= 4, p += 4, src += 4) {
+			*(word_t*)p ^= *(const word_t*)src;
+		}
+	}
+#else
+	// 16-byte blocks the host compiler turns into vector ops; src goes
+	// through a copy so it needs no alias check
+	for (; n >= 16; n -= 16, p += 16, src += 16) {
+		uint8_t s[16];
+		memcpy(s, src, 16);
+		for (int i = 0; i < 16; i++) p[i] ^= s[i];
+	}
+#endif
+	while (n--) *p++ ^= *src++;
+}
+
+void PageBuffer::blitMasked(const uint8_t* src, const uint8_t* mask) {
+	uint8_t* p = _data;
+	size_t n = size();
+#if PAGEBUFFER_PIE
+	if (aligned(p, 16) && aligned(src, 16) && aligned(mask, 16)) {
+		for (size_t i = n / 16; i; i--) {
+			// p ^ ((p ^ src) & mask)
+			asm volatile(
+				"ee.vld.128.ip q0, %0, 0\n"
+				"ee.vld.128.ip q1, %1, 16\n"
+				"ee.vld.128.ip q2, %2, 16\n"
+				"ee.xorq q1, q1, q0\n"
+				"ee.andq q1, q1, q2\n"
+				"ee.xorq q0, q0, q1\n"
+				"ee.vst.128.ip q0, %0, 16\n"
+				: "+r"(p), "+r"(src), "+r"(mask) :: "memory");
+		}
+		n &= 15;
+	}
+#endif
+#ifdef ESP_PLATFORM
+	if (aligned(p, 4) && aligned(src, 4) && aligned(mask, 4)) {
+		for (; n >= 4; n -= 4, p += 4, src += 4, mask += 4) {
+			word_t d = *(word_t*)p;
+			*(word_t*)p = d ^ ((d ^ *(const word_t*)src) & *(const word_t*)mask);
+		}
+	}
+#else
+	for (; n >= 16; n -= 16, p += 16, src += 16, mask += 16) {
+		uint8_t s[16], m[16];
+		memcpy(s, src, 16);
+		memcpy(m, mask, 16);
+		for (int i = 0; i < 16; i++) p[i] ^= (p[i] ^ s[i]) & m[i];
+	}
+#endif
+	for (; n; n--, p++, src++, mask++) {
+		*p ^= (*p ^ *src) & *mask;
+	}
+}
+
+void PageBuffer::loadXbm(const uint8_t* xbm, uint16_t w, uint16_t h) {
+	if (h > _height) h = _height;
+	uint16_t pages = (h + 7) / 8;
+	xbmToPages(xbm, w, h, _data, _width);
+	memset(_data + pages * _width, 0, size() - pages * _width);
+}
+
+void PageBuffer::xbmToPages(const uint8_t* xbm, uint16_t w, uint16_t h, uint8_t* pages, uint16_t pageWidth) {
+	uint16_t stride = (w + 7) / 8;
+	uint16_t width = w < pageWidth ? w : pageWidth;
+	for (uint16_t page = 0; page * 8 < h; page++) {
+		uint8_t* out = pages + page * pageWidth;
+		uint8_t rows = h - page * 8 < 8 ? h - page * 8 : 8;
+		const uint8_t* in = xbm + page * 8 * stride;
+
+		for (uint16_t x = 0; x < width; x += 8) {
+			// byte r = XBM byte of row r, bit c = column c
+			uint64_t m = 0;
+			for (uint8_t r = 0; r < rows; r++) {
+				m |= (uint64_t)in[r * stride + x / 8] << (r * 8);
+			}
+			m = transpose8x8(m);
+
+			uint8_t cols = width - x < 8 ? width - x : 8;
+			for (uint8_t c = 0; c < cols; c++) {
+				out[x + c] = (uint8_t)(m >> (c * 8));
+			}
+		}
+		memset(out + width, 0, pageWidth - width);
+	}
+}
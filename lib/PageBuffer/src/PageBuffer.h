@@ -0,0 +1,87 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * 1bpp frame buffer primitives for the SSD1306 page layout, which is also
+ * U8g2's full buffer layout: one byte per column and page, bit (y & 7) of
+ * byte [(y / 8) * width + x] is pixel (x, y).
+ *
+ * Byte runs are processed 16 bytes at a time with the ESP32-S3 PIE vector
+ * unit when the pointers are 16-byte aligned, otherwise a word at a time.
+ * Other targets use the word path only. On the host xorWith and blitMasked
+ * go 16 bytes at a time in plain C++ the compiler vectorizes. Drawing clips
+ * to the buffer like U8g2 does.
+ */
+
+// CONFIG_IDF_TARGET_* is only defined once sdkconfig.h is in
+#ifdef ESP_PLATFORM
+#include "sdkconfig.h"
+#endif
+
+#if defined(CONFIG_IDF_TARGET_ESP32S3) && !defined(PAGEBUFFER_NO_PIE)
+#define PAGEBUFFER_PIE 1
+#else
+#define PAGEBUFFER_PIE 0
+#endif
+
+// Same numbering as U8g2 draw colors
+enum class PageOp : uint8_t {
+	Clear = 0,
+	Set = 1,
+	Xor = 2,
+};
+
+class PageBuffer {
+public:
+	// width pixels by height pixels, height a multiple of 8
+	PageBuffer(uint8_t* data, uint16_t width, uint16_t height);
+
+	uint8_t* data() const { return _data; }
+	uint16_t width() const { return _width; }
+	uint16_t height() const { return _height; }
+	size_t size() const { return (size_t)_width * (_height / 8); }
+
+	// Every byte to value, 0x00 or 0xFF for a blank or lit screen
+	void clear(uint8_t value = 0);
+	void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, PageOp op = PageOp::Set);
+	void hspan(int16_t x, int16_t y, int16_t w, PageOp op = PageOp::Set);
+	void vspan(int16_t x, int16_t y, int16_t h, PageOp op = PageOp::Set);
+
+	// Whole-frame operations with another buffer of the same size
+	void xorWith(const uint8_t* src);
+	// Pixels where mask is set come from src, the rest are kept
+	void blitMasked(const uint8_t* src, const uint8_t* mask);
+
+	// Replace the frame with a w x h XBM image (rows of (w + 7) / 8 bytes,
+	// LSB first) at the top left corner, pixels outside it are cleared.
+	// Same result as clearBuffer() and drawXBMP(0, 0, w, h, xbm)
+	void loadXbm(const uint8_t* xbm, uint16_t w, uint16_t h);
+
+	// XBM rows to pages: pages gets pageWidth bytes per page for
+	// (h + 7) / 8 pages. Columns past pageWidth are dropped, columns past
+	// w are cleared
+	static void xbmToPages(const uint8_t* xbm, uint16_t w, uint16_t h, uint8_t* pages, uint16_t pageWidth);
+
+	// 8x8 bit matrix transpose, bit (8 * r + c) moves to bit (8 * c + r).
+	// Turns eight row bytes into eight column bytes and back
+	static inline uint64_t transpose8x8(uint64_t m) {
+		uint64_t t;
+		t = (m ^ (m >> 7)) & 0x00AA00AA00AA00AAULL;
+		m = m ^ t ^ (t << 7);
+		t = (m ^ (m >> 14)) & 0x0000CCCC0000CCCCULL;
+		m = m ^ t ^ (t << 14);
+		t = (m ^ (m >> 28)) & 0x00000000F0F0F0F0ULL;
+		m = m ^ t ^ (t << 28);
+		return m;
+	}
+
+	// n bytes at p: op with the same bit mask in every byte
+	static void apply(uint8_t* p, size_t n, uint8_t mask, PageOp op);
+
+private:
+	uint8_t* _data;
+	uint16_t _width;
+	uint16_t _height;
+};
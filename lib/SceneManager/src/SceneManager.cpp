@@ -0,0 +1,118 @@
+#include "SceneManager.h"
+#include <string.h>
+
+SceneManager::SceneManager(Scene& base) : _depth(1), _routeCount(0), _active(nullptr) {
+	_stack[0] = {&base, nullptr, 0, false};
+}
+
+bool SceneManager::show(const char* event, Scene& scene) {
+	return addRoute(event, scene, false);
+}
+
+bool SceneManager::dismiss(const char* event, Scene& scene) {
+	return addRoute(event, scene, true);
+}
+
+bool SceneManager::addRoute(const char* event, Scene& scene, bool dismiss) {
+	if (!event || _routeCount >= MAX_ROUTES) return false;
+	_routes[_routeCount++] = {event, &scene, dismiss};
+	return true;
+}
+
+bool SceneManager::handle(const char* event) {
+	if (!event) return false;
+
+	bool matched = false;
+	for (size_t i = 0; i < _routeCount; i++) {
+		const Route& route = _routes[i];
+		if (route.event != event && strcmp(route.event, event) != 0) continue;
+
+		if (route.dismiss) {
+			remove(*route.scene);
+		} else {
+			push(*route.scene, event);
+		}
+		matched = true;
+	}
+	return matched;
+}
+
+void SceneManager::push(Scene& scene, const char* event) {
+	if (&scene == _stack[0].scene) return;
+
+	int index = find(scene);
+	if (index > 0) erase(index);
+	if (&scene == _active) {
+		// Restart: exit now, enter again on the next tick with the new event
+		if (scene.exit) scene.exit(scene.arg);
+		_active = nullptr;
+	}
+
+	if (_depth == MAX_DEPTH) {
+		// Full: drop the lowest pushed scene, unless that is the new one
+		if (scene.priority < _stack[1].scene->priority) return;
+		erase(1);
+	}
+
+	size_t at = _depth;
+	while (at > 1 && _stack[at - 1].scene->priority > scene.priority) at--;
+	memmove(&_stack[at + 1], &_stack[at], (_depth - at) * sizeof(Entry));
+	_stack[at] = {&scene, event, 0, false};
+	_depth++;
+}
+
+void SceneManager::remove(Scene& scene) {
+	int index = find(scene);
+	if (index <= 0) return;
+	erase(index);
+}
+
+void SceneManager::tick(DisplayBackend& display, uint32_t now) {
+	activate(now);
+
+	Entry& top = _stack[_depth - 1];
+	Scene& scene = *top.scene;
+
+	uint32_t start = micros();
+	scene.tick(display, now - top.startedAt, scene.arg);
+	uint32_t elapsed = micros() - start;
+	display.flush();
+
+	scene.stats.frames++;
+	scene.stats.lastUs = elapsed;
+	scene.stats.totalUs += elapsed;
+	if (elapsed > scene.stats.maxUs) scene.stats.maxUs = elapsed;
+	if (display.lastFlushUs() > scene.stats.flushMaxUs) scene.stats.flushMaxUs = display.lastFlushUs();
+}
+
+int SceneManager::find(const Scene& scene) const {
+	for (size_t i = 0; i < _depth; i++) {
+		if (_stack[i].scene == &scene) return i;
+	}
+	return -1;
+}
+
+void SceneManager::erase(size_t index) {
+	memmove(&_stack[index], &_stack[index + 1], (_depth - index - 1) * sizeof(Entry));
+	_depth--;
+}
+
+bool SceneManager::expired(const Entry& entry, uint32_t now) const {
+	return entry.started && entry.scene->durationMs && now - entry.startedAt >= entry.scene->durationMs;
+}
+
+void SceneManager::activate(uint32_t now) {
+	// Timed scenes that ran out, including ones that did so while preempted
+	while (_depth > 1 && expired(_stack[_depth - 1], now)) _depth--;
+
+	Entry& top = _stack[_depth - 1];
+	if (top.scene == _active) return;
+
+	if (_active && _active->exit) _active->exit(_active->arg);
+	if (!top.started) {
+		top.startedAt = now;
+		top.started = true;
+	}
+	_active = top.scene;
+	if (_active->enter) _active->enter(top.event, _active->arg);
+}
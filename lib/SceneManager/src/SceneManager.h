@@ -0,0 +1,95 @@
+#pragma once
+
+#include <Arduino.h>
+#include "DisplayBackend.h"
+
+/**
+ * Display scenes on a priority stack.
+ *
+ * The base scene (e.g. the sound detector) sits at the bottom and is never
+ * removed. Other scenes are pushed by events and kept ordered by priority:
+ * a scene with a higher or equal priority than the one on top preempts it,
+ * a lower one waits underneath until the scenes above it are gone. A timed
+ * scene is removed durationMs after it first came on top, also while it was
+ * preempted, so a paused scene that ran out is dropped when it resurfaces.
+ *
+ * Stack changes take effect on the next tick(), so an event that dismisses
+ * one scene and shows another only runs the hooks of the final top scene.
+ * Hooks run on the render loop and must not block. tick() draws one frame
+ * into display.gfx() and the manager flushes it.
+ */
+struct SceneStats {
+	uint32_t frames;
+	uint32_t lastUs;   // tick hook, without the flush
+	uint32_t maxUs;
+	uint32_t totalUs;
+	uint32_t flushMaxUs;
+};
+
+typedef void (*SceneEnter)(const char* event, void* arg);
+typedef void (*SceneExit)(void* arg);
+// elapsedMs counts from the first time the scene came on top
+typedef void (*SceneTick)(DisplayBackend& display, uint32_t elapsedMs, void* arg);
+
+struct Scene {
+	const char* name;
+	uint8_t priority;
+	uint32_t durationMs;  // 0: until dismissed
+	SceneEnter enter;     // optional
+	SceneExit exit;       // optional
+	SceneTick tick;
+	void* arg;
+	SceneStats stats;
+};
+
+class SceneManager {
+public:
+	static const size_t MAX_DEPTH = 6;
+	static const size_t MAX_ROUTES = 16;
+
+	explicit SceneManager(Scene& base);
+
+	// Event routes, compared by string content. One event can have several
+	// routes, they run in the order they were added
+	bool show(const char* event, Scene& scene);
+	bool dismiss(const char* event, Scene& scene);
+
+	// Runs the routes for event, false if none matched
+	bool handle(const char* event);
+
+	// Pushing a scene that is already on the stack restarts it with the new event
+	void push(Scene& scene, const char* event);
+	void remove(Scene& scene);
+
+	// Drops expired scenes, draws the top one and flushes the display
+	void tick(DisplayBackend& display, uint32_t now);
+
+	Scene& current() const { return *_stack[_depth - 1].scene; }
+	size_t depth() const { return _depth; }
+
+private:
+	struct Entry {
+		Scene* scene;
+		const char* event;
+		uint32_t startedAt;
+		bool started;
+	};
+
+	struct Route {
+		const char* event;
+		Scene* scene;
+		bool dismiss;
+	};
+
+	Entry _stack[MAX_DEPTH];
+	size_t _depth;
+	Route _routes[MAX_ROUTES];
+	size_t _routeCount;
+	Scene* _active;  // scene whose enter() ran last
+
+	bool addRoute(const char* event, Scene& scene, bool dismiss);
+	int find(const Scene& scene) const;
+	void erase(size_t index);
+	bool expired(const Entry& entry, uint32_t now) const;
+	void activate(uint32_t now);
+};
@@ -0,0 +1,91 @@
+#include "SrWatchdog.h"
+#include <string.h>
+
+static const uint32_t WINDOW_MS = 1000;
+static const uint32_t STEADY_MS = 250;
+
+SrWatchdog::SrWatchdog(const SrWatchdogConfig& config)
+	: _config(config), _lastFillMs(0), _lastAudioMs(0), _firstAudioMs(0), _recoverSamples(0), _windowSamples(0), _windowStartMs(0),
+	  _slowWindows(0), _recovering(false), _step(0), _detectedMs(0), _outageStartMs(0), _stepMs(0) {
+	memset(&_stats, 0, sizeof(_stats));
+}
+
+void SrWatchdog::fill(size_t liveSamples, uint32_t nowMs) {
+	_lastFillMs = nowMs;
+	if (!liveSamples) return;
+
+	_lastAudioMs = nowMs;
+	_windowSamples += (uint32_t)liveSamples;
+	if (!_recovering) return;
+	// 0 means "not yet"; a real timestamp of 0 only happens at boot
+	if (!_firstAudioMs) _firstAudioMs = nowMs ? nowMs : 1;
+	_recoverSamples += (uint32_t)liveSamples;
+}
+
+void SrWatchdog::rearm(uint32_t nowMs) {
+	_lastFillMs = nowMs;
+	_lastAudioMs = nowMs;
+	_windowSamples = 0;
+	_windowStartMs = nowMs;
+	_slowWindows = 0;
+}
+
+SrWatchdogAction SrWatchdog::nextStep(uint32_t nowMs) {
+	_stepMs = nowMs;
+	_firstAudioMs = 0;
+	_recoverSamples = 0;
+	_step++;
+	if (_step == 1) {
+		_stats.micRestarts++;
+		return SR_WATCHDOG_RESTART_MIC;
+	}
+	if (_step <= 1 + _config.attempts) {
+		_stats.pipelineRestarts++;
+		return SR_WATCHDOG_RESTART_PIPELINE;
+	}
+	return SR_WATCHDOG_REBOOT;
+}
+
+SrWatchdogAction SrWatchdog::check(uint32_t nowMs) {
+	if (!_windowStartMs) _windowStartMs = nowMs;
+	bool windowDone = nowMs - _windowStartMs >= WINDOW_MS;
+	if (windowDone) {
+		uint32_t samples = _windowSamples;
+		_windowSamples = 0;
+		_stats.samplesPerSec = (uint32_t)((uint64_t)samples * 1000 / (nowMs - _windowStartMs));
+		_windowStartMs = nowMs;
+		bool slow = _stats.samplesPerSec * 100 < _config.sampleRate * _config.minRatePercent;
+		_slowWindows = slow ? _slowWindows + 1 : 0;
+	}
+
+	if (_recovering) {
+		uint32_t first = _firstAudioMs;
+		if (first) {
+			uint32_t elapsed = nowMs - first;
+			bool steady = (uint64_t)_recoverSamples * 1000 * 100 >= (uint64_t)_config.sampleRate * _config.minRatePercent * elapsed;
+			if (elapsed >= STEADY_MS && steady) {
+				_recovering = false;
+				_slowWindows = 0;
+				_stats.recoveries++;
+				_stats.lastOutageMs = first - _outageStartMs;
+				_stats.lastRecoveryMs = first - _detectedMs;
+				if (_stats.lastOutageMs > _stats.maxOutageMs) _stats.maxOutageMs = _stats.lastOutageMs;
+				return SR_WATCHDOG_NONE;
+			}
+			// Still settling: one more grace period while audio keeps coming
+			if (elapsed < STEADY_MS + _config.graceMs && nowMs - _lastAudioMs < _config.stallMs) return SR_WATCHDOG_NONE;
+		}
+		if (nowMs - _stepMs < _config.graceMs) return SR_WATCHDOG_NONE;
+		return nextStep(nowMs);
+	}
+
+	bool silent = nowMs - _lastFillMs > _config.stallMs || nowMs - _lastAudioMs > _config.stallMs;
+	if (!silent && _slowWindows < 2) return SR_WATCHDOG_NONE;
+
+	_recovering = true;
+	_stats.stalls++;
+	_step = 0;
+	_detectedMs = nowMs;
+	_outageStartMs = _lastAudioMs;
+	return nextStep(nowMs);
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * Stall detector and recovery ladder for the microphone -> ESP-SR path.
+ *
+ * The fill callback is the pipeline's heartbeat: ESP-SR's feed task calls it
+ * for every chunk, and it blocks in the AFE when the detect task stops
+ * consuming. fill() records each call and the live samples it got. check()
+ * runs on a monitor task and reports a stall when
+ * - no fill call or no live audio came for stallMs, or
+ * - two consecutive one-second windows brought less than minRatePercent of
+ *   the sample rate
+ *
+ * It then asks for a recovery step, each given graceMs to bring audio back:
+ * the microphone alone first, then the whole pipeline up to `attempts`
+ * times, then a reboot. Time to recover is bounded by
+ * stallMs + (1 + attempts) * graceMs plus the check period and the time the
+ * steps themselves take; the caller has to bound the pipeline restart.
+ *
+ * Audio counts as back once it has arrived at minRatePercent or better for
+ * a quarter of a second.
+ *
+ * The outage is timed from the last live audio before the stall to the
+ * first after it, the recovery from detection to that first audio.
+ */
+enum SrWatchdogAction {
+	SR_WATCHDOG_NONE = 0,
+	SR_WATCHDOG_RESTART_MIC,
+	SR_WATCHDOG_RESTART_PIPELINE,  // microphone and sr_stop() / sr_start()
+	SR_WATCHDOG_REBOOT,
+};
+
+struct SrWatchdogConfig {
+	uint32_t sampleRate;
+	uint32_t stallMs;
+	uint8_t minRatePercent;
+	uint32_t graceMs;
+	uint8_t attempts;       // pipeline restarts before a reboot
+};
+
+struct SrWatchdogStats {
+	uint32_t stalls;
+	uint32_t recoveries;
+	uint32_t micRestarts;
+	uint32_t pipelineRestarts;
+	uint32_t lastOutageMs;
+	uint32_t lastRecoveryMs;
+	uint32_t maxOutageMs;
+	uint32_t samplesPerSec;  // last complete window
+};
+
+class SrWatchdog {
+public:
+	SrWatchdog(const SrWatchdogConfig& config);
+
+	// Fill path: one call per fill callback with the live samples it read
+	void fill(size_t liveSamples, uint32_t nowMs);
+	// An intentional restart: give the pipeline stallMs before judging it
+	void rearm(uint32_t nowMs);
+
+	// Monitor task: the step to take now; the step is counted as taken
+	SrWatchdogAction check(uint32_t nowMs);
+	bool recovering() const { return _recovering; }
+	// Recovery steps taken in the current outage
+	uint8_t step() const { return _step; }
+
+	const SrWatchdogStats& stats() const { return _stats; }
+
+private:
+	SrWatchdogConfig _config;
+	SrWatchdogStats _stats;
+
+	volatile uint32_t _lastFillMs;
+	volatile uint32_t _lastAudioMs;
+	volatile uint32_t _firstAudioMs;  // first live audio after a recovery step, 0 if none
+	volatile uint32_t _recoverSamples; // live samples since _firstAudioMs
+	volatile uint32_t _windowSamples;
+	uint32_t _windowStartMs;
+	uint8_t _slowWindows;
+
+	volatile bool _recovering;
+	uint8_t _step;
+	uint32_t _detectedMs;
+	uint32_t _outageStartMs;
+	uint32_t _stepMs;
+
+	SrWatchdogAction nextStep(uint32_t nowMs);
+};
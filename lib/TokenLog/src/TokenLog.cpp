@@ -0,0 +1,115 @@
+#include "TokenLog.h"
+
+namespace TokenLog {
+
+	Ring rings[portNUM_PROCESSORS];
+
+	static uint32_t reportedDrops = 0;
+
+	// Frame writer keeping the running xor checksum. The frame is collected
+	// and written in one go, so output from other tasks on the same stream
+	// (PbmSink) never ends up inside it
+	class FrameWriter {
+	public:
+		FrameWriter(Print& out) : _out(out), _len(2), _sum(0) {
+			_buf[0] = 0xFE;
+			_buf[1] = 0xFF;
+		}
+
+		void put(const uint8_t* data, size_t len) {
+			for (size_t i = 0; i < len; i++) {
+				_sum ^= data[i];
+				_buf[_len++] = data[i];
+			}
+		}
+		void put8(uint8_t v) { put(&v, 1); }
+		void put16(uint16_t v) { put((const uint8_t*)&v, sizeof(v)); }
+		void put32(uint32_t v) { put((const uint8_t*)&v, sizeof(v)); }
+		void finish() {
+			_buf[_len++] = _sum;
+			_out.write(_buf, _len);
+		}
+
+	private:
+		// sync, length, fixed fields, arguments, checksum
+		static const size_t MAX_FRAME = 2 + 2 + 12 + MAX_ARGS * (1 + MAX_STRING) + 1;
+
+		Print& _out;
+		uint8_t _buf[MAX_FRAME];
+		size_t _len;
+		uint8_t _sum;
+	};
+
+	static size_t stringLength(const char* s) {
+		if (!s) return 0;
+		size_t len = strnlen(s, MAX_STRING);
+		return len;
+	}
+
+	static void emit(Print& out, const Record& r) {
+		// Payload length first, strings are expanded inline
+		uint16_t len = 12;
+		for (uint8_t i = 0; i < r.argc; i++) {
+			uint8_t type = (r.tags >> (2 * i)) & 0x3;
+			len += type == ARG_STR ? 1 + stringLength((const char*)(uintptr_t)r.args[i]) : 4;
+		}
+
+		FrameWriter frame(out);
+		frame.put16(len);
+		frame.put32(r.id);
+		frame.put32(r.timestamp);
+		frame.put8(r.core);
+		frame.put8(r.argc);
+		frame.put16(r.tags);
+		for (uint8_t i = 0; i < r.argc; i++) {
+			uint8_t type = (r.tags >> (2 * i)) & 0x3;
+			if (type == ARG_STR) {
+				const char* s = (const char*)(uintptr_t)r.args[i];
+				uint8_t n = stringLength(s);
+				frame.put8(n);
+				if (n) frame.put((const uint8_t*)s, n);
+			} else {
+				frame.put32(r.args[i]);
+			}
+		}
+		frame.finish();
+	}
+
+	size_t drain(Print& out, size_t maxRecords) {
+		size_t written = 0;
+
+		for (int core = 0; core < portNUM_PROCESSORS && written < maxRecords; core++) {
+			Ring& ring = rings[core];
+			uint32_t tail = ring.tail.load(std::memory_order_relaxed);
+			uint32_t head = ring.head.load(std::memory_order_acquire);
+
+			while (tail != head && written < maxRecords) {
+				emit(out, ring.slots[tail & (TOKENLOG_RING_SIZE - 1)]);
+				ring.tail.store(++tail, std::memory_order_release);
+				written++;
+			}
+		}
+
+		uint32_t total = dropped();
+		if (total != reportedDrops) {
+			Record r = {};
+			r.id = DROP_ID;
+			r.timestamp = (uint32_t)esp_timer_get_time();
+			r.argc = 1;
+			r.core = xPortGetCoreID();
+			encode(r, 0, total - reportedDrops);
+			emit(out, r);
+			reportedDrops = total;
+		}
+
+		return written;
+	}
+
+	uint32_t dropped() {
+		uint32_t total = 0;
+		for (int core = 0; core < portNUM_PROCESSORS; core++) {
+			total += rings[core].dropped;
+		}
+		return total;
+	}
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <atomic>
+#include <type_traits>
+
+/**
+ * Tokenized, deferred logging.
+ *
+ * TLOG("fmt", args...) stores a 32-bit FNV-1a hash of the format string plus
+ * the raw arguments into a per-core ring and returns. The format string never
+ * reaches the firmware image: logTask drains the rings to Serial as binary
+ * frames and tools/tokenlog.py rebuilds the text from the id map generated at
+ * build time (tools/tokenlog_map.py).
+ *
+ * - Each TLOG call is one line, so format strings carry no trailing "\n".
+ * - Integers, floats and pointers are stored as 32-bit words.
+ * - "%s" arguments are stored as pointers and only read when the ring is
+ *   drained: they must point to static storage (literals, const tables,
+ *   esp_err_to_name()).
+ * - Build with -DTOKENLOG_ENABLED=0 to turn TLOG back into Serial.printf.
+ *
+ * Wire frame (little endian):
+ *   FE FF | len:u16 | id:u32 | timestamp_us:u32 | core:u8 | argc:u8 | tags:u16
+ *         | args (u32, or len:u8 + bytes for strings) | xor:u8
+ */
+
+#ifndef TOKENLOG_ENABLED
+#define TOKENLOG_ENABLED 1
+#endif
+
+#ifndef TOKENLOG_RING_SIZE
+#define TOKENLOG_RING_SIZE 128  // records per core, power of two
+#endif
+
+namespace TokenLog {
+
+	static const uint8_t MAX_ARGS = 5;
+	static const uint8_t MAX_STRING = 48;
+	static const uint32_t DROP_ID = 0;
+
+	enum ArgType : uint8_t {
+		ARG_INT = 0,
+		ARG_UINT = 1,
+		ARG_FLOAT = 2,
+		ARG_STR = 3,
+	};
+
+	struct Record {
+		uint32_t id;
+		uint32_t timestamp;
+		uint16_t tags;  // 2 bits ArgType per argument
+		uint8_t argc;
+		uint8_t core;
+		uint32_t args[MAX_ARGS];
+	};
+
+	struct Ring {
+		Record slots[TOKENLOG_RING_SIZE];
+		std::atomic<uint32_t> head;
+		std::atomic<uint32_t> tail;
+		volatile uint32_t dropped;
+	};
+
+	static_assert((TOKENLOG_RING_SIZE & (TOKENLOG_RING_SIZE - 1)) == 0, "TOKENLOG_RING_SIZE must be a power of two");
+
+	extern Ring rings[portNUM_PROCESSORS];
+
+	// Must match fnv1a() in tools/tokenlog.py
+	constexpr uint32_t hash(const char* s, uint32_t h = 2166136261u) {
+		return *s ? hash(s + 1, (h ^ (uint8_t)*s) * 16777619u) : h;
+	}
+
+	template <typename T>
+	inline typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value>::type
+	encode(Record& r, uint8_t i, T v) {
+		r.args[i] = (uint32_t)v;
+		r.tags |= (std::is_signed<T>::value ? ARG_INT : ARG_UINT) << (2 * i);
+	}
+
+	inline void encode(Record& r, uint8_t i, double v) {
+		float f = (float)v;
+		memcpy(&r.args[i], &f, sizeof(f));
+		r.tags |= ARG_FLOAT << (2 * i);
+	}
+
+	inline void encode(Record& r, uint8_t i, const char* v) {
+		r.args[i] = (uint32_t)(uintptr_t)v;
+		r.tags |= ARG_STR << (2 * i);
+	}
+
+	inline void encode(Record& r, uint8_t i, const void* v) {
+		r.args[i] = (uint32_t)(uintptr_t)v;
+		r.tags |= ARG_UINT << (2 * i);
+	}
+
+	inline void encodeAll(Record& r, uint8_t i) {}
+
+	template <typename T, typename... Rest>
+	inline void encodeAll(Record& r, uint8_t i, T v, Rest... rest) {
+		encode(r, i, v);
+		encodeAll(r, i + 1, rest...);
+	}
+
+	template <typename... Args>
+	inline void write(uint32_t id, Args... args) {
+		static_assert(sizeof...(Args) <= MAX_ARGS, "TLOG supports at most 5 arguments");
+
+		uint32_t timestamp = (uint32_t)esp_timer_get_time();
+
+		// Only the local core produces into its ring: masking interrupts is
+		// enough to keep tasks and ISRs on this core from interleaving. The
+		// core is read with interrupts masked, an unpinned task could
+		// otherwise migrate between picking the ring and writing it
+		UBaseType_t state = portSET_INTERRUPT_MASK_FROM_ISR();
+		uint8_t core = xPortGetCoreID();
+		Ring& ring = rings[core];
+		uint32_t head = ring.head.load(std::memory_order_relaxed);
+		if (head - ring.tail.load(std::memory_order_acquire) >= TOKENLOG_RING_SIZE) {
+			ring.dropped = ring.dropped + 1;
+			portCLEAR_INTERRUPT_MASK_FROM_ISR(state);
+			return;
+		}
+
+		Record& r = ring.slots[head & (TOKENLOG_RING_SIZE - 1)];
+		r.id = id;
+		r.timestamp = timestamp;
+		r.tags = 0;
+		r.argc = sizeof...(Args);
+		r.core = core;
+		encodeAll(r, 0, args...);
+
+		ring.head.store(head + 1, std::memory_order_release);
+		portCLEAR_INTERRUPT_MASK_FROM_ISR(state);
+	}
+
+	// Consumer side: writes up to maxRecords pending records as binary frames,
+	// returns the number written
+	size_t drain(Print& out, size_t maxRecords = 32);
+	uint32_t dropped();
+}
+
+#if TOKENLOG_ENABLED
+#define TLOG(fmt, ...) TokenLog::write(std::integral_constant<uint32_t, TokenLog::hash(fmt)>::value, ##__VA_ARGS__)
+#else
+#define TLOG(fmt, ...) Serial.printf(fmt "\n", ##__VA_ARGS__)
+#endif
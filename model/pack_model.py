@@ -1,7 +1,15 @@
 import os
 import struct
+import zlib
 import argparse
 
+# Aligned pack (format version 2): see pack_models()
+PACK_MAGIC = b"SRMP"
+PACK_VERSION = 2
+PACK_HEADER_LEN = 20
+INDEX_ENTRY_LEN = 80
+MMU_PAGE_SIZE = 0x10000
+
 
 def struct_pack_string(string, max_len=None):
     """
@@ -38,7 +46,44 @@ def read_data(filename):
         data = f.read()
     return data
 
-def pack_models(model_path, out_file="srmodels.bin"):
+def collect_models(model_path):
+    """
+    Return {model_name: {file_name: data}} for every model directory under model_path
+    """
+    models = {}
+    for root, dirs, _ in os.walk(model_path):
+        for model_name in dirs:
+            models[model_name] = {}
+            model_dir = os.path.join(root, model_name)
+            for _, _, files in os.walk(model_dir):
+                for file_name in files:
+                    file_path = os.path.join(model_dir, file_name)
+                    models[model_name][file_name] = read_data(file_path)
+    return models
+
+def align_up(value, alignment):
+    return (value + alignment - 1) // alignment * alignment
+
+def legacy_header_len(models):
+    file_num = sum(len(files) for files in models.values())
+    return 4 + len(models)*(32+4) + file_num*(32+4+4)
+
+def pack_legacy_header(models, offsets):
+    """
+    model_pack_t header read by ESP-SR. offsets[(model, file)] is the absolute
+    start of each file, so the data may live anywhere in the image.
+    """
+    out_bin = struct.pack('I', len(models))  # model number
+    for key in models:
+        out_bin += struct_pack_string(key, 32) # + model name
+        out_bin += struct.pack('I', len(models[key])) # + file number in this model
+        for file_name in models[key]:
+            out_bin += struct_pack_string(file_name, 32) # + file name
+            out_bin += struct.pack('I', offsets[(key, file_name)]) # + file start
+            out_bin += struct.pack('I', len(models[key][file_name])) # + file length
+    return out_bin
+
+def pack_models(model_path, out_file="srmodels.bin", alignment=MMU_PAGE_SIZE):
     """
     Pack all models into one binary file by the following format:
     {
@@ -46,6 +91,7 @@ def pack_models(model_path, out_file="srmodels.bin"):
         model1_info: model_info_t
         model2_info: model_info_t
         ...
+        pack_index: pack_index_t          // only when alignment > 0
         model1_index,model1_data,model1_MODEL_INFO
         model1_index,model1_data,model1_MODEL_INFO
         ...
@@ -63,53 +109,80 @@ def pack_models(model_path, out_file="srmodels.bin"):
         ...
     }model_info_t
 
+    The model_info_t list is the layout ESP-SR reads. With alignment > 0
+    (format version 2, default) each file starts on an `alignment` boundary
+    (the 64 KB flash MMU page) so it can be mapped in place, and the header
+    is followed by:
+    {
+        magic: char[4]            // "SRMP"
+        version: uint16           // 2
+        entry_len: uint16         // 80
+        entry_count: uint32
+        alignment: uint32
+        index_crc32: uint32       // CRC32 of all entries
+        entry1: pack_entry_t
+        ...
+    }pack_index_t                 // entries sorted by (model_name, file_name)
+
+    {
+        model_name: char[32]
+        file_name: char[32]
+        file_start: uint32
+        file_len: uint32
+        file_crc32: uint32
+        reserved: uint32
+    }pack_entry_t
+
+    alignment = 0 writes the original unaligned layout (format version 1).
+
     model_path: the path of models
     out_file: the ouput binary filename
+    alignment: file alignment in bytes
     """
 
-    models = {}
-    file_num = 0
-    model_num = 0
-    for root, dirs, _ in os.walk(model_path):
-        for model_name in dirs:
-            models[model_name] = {}
-            model_dir = os.path.join(root, model_name)
-            model_num += 1
-            for _, _, files in os.walk(model_dir):
-                for file_name in files:
-                    file_num += 1
-                    file_path = os.path.join(model_dir, file_name)
-                    models[model_name][file_name] = read_data(file_path)
-    
-    model_num = len(models)
-    header_len = 4 + model_num*(32+4) + file_num*(32+4+4) 
-    out_bin = struct.pack('I', model_num)  # model number
-    data_bin = None
+    models = collect_models(model_path)
+    if alignment:
+        # stable layout: sorted models and files
+        models = {key: dict(sorted(models[key].items())) for key in sorted(models)}
+
+    header_len = legacy_header_len(models)
+    file_num = sum(len(files) for files in models.values())
+    index_len = PACK_HEADER_LEN + file_num*INDEX_ENTRY_LEN if alignment else 0
+
+    offsets = {}
+    cursor = header_len + index_len
     for key in models:
-        model_bin = struct_pack_string(key, 32) # + model name
-        model_bin += struct.pack('I', len(models[key])) # + file number in this model
-        
         for file_name in models[key]:
-            model_bin += struct_pack_string(file_name, 32) # + file name
-            if data_bin == None:
-                model_bin += struct.pack('I', header_len) 
-                data_bin = models[key][file_name]
-                model_bin += struct.pack('I', len(models[key][file_name]))
-                print(file_name, header_len, len(models[key][file_name]), len(data_bin))
-            else:
-                model_bin += struct.pack('I', header_len+len(data_bin))
-                print(file_name, header_len+len(data_bin), len(models[key][file_name]))
-                data_bin += models[key][file_name]
-                model_bin += struct.pack('I', len(models[key][file_name]))
-        
-        out_bin += model_bin
+            if alignment:
+                cursor = align_up(cursor, alignment)
+            offsets[(key, file_name)] = cursor
+            print(key, file_name, cursor, len(models[key][file_name]))
+            cursor += len(models[key][file_name])
+
+    out_bin = pack_legacy_header(models, offsets)
     assert len(out_bin) == header_len
-    if data_bin != None:
-        out_bin += data_bin
+
+    if alignment:
+        entries = b""
+        for key, file_name in sorted(offsets):
+            data = models[key][file_name]
+            entries += struct_pack_string(key, 32) + struct_pack_string(file_name, 32)
+            entries += struct.pack('IIII', offsets[(key, file_name)], len(data), zlib.crc32(data) & 0xFFFFFFFF, 0)
+        out_bin += PACK_MAGIC
+        out_bin += struct.pack('HHIII', PACK_VERSION, INDEX_ENTRY_LEN, file_num, alignment, zlib.crc32(entries) & 0xFFFFFFFF)
+        out_bin += entries
+    assert len(out_bin) == header_len + index_len
+
+    image = bytearray(out_bin)
+    for (key, file_name), start in offsets.items():
+        data = models[key][file_name]
+        if len(image) < start:
+            image += b'\xff' * (start - len(image))  # erased flash
+        image[start:start + len(data)] = data
 
     out_file = os.path.join(model_path, out_file)
     with open(out_file, "wb") as f:
-        f.write(out_bin)
+        f.write(image)
 
 
 if __name__ == "__main__":
@@ -117,7 +190,8 @@ if __name__ == "__main__":
     parser = argparse.ArgumentParser(description='Model package tool')
     parser.add_argument('-m', '--model_path', help="the path of model files")
     parser.add_argument('-o', '--out_file', default="srmodels.bin", help="the path of binary file")
+    parser.add_argument('-a', '--align', type=lambda x: int(x, 0), default=MMU_PAGE_SIZE, help="file alignment, 0 for the unaligned v1 layout")
     args = parser.parse_args()
 
     # convert(args.model_path, args.out_file)
-    pack_models(model_path=args.model_path, out_file=args.out_file)
+    pack_models(model_path=args.model_path, out_file=args.out_file, alignment=args.align)
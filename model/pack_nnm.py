@@ -0,0 +1,194 @@
+import os
+import json
+import struct
+import zlib
+import argparse
+
+# .nnm model container (format version 1), read by lib/NnModel
+NNM_MAGIC = b"NNMF"
+NNM_VERSION = 1
+NNM_HEADER_LEN = 64
+NNM_ALIGNMENT = 16
+TENSOR_RECORD_LEN = 48
+OP_RECORD_LEN = 32
+META_RECORD_LEN = 8
+MAX_OP_INPUTS = 12
+NO_TENSOR = 0xFFFF
+
+TENSOR_TYPES = {"int8": (1, "b"), "int32": (2, "i"), "float32": (3, "f")}
+OP_TYPES = {"conv": 0, "depthwise": 1, "avgpool": 2, "fc": 3, "gru": 4}
+OP_FLAG_RELU = 0x01
+
+
+def align_up(value, alignment):
+    return (value + alignment - 1) // alignment * alignment
+
+def tensor_data(tensor, base_dir):
+    """
+    Little endian bytes of a constant tensor: "data" names a raw file
+    relative to the manifest, "values" lists the numbers inline
+    """
+    type_id, code = TENSOR_TYPES[tensor["type"]]
+    if "data" in tensor:
+        with open(os.path.join(base_dir, tensor["data"]), "rb") as f:
+            return f.read()
+    if "values" in tensor:
+        values = tensor["values"]
+        return struct.pack("<%d%s" % (len(values), code), *values)
+    return None
+
+class Strings:
+    def __init__(self):
+        self.data = b""
+        self.offsets = {}
+
+    def add(self, text):
+        if text not in self.offsets:
+            self.offsets[text] = len(self.data)
+            self.data += text.encode("utf-8") + b"\0"
+        return self.offsets[text]
+
+def pack_nnm(manifest_path, out_file):
+    """
+    Build a container from a JSON manifest:
+    {
+        "meta": {"mel.window": 480, ...},     // any key, values stored as text
+        "labels": ["_silence_", ...],         // stored as meta label.0 .. label.N-1
+        "tensors": [{
+            "name": "conv1.weights",
+            "type": "int8" | "int32" | "float32",
+            "shape": [64, 3, 40],             // up to 4 dims
+            "scale": 0.05, "zero_point": -3,  // optional, 0 by default
+            "data": "conv1.weights.bin"       // or "values": [...]; absent for activations
+        }, ...],
+        "ops": [{
+            "op": "conv" | "depthwise" | "avgpool" | "fc" | "gru",
+            "kernel": 3, "stride": 1, "relu": true,
+            "inputs": ["input", "conv1.weights", null, ...],  // null for an absent input
+            "output": "conv1"
+        }, ...]
+    }
+
+    Output layout: header, tensor records, op records, meta records,
+    strings, then every constant on a 16-byte boundary. See
+    lib/NnModel/src/NnModelFile.h for the record formats.
+    """
+    base_dir = os.path.dirname(os.path.abspath(manifest_path))
+    with open(manifest_path) as f:
+        manifest = json.load(f)
+
+    strings = Strings()
+    tensors = manifest["tensors"]
+    index = {t["name"]: i for i, t in enumerate(tensors)}
+    assert len(index) == len(tensors), "duplicate tensor names"
+    assert 0 < len(tensors) < NO_TENSOR
+
+    meta = [(str(k), str(v)) for k, v in manifest.get("meta", {}).items()]
+    meta += [("label.%d" % i, label) for i, label in enumerate(manifest.get("labels", []))]
+
+    names = [strings.add(t["name"]) for t in tensors]
+    meta_offsets = [(strings.add(k), strings.add(v)) for k, v in meta]
+
+    tensors_offset = NNM_HEADER_LEN
+    ops_offset = tensors_offset + len(tensors) * TENSOR_RECORD_LEN
+    meta_offset = ops_offset + len(manifest["ops"]) * OP_RECORD_LEN
+    strings_offset = meta_offset + len(meta) * META_RECORD_LEN
+    cursor = strings_offset + len(strings.data)
+
+    blobs = []
+    records = b""
+    for t, name in zip(tensors, names):
+        type_id, code = TENSOR_TYPES[t["type"]]
+        shape = list(t["shape"])
+        assert 1 <= len(shape) <= 4, t["name"]
+        count = 1
+        for d in shape:
+            count *= d
+        data = tensor_data(t, base_dir)
+        offset = 0
+        if data is not None:
+            assert len(data) == count * struct.calcsize(code), "%s: %d bytes for shape %s" % (t["name"], len(data), shape)
+            cursor = align_up(cursor, NNM_ALIGNMENT)
+            offset = cursor
+            blobs.append((offset, data))
+            cursor += len(data)
+        dims = shape + [1] * (4 - len(shape))
+        records += struct.pack("<IBBH4III", name, type_id, len(shape), 0, *dims, offset, len(data) if data else 0)
+        records += struct.pack("<fi", float(t.get("scale", 0.0)), int(t.get("zero_point", 0)))
+        records += struct.pack("<II", 0, 0)
+
+    for op in manifest["ops"]:
+        inputs = [NO_TENSOR if name is None else index[name] for name in op["inputs"]]
+        assert 1 <= len(inputs) <= MAX_OP_INPUTS
+        flags = OP_FLAG_RELU if op.get("relu") else 0
+        records += struct.pack("<BBBBHH", OP_TYPES[op["op"]], op.get("kernel", 1), op.get("stride", 1), flags,
+                               index[op["output"]], len(inputs))
+        records += struct.pack("<%dH" % MAX_OP_INPUTS, *(inputs + [NO_TENSOR] * (MAX_OP_INPUTS - len(inputs))))
+
+    for key, value in meta_offsets:
+        records += struct.pack("<II", key, value)
+
+    body = bytearray(records + strings.data)
+    for offset, data in blobs:
+        start = offset - NNM_HEADER_LEN
+        body += b"\0" * (start - len(body))
+        body[start:start + len(data)] = data
+    file_len = NNM_HEADER_LEN + len(body)
+
+    header = NNM_MAGIC
+    header += struct.pack("<HHII", NNM_VERSION, NNM_HEADER_LEN, file_len, zlib.crc32(body) & 0xFFFFFFFF)
+    header += struct.pack("<HHHH", len(tensors), len(manifest["ops"]), len(meta), 0)
+    header += struct.pack("<IIIIII", tensors_offset, ops_offset, meta_offset, strings_offset, len(strings.data), NNM_ALIGNMENT)
+    header += b"\0" * 16
+    assert len(header) == NNM_HEADER_LEN
+
+    with open(out_file, "wb") as f:
+        f.write(header + body)
+    print(out_file, file_len, "bytes,", len(tensors), "tensors,", len(manifest["ops"]), "ops")
+
+def dump_nnm(path):
+    """
+    Print the header, tensors, ops and metadata of a container
+    """
+    with open(path, "rb") as f:
+        image = f.read()
+    assert image[:4] == NNM_MAGIC, "not an .nnm container"
+    version, header_len, file_len, crc = struct.unpack_from("<HHII", image, 4)
+    tensor_count, op_count, meta_count, _ = struct.unpack_from("<HHHH", image, 16)
+    tensors_offset, ops_offset, meta_offset, strings_offset, strings_len, alignment = struct.unpack_from("<IIIIII", image, 24)
+    crc_ok = zlib.crc32(image[header_len:file_len]) & 0xFFFFFFFF == crc
+
+    def string(offset):
+        start = strings_offset + offset
+        return image[start:image.index(b"\0", start)].decode("utf-8")
+
+    types = {v[0]: k for k, v in TENSOR_TYPES.items()}
+    ops = {v: k for k, v in OP_TYPES.items()}
+    print("version %d, %d bytes, crc %s" % (version, file_len, "ok" if crc_ok else "MISMATCH"))
+    for i in range(tensor_count):
+        name, type_id, rank, _, d0, d1, d2, d3, offset, size, scale, zero = \
+            struct.unpack_from("<IBBH4IIIfi", image, tensors_offset + i * TENSOR_RECORD_LEN)
+        shape = [d0, d1, d2, d3][:rank]
+        where = "@%d %d bytes" % (offset, size) if offset else "activation"
+        print("  tensor %2d %-24s %-7s %-16s scale %g zero %d, %s" % (i, string(name), types.get(type_id, "?"), shape, scale, zero, where))
+    for i in range(op_count):
+        type_id, kernel, stride, flags, output, count = struct.unpack_from("<BBBBHH", image, ops_offset + i * OP_RECORD_LEN)
+        inputs = struct.unpack_from("<%dH" % MAX_OP_INPUTS, image, ops_offset + i * OP_RECORD_LEN + 8)[:count]
+        print("  op %2d %-9s k%d s%d%s %s -> %d" % (i, ops.get(type_id, "?"), kernel, stride,
+                                                 " relu" if flags & OP_FLAG_RELU else "", list(inputs), output))
+    for i in range(meta_count):
+        key, value = struct.unpack_from("<II", image, meta_offset + i * META_RECORD_LEN)
+        print("  %s = %s" % (string(key), string(value)))
+    return crc_ok
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description='.nnm model container tool')
+    parser.add_argument('-m', '--manifest', help="JSON manifest of the network")
+    parser.add_argument('-o', '--out_file', default="model.nnm", help="the container to write")
+    parser.add_argument('-d', '--dump', help="print the contents of a container")
+    args = parser.parse_args()
+
+    if args.dump:
+        raise SystemExit(0 if dump_nnm(args.dump) else 1)
+    pack_nnm(args.manifest, args.out_file)
@@ -0,0 +1,50 @@
+#include "app/callback_list.h"
+#include <esp_mn_speech_commands.h>
+
+// Same calls sr_start() makes for its command list
+esp_err_t srLoadCommands(const sr_cmd_t* commands, size_t count) {
+    esp_mn_commands_clear();
+    for (size_t i = 0; i < count; i++) {
+        esp_err_t err = esp_mn_commands_phoneme_add(commands[i].command_id, commands[i].str, commands[i].phoneme);
+        if (err != ESP_OK) return err;
+    }
+    esp_mn_error_t* rejected = esp_mn_commands_update();
+    if (rejected) {
+        for (int i = 0; i < rejected->num; i++) {
+            TLOG("[commands] rejected phrase of command %d", rejected->phrases[i]->command_id);
+        }
+        return ESP_ERR_INVALID_ARG;
+    }
+    return ESP_OK;
+}
+
+// Runs where MultiNet is not detecting: the ESP-SR detect task, or kwsTask
+// while ESP-SR is in SR_MODE_OFF. A failed rebuild keeps the old set
+void srOpenCommands() {
+    if (!commandSets) return;
+
+    // MultiNet was released after the last window; a new instance needs the
+    // active set loaded unless apply() loads another one
+    bool created = srMultiNetAcquire();
+    const CommandSet* active = commandSets->active();
+    esp_err_t err = commandSets->apply();
+    if (err != ESP_OK) {
+        TLOG("[commands] ERROR: loading set %s: %s", commandSets->selected()->name, esp_err_to_name(err));
+        commandSets->select(active->name);
+    }
+    if (created && commandSets->active() == active) {
+        err = srLoadCommands(commandSets->commands(active), active->count);
+        if (err != ESP_OK) TLOG("[commands] ERROR: loading set %s: %s", active->name, esp_err_to_name(err));
+    }
+    commandSets->windowOpened(millis());
+}
+
+int srCloseCommands(sr_event_t event, int phraseId) {
+    if (!commandSets) return phraseId;
+
+    commandSets->windowClosed(event == SR_EVENT_COMMAND, millis());
+    int index = event == SR_EVENT_COMMAND ? commandSets->toTable(phraseId) : phraseId;
+    // MultiNet is not needed until the next wake word
+    srMultiNetRelease();
+    return index;
+}
@@ -0,0 +1,66 @@
+#include "app/callback_list.h"
+#include <esp_timer.h>
+
+static inline uint32_t nowUs() {
+    return (uint32_t)esp_timer_get_time();
+}
+
+static void logHandoff() {
+    const AudioReplayStats& stats = srReplay->stats();
+    TLOG("[handoff] replayed %lu samples (%lu ms back), first after %lu us, live after %lu us",
+        stats.replayed, stats.lookback / SR_SAMPLES_PER_MS, stats.switchUs, stats.drainUs);
+    if (stats.clipped || stats.overruns) {
+        TLOG("[handoff] %lu of %lu handoffs clipped to the history, %lu samples overrun",
+            stats.clipped, stats.handoffs, stats.overruns);
+    }
+}
+
+// Runs on the ESP-SR feed task. Normally a blocking read of live audio.
+// After a wake word the history from the end of the word is served first:
+// fill returns at once while there is backlog, so ESP-SR catches up faster
+// than real time, and the microphone is drained without blocking meanwhile
+// so its DMA buffers never overflow. The backlog is at most
+// SR_HANDOFF_HISTORY_MS, well inside the AFE input ring.
+esp_err_t srFill(SrMicRead read, void* out, size_t len, size_t* bytes_read, uint32_t timeout_ms) {
+    int16_t* samples = (int16_t*)out;
+    int wanted = len / sizeof(int16_t);
+
+    if (srReplay && srReplay->active()) {
+        int live = read(samples, wanted, 0);
+        if (srWatchdog) srWatchdog->fill(live > 0 ? live : 0, millis());
+        if (live > 0) {
+            srReplay->write(samples, live);
+            kwsFeed(samples, live);
+            srProfileFeed(samples, live);
+        }
+        size_t replayed = srReplay->read(samples, wanted, nowUs());
+        if (srReplay->finished()) logHandoff();
+        if (replayed) {
+            *bytes_read = replayed * sizeof(int16_t);
+            return ESP_OK;
+        }
+        // Nothing to go back to: the live chunk is still in out
+        *bytes_read = live > 0 ? live * sizeof(int16_t) : 0;
+        return live > 0 ? ESP_OK : ESP_FAIL;
+    }
+
+    int live = read(samples, wanted, timeout_ms);
+    if (srWatchdog) srWatchdog->fill(live > 0 ? live : 0, millis());
+    if (live <= 0) {
+        *bytes_read = 0;
+        return ESP_FAIL;
+    }
+    if (srReplay) srReplay->write(samples, live);
+    kwsFeed(samples, live);
+    srProfileFeed(samples, live);
+    *bytes_read = live * sizeof(int16_t);
+    return ESP_OK;
+}
+
+// Called on the wake word, before the mode switch. ESP-SR may still hold a
+// chunk or two it has not fetched yet; those reach MultiNet ahead of the
+// replay, a few tens of ms the recognizer hears twice
+void srHandoff(uint32_t lookback) {
+    if (!srReplay) return;
+    srReplay->request(srReplay->position() - lookback, nowUs());
+}
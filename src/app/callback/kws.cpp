@@ -0,0 +1,44 @@
+#include "app/callback_list.h"
+
+static volatile uint32_t kwsDropCount = 0;
+
+// Tee of the fill callbacks into kwsTask. Runs on the ESP-SR feed task and
+// never waits: a chunk that does not fit is dropped whole and counted.
+void kwsFeed(const int16_t* samples, size_t count) {
+    if (!kwsAudio) return;
+
+    size_t bytes = count * sizeof(int16_t);
+    if (xStreamBufferSpacesAvailable(kwsAudio) < bytes) {
+        kwsDropCount++;
+        return;
+    }
+    xStreamBufferSend(kwsAudio, samples, bytes, 0);
+}
+
+// WAKE_WORDS[word] detected by kwsTask: same mode switch and event as a
+// WakeNet detection in sr_event_callback
+bool kwsWakeWord(uint8_t word) {
+    // Audio still queued for kwsTask came after the detection point
+    uint32_t queued = xStreamBufferBytesAvailable(kwsAudio) / sizeof(int16_t);
+    if (!srWakeWord(word, queued + SR_HANDOFF_KWS_MS * SR_SAMPLES_PER_MS)) return false;
+
+    if (commandDispatcher) {
+        commandDispatcher->post(SR_EVENT_WAKEWORD, 0, word);
+    }
+    return true;
+}
+
+uint32_t kwsDropped() {
+    return kwsDropCount;
+}
+
+// SR mode between commands. With only the keyword spotter WakeNet is
+// switched off; ESP-SR keeps calling the fill callback in SR_MODE_OFF, which
+// is what feeds kwsTask
+sr_mode_t srIdleMode() {
+#if WAKEWORD_ENGINE == WAKEWORD_ENGINE_KWS
+    return kwsDetectorCount ? SR_MODE_OFF : SR_MODE_WAKEWORD;
+#else
+    return SR_MODE_WAKEWORD;
+#endif
+}
@@ -1,22 +1,21 @@
 #include "app/callback_list.h"
 
 #if (MIC_TYPE == MIC_TYPE_I2S)
+static int i2sMicRead(int16_t* out, int samples, uint32_t timeout_ms) {
+    if (!microphone || !microphone->isActive()) return 0;
+    return microphone->readSamples(out, samples, timeout_ms);
+}
+
 // I2S fill callback for ESP-SR system
 esp_err_t sr_i2s_fill_callback(void *arg, void *out, size_t len, size_t *bytes_read, uint32_t timeout_ms) {
-    // Calculate how many 16-bit samples we need
-    int samples_needed = len / sizeof(int16_t);
-    int samples_read = 0;
-    
-    if (microphone && microphone->isActive()) {
-        samples_read = microphone->readSamples((int16_t*)out, samples_needed, timeout_ms);
-    }
-    
-    if (samples_read > 0) {
-        *bytes_read = samples_read * sizeof(int16_t);
-        return ESP_OK;
+    static bool chunkChecked = false;
+    if (!chunkChecked) {
+        chunkChecked = true;
+        if (len / sizeof(int16_t) != SR_FEED_CHUNK_SAMPLES) {
+            TLOG("[mic] ESP-SR reads %u samples per fill, the DMA is matched to %u (SR_FEED_CHUNK_SAMPLES)",
+                (unsigned)(len / sizeof(int16_t)), SR_FEED_CHUNK_SAMPLES);
+        }
     }
-    
-    *bytes_read = 0;
-    return ESP_FAIL;
+    return srFill(i2sMicRead, out, len, bytes_read, timeout_ms);
 }
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,193 @@
+#include "app/callback_list.h"
+#include <esp_heap_caps.h>
+#include <esp_mn_iface.h>
+#include <esp_mn_models.h>
+#include <esp_mn_speech_commands.h>
+
+// MultiNet and its FST are only needed between a wake word and the command
+// or timeout, but the arduino wrapper creates MultiNet in sr_start() and
+// keeps it. The build links esp_mn_handle_from_name through -Wl,--wrap
+// (platformio.ini) and hands the wrapper a proxy: the model handle it gets
+// stands for an instance that srMultiNetAcquire() creates before the switch
+// to SR_MODE_COMMAND and srMultiNetRelease() destroys after it. Every
+// operation takes that handle, so each one is replaced and passes through
+// to the instance while there is one.
+//
+// sr_start() still builds one instance, it reads the sample geometry and
+// checks the phrases against it; srModelsStarted() releases it again.
+
+static const esp_mn_iface_t* real = nullptr;
+static esp_mn_iface_t proxy;
+static model_iface_data_t* model = nullptr;
+// What the wrapper sees as its instance, never dereferenced
+static uint8_t proxyToken;
+static model_iface_data_t* const PROXY_MODEL = (model_iface_data_t*)&proxyToken;
+
+static char modelName[32];
+static int modelDuration = 0;
+// Answers for calls made while no instance exists
+static int sampleRate = 16000;
+static int chunkSize = 0;
+static int chunkNum = 0;
+static char* language = nullptr;
+static float threshold = 0.0f;
+static bool thresholdSet = false;
+
+static SrModelCost multiNetCost;
+
+static bool createModel() {
+    size_t psram = heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
+    size_t internal = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+    uint32_t start = micros();
+    model = real->create(modelName, modelDuration);
+    if (!model) return false;
+
+    multiNetCost.creates++;
+    multiNetCost.createUs = micros() - start;
+    multiNetCost.psramBytes = psram - heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
+    multiNetCost.internalBytes = internal - heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+    multiNetCost.resident = true;
+    if (thresholdSet) real->set_det_threshold(model, threshold);
+    return true;
+}
+
+static model_iface_data_t* proxyCreate(const char* name, int duration) {
+    snprintf(modelName, sizeof(modelName), "%s", name);
+    modelDuration = duration;
+    if (!model && !createModel()) return nullptr;
+    sampleRate = real->get_samp_rate(model);
+    chunkSize = real->get_samp_chunksize(model);
+    chunkNum = real->get_samp_chunknum(model);
+    language = real->get_language(model);
+    return PROXY_MODEL;
+}
+
+static int proxySampleRate(model_iface_data_t*) {
+    return model ? real->get_samp_rate(model) : sampleRate;
+}
+
+static int proxyChunkSize(model_iface_data_t*) {
+    return model ? real->get_samp_chunksize(model) : chunkSize;
+}
+
+static int proxyChunkNum(model_iface_data_t*) {
+    return model ? real->get_samp_chunknum(model) : chunkNum;
+}
+
+static int proxySetThreshold(model_iface_data_t*, float value) {
+    threshold = value;
+    thresholdSet = true;
+    return model ? real->set_det_threshold(model, value) : 0;
+}
+
+static char* proxyLanguage(model_iface_data_t*) {
+    return model ? real->get_language(model) : language;
+}
+
+static esp_mn_state_t proxyDetect(model_iface_data_t*, int16_t* samples) {
+    // Command mode without srOpenCommands(): create it here, with the
+    // phrases ESP-SR last compiled
+    if (!model) {
+        if (!srMultiNetAcquire()) return ESP_MN_STATE_TIMEOUT;
+        esp_mn_commands_update();
+    }
+    return real->detect(model, samples);
+}
+
+static void proxyDestroy(model_iface_data_t*) {
+    srMultiNetRelease();
+}
+
+static esp_mn_results_t* proxyResults(model_iface_data_t*) {
+    return model ? real->get_results(model) : nullptr;
+}
+
+static void proxyClean(model_iface_data_t*) {
+    if (model) real->clean(model);
+}
+
+// Without an instance the phrases are compiled when the next one is created
+static esp_mn_error_t* proxySetCommands(model_iface_data_t*, esp_mn_node_t* phrases) {
+    return model ? real->set_speech_commands(model, phrases) : nullptr;
+}
+
+static void proxyPrintCommands(model_iface_data_t*) {
+    if (model) real->print_active_speech_commands(model);
+}
+
+static int proxyCheckCommand(model_iface_data_t*, const char* str) {
+    return model ? real->check_speech_command(model, str) : 0;
+}
+
+extern "C" esp_mn_iface_t* __real_esp_mn_handle_from_name(char* model_name);
+
+extern "C" esp_mn_iface_t* __wrap_esp_mn_handle_from_name(char* model_name) {
+    esp_mn_iface_t* handle = __real_esp_mn_handle_from_name(model_name);
+    if (!handle) return handle;
+    real = handle;
+    proxy = *handle;
+    proxy.create = proxyCreate;
+    proxy.get_samp_rate = proxySampleRate;
+    proxy.get_samp_chunksize = proxyChunkSize;
+    proxy.get_samp_chunknum = proxyChunkNum;
+    proxy.set_det_threshold = proxySetThreshold;
+    proxy.get_language = proxyLanguage;
+    proxy.detect = proxyDetect;
+    proxy.destroy = proxyDestroy;
+    proxy.get_results = proxyResults;
+    proxy.clean = proxyClean;
+    proxy.set_speech_commands = proxySetCommands;
+    proxy.print_active_speech_commands = proxyPrintCommands;
+    proxy.check_speech_command = proxyCheckCommand;
+    return &proxy;
+}
+
+bool srMultiNetAcquire() {
+    if (model || !real) return false;
+    if (!createModel()) {
+        TLOG("[models] ERROR: %s: cannot create MultiNet", modelName);
+        return false;
+    }
+    return true;
+}
+
+void srMultiNetRelease() {
+    if (!model) return;
+    real->destroy(model);
+    model = nullptr;
+    multiNetCost.resident = false;
+}
+
+// In command mode, between srMultiNetAcquire() and srMultiNetRelease()
+bool srMultiNetLoaded() {
+    return model != nullptr;
+}
+
+// After each sr_start(): what building the models cost, then MultiNet goes
+// until the first wake word
+void srModelsStarted() {
+    const SrModelCost* afe = srAfeCost();
+    TLOG("[models] AFE (%s): %lu us, PSRAM %lu bytes, internal %lu bytes",
+        srAfeModels(), afe->createUs, afe->psramBytes, afe->internalBytes);
+    TLOG("[models] %s: %lu us, PSRAM %lu bytes, internal %lu bytes, released until a wake word",
+        modelName, multiNetCost.createUs, multiNetCost.psramBytes, multiNetCost.internalBytes);
+    if (srIdleMode() != SR_MODE_COMMAND) srMultiNetRelease();
+}
+
+void srModelsReport() {
+    const SrModelCost* afe = srAfeCost();
+    if (afe->resident) {
+        TLOG("[models] AFE (%s): resident, PSRAM %lu bytes, internal %lu bytes",
+            srAfeModels(), afe->psramBytes, afe->internalBytes);
+    }
+    if (multiNetCost.creates) {
+        TLOG("[models] %s: %s, PSRAM %lu bytes, internal %lu bytes, %lu creations",
+            modelName, multiNetCost.resident ? "resident" : "released", multiNetCost.psramBytes,
+            multiNetCost.internalBytes, multiNetCost.creates);
+    }
+    // lib/Kws containers and modelCheckTask's passes
+    for (size_t i = 0; modelLoader && i < modelLoader->count(); i++) {
+        const ModelStats* stats = modelLoader->stats(i);
+        if (stats->resident) TLOG("[models] %s: %lu bytes, resident %lu", stats->name, stats->size, stats->resident);
+    }
+}
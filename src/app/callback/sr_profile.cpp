@@ -0,0 +1,207 @@
+#include "app/callback_list.h"
+#include <esp_timer.h>
+#include <esp_afe_config.h>
+#include <model_path.h>
+
+// NS and VAD are chosen when sr_start() builds the AFE config, which the
+// arduino wrapper does not expose: the build links afe_config_init through
+// -Wl,--wrap (platformio.ini) and this file edits the config per profile.
+// The WakeNet models are set in the same place (callback/wakenet.cpp).
+
+static const uint8_t SR_PROFILE_COUNT = SR_PROFILE_FULL + 1;
+static const char* SR_PROFILE_NAMES[SR_PROFILE_COUNT] = {"off", "light", "full"};
+
+struct SrProfileCost {
+    uint32_t starts;
+    uint32_t startUs;        // last sr_start()
+    uint32_t psramBytes;     // heap the last sr_start() took
+    uint32_t internalBytes;
+    uint64_t wallUs;         // time spent in the profile
+    uint64_t idleUs;         // idle time of all cores meanwhile
+    bool idleKnown;          // idleUs was measured, see idleTime()
+};
+
+static SrProfileCost costs[SR_PROFILE_COUNT];
+static volatile uint8_t current = SR_PROFILE_MAX;   // profile of the running AFE
+static volatile uint8_t requested = SR_PROFILE_MAX;
+static volatile uint8_t ceiling = SR_PROFILE_MAX;   // where the automatic step-up returns to
+static NoiseFloor noiseFloor;                       // ~1 s blocks, floor over the last 8
+static uint32_t quietSeconds = 0;
+// NS / VAD models that failed their CRC (modelCheckTask), kept out of the AFE
+static const uint8_t SR_PROFILE_MAX_EXCLUDED = 4;
+static const char* excluded[SR_PROFILE_MAX_EXCLUDED];
+static volatile uint8_t excludedCount = 0;
+static volatile bool rebuild = false;                // restart even without a profile change
+
+static char* usableModel(char* name) {
+    for (uint8_t i = 0; name && i < excludedCount; i++) {
+        if (strcmp(name, excluded[i]) == 0) return nullptr;
+    }
+    return name;
+}
+
+extern "C" afe_config_t* __real_afe_config_init(const char* input_format, srmodel_list_t* models, afe_type_t type, afe_mode_t mode);
+
+extern "C" afe_config_t* __wrap_afe_config_init(const char* input_format, srmodel_list_t* models, afe_type_t type, afe_mode_t mode) {
+    afe_config_t* config = __real_afe_config_init(input_format, models, type, mode);
+    if (!config) return config;
+
+    srWakeNetConfig(config, models);
+    switch (current) {
+        case SR_PROFILE_OFF:
+            config->ns_init = false;
+            config->vad_init = false;
+            break;
+        case SR_PROFILE_LIGHT:
+            config->ns_init = true;
+            config->afe_ns_mode = AFE_NS_MODE_WEBRTC;
+            config->ns_model_name = nullptr;
+            config->vad_init = true;
+            config->vad_model_name = nullptr;
+            break;
+        default:
+            // Whatever the partition has, WebRTC where a model is missing
+            config->ns_model_name = usableModel(esp_srmodel_filter(models, ESP_NSNET_PREFIX, nullptr));
+            config->ns_init = true;
+            config->afe_ns_mode = config->ns_model_name ? AFE_NS_MODE_NET : AFE_NS_MODE_WEBRTC;
+            config->vad_model_name = usableModel(esp_srmodel_filter(models, ESP_VADN_PREFIX, nullptr));
+            config->vad_init = true;
+            break;
+    }
+    return config;
+}
+
+// Runs on the ESP-SR feed task
+void srProfileFeed(const int16_t* samples, size_t count) {
+    noiseFloor.update(samples, count);
+}
+
+void srProfileStarted(size_t psramBytes, size_t internalBytes, uint32_t startUs) {
+    SrProfileCost& cost = costs[current];
+    cost.starts++;
+    cost.startUs = startUs;
+    cost.psramBytes = psramBytes;
+    cost.internalBytes = internalBytes;
+    TLOG("[profile] %s: sr_start %lu us, PSRAM %lu bytes, internal %lu bytes",
+        SR_PROFILE_NAMES[current], startUs, cost.psramBytes, cost.internalBytes);
+}
+
+bool srSetProfile(uint8_t profile) {
+    if (profile >= SR_PROFILE_COUNT) return false;
+    ceiling = profile;
+    requested = profile;
+    quietSeconds = 0;
+    return true;
+}
+
+void srProfileExclude(const char* model) {
+    if (excludedCount >= SR_PROFILE_MAX_EXCLUDED) return;
+    excluded[excludedCount] = model;
+    excludedCount = excludedCount + 1;
+    // Only the full profile loads models
+    if (current == SR_PROFILE_FULL) rebuild = true;
+}
+
+void srProfileRebuild() {
+    rebuild = true;
+}
+
+uint8_t srProfile() {
+    return current;
+}
+
+// Idle task run time of all cores, in run time counter ticks (us). False
+// without configGENERATE_RUN_TIME_STATS, there is no counter to read
+static bool idleTime(uint32_t& idle) {
+#if configGENERATE_RUN_TIME_STATS
+    idle = 0;
+    for (BaseType_t core = 0; core < portNUM_PROCESSORS; core++) {
+        idle += ulTaskGetRunTimeCounter(xTaskGetIdleTaskHandleForCore(core));
+    }
+    return true;
+#else
+    idle = 0;
+    return false;
+#endif
+}
+
+// "n/a" when the idle time was not measured, rather than 0 idle = 100%
+static const char* busyPercent(const SrProfileCost& cost, char* text, size_t size) {
+    uint64_t capacity = cost.wallUs * portNUM_PROCESSORS;
+    if (!cost.idleKnown || !capacity || cost.idleUs > capacity) return "n/a";
+    snprintf(text, size, "%lu%%", (unsigned long)(100 - cost.idleUs * 100 / capacity));
+    return text;
+}
+
+static void account() {
+    static int64_t lastWall = 0;
+    static uint32_t lastIdle = 0;
+    int64_t wall = esp_timer_get_time();
+    uint32_t idle;
+    bool known = idleTime(idle);
+    if (lastWall) {
+        costs[current].wallUs += (uint64_t)(wall - lastWall);
+        costs[current].idleUs += idle - lastIdle;
+        costs[current].idleKnown = known;
+    }
+    lastWall = wall;
+    lastIdle = idle;
+}
+
+static void stepProfile() {
+    float floor = noiseFloor.floorDb();
+    if (!noiseFloor.ready()) return;
+
+    if (floor > SR_PROFILE_QUIET_DBFS + SR_PROFILE_HYSTERESIS_DB) {
+        quietSeconds = 0;
+        if (requested != ceiling) {
+            TLOG("[profile] noise floor %d dBFS, back to %s", (int)floor, SR_PROFILE_NAMES[ceiling]);
+            requested = ceiling;
+        }
+    } else if (floor < SR_PROFILE_QUIET_DBFS) {
+        if (++quietSeconds < SR_PROFILE_QUIET_S || requested == SR_PROFILE_OFF) return;
+        quietSeconds = 0;
+        requested = requested - 1;
+        TLOG("[profile] noise floor %d dBFS for %u s, stepping down to %s",
+            (int)floor, SR_PROFILE_QUIET_S, SR_PROFILE_NAMES[requested]);
+    }
+}
+
+// speechRecognitionTask, once a second
+void srProfileTick() {
+    account();
+#if SR_PROFILE_AUTO
+    stepProfile();
+#endif
+    uint8_t next = requested;
+    if ((next == current && !rebuild) || !sr_system_running) return;
+    // The watchdog restarts ESP-SR itself while it recovers
+    if (srWatchdog && srWatchdog->recovering()) return;
+    // Not in the middle of a command; try again next second
+    if (!srHoldWakeWord()) return;
+
+    uint8_t from = current;
+    current = next;
+    rebuild = false;
+    if (restartSpeechRecognition() != ESP_OK) {
+        // Bring the old profile back, it started before
+        current = from;
+        requested = from;
+        restartSpeechRecognition();
+    }
+    srArmWakeWord();
+    TLOG("[profile] %s -> %s (%s)", SR_PROFILE_NAMES[from], SR_PROFILE_NAMES[current],
+        current == next ? "ok" : "failed");
+}
+
+void srProfileReport() {
+    TLOG("[profile] %s, noise floor %d dBFS", SR_PROFILE_NAMES[current], (int)noiseFloor.floorDb());
+    for (uint8_t i = 0; i < SR_PROFILE_COUNT; i++) {
+        const SrProfileCost& cost = costs[i];
+        if (!cost.starts) continue;
+        char busy[8];
+        TLOG("[profile] %s: %lu s, CPU %s of both cores, PSRAM %lu bytes, internal %lu bytes",
+            SR_PROFILE_NAMES[i], (uint32_t)(cost.wallUs / 1000000), busyPercent(cost, busy, sizeof(busy)),
+            cost.psramBytes, cost.internalBytes);
+    }
+}
@@ -0,0 +1,197 @@
+#include "app/callback_list.h"
+#include <esp_afe_sr_iface.h>
+#include <esp_afe_sr_models.h>
+#include <esp_heap_caps.h>
+
+// ESP-SR runs up to two WakeNet models (wakenet_model_name and _2 of the AFE
+// config), but the arduino wrapper reports a wake word without saying which
+// model heard it. The build links esp_afe_handle_from_config through
+// -Wl,--wrap (platformio.ini) so the AFE's fetch passes wakeNetFetch, which
+// keeps the model of the last detection for the event callback; both run
+// on the detect task. The AFE's create and destroy are passed through the
+// same way to time them and measure the heap they take (srAfeCost()).
+//
+// The second model costs detect task time on every chunk. The fetch hook
+// adds up the detect task's run time per chunk, by profile and by the
+// number of models in the AFE; above WAKENET_LOAD_LIMIT with both, only one
+// runs from the next sr_start() on, the first word or each in turn.
+
+static const uint8_t WAKENET_MAX_MODELS = 2;
+static uint8_t words[WAKENET_MAX_MODELS];  // WAKE_WORDS entry of each model
+static uint8_t wordCount = 0;
+static uint8_t detected = 0;                // model of the last detection
+static uint8_t available = 0;               // WakeNet words with a model in the partition
+static bool single = false;                 // only one model runs
+static uint8_t turn = 0;                    // the one of `available` it is
+static uint32_t turnStart = 0;
+static esp_afe_sr_iface_t afeHandle;
+static esp_afe_sr_iface_op_fetch_t realFetch = nullptr;
+static esp_afe_sr_iface_op_create_from_config_t realCreate = nullptr;
+static esp_afe_sr_iface_op_destroy_t realDestroy = nullptr;
+static SrModelCost afeCost;
+static char afeModels[96] = "";
+
+// Detect task run time and the audio it covered, while no MultiNet runs
+struct WakeNetLoad {
+    uint64_t runUs;
+    uint64_t samples;
+};
+static WakeNetLoad loads[SR_PROFILE_FULL + 1][WAKENET_MAX_MODELS];
+
+// Called by the afe_config_init wrap (callback/sr_profile.cpp) on every
+// sr_start(). Left alone ESP-SR takes the first wn model of the pack, and
+// the pack is sorted by name, so the models are always set here
+void srWakeNetConfig(afe_config_t* config, srmodel_list_t* models) {
+    char* names[WAKENET_MAX_MODELS] = {};
+    uint8_t found[WAKENET_MAX_MODELS];
+    available = 0;
+    for (uint8_t i = 0; i < WAKE_WORD_COUNT && available < WAKENET_MAX_MODELS; i++) {
+        if (WAKE_WORDS[i].label) continue;
+        // Not in the partition: setupModels reported it
+        char* name = esp_srmodel_filter(models, WAKE_WORDS[i].model, nullptr);
+        if (!name) continue;
+        names[available] = name;
+        found[available++] = i;
+    }
+    wordCount = single && available ? 1 : available;
+    if (!wordCount) return;
+    uint8_t first = single ? turn % available : 0;
+    for (uint8_t k = 0; k < wordCount; k++) words[k] = found[first + k];
+    config->wakenet_model_name = names[first];
+    config->wakenet_model_name_2 = wordCount > 1 ? names[1] : nullptr;
+}
+
+// Detect task run time since the last fetch returned, one pass of its loop
+// (fetch runs WakeNet). The task is new after each sr_start()
+static void accountFetch(const afe_fetch_result_t* result) {
+#if configGENERATE_RUN_TIME_STATS
+    static TaskHandle_t lastTask = nullptr;
+    static uint32_t lastRun = 0;
+    static bool lastCommand = true;
+    TaskHandle_t task = xTaskGetCurrentTaskHandle();
+    uint32_t run = ulTaskGetRunTimeCounter(task);
+    bool command = srMultiNetLoaded();
+    if (result && wordCount && task == lastTask && !command && !lastCommand) {
+        WakeNetLoad& load = loads[srProfile()][wordCount - 1];
+        load.runUs += run - lastRun;
+        load.samples += result->data_size / sizeof(int16_t);
+    }
+    lastTask = task;
+    lastRun = run;
+    lastCommand = command;
+#endif
+}
+
+static afe_fetch_result_t* wakeNetFetch(esp_afe_sr_data_t* afe) {
+    afe_fetch_result_t* result = realFetch(afe);
+    accountFetch(result);
+    // wakenet_model_index counts from 1
+    if (result && result->wakeup_state == WAKENET_DETECTED && result->wakenet_model_index > 0) {
+        detected = result->wakenet_model_index - 1;
+    }
+    return result;
+}
+
+static void addModel(const char* name) {
+    size_t used = strlen(afeModels);
+    if (!name || used >= sizeof(afeModels) - 1) return;
+    snprintf(afeModels + used, sizeof(afeModels) - used, used ? " %s" : "%s", name);
+}
+
+static esp_afe_sr_data_t* afeCreate(afe_config_t* config) {
+    size_t psram = heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
+    size_t internal = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+    uint32_t start = micros();
+    esp_afe_sr_data_t* afe = realCreate(config);
+    if (!afe) return afe;
+
+    afeCost.creates++;
+    afeCost.createUs = micros() - start;
+    afeCost.psramBytes = psram - heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
+    afeCost.internalBytes = internal - heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+    afeCost.resident = true;
+    afeModels[0] = '\0';
+    addModel(config->wakenet_model_name);
+    addModel(config->wakenet_model_name_2);
+    if (config->ns_init && config->afe_ns_mode == AFE_NS_MODE_NET) addModel(config->ns_model_name);
+    if (config->vad_init) addModel(config->vad_model_name);
+    return afe;
+}
+
+static void afeDestroy(esp_afe_sr_data_t* afe) {
+    realDestroy(afe);
+    afeCost.resident = false;
+}
+
+extern "C" esp_afe_sr_iface_t* __real_esp_afe_handle_from_config(const afe_config_t* config);
+
+extern "C" esp_afe_sr_iface_t* __wrap_esp_afe_handle_from_config(const afe_config_t* config) {
+    esp_afe_sr_iface_t* handle = __real_esp_afe_handle_from_config(config);
+    if (!handle) return handle;
+    afeHandle = *handle;
+    realFetch = handle->fetch;
+    afeHandle.fetch = wakeNetFetch;
+    realCreate = handle->create_from_config;
+    afeHandle.create_from_config = afeCreate;
+    realDestroy = handle->destroy;
+    afeHandle.destroy = afeDestroy;
+    return &afeHandle;
+}
+
+uint8_t srWakeNetWord() {
+    if (detected < wordCount) return words[detected];
+    // No WakeNet model configured here, ESP-SR runs its default one
+    for (uint8_t i = 0; i < WAKE_WORD_COUNT; i++) {
+        if (!WAKE_WORDS[i].label) return i;
+    }
+    return 0;
+}
+
+// In % of a core, -1 before a chunk was measured
+static int loadPercent(const WakeNetLoad& load) {
+    if (!load.samples) return -1;
+    return (int)(load.runUs * 100 / (load.samples * 1000 / SR_SAMPLES_PER_MS));
+}
+
+static const char* percentText(int percent, char* text, size_t size) {
+    if (percent < 0) return "n/a";
+    snprintf(text, size, "%d%%", percent);
+    return text;
+}
+
+void srWakeNetTick() {
+#if WAKENET_ALTERNATE_S
+    if (!single || available < 2 || millis() - turnStart < WAKENET_ALTERNATE_S * 1000UL) return;
+    turn = (turn + 1) % available;
+    turnStart = millis();
+    srProfileRebuild();
+#endif
+}
+
+void srWakeNetReport() {
+    if (available < 2) return;
+    const WakeNetLoad* load = loads[srProfile()];
+    int one = loadPercent(load[0]);
+    int both = loadPercent(load[1]);
+    char oneText[8], bothText[8], secondText[8];
+    TLOG("[wakenet] %s running, detect task: one model %s of a core, both %s, the second model %s",
+        single ? WAKE_WORDS[words[0]].name : "both models", percentText(one, oneText, sizeof(oneText)),
+        percentText(both, bothText, sizeof(bothText)),
+        percentText(one < 0 || both < one ? -1 : both - one, secondText, sizeof(secondText)));
+
+    if (single || !WAKENET_LOAD_LIMIT || both <= WAKENET_LOAD_LIMIT) return;
+    single = true;
+    turn = 0;
+    turnStart = millis();
+    srProfileRebuild();
+    TLOG("[wakenet] both models at %d%% of a core, limit %u%%: %s %s", both, WAKENET_LOAD_LIMIT,
+        WAKENET_ALTERNATE_S ? "alternating with" : "dropping", WAKE_WORDS[words[1]].name);
+}
+
+const SrModelCost* srAfeCost() {
+    return &afeCost;
+}
+
+const char* srAfeModels() {
+    return afeModels[0] ? afeModels : "no models";
+}
@@ -2,7 +2,81 @@
 
 #include "boot/init.h"
 #include <esp32-hal-sr.h>
+#include <esp_afe_config.h>
 
 esp_err_t sr_i2s_fill_callback(void *arg, void *out, size_t len, size_t *bytes_read, uint32_t timeout_ms);
 esp_err_t sr_analog_fill_callback(void *arg, void *out, size_t len, size_t *bytes_read, uint32_t timeout_ms);
-void sr_event_callback(void *arg, sr_event_t event, int command_id, int phrase_id);
\ No newline at end of file
+
+// Fill path shared by both microphones (callback/handoff.cpp): records the
+// history, tees to the keyword spotter and the noise floor and serves a replay
+// after a wake word
+typedef int (*SrMicRead)(int16_t* out, int samples, uint32_t timeout_ms);
+esp_err_t srFill(SrMicRead read, void* out, size_t len, size_t* bytes_read, uint32_t timeout_ms);
+// Replay to ESP-SR from lookback samples before the newest fed sample
+void srHandoff(uint32_t lookback);
+// Command sets (callback/command_set.cpp). srLoadCommands rebuilds MultiNet,
+// srOpenCommands loads the selected set and starts timing the window right
+// before the switch to SR_MODE_COMMAND (creating MultiNet), srCloseCommands
+// ends it, releases MultiNet and returns the voice_commands index of a
+// phrase_id
+esp_err_t srLoadCommands(const sr_cmd_t* commands, size_t count);
+void srOpenCommands();
+int srCloseCommands(sr_event_t event, int phraseId);
+// Front-end profiles (callback/sr_profile.cpp). A profile is fixed per
+// sr_start(), so switching restarts ESP-SR between command windows;
+// srProfileTick() does that and the automatic step-down, once a second
+void srProfileFeed(const int16_t* samples, size_t count);
+void srProfileStarted(size_t psramBytes, size_t internalBytes, uint32_t startUs);
+bool srSetProfile(uint8_t profile);
+// Keeps an NS / VAD model out of the AFE from the next sr_start() on, and
+// restarts ESP-SR if the running profile uses models
+void srProfileExclude(const char* model);
+// Restarts ESP-SR at the next tick in the same profile, for a new AFE config
+void srProfileRebuild();
+uint8_t srProfile();
+void srProfileTick();
+void srProfileReport();
+// Time and heap creating one ESP-SR model instance took, and whether it is
+// still there
+struct SrModelCost {
+    uint32_t creates;
+    uint32_t createUs;       // last creation
+    uint32_t psramBytes;     // heap the last creation took
+    uint32_t internalBytes;
+    bool resident;
+};
+// MultiNet only exists in command mode (callback/sr_models.cpp):
+// srMultiNetAcquire creates it, true if it did (the new instance has no
+// phrases yet), srMultiNetRelease destroys it. srModelsStarted runs after
+// each sr_start(), srModelsReport logs the per-model figures
+bool srMultiNetAcquire();
+void srMultiNetRelease();
+bool srMultiNetLoaded();
+void srModelsStarted();
+void srModelsReport();
+// WakeNet words (callback/wakenet.cpp): srWakeNetConfig puts the models of
+// the WakeNet entries of WAKE_WORDS into the AFE config, srWakeNetWord is
+// the entry the last WakeNet detection belongs to. srWakeNetTick (once a
+// second) turns the words when they alternate, srWakeNetReport logs the
+// detect task load with one and two models and drops to one above
+// WAKENET_LOAD_LIMIT
+void srWakeNetConfig(afe_config_t* config, srmodel_list_t* models);
+uint8_t srWakeNetWord();
+void srWakeNetTick();
+void srWakeNetReport();
+// The AFE instance of the last sr_start() and the models in it
+const SrModelCost* srAfeCost();
+const char* srAfeModels();
+// Wake word -> command mode for WAKE_WORDS[word], false if a command window
+// is already open; srArmWakeWord() when it closes (callback/sr_event.cpp)
+bool srWakeWord(uint8_t word, uint32_t lookback);
+void srArmWakeWord();
+// Closes the gate without a wake word, false if a command window is open
+bool srHoldWakeWord();
+void sr_event_callback(void *arg, sr_event_t event, int command_id, int phrase_id);
+
+// Keyword spotter glue (callback/kws.cpp)
+void kwsFeed(const int16_t* samples, size_t count);
+bool kwsWakeWord(uint8_t word);
+uint32_t kwsDropped();
+sr_mode_t srIdleMode();
\ No newline at end of file
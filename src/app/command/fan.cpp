@@ -0,0 +1,19 @@
+#include "app/command_list.h"
+
+void onFanStart(const SRCommandEvent& evt, void* arg) {
+    TLOG("🌀 Action: Starting fan");
+    TLOG("   🎯 Target: Fan Control System (START)");
+    // Add your fan start control logic here
+    if (notification) {
+        notification->send(NOTIFICATION_DISPLAY, (void*)EVENT_DISPLAY_FAN_START);
+    }
+}
+
+void onFanStop(const SRCommandEvent& evt, void* arg) {
+    TLOG("🌀 Action: Stopping fan");
+    TLOG("   🎯 Target: Fan Control System (STOP)");
+    // Add your fan stop control logic here
+    if (notification) {
+        notification->send(NOTIFICATION_DISPLAY, (void*)EVENT_DISPLAY_FAN_STOP);
+    }
+}
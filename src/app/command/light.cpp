@@ -0,0 +1,19 @@
+#include "app/command_list.h"
+
+void onLightOn(const SRCommandEvent& evt, void* arg) {
+    TLOG("💡 Action: Turning ON the light");
+    TLOG("   🎯 Target: Light Control System (ON)");
+    // Add your light ON control logic here
+    if (notification) {
+        notification->send(NOTIFICATION_DISPLAY, (void*)EVENT_DISPLAY_LIGHTS_ON);
+    }
+}
+
+void onLightOff(const SRCommandEvent& evt, void* arg) {
+    TLOG("💡 Action: Turning OFF the light");
+    TLOG("   🎯 Target: Light Control System (OFF/DARK)");
+    // Add your light OFF control logic here
+    if (notification) {
+        notification->send(NOTIFICATION_DISPLAY, (void*)EVENT_DISPLAY_LIGHTS_OFF);
+    }
+}
@@ -0,0 +1,78 @@
+#include "app/command_list.h"
+
+// Runs on commandTask, after sr_event_callback has already switched the SR mode
+
+void onWakeWord(const SRCommandEvent& evt, void* arg) {
+    // phraseId is the WAKE_WORDS entry that fired
+    const char* word = evt.phraseId >= 0 && evt.phraseId < WAKE_WORD_COUNT ? WAKE_WORDS[evt.phraseId].name : "?";
+    if (evt.event == SR_EVENT_WAKEWORD_CHANNEL) {
+        TLOG("🎙️ Wake word '%s' detected on channel: %d", word, evt.commandId);
+    } else {
+        TLOG("🎙️ Wake word '%s' detected!", word);
+    }
+    if (notification) {
+        notification->send(NOTIFICATION_DISPLAY, (void*)EVENT_DISPLAY_WAKEWORD);
+    }
+    const CommandSet* set = commandSets ? commandSets->active() : nullptr;
+    TLOG("📞 Listening for commands (set %s)...", set ? set->name : "global");
+}
+
+// Wake word to result includes the spoken command, compare sets over many
+// commands rather than one
+static void logCommandSet() {
+    if (!commandSets) return;
+
+    const CommandSet* set = commandSets->active();
+    const CommandSetStats* stats = commandSets->stats(set);
+    if (!stats->commands) return;
+    TLOG("[commands] set %s (%u phrases): %lu ms, avg %lu ms, max %lu ms",
+        set->name, set->count, stats->latencyLastMs, stats->latencySumMs / stats->commands, stats->latencyMaxMs);
+    TLOG("[commands] set %s: %lu of %lu windows with a command, graph rebuilt %lu times, last %lu us",
+        set->name, stats->commands, stats->windows, stats->loads, stats->loadUs);
+}
+
+void onCommandDetected(const SRCommandEvent& evt, void* arg) {
+    TLOG("✅ Command detected! ID=%d, Phrase=%d", evt.commandId, evt.phraseId);
+
+    // Map phrase_id to actual voice command (since phrase_id indexes the voice_commands array)
+    if (evt.phraseId >= 0 && evt.phraseId < (sizeof(voice_commands) / sizeof(sr_cmd_t))) {
+        const sr_cmd_t* cmd = &voice_commands[evt.phraseId];
+        TLOG("   📝 You said: '%s'", cmd->str);
+        TLOG("   🔤 Phonetic: '%s'", cmd->phoneme);
+        TLOG("   🆔 Command Group: %d, Phrase Index: %d", evt.commandId, evt.phraseId);
+        logCommandSet();
+    } else {
+        TLOG("   ❓ Unknown command mapping");
+    }
+}
+
+void onCommandTimeout(const SRCommandEvent& evt, void* arg) {
+    TLOG("⏰ Command timeout - returning to wake word mode");
+    if (notification) {
+        notification->send(NOTIFICATION_DISPLAY, (void*)EVENT_DISPLAY_TIMEOUT);
+    }
+    TLOG("   💭 No command detected within timeout period");
+    TLOG("   🔄 Say 'Hi ESP' to activate again");
+}
+
+void onUnknownCommand(const SRCommandEvent& evt, void* arg) {
+    if (evt.event == SR_EVENT_COMMAND) {
+        TLOG("❓ Unknown command ID: %d", evt.commandId);
+        TLOG("   📋 Available commands:");
+        for (int i = 0; i < (sizeof(voice_commands) / sizeof(sr_cmd_t)); i++) {
+            TLOG("      [%d] Group %d: '%s' (%s)", 
+                        i,
+                        voice_commands[i].command_id, 
+                        voice_commands[i].str, 
+                        voice_commands[i].phoneme);
+        }
+        return;
+    }
+
+    TLOG("❓ Unknown SR event: %d", evt.event);
+    TLOG("   📚 Known events:");
+    TLOG("      SR_EVENT_WAKEWORD: Wake word detected");
+    TLOG("      SR_EVENT_WAKEWORD_CHANNEL: Multi-channel wake word");
+    TLOG("      SR_EVENT_COMMAND: Voice command detected");
+    TLOG("      SR_EVENT_TIMEOUT: Command timeout occurred");
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include "boot/init.h"
+
+void onWakeWord(const SRCommandEvent& evt, void* arg);
+void onCommandDetected(const SRCommandEvent& evt, void* arg);
+void onCommandTimeout(const SRCommandEvent& evt, void* arg);
+void onUnknownCommand(const SRCommandEvent& evt, void* arg);
+
+void onLightOn(const SRCommandEvent& evt, void* arg);
+void onLightOff(const SRCommandEvent& evt, void* arg);
+void onFanStart(const SRCommandEvent& evt, void* arg);
+void onFanStop(const SRCommandEvent& evt, void* arg);
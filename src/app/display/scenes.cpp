@@ -0,0 +1,92 @@
+#include "app/display_list.h"
+#include "Mochi.h"
+
+// Scene priorities: higher preempts lower
+enum ScenePriority : uint8_t {
+	PRIORITY_IDLE = 0,
+	PRIORITY_LISTENING = 1,
+	PRIORITY_REACTION = 2,
+	PRIORITY_COMMAND = 3,
+};
+
+static const uint32_t MOCHI_FRAME_MS = 40;
+
+struct CommandLabel {
+	const char* event;
+	const char* label;
+};
+
+static const CommandLabel COMMAND_LABELS[] = {
+	{EVENT_DISPLAY_LIGHTS_ON, "Lights on"},
+	{EVENT_DISPLAY_LIGHTS_OFF, "Lights off"},
+	{EVENT_DISPLAY_FAN_START, "Fan start"},
+	{EVENT_DISPLAY_FAN_STOP, "Fan stop"},
+};
+
+static const char* commandLabel = "";
+
+static void tickSoundDetector(DisplayBackend& display, uint32_t elapsedMs, void* arg) {
+	displaySoundDetector();
+}
+
+static void tickListening(DisplayBackend& display, uint32_t elapsedMs, void* arg) {
+	displayListening(elapsedMs);
+}
+
+static void enterFace(const char* event, void* arg) {
+	faceDisplay->LookFront();
+	faceDisplay->Expression.GoTo_Happy();
+}
+
+static void tickFace(DisplayBackend& display, uint32_t elapsedMs, void* arg) {
+	displayHappyFace();
+}
+
+static void tickMochi(DisplayBackend& display, uint32_t elapsedMs, void* arg) {
+	Mochi::loadFrame(&display, elapsedMs / MOCHI_FRAME_MS);
+}
+
+static void enterCommand(const char* event, void* arg) {
+	commandLabel = event;
+	for (size_t i = 0; i < sizeof(COMMAND_LABELS) / sizeof(COMMAND_LABELS[0]); i++) {
+		if (strcmp(COMMAND_LABELS[i].event, event) == 0) {
+			commandLabel = COMMAND_LABELS[i].label;
+			break;
+		}
+	}
+}
+
+static void tickCommand(DisplayBackend& display, uint32_t elapsedMs, void* arg) {
+	displayCommand(commandLabel);
+}
+
+Scene soundDetectorScene = {"sound_detector", PRIORITY_IDLE, 0, nullptr, nullptr, tickSoundDetector, nullptr, {}};
+Scene listeningScene = {"listening", PRIORITY_LISTENING, 0, nullptr, nullptr, tickListening, nullptr, {}};
+Scene faceScene = {"face", PRIORITY_REACTION, 3000, enterFace, nullptr, tickFace, nullptr, {}};
+Scene mochiScene = {"mochi", PRIORITY_REACTION, Mochi::epd_bitmap_allArray_LEN * MOCHI_FRAME_MS, nullptr, nullptr, tickMochi, nullptr, {}};
+Scene commandScene = {"command", PRIORITY_COMMAND, 1500, enterCommand, nullptr, tickCommand, nullptr, {}};
+
+void setupScenes(SceneManager& scenes) {
+	// Wake word: happy face first, then listening until a command or timeout
+	scenes.show(EVENT_DISPLAY_WAKEWORD, faceScene);
+	scenes.show(EVENT_DISPLAY_WAKEWORD, listeningScene);
+	scenes.show(EVENT_DISPLAY_LISTENING, listeningScene);
+
+	for (size_t i = 0; i < sizeof(COMMAND_LABELS) / sizeof(COMMAND_LABELS[0]); i++) {
+		scenes.dismiss(COMMAND_LABELS[i].event, listeningScene);
+		scenes.show(COMMAND_LABELS[i].event, commandScene);
+	}
+
+	scenes.dismiss(EVENT_DISPLAY_TIMEOUT, listeningScene);
+	scenes.show(EVENT_DISPLAY_TIMEOUT, mochiScene);
+}
+
+void logSceneStats() {
+	const Scene* all[] = {&soundDetectorScene, &listeningScene, &faceScene, &mochiScene, &commandScene};
+	for (size_t i = 0; i < sizeof(all) / sizeof(all[0]); i++) {
+		const SceneStats& stats = all[i]->stats;
+		if (!stats.frames) continue;
+		TLOG("[scene] %s: %lu frames, render avg %lu us, max %lu us, flush max %lu us",
+			all[i]->name, stats.frames, stats.totalUs / stats.frames, stats.maxUs, stats.flushMaxUs);
+	}
+}
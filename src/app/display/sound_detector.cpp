@@ -1,4 +1,24 @@
 #include "app/display_list.h"
+#include "StaticLayer.h"
+
+// Everything but the level inside the bar
+static void paintSoundDetector(U8G2& gfx) {
+	// Draw header
+	gfx.setFont(u8g2_font_7x13_tf);
+	gfx.drawStr(0, 10, "Sound detector");
+	gfx.drawLine(0, 12, 127, 12);
+
+	// Draw status
+	gfx.setFont(u8g2_font_5x8_tf);
+	gfx.drawStr(0, 25, "Status:");
+	gfx.drawStr(50, 25, "Listen");
+
+	// Draw sound 
+	gfx.drawStr(0, 35, "Mic:");
+	gfx.drawFrame(45, 30, 80, 8);
+}
+
+static StaticLayer soundDetectorLayer(paintSoundDetector);
 
 void displaySoundDetector() {
 #if MIC_TYPE == MIC_TYPE_ANALOG
@@ -8,24 +28,13 @@ void displaySoundDetector() {
 	}
 #endif
 
-	// Draw header
-	display->setFont(u8g2_font_7x13_tf);
-	display->drawStr(0, 10, "Sound detector");
-	display->drawLine(0, 12, 127, 12);
+	soundDetectorLayer.draw(*display);
 
-	// Draw status
-	display->setFont(u8g2_font_5x8_tf);
-	display->drawStr(0, 25, "Status:");
-	display->drawStr(50, 25, "Listen");
-
-	// Draw sound 
-	display->drawStr(0, 35, "Mic:");
 #if MIC_TYPE == MIC_TYPE_I2S
 	int micLevel = microphone->readLevel();
 #else
 	int micLevel = amicrophone->readLevel();
 #endif
 	int barWidth = map(micLevel, 0, 4096, 0, 80);
-	display->drawFrame(45, 30, 80, 8);
-	display->drawBox(45, 30, barWidth, 8);
+	display->gfx().drawBox(45, 30, barWidth, 8);
 }
\ No newline at end of file
@@ -1,40 +1,45 @@
 #include "app/display_list.h"
 #include "Mochi.h"
+#include "StaticLayer.h"
 
-void displayListening() {
+static void paintListening(U8G2& gfx) {
+    gfx.setFont(u8g2_font_6x10_tf);
+    gfx.drawStr(10, 20, "Listening...");
+    gfx.drawStr(10, 35, "Say command");
+}
+
+static void paintCommand(U8G2& gfx) {
+    gfx.setFont(u8g2_font_6x10_tf);
+    gfx.drawStr(10, 20, "Command:");
+    gfx.drawStr(10, 50, "Executing...");
+}
+
+static StaticLayer listeningLayer(paintListening);
+static StaticLayer commandLayer(paintCommand);
+
+void displayListening(uint32_t elapsedMs) {
     if (!display) return;
-    
-    display->clearBuffer();
-    display->setFont(u8g2_font_6x10_tf);
+    U8G2& gfx = display->gfx();
     
     // Draw listening indicator
-    display->drawStr(10, 20, "Listening...");
-    display->drawStr(10, 35, "Say command");
+    listeningLayer.draw(*display);
     
     // Draw animated microphone icon
-    static uint8_t animate = 0;
-    animate = (animate + 1) % 8;
+    uint8_t animate = (elapsedMs / 33) % 8;
     
     for (int i = 0; i < 3; i++) {
         if (animate > i * 2) {
-            display->drawCircle(100 + i * 8, 25, 2);
+            gfx.drawCircle(100 + i * 8, 25, 2);
         }
     }
-    
-    display->sendBuffer();
 }
 
 void displayCommand(const char* command) {
     if (!display) return;
-    
-    display->clearBuffer();
-    display->setFont(u8g2_font_6x10_tf);
+    U8G2& gfx = display->gfx();
     
     // Draw command confirmation
-    display->drawStr(10, 20, "Command:");
-    display->drawStr(10, 35, command);
-    display->drawStr(10, 50, "Executing...");
-    
-    display->sendBuffer();
-    delay(300);
+    commandLayer.draw(*display);
+    gfx.setFont(u8g2_font_6x10_tf);
+    gfx.drawStr(10, 35, command);
 }
@@ -1,5 +1,6 @@
 #include "app/display_list.h"
 
 void displayHappyFace() {
+	display->gfx().clearBuffer();
 	faceDisplay->Update();
 }
\ No newline at end of file
@@ -1,8 +1,20 @@
 #pragma once
 
 #include "boot/init.h"
+#include "SceneManager.h"
 
+// Render functions: draw one frame into display->gfx(), the caller flushes
 void displaySoundDetector();
 void displayHappyFace();
-void displayListening();
-void displayCommand(const char* command);
\ No newline at end of file
+void displayListening(uint32_t elapsedMs);
+void displayCommand(const char* command);
+
+// Scenes for displayTask, base scene first
+extern Scene soundDetectorScene;
+extern Scene listeningScene;
+extern Scene faceScene;
+extern Scene mochiScene;
+extern Scene commandScene;
+
+void setupScenes(SceneManager& scenes);
+void logSceneStats();
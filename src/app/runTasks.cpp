@@ -11,6 +11,16 @@ void runTasks(){
 		0
 	);
 
+	xTaskCreateUniversal(
+		commandTask,
+		"commandTask",
+		1024 * 4,
+		NULL,
+		7,
+		&commandTaskHandle,
+		0
+	);
+
 	xTaskCreateUniversal(
 		displayTask,
 		"displayTask",
@@ -20,4 +30,38 @@ void runTasks(){
 		&displayTaskHandle,
 		1
 	);
+
+	if (kwsDetectorCount) {
+		xTaskCreateUniversal(
+			kwsTask,
+			"kwsTask",
+			1024 * 4,
+			NULL,
+			9,
+			&kwsTaskHandle,
+			1
+		);
+	}
+
+	if (modelLoader) {
+		xTaskCreateUniversal(
+			modelCheckTask,
+			"modelCheckTask",
+			1024 * 3,
+			NULL,
+			1,
+			&modelCheckTaskHandle,
+			1
+		);
+	}
+
+	xTaskCreateUniversal(
+		logTask,
+		"logTask",
+		1024 * 3,
+		NULL,
+		1,
+		&logTaskHandle,
+		1
+	);
 }
\ No newline at end of file
@@ -6,9 +6,17 @@
 extern TaskHandle_t displayTaskHandle;
 extern TaskHandle_t speechRecognitionTaskHandle;
 extern TaskHandle_t FTPTaskHandle;
+extern TaskHandle_t commandTaskHandle;
+extern TaskHandle_t logTaskHandle;
+extern TaskHandle_t kwsTaskHandle;
+extern TaskHandle_t modelCheckTaskHandle;
 
 void runTasks();
 
 void displayTask(void *param);
 void speechRecognitionTask(void* param);
 void FTPTask(void *param);
+void commandTask(void *param);
+void logTask(void *param);
+void kwsTask(void *param);
+void modelCheckTask(void *param);
@@ -0,0 +1,13 @@
+#include "app/tasks.h"
+
+TaskHandle_t commandTaskHandle = nullptr;
+
+void commandTask(void *param) {
+	// wait dispatcher initiate
+	while (!commandDispatcher)
+		vTaskDelay(pdMS_TO_TICKS(10));
+
+	while (1) {
+		commandDispatcher->process(portMAX_DELAY);
+	}
+}
@@ -1,47 +1,39 @@
 #include "app/tasks.h"
-#include "Mochi.h"
 
 TaskHandle_t displayTaskHandle = nullptr;
 
+static const uint32_t SCENE_STATS_INTERVAL_MS = 60000;
+
 void displayTask(void *param) {
   TickType_t lastWakeTime = xTaskGetTickCount();
   TickType_t updateFrequency = pdMS_TO_TICKS(33);
-	size_t updateDelay = 0;
-	const char* lastEvent;
+	uint32_t lastStats = millis();
 
 	// wait notification initiate
 	while (!notification)
 		taskYIELD();
-	
+
+	SceneManager scenes(soundDetectorScene);
+	setupScenes(scenes);
 
 	while(1) {
 		vTaskDelayUntil(&lastWakeTime, updateFrequency);
-		display->clearBuffer();
-
-		if (!notification->has(NOTIFICATION_DISPLAY) && updateDelay == 0) {
-			displaySoundDetector();
-	    display->sendBuffer();
-			continue;
-		} 
-
-		void* event = notification->has(NOTIFICATION_DISPLAY) 
-			? notification->consume(NOTIFICATION_DISPLAY, updateFrequency)
-			: nullptr;
-		if ((event && strcmp((const char*)event, EVENT_DISPLAY_WAKEWORD) == 0) || strcmp(lastEvent, EVENT_DISPLAY_WAKEWORD) == 0) {
-			if (updateDelay == 0) {
-				updateDelay = millis() + 3000;
-				lastEvent = EVENT_DISPLAY_WAKEWORD;
-				faceDisplay->LookFront();
-				faceDisplay->Expression.GoTo_Happy();
+		uint32_t now = millis();
+
+		// Take every pending event without waiting, the frame rate stays fixed
+		while (notification->has(NOTIFICATION_DISPLAY)) {
+			const char* event = (const char*)notification->consume(NOTIFICATION_DISPLAY, 0);
+			if (!event) break;
+			if (!scenes.handle(event)) {
+				TLOG("[display] no scene for event %s", event);
 			}
-			displayHappyFace();
-			// Mochi::drawFrame(display);
-			// send buffer will handled by Face class
 		}
 
-		if (updateDelay <= millis()) {
-			updateDelay = 0;
-			lastEvent = "";
+		scenes.tick(*display, now);
+
+		if (now - lastStats >= SCENE_STATS_INTERVAL_MS) {
+			lastStats = now;
+			logSceneStats();
 		}
 	}
-}
\ No newline at end of file
+}
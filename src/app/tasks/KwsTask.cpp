@@ -0,0 +1,84 @@
+#include "app/tasks.h"
+#include <esp_timer.h>
+
+TaskHandle_t kwsTaskHandle = nullptr;
+
+// One 10 ms hop at 16 kHz per receive
+static const size_t KWS_CHUNK_SAMPLES = 160;
+static const uint32_t KWS_STATS_INTERVAL_MS = 30000;
+
+// Per detector, since the last report. Sliced detectors only count the
+// chunks they ran, so usPer10ms is always the full-rate cost of the word
+struct KwsLoad {
+	uint32_t busyUs;
+	uint32_t worstUs;
+	uint32_t samples;
+};
+
+static uint32_t usPer10ms(const KwsLoad& load) {
+	return load.samples ? (uint32_t)((uint64_t)load.busyUs * KWS_CHUNK_SAMPLES / load.samples) : 0;
+}
+
+void kwsTask(void *param) {
+	int16_t chunk[KWS_CHUNK_SAMPLES];
+	KwsResult result;
+	KwsLoad load[KWS_MAX_DETECTORS] = {};
+	uint32_t lastStats = millis();
+	// Time-slicing: only detector `turn` runs, for KWS_SLICE_MS each
+	bool sliced = false;
+	uint8_t turn = 0;
+	uint32_t turnStart = 0;
+
+	while (1) {
+		size_t bytes = xStreamBufferReceive(kwsAudio, chunk, sizeof(chunk), pdMS_TO_TICKS(1000));
+		size_t count = bytes / sizeof(int16_t);
+		for (uint8_t i = 0; count && i < kwsDetectorCount; i++) {
+			if (sliced && i != turn) continue;
+
+			KwsDetector& detector = kwsDetectors[i];
+			int64_t start = esp_timer_get_time();
+			bool detected = detector.engine->process(chunk, count, &result);
+			uint32_t us = (uint32_t)(esp_timer_get_time() - start);
+			load[i].busyUs += us;
+			load[i].samples += count;
+			if (us > load[i].worstUs) load[i].worstUs = us;
+
+			if (detected && kwsWakeWord(detector.word)) {
+				TLOG("[kws] %s (%s) %u%%", WAKE_WORDS[detector.word].name,
+					detector.engine->model()->labels[result.label], (unsigned)(result.score * 100));
+			}
+		}
+
+		// The next detector starts from silence: its history is from its last turn
+		if (sliced && millis() - turnStart >= KWS_SLICE_MS) {
+			turn = (turn + 1) % kwsDetectorCount;
+			kwsDetectors[turn].engine->reset();
+			turnStart = millis();
+		}
+
+		if (millis() - lastStats >= KWS_STATS_INTERVAL_MS) {
+			uint32_t totalUs = 0;
+			for (uint8_t i = 0; i < kwsDetectorCount; i++) {
+				const KwsStats& stats = kwsDetectors[i].engine->stats();
+				uint32_t us = usPer10ms(load[i]);
+				totalUs += us;
+				TLOG("[kws] %s: %lu us per 10 ms (%lu%% of a core), worst %lu us, detections %lu",
+					WAKE_WORDS[kwsDetectors[i].word].name, us, us / 100, load[i].worstUs, stats.detections);
+			}
+			TLOG("[kws] %u words: %lu%% of a core at full rate, dropped chunks: %lu",
+				kwsDetectorCount, totalUs / 100, kwsDropped());
+
+			// Decided on the full-rate cost, so slicing does not switch itself off again
+			bool slice = KWS_LOAD_LIMIT && kwsDetectorCount > 1 && totalUs / 100 > KWS_LOAD_LIMIT;
+			if (slice != sliced) {
+				sliced = slice;
+				turn = 0;
+				turnStart = millis();
+				for (uint8_t i = 0; i < kwsDetectorCount; i++) kwsDetectors[i].engine->reset();
+				TLOG("[kws] time-slicing %s: %lu%% of a core, limit %u%%", sliced ? "on" : "off", totalUs / 100, KWS_LOAD_LIMIT);
+			}
+			memset(load, 0, sizeof(load));
+			lastStats = millis();
+		}
+	}
+}
@@ -0,0 +1,14 @@
+#include "app/tasks.h"
+
+TaskHandle_t logTaskHandle = nullptr;
+
+void logTask(void *param) {
+	while (1) {
+		// Drain TLOG rings to Serial, back off while they are empty
+		if (TokenLog::drain(Serial, 32) == 0) {
+			vTaskDelay(pdMS_TO_TICKS(20));
+		} else {
+			taskYIELD();
+		}
+	}
+}
@@ -0,0 +1,64 @@
+#include "app/tasks.h"
+
+TaskHandle_t modelCheckTaskHandle = nullptr;
+
+static bool isOptional(const char* model) {
+	for (size_t i = 0; i < sizeof(SR_MODELS_OPTIONAL) / sizeof(SR_MODELS_OPTIONAL[0]); i++) {
+		if (strcmp(model, SR_MODELS_OPTIONAL[i]) == 0) return true;
+	}
+	return false;
+}
+
+static bool isRequired(const char* model) {
+	for (size_t i = 0; i < sizeof(SR_MODELS_REQUIRED) / sizeof(SR_MODELS_REQUIRED[0]); i++) {
+		if (strcmp(model, SR_MODELS_REQUIRED[i]) == 0) return true;
+	}
+	return false;
+}
+
+static void checkModel(const char* model) {
+	if (!modelPack->modelSize(model)) return;  // absent, setupModels reported it
+
+	esp_err_t err = modelLoader->acquire(model);
+	const ModelStats* stats = modelLoader->stats(model);
+	if (err == ESP_OK) modelLoader->release(model);
+	if (!stats) return;
+
+	if (err == ESP_OK && stats->verified) {
+		TLOG("[models] %s: %lu bytes, crc ok in %lu us", model, stats->size, stats->verifyUs);
+	} else if (err == ESP_OK) {
+		TLOG("[models] %s: %lu bytes, not verified (pack has no checksums)", model, stats->size);
+	} else if (isOptional(model)) {
+		TLOG("[models] ERROR: %s: %s, leaving it out of the AFE", model, esp_err_to_name(err));
+		srProfileExclude(model);
+	} else {
+		TLOG("[models] ERROR: %s: %s, ESP-SR is running on a damaged model, reflash the partition",
+			model, esp_err_to_name(err));
+	}
+}
+
+// One pass over the SR models once ESP-SR is listening. ESP-SR reads them
+// from its own mapping, so this only reports damage (and keeps a damaged
+// NS / VAD model out of the next AFE); it is off the boot path because the
+// CRCs read a few MB of flash. Lowest priority, then the task ends
+void modelCheckTask(void *param) {
+	while (!sr_system_running) {
+		vTaskDelay(pdMS_TO_TICKS(1000));
+	}
+	if (modelLoader && modelPack) {
+		uint32_t start = micros();
+		for (size_t i = 0; i < sizeof(SR_MODELS_REQUIRED) / sizeof(SR_MODELS_REQUIRED[0]); i++) {
+			checkModel(SR_MODELS_REQUIRED[i]);
+		}
+		for (size_t i = 0; i < sizeof(SR_MODELS_OPTIONAL) / sizeof(SR_MODELS_OPTIONAL[0]); i++) {
+			checkModel(SR_MODELS_OPTIONAL[i]);
+		}
+		// The other WakeNet words
+		for (uint8_t i = 0; i < WAKE_WORD_COUNT; i++) {
+			if (!WAKE_WORDS[i].label && !isRequired(WAKE_WORDS[i].model)) checkModel(WAKE_WORDS[i].model);
+		}
+		TLOG("[models] check done in %lu us", micros() - start);
+	}
+	modelCheckTaskHandle = nullptr;
+	vTaskDelete(NULL);
+}
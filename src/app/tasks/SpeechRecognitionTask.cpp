@@ -3,6 +3,57 @@
 
 TaskHandle_t speechRecognitionTaskHandle = nullptr;
 
+// sr_pause() stops the fill callback on purpose
+static bool srPaused = false;
+
+// Runs the step SrWatchdog asks for. A pipeline restart is sr_stop() /
+// sr_start(), which frees and rebuilds the AFE, WakeNet and MultiNet with
+// their models; only what lives outside ESP-SR stays (KWS engines, command
+// sets, the handoff history). Keeping the models loaded across it is not
+// done: the arduino wrapper has no restart that keeps them. A restart that
+// hangs reboots after SR_RESTART_TIMEOUT_MS (restartSpeechRecognition)
+static void watchdogTick() {
+    if (!srWatchdog || srPaused) return;
+
+    SrWatchdogAction action = srWatchdog->check(millis());
+    const SrWatchdogStats& stats = srWatchdog->stats();
+    switch (action) {
+        case SR_WATCHDOG_RESTART_MIC:
+            TLOG("[watchdog] SR stalled (%lu samples/s), restarting the microphone", stats.samplesPerSec);
+            if (restartMicrophone() != ESP_OK) TLOG("[watchdog] microphone restart failed");
+            break;
+
+        case SR_WATCHDOG_RESTART_PIPELINE: {
+            TLOG("[watchdog] still stalled, restarting microphone and ESP-SR (attempt %u of %u)",
+                srWatchdog->step() - 1, SR_WATCHDOG_ATTEMPTS);
+            uint32_t start = millis();
+            restartMicrophone();
+            // A command window open at the stall is lost
+            srHoldWakeWord();
+            esp_err_t err = restartSpeechRecognition();
+            srArmWakeWord();
+            TLOG("[watchdog] microphone and ESP-SR restarted in %lu ms (%s)", millis() - start, esp_err_to_name(err));
+            break;
+        }
+
+        case SR_WATCHDOG_REBOOT:
+            TLOG("[watchdog] no audio after %u restarts, rebooting", SR_WATCHDOG_ATTEMPTS);
+            vTaskDelay(pdMS_TO_TICKS(200));  // let logTask drain
+            esp_restart();
+            break;
+
+        default: {
+            static uint32_t recoveries = 0;
+            if (stats.recoveries != recoveries) {
+                recoveries = stats.recoveries;
+                TLOG("[watchdog] audio back: outage %lu ms, recovered %lu ms after detection (max outage %lu ms)",
+                    stats.lastOutageMs, stats.lastRecoveryMs, stats.maxOutageMs);
+            }
+            break;
+        }
+    }
+}
+
 void speechRecognitionTask(void* param) {
     const char* TAG = "speechRecognitionTask";
     
@@ -21,6 +72,9 @@ void speechRecognitionTask(void* param) {
     
     while (1) {
         vTaskDelayUntil(&lastWakeTime, updateFrequency);
+        watchdogTick();
+        srWakeNetTick();
+        srProfileTick();
         
         // Monitor system health
         static int counter = 0;
@@ -28,9 +82,25 @@ void speechRecognitionTask(void* param) {
             int free_heap = heap_caps_get_free_size(MALLOC_CAP_8BIT);
             int internal_heap = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
             ESP_LOGI(TAG, "System Health - Free Heap: %d, Internal: %d", free_heap, internal_heap);
+
+            if (commandDispatcher) {
+                CommandDispatcherStats stats = commandDispatcher->getStats();
+                ESP_LOGI(TAG, "SR callback - last: %" PRIu32 "us, worst: %" PRIu32 "us | queue worst: %" PRIu32 "us, handler worst: %" PRIu32 "us | posted: %" PRIu32 ", dropped: %" PRIu32,
+                    stats.callbackLastUs, stats.callbackMaxUs, stats.queueMaxUs, stats.handlerMaxUs, stats.posted, stats.dropped);
+            }
+
+            srProfileReport();
+            srModelsReport();
+            srWakeNetReport();
             
-            // Check if SR system is still running
-            if (sr_system_running) {
+            // sr_system_running only says sr_start() succeeded; the
+            // watchdog knows whether audio is actually flowing
+            if (srWatchdog) {
+                const SrWatchdogStats& stats = srWatchdog->stats();
+                ESP_LOGI(TAG, "SR %s - %" PRIu32 " samples/s | stalls: %" PRIu32 ", recovered: %" PRIu32 ", last outage: %" PRIu32 "ms, max: %" PRIu32 "ms",
+                    srPaused ? "paused" : srWatchdog->recovering() ? "stalled, recovering" : "running normally",
+                    stats.samplesPerSec, stats.stalls, stats.recoveries, stats.lastOutageMs, stats.maxOutageMs);
+            } else if (sr_system_running) {
                 ESP_LOGI(TAG, "SR system running normally");
             } else {
                 ESP_LOGW(TAG, "SR system appears to be stopped");
@@ -48,9 +118,12 @@ void speechRecognitionTask(void* param) {
                 if (strcmp(command, "pause_sr") == 0) {
                     ESP_LOGI(TAG, "Pausing speech recognition");
                     sr_pause();
+                    srPaused = true;
                 } else if (strcmp(command, "resume_sr") == 0) {
                     ESP_LOGI(TAG, "Resuming speech recognition");
                     sr_resume();
+                    srPaused = false;
+                    if (srWatchdog) srWatchdog->rearm(millis());
                 }
             }
 				}
@@ -3,8 +3,9 @@
 
 #include "esp32-hal-sr.h"
 
-// Define voice commands (phonetic representations)
-static const sr_cmd_t voice_commands[] = {
+// Define voice commands (phonetic representations). Command sets are ranges
+// of this table (COMMAND_SETS), keep the phrases of one set together
+static constexpr sr_cmd_t voice_commands[] = {
 	{0, "Turn on the light", "TkN nN jc LiT"},
 	{0, "Switch on the light", "SWgp nN jc LiT"},
 	{1, "Turn off the light", "TkN eF jc LiT"},
@@ -13,6 +14,95 @@ static const sr_cmd_t voice_commands[] = {
 	{2, "Start fan", "STnRT FaN"},
 	{3, "Stop fan", "STnP FaN"},
 };
+static constexpr size_t VOICE_COMMAND_COUNT = sizeof(voice_commands) / sizeof(sr_cmd_t);
+
+// MultiNet command sets, each the phrases of a range of command_ids
+// (setupCommandSets). The phrases of a set have to follow each other in
+// voice_commands, which the static_assert below checks
+struct CommandSetRange {
+	const char* name;
+	int firstId;
+	int lastId;
+};
+static constexpr CommandSetRange COMMAND_SETS[] = {
+	{"global", 0, 3},
+	{"lights", 0, 1},
+	{"fan", 2, 3},
+};
+
+constexpr bool inCommandSet(const CommandSetRange& set, size_t phrase) {
+	return voice_commands[phrase].command_id >= set.firstId && voice_commands[phrase].command_id <= set.lastId;
+}
+
+// First phrase of a set in voice_commands
+constexpr size_t commandSetFirst(const CommandSetRange& set) {
+	size_t i = 0;
+	while (i < VOICE_COMMAND_COUNT && !inCommandSet(set, i)) i++;
+	return i;
+}
+
+// Phrases from the first one up to the first phrase outside the set
+constexpr size_t commandSetCount(const CommandSetRange& set) {
+	size_t first = commandSetFirst(set);
+	size_t i = first;
+	while (i < VOICE_COMMAND_COUNT && inCommandSet(set, i)) i++;
+	return i - first;
+}
+
+// Every set has phrases and none of them come after its range
+constexpr bool commandSetsContiguous() {
+	for (const CommandSetRange& set : COMMAND_SETS) {
+		size_t count = commandSetCount(set);
+		if (!count) return false;
+		for (size_t i = commandSetFirst(set) + count; i < VOICE_COMMAND_COUNT; i++) {
+			if (inCommandSet(set, i)) return false;
+		}
+	}
+	return true;
+}
+static_assert(commandSetsContiguous(), "each command set needs phrases, and they must follow each other in voice_commands");
+
+// Models in the "model" partition (model/target/srmodels.bin). ESP-SR maps
+// them itself inside sr_start() (esp_srmodel_init), MultiNet is only kept
+// in command mode (callback/sr_models.cpp); boot only checks they are in
+// the pack and modelCheckTask verifies their CRC afterwards. WakeNet
+// and MultiNet are required, without the NS / VAD models the AFE falls back
+// to WebRTC (callback/sr_profile.cpp). The WakeNet models of the other
+// WAKE_WORDS are checked too, a missing one only loses its word.
+static const char* SR_MODEL_PARTITION = "model";
+// ESP-SR input: 16 kHz mono PCM16
+static const uint32_t SR_SAMPLES_PER_MS = 16;
+// Samples the AFE asks for per fill call (its feed chunk), what the I2S DMA
+// geometry is matched to
+static const uint16_t SR_FEED_CHUNK_SAMPLES = 512;
+static const char* SR_MODELS_REQUIRED[] = {"wn9_hiesp", "mn5q8_en", "fst"};
+static const char* SR_MODELS_OPTIONAL[] = {"nsnet2", "vadnet1_medium"};
+// Keyword spotter containers (model/pack_nnm.py) are <name>/model.nnm in the
+// model partition; a linked kwsModel() stands in for KWS_MODEL_NAME
+static const char* KWS_MODEL_NAME = "kws_hiesp";
+static const char* KWS_MODEL_FILE = "model.nnm";
+static const uint8_t KWS_MAX_DETECTORS = 4;
+
+// Wake words and the command set each one opens (nullptr keeps the current
+// set). An entry without a label is a WakeNet word and names its wn9 model
+// in the model partition; ESP-SR runs the first two of them side by side
+// (callback/wakenet.cpp). The others are lib/Kws labels, several labels may
+// share one container. WAKEWORD_ENGINE picks which kind runs; with both, a
+// KWS entry named like a WakeNet word is skipped.
+struct WakeWord {
+	const char* name;
+	const char* model;      // WakeNet model or KWS container
+	const char* label;      // KWS output label, nullptr for WakeNet
+	float threshold;        // KWS smoothed posterior
+	const char* commandSet;
+};
+static const WakeWord WAKE_WORDS[] = {
+	{"Hi ESP", "wn9_hiesp", nullptr, 0.0f, nullptr},
+	{"Computer", "wn9_computer_tts", nullptr, 0.0f, "lights"},
+	{"Hi ESP", "kws_hiesp", "hi_esp", 0.80f, nullptr},
+	{"Computer", "kws_computer", "computer", 0.80f, "lights"},
+};
+static const uint8_t WAKE_WORD_COUNT = sizeof(WAKE_WORDS) / sizeof(WAKE_WORDS[0]);
 
 static const char* NOTIFICATION_WAKEWORD = "wakeword";
 static const char* NOTIFICATION_DISPLAY = "display";
@@ -23,6 +113,11 @@ static const char* NOTIFICATION_COMMAND = "command";
 static const char* EVENT_DISPLAY_WAKEWORD = "display_wakeword";
 static const char* EVENT_DISPLAY_COMMAND = "display_command";
 static const char* EVENT_DISPLAY_LISTENING = "display_listening";
+static const char* EVENT_DISPLAY_TIMEOUT = "display_timeout";
+static const char* EVENT_DISPLAY_LIGHTS_ON = "LIGHTS_ON";
+static const char* EVENT_DISPLAY_LIGHTS_OFF = "LIGHTS_OFF";
+static const char* EVENT_DISPLAY_FAN_START = "FAN_START";
+static const char* EVENT_DISPLAY_FAN_STOP = "FAN_STOP";
 
 // SR Events
 static const char* EVENT_SR_WAKEWORD = "sr_wakeword";
@@ -8,11 +8,23 @@
 #include "Notification.h"
 #include "Display.h"
 #include "Face.h"
+#include "BootGraph.h"
+#include "CommandDispatcher.h"
+#include "ModelLoader.h"
+#include "TokenLog.h"
+#include "KwsEngine.h"
+#include "KwsModelFile.h"
+#include "AudioReplay.h"
+#include "NoiseFloor.h"
+#include "SrWatchdog.h"
+#include "CommandSets.h"
+#include <freertos/stream_buffer.h>
 #include "esp32-hal-sr.h"
 
 #if (MIC_TYPE == MIC_TYPE_I2S)
-#include "I2SMicrophone.h"
-extern I2SMicrophone* microphone;
+#include "I2SDmaMicrophone.h"
+#include "I2SDmaBench.h"
+extern I2SDmaMicrophone* microphone;
 void setupI2SMicrophone();
 #else 
 #include "AnalogMicrophone.h"
@@ -22,10 +34,41 @@ void setupAnalogMicrophone();
 
 extern Notification* notification;
 extern Face* faceDisplay;
+extern CommandDispatcher* commandDispatcher;
+extern ModelPack* modelPack;
+extern ModelLoader* modelLoader;
 extern bool sr_system_running;
+extern BootGraph bootGraph;
+// One lib/Kws engine per KWS wake word, all fed by kwsTask
+struct KwsDetector {
+	KwsEngine* engine;
+	uint8_t word;  // index in WAKE_WORDS
+};
+extern KwsDetector kwsDetectors[KWS_MAX_DETECTORS];
+extern uint8_t kwsDetectorCount;
+extern StreamBufferHandle_t kwsAudio;
+extern AudioReplay* srReplay;
+extern CommandSets* commandSets;
+extern SrWatchdog* srWatchdog;
+
+// Keyword spotter network, weak nullptr default; tools/kws_bench --export-c
+// generates the definition. Without it the network comes from the
+// KWS_MODEL_NAME container in the model partition like the other words
+const KwsModel* kwsModel();
 
 void setupApp();
+void logBootTrace();
 
 void setupNotification();
+void setupCommandDispatcher();
 void setupFaceDisplay(uint16_t size = 40);
-void setupSpeechRecognition();
\ No newline at end of file
+esp_err_t setupModels();
+void setupSpeechRecognition();
+// sr_stop() if running, then sr_start() with the same microphone, idle mode
+// and the selected command set
+esp_err_t restartSpeechRecognition();
+// Stops and starts the microphone driver, keeping its configuration
+esp_err_t restartMicrophone();
+esp_err_t setupKeywordSpotter();
+esp_err_t setupAudioReplay();
+void setupCommandSets();
\ No newline at end of file
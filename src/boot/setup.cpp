@@ -1,59 +1,194 @@
 #include "init.h"
+#include "app/command_list.h"
+
+#if DISPLAY_TYPE == DISPLAY_TYPE_SSD1306_SPI
+#include "SpiDmaDisplay.h"
+#elif DISPLAY_TYPE == DISPLAY_TYPE_PBM
+#include "PbmSink.h"
+#else
+#include "I2CDisplay.h"
+#endif
 
 #if MIC_TYPE == MIC_TYPE_I2S
-I2SMicrophone* microphone = nullptr;
+I2SDmaMicrophone* microphone = nullptr;
 #else
 AnalogMicrophone* amicrophone = nullptr;
 #endif
 
 Notification *notification = nullptr;
 Face* faceDisplay = nullptr;
+CommandDispatcher* commandDispatcher = nullptr;
+ModelPack* modelPack = nullptr;
+ModelLoader* modelLoader = nullptr;
 bool sr_system_running = false;
+KwsDetector kwsDetectors[KWS_MAX_DETECTORS];
+uint8_t kwsDetectorCount = 0;
+StreamBufferHandle_t kwsAudio = nullptr;
+AudioReplay* srReplay = nullptr;
+CommandSets* commandSets = nullptr;
+SrWatchdog* srWatchdog = nullptr;
 
-void setupApp(){
-	Serial.println("[setupApp] initiate global variable");
+BootGraph bootGraph;
+
+// Boot steps: wrap the setup functions so the graph can see their result
 
-	Wire.begin(SDA_PIN, SCL_PIN);
-	
+static esp_err_t bootWire() {
+	return Wire.begin(SDA_PIN, SCL_PIN) ? ESP_OK : ESP_FAIL;
+}
+
+static esp_err_t bootNotification() {
 	setupNotification();
+	return notification ? ESP_OK : ESP_ERR_NO_MEM;
+}
+
+static esp_err_t bootCommandDispatcher() {
+	setupCommandDispatcher();
+	return commandDispatcher ? ESP_OK : ESP_ERR_NO_MEM;
+}
+
+static esp_err_t bootMicrophone() {
 #if MIC_TYPE == MIC_TYPE_I2S
 	setupI2SMicrophone();
+	return microphone && microphone->isInitialized() ? ESP_OK : ESP_FAIL;
+#else
+	setupAnalogMicrophone();
+	return amicrophone && amicrophone->isInitialized() ? ESP_OK : ESP_FAIL;
+#endif
+}
+
+static esp_err_t bootDisplay() {
+#if DISPLAY_TYPE == DISPLAY_TYPE_SSD1306_SPI
+	SpiDmaDisplay::Pins pins = {DISPLAY_SCK, DISPLAY_MOSI, DISPLAY_CS, DISPLAY_DC, DISPLAY_RST};
+	DisplayBackend* backend = new SpiDmaDisplay(pins, DISPLAY_SPI_CLOCK);
+#elif DISPLAY_TYPE == DISPLAY_TYPE_PBM
+	DisplayBackend* backend = new PbmSink(Serial);
+#elif DISPLAY_TYPE == DISPLAY_TYPE_SH1106_I2C
+	DisplayBackend* backend = new I2CDisplay(I2CPanel::SH1106, SDA_PIN, SCL_PIN);
 #else
-    setupAnalogMicrophone();
+	DisplayBackend* backend = new I2CDisplay(I2CPanel::SSD1306, SDA_PIN, SCL_PIN);
 #endif
-	setupDisplay(SDA_PIN, SCL_PIN);
+	if (!backend) return ESP_ERR_NO_MEM;
+	if (!setupDisplay(backend)) return ESP_FAIL;
+	TLOG("[display] %s", display->name());
+	return ESP_OK;
+}
+
+static esp_err_t bootFace() {
 	setupFaceDisplay(40);
+	return faceDisplay ? ESP_OK : ESP_ERR_NO_MEM;
+}
+
+static esp_err_t bootSpeechRecognition() {
 	setupSpeechRecognition();
+	return sr_system_running ? ESP_OK : ESP_FAIL;
+}
+
+void setupApp(){
+	TLOG("[setupApp] initiate global variable");
+	TLOG("[setupApp] nn kernels: %s", nnBackendName(nnInit()));
+
+	// Display chain on core 1, audio chain on core 0; only SR has to wait
+	// for both the microphone and the models
+	BootStepMask wire = bootGraph.add("wire", bootWire, 0, 1);
+	BootStepMask notify = bootGraph.add("notification", bootNotification);
+	BootStepMask dispatcher = bootGraph.add("dispatcher", bootCommandDispatcher);
+	BootStepMask mic = bootGraph.add("microphone", bootMicrophone, 0, 0);
+	BootStepMask models = bootGraph.add("models", setupModels, 0, 0);
+	BootStepMask lcd = bootGraph.add("display", bootDisplay, wire, 1);
+	bootGraph.add("face", bootFace, lcd, 1);
+	bootGraph.add("sr", bootSpeechRecognition, mic | models | dispatcher | notify, 0, 8192);
+
+	esp_err_t ret = bootGraph.run(pdMS_TO_TICKS(30000));
+	if (ret != ESP_OK) {
+		TLOG("[setupApp] boot finished with errors: %s", esp_err_to_name(ret));
+	}
+	logBootTrace();
+}
+
+void logBootTrace() {
+	for (size_t i = 0; i < bootGraph.count(); i++) {
+		const BootStepInfo* step = bootGraph.step(i);
+		if (step->core < 0) {
+			TLOG("[boot] %s: not run (%s)", step->name, esp_err_to_name(step->result));
+			continue;
+		}
+		TLOG("[boot] %s: core %d, %lu -> %lu us (%lu us)",
+			step->name, step->core, step->startUs, step->endUs, step->endUs - step->startUs);
+		if (step->result != ESP_OK) {
+			TLOG("[boot] %s: %s%s", step->name, esp_err_to_name(step->result), step->skipped ? " (dependency failed)" : "");
+		}
+	}
+	TLOG("[boot] graph: %lu us wall, %lu us of steps", bootGraph.endUs() - bootGraph.startUs(), bootGraph.busyUs());
+
+	const BootStepInfo* sr = bootGraph.step("sr");
+	if (sr && sr->result == ESP_OK) {
+		TLOG("[boot] time-to-listening: %lu ms since reset", sr->endUs / 1000);
+	} else {
+		TLOG("[boot] time-to-listening: SR not running");
+	}
 }
 
 #if MIC_TYPE == MIC_TYPE_I2S
-// New setup function for I2SMicrophone using ESP-IDF v5+ API
+// DMA buffers that divide the ESP-SR feed chunk, at most latencyMs long
+static I2SDmaGeometry micDmaGeometry(uint16_t latencyMs) {
+    I2SDmaTarget target = {SR_SAMPLES_PER_MS * 1000, sizeof(int16_t), SR_FEED_CHUNK_SAMPLES, latencyMs, MIC_DMA_HEADROOM_MS};
+    return i2sDmaGeometry(target);
+}
+
+#if MIC_DMA_BENCH
+// Every latency target, then the IDF default (6 x 240) for comparison.
+// Runs before ESP-SR owns the microphone
+static void benchMicDma() {
+    static const uint16_t targets[] = {2, 4, 8, 16, 32};
+    const uint8_t count = sizeof(targets) / sizeof(targets[0]);
+    for (uint8_t i = 0; i <= count; i++) {
+        I2SDmaGeometry geometry = i < count ? micDmaGeometry(targets[i]) : I2SDmaGeometry{6, 240};
+        I2SDmaBenchResult r;
+        esp_err_t err = i2sDmaBench(*microphone, SR_SAMPLES_PER_MS * 1000, geometry, SR_FEED_CHUNK_SAMPLES, 3000, r);
+        if (err != ESP_OK) {
+            TLOG("[mic-bench] %u x %u failed: %s", geometry.descNum, geometry.frameNum, esp_err_to_name(err));
+            continue;
+        }
+        TLOG("[mic-bench] %u x %u: %lu irq/s, %lu overflows, %lu partial reads",
+            geometry.descNum, geometry.frameNum, r.interruptsPerSec, r.overflows, r.partialReads);
+        TLOG("[mic-bench] %u x %u: latency avg %lu us max %lu us, read blocks %lu us",
+            geometry.descNum, geometry.frameNum, r.avgLatencyUs, r.maxLatencyUs, r.avgReadUs);
+    }
+}
+#endif
+
 void setupI2SMicrophone() {
-    Serial.println("[setupI2SMicrophone] Initializing I2S Standard driver...");
+    TLOG("[setupI2SMicrophone] Initializing I2S driver...");
     
     if (!microphone) {
-        microphone = new I2SMicrophone(
+        microphone = new I2SDmaMicrophone(
             (gpio_num_t)MIC_DIN,    // Data pin
             (gpio_num_t)MIC_SCK,    // Clock pin  
-            (gpio_num_t)MIC_WS,     // Word select pin
+            (gpio_num_t)MIC_WS,     // Word select pin, NC for PDM
             I2S_NUM_0               // Port number
         );
+#if MIC_DMA_BENCH
+        benchMicDma();
+#endif
         
         // Configure for ESP-SR requirements: 16kHz, 16-bit, mono
-        esp_err_t ret = microphone->init(16000, I2S_DATA_BIT_WIDTH_16BIT, I2S_SLOT_MODE_MONO);
+        I2SDmaGeometry geometry = micDmaGeometry(MIC_DMA_LATENCY_MS);
+        esp_err_t ret = microphone->init(SR_SAMPLES_PER_MS * 1000, I2S_DATA_BIT_WIDTH_16BIT, I2S_SLOT_MODE_MONO, geometry);
         if (ret != ESP_OK) {
-            Serial.printf("[setupI2SMicrophone] ERROR: Failed to initialize I2S Standard driver: %s\n", esp_err_to_name(ret));
+            TLOG("[setupI2SMicrophone] ERROR: Failed to initialize I2S driver: %s", esp_err_to_name(ret));
             return;
         }
         
         // Start the I2S channel
         ret = microphone->start();
         if (ret != ESP_OK) {
-            Serial.printf("[setupI2SMicrophone] ERROR: Failed to start I2S Standard driver: %s\n", esp_err_to_name(ret));
+            TLOG("[setupI2SMicrophone] ERROR: Failed to start I2S driver: %s", esp_err_to_name(ret));
             return;
         }
         
-        Serial.println("[setupI2SMicrophone] I2S Standard driver initialized and started successfully");
+        TLOG("[setupI2SMicrophone] DMA %u x %u frames: %lu us per buffer, %lu irq/s",
+            geometry.descNum, geometry.frameNum, i2sDmaBufferUs(geometry, microphone->sampleRate()),
+            i2sDmaInterruptsPerSec(geometry, microphone->sampleRate()));
     }
 }
 #else
@@ -63,11 +198,12 @@ void setupAnalogMicrophone(){
         
         esp_err_t ret = amicrophone->init();
         if (ret != ESP_OK) {
-            Serial.printf("[setupAnalogMicrophone] ERROR: Failed to start analog microphone: %s\n", esp_err_to_name(ret));
+            TLOG("[setupAnalogMicrophone] ERROR: Failed to start analog microphone: %s", esp_err_to_name(ret));
             return;
         }
         amicrophone->setGain(INPUT);
         amicrophone->setAttackRelease(true);
+        // AGC settle time; only holds back SR, display and face boot meanwhile
         delay(1000);
     }
 }
@@ -80,9 +216,77 @@ void setupNotification() {
 	}
 }
 
+void setupCommandDispatcher() {
+	if (!commandDispatcher) {
+		commandDispatcher = new CommandDispatcher(8);
+
+		commandDispatcher->onEvent(SR_EVENT_WAKEWORD, onWakeWord);
+		commandDispatcher->onEvent(SR_EVENT_WAKEWORD_CHANNEL, onWakeWord);
+		commandDispatcher->onEvent(SR_EVENT_COMMAND, onCommandDetected);
+		commandDispatcher->onEvent(SR_EVENT_TIMEOUT, onCommandTimeout);
+		commandDispatcher->onUnknown(onUnknownCommand);
+
+		// command_id groups from voice_commands
+		commandDispatcher->onCommand(0, onLightOn);
+		commandDispatcher->onCommand(1, onLightOff);
+		commandDispatcher->onCommand(2, onFanStart);
+		commandDispatcher->onCommand(3, onFanStop);
+	}
+}
+
+esp_err_t setupModels() {
+	if (modelLoader) return ESP_OK;
+
+	uint32_t start = micros();
+	modelPack = new ModelPack();
+
+	// Only the header and index page, each model maps its own range on use
+	esp_err_t ret = modelPack->mapIndex(SR_MODEL_PARTITION);
+	if (ret != ESP_OK) {
+		TLOG("[setupModels] ERROR: cannot read model partition: %s", esp_err_to_name(ret));
+		delete modelPack;
+		modelPack = nullptr;
+		return ret;
+	}
+	if (modelPack->version() < ModelPack::VERSION) {
+		TLOG("[setupModels] srmodels.bin v%d has no checksums, repack with model/pack_model.py", modelPack->version());
+	}
+
+	// KWS containers and modelCheckTask map models through the loader; ESP-SR
+	// maps its own. Only presence is checked here, the CRCs cost too much
+	// flash reading for the boot path
+	modelLoader = new ModelLoader(*modelPack, MODEL_LOAD_MAP);
+	uint32_t offset, size;
+	for (size_t i = 0; i < sizeof(SR_MODELS_REQUIRED) / sizeof(SR_MODELS_REQUIRED[0]); i++) {
+		if (!modelPack->locateModel(SR_MODELS_REQUIRED[i], &offset, &size)) {
+			TLOG("[setupModels] ERROR: %s is not in the model partition", SR_MODELS_REQUIRED[i]);
+			ret = ESP_ERR_NOT_FOUND;
+		}
+	}
+	for (size_t i = 0; i < sizeof(SR_MODELS_OPTIONAL) / sizeof(SR_MODELS_OPTIONAL[0]); i++) {
+		if (!modelPack->locateModel(SR_MODELS_OPTIONAL[i], &offset, &size)) {
+			TLOG("[setupModels] %s is not in the model partition, the AFE uses WebRTC instead", SR_MODELS_OPTIONAL[i]);
+		}
+	}
+	for (uint8_t i = 0; i < WAKE_WORD_COUNT; i++) {
+		if (WAKE_WORDS[i].label || modelPack->locateModel(WAKE_WORDS[i].model, &offset, &size)) continue;
+		TLOG("[setupModels] %s is not in the model partition, WakeNet does not hear %s", WAKE_WORDS[i].model, WAKE_WORDS[i].name);
+	}
+
+	for (size_t i = 0; i < modelPack->modelCount(); i++) {
+		const char* name = modelPack->modelName(i);
+		TLOG("[setupModels] %s: %lu bytes", name, (uint32_t)modelPack->modelSize(name));
+	}
+
+	TLOG("[setupModels] %u models in pack, boot cost %lu us", modelPack->modelCount(), micros() - start);
+	return ret;
+}
+
 void setupFaceDisplay(uint16_t size) {
 	if (!faceDisplay) {
 		faceDisplay = new Face(display, SCREEN_WIDTH, SCREEN_HEIGHT, size);
+		// displayTask's scene manager flushes each frame
+		faceDisplay->AutoFlush = false;
     faceDisplay->Expression.GoTo_Normal();
 		faceDisplay->LookFront();
 
@@ -126,63 +330,286 @@ void setupFaceDisplay(uint16_t size) {
 	}
 }
 
+__attribute__((weak)) const KwsModel* kwsModel() {
+	return nullptr;
+}
+
+// Audio queued between the fill callback and kwsTask
+static const size_t KWS_AUDIO_BYTES = 16000 / 4 * sizeof(int16_t);
+
+// Containers stay mapped for the life of the engines: their weights are
+// used in place. Words with the same container share it
+struct KwsContainer {
+	const char* name;
+	NnModelFile file;
+	KwsModelStorage storage;
+};
+static KwsContainer* kwsContainers[KWS_MAX_DETECTORS];
+static uint8_t kwsContainerCount = 0;
+
+static const KwsModel* loadKwsContainer(const char* name) {
+	for (uint8_t i = 0; i < kwsContainerCount; i++) {
+		if (!strcmp(kwsContainers[i]->name, name)) return &kwsContainers[i]->storage.model;
+	}
+	if (kwsContainerCount == KWS_MAX_DETECTORS) return nullptr;
+	if (!modelLoader || modelLoader->acquire(name) != ESP_OK) return nullptr;
+
+	KwsContainer* container = new KwsContainer();
+	container->name = name;
+	esp_err_t err = container->file.open(modelLoader->file(name, KWS_MODEL_FILE));
+	int bad = -1;
+	if (err == ESP_OK) err = kwsModelFromFile(container->file, container->storage, &bad);
+	if (err != ESP_OK) {
+		TLOG("[kws] ERROR: %s/%s: %s (op %d)", name, KWS_MODEL_FILE, esp_err_to_name(err), bad);
+		delete container;
+		modelLoader->release(name);
+		return nullptr;
+	}
+	TLOG("[kws] %s/%s: %u bytes mapped, %u tensors", name, KWS_MODEL_FILE, (unsigned)container->file.size(), container->file.tensorCount());
+	kwsContainers[kwsContainerCount++] = container;
+	return &container->storage.model;
+}
+
+// With both engines WakeNet already listens for its own word
+static bool wakeNetHears(const WakeWord& word) {
+#if WAKEWORD_ENGINE == WAKEWORD_ENGINE_BOTH
+	for (uint8_t i = 0; i < WAKE_WORD_COUNT; i++) {
+		if (!WAKE_WORDS[i].label && !strcmp(WAKE_WORDS[i].name, word.name)) return true;
+	}
+#endif
+	return false;
+}
+
+static KwsEngine* createKwsDetector(const WakeWord& word) {
+	const KwsModel* model = !strcmp(word.model, KWS_MODEL_NAME) ? kwsModel() : nullptr;
+	if (!model) model = loadKwsContainer(word.model);
+	if (!model) {
+		TLOG("[kws] %s: no model linked or in the model partition", word.name);
+		return nullptr;
+	}
+
+	KwsConfig config = {0, word.threshold, 4, 100};
+	while (config.keyword < model->labelCount && strcmp(model->labels[config.keyword], word.label) != 0) {
+		config.keyword++;
+	}
+	if (config.keyword == model->labelCount) {
+		TLOG("[kws] ERROR: %s has no label %s", word.model, word.label);
+		return nullptr;
+	}
+
+	size_t bytes = KwsEngine::arenaSize(*model);
+	void* arena = heap_caps_malloc(bytes, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+	KwsEngine* engine = new KwsEngine();
+	esp_err_t err = arena ? engine->begin(*model, config, arena, bytes) : ESP_ERR_NO_MEM;
+	if (err != ESP_OK) {
+		TLOG("[kws] ERROR: %s: %s", word.name, esp_err_to_name(err));
+		delete engine;
+		heap_caps_free(arena);
+		return nullptr;
+	}
+	TLOG("[kws] %s: %u layers, %u labels, arena %u bytes", word.name, model->layerCount, model->labelCount, (unsigned)bytes);
+	return engine;
+}
+
+esp_err_t setupKeywordSpotter() {
+	if (kwsDetectorCount) return ESP_OK;
+
+	// 10 ms wakes kwsTask once per hop of the usual 16 kHz models
+	StreamBufferHandle_t audio = xStreamBufferCreate(KWS_AUDIO_BYTES, 10 * SR_SAMPLES_PER_MS * sizeof(int16_t));
+	if (!audio) {
+		TLOG("[kws] ERROR: no memory for the audio queue, using WakeNet");
+		return ESP_ERR_NO_MEM;
+	}
+
+	for (uint8_t i = 0; i < WAKE_WORD_COUNT && kwsDetectorCount < KWS_MAX_DETECTORS; i++) {
+		if (!WAKE_WORDS[i].label || wakeNetHears(WAKE_WORDS[i])) continue;
+		KwsEngine* engine = createKwsDetector(WAKE_WORDS[i]);
+		if (engine) kwsDetectors[kwsDetectorCount++] = {engine, i};
+	}
+	if (!kwsDetectorCount) {
+		TLOG("[kws] no wake word has a model, using WakeNet");
+		vStreamBufferDelete(audio);
+		return ESP_ERR_NOT_FOUND;
+	}
+	kwsAudio = audio;
+	return ESP_OK;
+}
+
+esp_err_t setupAudioReplay() {
+	if (srReplay || !SR_HANDOFF_HISTORY_MS) return ESP_OK;
+
+	size_t samples = SR_HANDOFF_HISTORY_MS * SR_SAMPLES_PER_MS;
+	int16_t* history = (int16_t*)heap_caps_malloc(samples * sizeof(int16_t), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+	if (!history) history = (int16_t*)heap_caps_malloc(samples * sizeof(int16_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+	if (!history) {
+		TLOG("[handoff] ERROR: no memory for %u ms of history, commands start at the mode switch", SR_HANDOFF_HISTORY_MS);
+		return ESP_ERR_NO_MEM;
+	}
+
+	AudioReplay* replay = new AudioReplay();
+	replay->begin(history, samples);
+	srReplay = replay;
+	TLOG("[handoff] %u ms of microphone history", SR_HANDOFF_HISTORY_MS);
+	return ESP_OK;
+}
+
+void setupCommandSets() {
+	if (commandSets) return;
+
+	commandSets = new CommandSets(voice_commands, VOICE_COMMAND_COUNT, srLoadCommands);
+	for (const CommandSetRange& set : COMMAND_SETS) {
+		commandSets->add(set.name, commandSetFirst(set), commandSetCount(set));
+	}
+	if (!commandSets->select(SR_COMMAND_SET_DEFAULT)) {
+		TLOG("[commands] unknown set %s, using %s", SR_COMMAND_SET_DEFAULT, commandSets->selected()->name);
+	}
+}
+
+// Microphone handed to the fill callback, kept for restarts
+static void* srMicInstance = nullptr;
+
+// sr_start() with the selected command set. The front-end profile is applied
+// inside it (afe_config_init hook, callback/sr_profile.cpp); the heap it
+// takes is charged to that profile
+static esp_err_t startSpeechRecognition() {
+    const CommandSet* commandSet = commandSets->selected();
+    size_t psram = heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
+    size_t internal = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+    uint32_t start = micros();
+
+    esp_err_t ret = sr_start(
+#if MIC_TYPE == MIC_TYPE_I2S
+        sr_i2s_fill_callback,                              // I2S data fill callback
+#else
+        sr_analog_fill_callback,                           // analog data fill callback
+#endif
+        srMicInstance,                                     // Microphone instance (I2SDmaMicrophone or AnalogMicrophone)
+        SR_CHANNELS_MONO,                                  // Single channel I2S input
+        srIdleMode(),                                      // Start in wake word mode
+        commandSets->commands(commandSet),                 // Commands array of the starting set
+        commandSet->count,                                 // Number of commands
+        sr_event_callback,                                 // Event callback
+        NULL                                               // Event callback argument
+    );
+    if (ret != ESP_OK) return ret;
+
+    commandSets->started();
+    srModelsStarted();
+    srProfileStarted(psram - heap_caps_get_free_size(MALLOC_CAP_SPIRAM),
+        internal - heap_caps_get_free_size(MALLOC_CAP_INTERNAL), micros() - start);
+    return ESP_OK;
+}
+
+// sr_stop() waits for ESP-SR's tasks to exit, which a wedged detect task
+// never does. The restart runs on its own task so the caller can give up
+// after SR_RESTART_TIMEOUT_MS; nothing brings ESP-SR back from there but a
+// reboot
+struct SrRestart {
+    TaskHandle_t caller;
+    esp_err_t result;
+};
+
+static void srRestartTask(void* param) {
+    SrRestart* restart = (SrRestart*)param;
+    if (sr_system_running) sr_stop();
+    restart->result = startSpeechRecognition();
+    xTaskNotifyGive(restart->caller);
+    vTaskDelete(nullptr);
+}
+
+esp_err_t restartSpeechRecognition() {
+    if (!srMicInstance || !commandSets) return ESP_ERR_INVALID_STATE;
+
+    static SrRestart restart;
+    restart.caller = xTaskGetCurrentTaskHandle();
+    restart.result = ESP_FAIL;
+    ulTaskNotifyTake(pdTRUE, 0);
+    if (xTaskCreateUniversal(srRestartTask, "srRestartTask", 1024 * 8, &restart,
+            uxTaskPriorityGet(nullptr), nullptr, tskNO_AFFINITY) != pdPASS) {
+        return ESP_ERR_NO_MEM;
+    }
+    if (!ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(SR_RESTART_TIMEOUT_MS))) {
+        TLOG("[sr] ESP-SR restart still running after %u ms, rebooting", SR_RESTART_TIMEOUT_MS);
+        vTaskDelay(pdMS_TO_TICKS(200));  // let logTask drain
+        esp_restart();
+    }
+    esp_err_t ret = restart.result;
+    sr_system_running = ret == ESP_OK;
+    // The fill callback paused while ESP-SR restarted
+    if (srWatchdog) srWatchdog->rearm(millis());
+    if (ret != ESP_OK) {
+        TLOG("❌ Failed to restart Speech Recognition: %s", esp_err_to_name(ret));
+    }
+    return ret;
+}
+
+esp_err_t restartMicrophone() {
+#if MIC_TYPE == MIC_TYPE_I2S
+    if (!microphone) return ESP_ERR_INVALID_STATE;
+    microphone->stop();
+    return microphone->start();
+#else
+    // The ADC path has no driver state to reset
+    return amicrophone ? ESP_OK : ESP_ERR_INVALID_STATE;
+#endif
+}
+
 void setupSpeechRecognition() {
-    void* mic_instance = nullptr;
 #if MIC_TYPE == MIC_TYPE_I2S
     if (microphone && microphone->isInitialized()) {
-        mic_instance = (void*)microphone;
+        srMicInstance = (void*)microphone;
     } else {
-        Serial.println("❌ Cannot setup SR: No active I2S implementation");
+        TLOG("❌ Cannot setup SR: No active I2S implementation");
         return;
     }
 #else
     if (amicrophone && amicrophone->isInitialized()) {
-        mic_instance = (void*)amicrophone;
+        srMicInstance = (void*)amicrophone;
     } else {
-        Serial.println("❌ Cannot setup SR: No active Analog implementation");
+        TLOG("❌ Cannot setup SR: No active Analog implementation");
         return;
     }
 #endif
     
-    Serial.println("🧠 Setting up Speech Recognition system...");
+    TLOG("🧠 Setting up Speech Recognition system...");
+
+#if WAKEWORD_ENGINE != WAKEWORD_ENGINE_ESP_SR
+    setupKeywordSpotter();
+#endif
+    setupAudioReplay();
+    setupCommandSets();
     
     // Start ESP-SR system with high-level API
-    esp_err_t ret = sr_start(
-#if MIC_TYPE == MIC_TYPE_I2S
-        sr_i2s_fill_callback,                              // I2S data fill callback
-#else
-        sr_analog_fill_callback,                           // analog data fill callback
-#endif
-        mic_instance,                                      // Microphone instance (I2SMicrophone or I2SMicrophone)
-        SR_CHANNELS_MONO,                                  // Single channel I2S input
-        SR_MODE_WAKEWORD,                                  // Start in wake word mode
-        voice_commands,                                    // Commands array
-        sizeof(voice_commands) / sizeof(sr_cmd_t),         // Number of commands
-        sr_event_callback,                                 // Event callback
-        NULL                                               // Event callback argument
-    );
+    esp_err_t ret = startSpeechRecognition();
     
     if (ret == ESP_OK) {
+        const CommandSet* commandSet = commandSets->active();
+        const sr_cmd_t* commands = commandSets->commands(commandSet);
         sr_system_running = true;
-        Serial.println("✅ Speech Recognition started successfully!");
-        Serial.println("🎯 Say 'Hi ESP' to activate, then try commands:");
-        Serial.println("   💡 Light Control:");
-        Serial.println("      • 'Turn on the light' / 'Switch on the light'");
-        Serial.println("      • 'Turn off the light' / 'Switch off the light' / 'Go dark'");
-        Serial.println("   🌀 Fan Control:");
-        Serial.println("      • 'Start fan'");
-        Serial.println("      • 'Stop fan'");
-        Serial.println("");
-        Serial.printf("📋 Loaded %d voice commands:\n", sizeof(voice_commands) / sizeof(sr_cmd_t));
-        for (int i = 0; i < (sizeof(voice_commands) / sizeof(sr_cmd_t)); i++) {
-            Serial.printf("   [%d] Group %d: '%s' -> '%s'\n", 
-                        i, 
-                        voice_commands[i].command_id,
-                        voice_commands[i].str, 
-                        voice_commands[i].phoneme);
+        if (!srWatchdog) {
+            SrWatchdogConfig config = {16000, SR_WATCHDOG_STALL_MS, SR_WATCHDOG_MIN_RATE, SR_WATCHDOG_GRACE_MS, SR_WATCHDOG_ATTEMPTS};
+            srWatchdog = new SrWatchdog(config);
+        }
+        srWatchdog->rearm(millis());
+        TLOG("✅ Speech Recognition started successfully!");
+        TLOG("🎯 Say 'Hi ESP' to activate, then try commands:");
+        TLOG("   💡 Light Control:");
+        TLOG("      • 'Turn on the light' / 'Switch on the light'");
+        TLOG("      • 'Turn off the light' / 'Switch off the light' / 'Go dark'");
+        TLOG("   🌀 Fan Control:");
+        TLOG("      • 'Start fan'");
+        TLOG("      • 'Stop fan'");
+        TLOG("");
+        TLOG("📋 Loaded %d voice commands (set %s):", commandSet->count, commandSet->name);
+        for (int i = 0; i < commandSet->count; i++) {
+            TLOG("   [%d] Group %d: '%s' -> '%s'", 
+                        commandSet->first + i, 
+                        commands[i].command_id,
+                        commands[i].str, 
+                        commands[i].phoneme);
         }
     } else {
-        Serial.printf("❌ Failed to start Speech Recognition: %s\n", esp_err_to_name(ret));
+        TLOG("❌ Failed to start Speech Recognition: %s", esp_err_to_name(ret));
         sr_system_running = false;
     }
 }
\ No newline at end of file
@@ -0,0 +1,144 @@
+// Host check for CommandSets (lib/CommandSets) and the command tables in
+// src/boot/constants.h.
+//   - the firmware's COMMAND_SETS, registered the way setupCommandSets()
+//     does: every set loads, each of its MultiNet phrase ids maps back to a
+//     phrase of its command_id range, and every phrase of the range is
+//     reachable. Wake words only open sets that exist
+//   - the API on a small table: add() rejects empty, out of range,
+//     duplicate and surplus sets; apply() only rebuilds when the selection
+//     changed and keeps the old set when the loader fails; toTable() and
+//     the window statistics
+//
+// Build (from the repository root):
+//   g++ -O2 -std=gnu++17 -Itools/host -Isrc -Ilib/CommandSets/src tools/commandsets_check/commandsets_check.cpp tools/host/host.cpp lib/CommandSets/src/CommandSets.cpp -o commandsets_check
+//
+// Usage:
+//   commandsets_check
+
+#include "CommandSets.h"
+#include "boot/constants.h"
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+namespace {
+
+unsigned failures = 0;
+
+void check(bool ok, const std::string& what) {
+	if (ok) return;
+	failures++;
+	printf("  FAIL %s\n", what.c_str());
+}
+
+// Loader stand-in: records what MultiNet would get
+struct Loads {
+	int count = 0;
+	const sr_cmd_t* commands = nullptr;
+	size_t size = 0;
+	esp_err_t result = ESP_OK;
+};
+Loads loads;
+
+esp_err_t loader(const sr_cmd_t* commands, size_t count) {
+	loads.count++;
+	loads.commands = commands;
+	loads.size = count;
+	return loads.result;
+}
+
+void checkFirmwareSets() {
+	CommandSets sets(voice_commands, VOICE_COMMAND_COUNT, loader);
+	for (const CommandSetRange& range : COMMAND_SETS) {
+		check(sets.add(range.name, commandSetFirst(range), commandSetCount(range)), std::string("add ") + range.name);
+	}
+	sets.started();
+
+	for (const CommandSetRange& range : COMMAND_SETS) {
+		std::string name = range.name;
+		check(sets.select(range.name), "select " + name);
+		sets.apply();
+		const CommandSet* set = sets.active();
+		if (!set || strcmp(set->name, range.name) != 0) {
+			check(false, "active set after apply, " + name);
+			continue;
+		}
+
+		// Every phrase id MultiNet can report lands in the range
+		bool reached[VOICE_COMMAND_COUNT] = {};
+		for (int phrase = 0; phrase < set->count; phrase++) {
+			int index = sets.toTable(phrase);
+			bool ok = index >= 0 && (size_t)index < VOICE_COMMAND_COUNT && inCommandSet(range, index);
+			check(ok, name + " phrase " + std::to_string(phrase) + " maps outside its command_ids");
+			if (ok) reached[index] = true;
+		}
+		check(sets.toTable(set->count) == -1, name + " phrase past the set maps to a command");
+
+		// and every phrase of the range is one of them
+		for (size_t i = 0; i < VOICE_COMMAND_COUNT; i++) {
+			if (inCommandSet(range, i) && !reached[i]) check(false, name + " cannot reach \"" + voice_commands[i].str + "\"");
+		}
+		printf("%-8s command_ids %d..%d: phrases %u..%u\n", range.name, range.firstId, range.lastId, set->first,
+			set->first + set->count - 1);
+	}
+
+	for (const WakeWord& word : WAKE_WORDS) {
+		if (word.commandSet) check(sets.find(word.commandSet), std::string(word.name) + " opens unknown set " + word.commandSet);
+	}
+}
+
+void checkApi() {
+	static const sr_cmd_t table[] = {{0, "a", "a"}, {0, "b", "b"}, {1, "c", "c"}, {2, "d", "d"}};
+	CommandSets sets(table, 4, loader);
+	check(sets.add("all", 0, 4), "add whole table");
+	check(sets.add("front", 0, 3), "add front");
+	check(sets.add("back", 2, 2), "add back");
+	check(!sets.add("past", 3, 2), "add past the end rejected");
+	check(!sets.add("empty", 1, 0), "add empty rejected");
+	check(!sets.add("front", 0, 1), "add duplicate name rejected");
+	static const char* extra[] = {"e3", "e4", "e5", "e6", "e7", "e8"};
+	for (const char* name : extra) sets.add(name, 0, 1);
+	check(sets.count() == CommandSets::MAX_SETS, "sets up to MAX_SETS");
+
+	loads = Loads();
+	sets.started();
+	check(sets.apply() == ESP_OK && loads.count == 0, "apply without a change does not load");
+	check(!sets.select("nope"), "select unknown rejected");
+	check(sets.select("back") && sets.apply() == ESP_OK, "select and apply back");
+	check(loads.count == 1 && loads.commands == table + 2 && loads.size == 2, "back loads phrases 2..3");
+	check(sets.toTable(1) == 3 && sets.toTable(2) == -1 && sets.toTable(-1) == -1, "toTable in back");
+	check(sets.apply() == ESP_OK && loads.count == 1, "second apply does not load");
+
+	loads.result = ESP_FAIL;
+	sets.select("front");
+	check(sets.apply() == ESP_FAIL && strcmp(sets.active()->name, "back") == 0, "failed load keeps back active");
+	loads.result = ESP_OK;
+	check(sets.apply() == ESP_OK && strcmp(sets.active()->name, "front") == 0, "retry loads front");
+
+	sets.windowOpened(100);
+	sets.windowClosed(true, 350);
+	sets.windowOpened(400);
+	sets.windowClosed(false, 900);
+	sets.windowClosed(true, 950);
+	const CommandSetStats* stats = sets.stats(sets.active());
+	check(stats->windows == 2 && stats->commands == 1, "windows and commands counted");
+	check(stats->latencyLastMs == 250 && stats->latencyMaxMs == 250 && stats->latencySumMs == 250, "latency");
+	check(stats->loads == 1, "loads of front");
+	printf("api: %s\n", failures ? "failures above" : "ok");
+}
+
+}  // namespace
+
+int main(int argc, char**) {
+	if (argc > 1) {
+		fprintf(stderr, "usage: commandsets_check\n");
+		return 2;
+	}
+
+	checkFirmwareSets();
+	checkApi();
+
+	printf("%s\n", failures ? "FAIL" : "all checks passed");
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,242 @@
+// Host check and benchmark for CornerTable (lib/FaceDisplay). The midpoint
+// corner loops that EyeDrawer::FillEllipseCorner ran for every corner
+// before the table are kept below as midpointCorner(). For every radius
+// 2..CornerTable::MaxRadius:
+//   - the table's spans must equal the widest run each midpoint pass draws
+//     per row offset
+//   - each of the four corners, drawn by EyeDrawer from the table at a
+//     grid of positions including clipped ones, must match the midpoint
+//     loops pixel for pixel
+// Radii 0, 1 and past MaxRadius must have no table (nothing drawn, or the
+// midpoint fallback). Then both ways are timed per corner.
+//
+// Build (from the repository root):
+//   g++ -O2 -std=gnu++17 -Itools/host -Ilib/FaceDisplay/src tools/corner_check/corner_check.cpp tools/host/host.cpp lib/FaceDisplay/src/CornerTable.cpp -o corner_check
+//
+// Usage:
+//   corner_check [--iterations N]
+
+#include "CornerTable.h"
+#include "EyeDrawer.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+const size_t FrameBytes = 128 * 64 / 8;
+
+unsigned failures = 0;
+
+// EyeDrawer::FillEllipseCorner before CornerTable, as it was
+void midpointCorner(U8G2* gfx, CornerType corner, int16_t x0, int16_t y0, int32_t rx, int32_t ry) {
+	if (rx < 2) return;
+	if (ry < 2) return;
+	int32_t x, y;
+	int32_t rx2 = rx * rx;
+	int32_t ry2 = ry * ry;
+	int32_t fx2 = 4 * rx2;
+	int32_t fy2 = 4 * ry2;
+	int32_t s;
+
+	if (corner == T_R) {
+		for(x = 0, y = ry, s = 2 * ry2 + rx2 * (1 - 2 * ry); ry2 * x <= rx2 * y; x++) {
+			gfx->drawHLine(x0, y0 - y, x);
+			if(s >= 0) {
+				s += fx2 * (1 - y);
+				y--;
+			}
+			s += ry2 * ((4 * x) + 6);
+		}
+		for(x = rx, y = 0, s = 2 * rx2 + ry2 * (1 - 2 * rx); rx2 * y <= ry2 * x; y++) {
+			gfx->drawHLine(x0, y0 - y, x);
+			if (s >= 0) {
+				s += fy2 * (1 - x);
+				x--;
+			}
+			s += rx2 * ((4 * y) + 6);
+		}
+	}
+	else if (corner == B_R) {
+		for (x = 0, y = ry, s = 2 * ry2 + rx2 * (1 - 2 * ry); ry2 * x <= rx2 * y; x++) {
+			gfx->drawHLine(x0, y0 + y -1, x);
+			if (s >= 0) {
+				s += fx2 * (1 - y);
+				y--;
+			}
+			s += ry2 * ((4 * x) + 6);
+		}
+		for (x = rx, y = 0, s = 2 * rx2 + ry2 * (1 - 2 * rx); rx2 * y <= ry2 * x; y++) {
+			gfx->drawHLine(x0, y0 + y -1, x);
+			if (s >= 0) {
+				s += fy2 * (1 - x);
+				x--;
+			}
+			s += rx2 * ((4 * y) + 6);
+		}
+	}
+	else if (corner == T_L) {
+		for (x = 0, y = ry, s = 2 * ry2 + rx2 * (1 - 2 * ry); ry2 * x <= rx2 * y; x++) {
+			gfx->drawHLine(x0-x, y0 - y, x);
+			if (s >= 0) {
+				s += fx2 * (1 - y);
+				y--;
+			}
+			s += ry2 * ((4 * x) + 6);
+		}
+		for (x = rx, y = 0, s = 2 * rx2 + ry2 * (1 - 2 * rx); rx2 * y <= ry2 * x; y++) {
+			gfx->drawHLine(x0-x, y0 - y, x);
+			if (s >= 0) {
+				s += fy2 * (1 - x);
+				x--;
+			}
+			s += rx2 * ((4 * y) + 6);
+		}
+	}
+	else if (corner == B_L) {
+		for (x = 0, y = ry, s = 2 * ry2 + rx2 * (1 - 2 * ry); ry2 * x <= rx2 * y; x++) {
+			gfx->drawHLine(x0-x, y0 + y - 1, x);
+			if (s >= 0) {
+				s += fx2 * (1 - y);
+				y--;
+			}
+			s += ry2 * ((4 * x) + 6);
+		}
+		for (x = rx, y = 0, s = 2 * rx2 + ry2 * (1 - 2 * rx); rx2 * y <= ry2 * x; y++) {
+			gfx->drawHLine(x0-x, y0 + y , x);
+			if (s >= 0) {
+				s += fy2 * (1 - x);
+				x--;
+			}
+			s += rx2 * ((4 * y) + 6);
+		}
+	}
+}
+
+// Widest run of each midpoint pass per row offset, straight from the loops
+std::vector<CornerSpan> midpointSpans(int32_t r) {
+	std::vector<CornerSpan> spans(r + 1, CornerSpan{0, 0});
+	int32_t x, y, s;
+	int32_t r2 = r * r;
+	int32_t f2 = 4 * r2;
+	for (x = 0, y = r, s = 2 * r2 + r2 * (1 - 2 * r); r2 * x <= r2 * y; x++) {
+		spans[y].First = std::max<int32_t>(spans[y].First, x);
+		if (s >= 0) {
+			s += f2 * (1 - y);
+			y--;
+		}
+		s += r2 * ((4 * x) + 6);
+	}
+	for (x = r, y = 0, s = 2 * r2 + r2 * (1 - 2 * r); r2 * y <= r2 * x; y++) {
+		spans[y].Second = std::max<int32_t>(spans[y].Second, x);
+		if (s >= 0) {
+			s += f2 * (1 - x);
+			x--;
+		}
+		s += r2 * ((4 * y) + 6);
+	}
+	return spans;
+}
+
+void checkSpans(int32_t r) {
+	const CornerSpan* table = CornerTable::Spans(r);
+	if (!table) {
+		failures++;
+		printf("  FAIL radius %d: no table\n", r);
+		return;
+	}
+	std::vector<CornerSpan> spans = midpointSpans(r);
+	for (int32_t dy = 0; dy <= r; dy++) {
+		if (table[dy].First != spans[dy].First || table[dy].Second != spans[dy].Second) {
+			if (failures++ < 5) {
+				printf("  FAIL radius %d row %d: table %u/%u, midpoint %u/%u\n", r, dy, table[dy].First,
+					table[dy].Second, spans[dy].First, spans[dy].Second);
+			}
+		}
+	}
+}
+
+unsigned checkPixels(U8G2& gfx, int32_t r) {
+	uint8_t reference[FrameBytes];
+	unsigned cases = 0;
+	for (int corner = T_R; corner <= B_R; corner++) {
+		for (int x = -r - 4; x <= 128 + r + 4; x += 5) {
+			for (int y = -r - 4; y <= 64 + r + 4; y += 3) {
+				gfx.clearBuffer();
+				midpointCorner(&gfx, (CornerType)corner, x, y, r, r);
+				memcpy(reference, gfx.getBufferPtr(), FrameBytes);
+				gfx.clearBuffer();
+				EyeDrawer::FillEllipseCorner(&gfx, (CornerType)corner, x, y, r, r, 1);
+				if (memcmp(reference, gfx.getBufferPtr(), FrameBytes) != 0 && failures++ < 5) {
+					printf("  FAIL radius %d corner %d at %d,%d\n", r, corner, x, y);
+				}
+				cases++;
+			}
+		}
+	}
+	return cases;
+}
+
+void bench(U8G2& gfx, int iterations) {
+	double best[2] = {1e18, 1e18};
+	for (int mode = 0; mode < 2; mode++) {
+		for (int run = 0; run < 15; run++) {
+			auto start = std::chrono::steady_clock::now();
+			int corners = 0;
+			for (int i = 0; i < iterations; i++) {
+				for (int r = 4; r <= 20; r += 4) {
+					for (int corner = T_R; corner <= B_R; corner++) {
+						if (mode == 0) midpointCorner(&gfx, (CornerType)corner, 64, 32, r, r);
+						else EyeDrawer::FillEllipseCorner(&gfx, (CornerType)corner, 64, 32, r, r, 1);
+						corners++;
+					}
+				}
+			}
+			double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+			best[mode] = std::min(best[mode], ns / corners);
+		}
+	}
+	printf("ns per corner, radius 4..20 (best of 15 x %d):\n", iterations);
+	printf("  midpoint  %8.0f\n", best[0]);
+	printf("  table     %8.0f  (%.1fx)\n", best[1], best[0] / best[1]);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+	int iterations = 3000;
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (arg == "--iterations" && i + 1 < argc) iterations = atoi(argv[++i]);
+		else {
+			fprintf(stderr, "usage: corner_check [--iterations N]\n");
+			return 2;
+		}
+	}
+
+	U8G2_SSD1306_128X64_NONAME_F_HW_I2C gfx(U8G2_R0);
+
+	unsigned cases = 0;
+	for (int32_t r = 2; r <= CornerTable::MaxRadius; r++) {
+		checkSpans(r);
+		cases += checkPixels(gfx, r);
+	}
+	printf("radius 2..%d: %u corners drawn, %u failures\n", CornerTable::MaxRadius, cases, failures);
+
+	const int32_t none[] = {-1, 0, 1, CornerTable::MaxRadius + 1, 1000};
+	for (int32_t r : none) {
+		if (CornerTable::Spans(r) != nullptr) {
+			failures++;
+			printf("  FAIL radius %d has a table\n", r);
+		}
+	}
+
+	bench(gfx, iterations);
+
+	printf("%s\n", failures ? "FAIL" : "all checks passed");
+	return failures ? 1 : 0;
+}
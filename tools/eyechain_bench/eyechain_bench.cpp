@@ -0,0 +1,181 @@
+// Host check and benchmark for EyeChain (lib/FaceDisplay): replays the
+// face with random behavior, looks and blinks, and now and then a
+// transition of one eye, on the virtual frame clock, once through
+// Eye::Update and once through EyeChain::Update, and compares every frame
+// buffer and both eyes' Config and FinalConfig (they must not differ).
+// Then times one frame of operator updates for both eyes either way, and
+// the sample / evaluate halves of EyeChain: once in the middle of a
+// transition, a look and a blink, once at rest.
+//
+// Build (from the repository root):
+//   g++ -Os -std=gnu++17 -Itools/host -Ilib/Display/src -Ilib/FaceDisplay/src tools/eyechain_bench/eyechain_bench.cpp tools/host/host.cpp lib/FaceDisplay/src/*.cpp lib/Display/src/DisplayBackend.cpp lib/Display/src/I2CDisplay.cpp -o eyechain_bench
+//
+// The firmware is built with -Os; build with -O2 as well to see how much
+// the result depends on the optimizer.
+//
+// Usage:
+//   eyechain_bench [--seed N] [--frames N] [--iterations N]
+
+#include "EyeChain.h"
+#include "Face.h"
+#include "FrameClock.h"
+#include "I2CDisplay.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct FrameState {
+	uint8_t pixels[128 * 64 / 8];
+	EyeConfig config[2];
+	EyeConfig final[2];
+};
+
+bool sameConfig(const EyeConfig& a, const EyeConfig& b) {
+	return memcmp(&a, &b, sizeof(EyeConfig)) == 0;
+}
+
+Face* makeFace(DisplayBackend& display, bool fused) {
+	display.begin();
+	Face* face = new Face(&display, 128, 64, 40);
+	face->FusedChain = fused;
+	face->AutoFlush = false;
+	face->Behavior.Timer.SetIntervalMillis(400);
+	face->Look.Timer.SetIntervalMillis(250);
+	face->Blink.Timer.SetIntervalMillis(700);
+	for (int e = 0; e < eEmotions::EMOTIONS_COUNT; e++) face->Behavior.SetEmotion((eEmotions)e, 1.0);
+	return face;
+}
+
+std::vector<FrameState> replay(bool fused, uint32_t seed, int frames) {
+	FrameClock::UseVirtual(1000);
+	randomSeed(seed);
+	I2CDisplay display(I2CPanel::SSD1306, 0, 0);
+	Face* face = makeFace(display, fused);
+
+	std::vector<FrameState> states(frames);
+	for (int i = 0; i < frames; i++) {
+		display.gfx().clearBuffer();
+		// Now and then one eye on its own, so the eyes' transitions differ
+		if (i % 150 == 75) face->RightEye.TransitionTo(Preset_Surprised);
+		face->Update();
+		FrameState& s = states[i];
+		memcpy(s.pixels, display.buffer(), sizeof(s.pixels));
+		s.config[0] = face->LeftEye.Config;
+		s.config[1] = face->RightEye.Config;
+		s.final[0] = *face->LeftEye.FinalConfig;
+		s.final[1] = *face->RightEye.FinalConfig;
+		FrameClock::Advance(i % 3 ? 16 : 17);
+	}
+	delete face;
+	return states;
+}
+
+unsigned compare(const std::vector<FrameState>& a, const std::vector<FrameState>& b) {
+	unsigned differ = 0;
+	for (size_t i = 0; i < a.size(); i++) {
+		bool same = memcmp(a[i].pixels, b[i].pixels, sizeof(a[i].pixels)) == 0;
+		for (int eye = 0; eye < 2; eye++) {
+			same = same && sameConfig(a[i].config[eye], b[i].config[eye]) && sameConfig(a[i].final[eye], b[i].final[eye]);
+		}
+		if (!same && differ++ < 3) printf("  FAIL frame %zu differs\n", i);
+	}
+	return differ;
+}
+
+// One run of fn, ns per call, kept in best when lower. The clock moves by
+// step ms before each call
+template <typename Fn>
+void timeRun(double& best, int iterations, unsigned long step, Fn fn) {
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < iterations; i++) {
+		FrameClock::Advance(step);
+		fn();
+	}
+	double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+	best = std::min(best, ns / iterations);
+}
+
+// Best of 15 runs each, the four timings take turns so that a slow stretch
+// of the host hits all of them
+void benchFace(Face* face, int iterations, unsigned long step, const char* title) {
+	Eye* eyes[2] = {&face->LeftEye, &face->RightEye};
+	EyeChainFrame frame;
+	volatile int sink = 0;
+	double chain = 1e18, fused = 1e18, sample = 1e18, evaluate = 1e18;
+
+	for (int run = 0; run < 15; run++) {
+		timeRun(chain, iterations, step, [&] {
+			face->LeftEye.Update();
+			face->RightEye.Update();
+			sink = sink + face->LeftEye.FinalConfig->Height;
+		});
+		timeRun(fused, iterations, step, [&] {
+			face->Chain.Update(face->LeftEye, face->RightEye);
+			sink = sink + face->LeftEye.FinalConfig->Height;
+		});
+		timeRun(sample, iterations, step, [&] {
+			EyeChain::Sample(eyes, frame);
+			sink = sink + (int)frame.Transition[0];
+		});
+		timeRun(evaluate, iterations, step, [&] {
+			face->Chain.Evaluate(eyes, frame);
+			sink = sink + face->LeftEye.FinalConfig->Height;
+		});
+	}
+
+	printf("%s, both eyes, ns per frame (best of 15 x %d):\n", title, iterations);
+	printf("  Eye::Update x2        %8.1f\n", chain);
+	printf("  EyeChain::Update      %8.1f  (%+.0f%%)\n", fused, (fused / chain - 1.0) * 100.0);
+	printf("    Sample              %8.1f\n", sample);
+	printf("    Evaluate            %8.1f\n", evaluate);
+}
+
+void bench(int iterations) {
+	FrameClock::UseVirtual(1000);
+	I2CDisplay display(I2CPanel::SSD1306, 0, 0);
+	Face* face = makeFace(display, false);
+	// Every operator active: a transition, a look, a blink and variations,
+	// held 60 ms in with the eyes closed
+	face->Expression.GoTo_Normal();
+	face->LookLeft();
+	face->DoBlink();
+	FrameClock::Advance(60);
+	benchFace(face, iterations, 0, "mid transition and blink");
+
+	// Most frames: transition and look done, eyes open, variations running
+	FrameClock::Advance(1000);
+	benchFace(face, iterations, 1, "at rest");
+	delete face;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+	uint32_t seed = 7;
+	int frames = 5000;
+	int iterations = 200000;
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		bool value = i + 1 < argc;
+		if (arg == "--seed" && value) seed = (uint32_t)atoi(argv[++i]);
+		else if (arg == "--frames" && value) frames = atoi(argv[++i]);
+		else if (arg == "--iterations" && value) iterations = atoi(argv[++i]);
+		else {
+			fprintf(stderr, "usage: eyechain_bench [--seed N] [--frames N] [--iterations N]\n");
+			return 2;
+		}
+	}
+
+	unsigned differ = compare(replay(false, seed, frames), replay(true, seed, frames));
+	printf("replay: %d frames, %u differ\n", frames, differ);
+	bench(iterations);
+
+	printf("%s\n", differ ? "FAIL" : "all checks passed");
+	return differ ? 1 : 0;
+}
@@ -0,0 +1,279 @@
+// Golden-image check and benchmark for EyeRaster (lib/FaceDisplay). The
+// golden images come from EyeDrawer, the U8g2 primitive path, drawn on
+// tools/host's U8g2 stand-in:
+//   - every preset, plain and mirrored, at a grid of centres including
+//     clipped ones, and random eye configs: one eye on a blank frame must
+//     match EyeDrawer exactly
+//   - overlapping pairs of random eyes and a face replay with SpanRaster
+//     on: each frame must equal the OR of both eyes drawn with EyeDrawer on
+//     blank frames. EyeDrawer on one shared frame can differ there, because
+//     its erase triangles (draw color 0) also clear pixels of the eye drawn
+//     before; those frames are counted
+// Then EyeDrawer and EyeRaster are timed per eye over the presets.
+//
+// Build (from the repository root):
+//   g++ -O2 -std=gnu++17 -Itools/host -Ilib/Display/src -Ilib/FaceDisplay/src tools/eyeraster_check/eyeraster_check.cpp tools/host/host.cpp lib/FaceDisplay/src/*.cpp lib/Display/src/DisplayBackend.cpp lib/Display/src/I2CDisplay.cpp -o eyeraster_check
+//
+// Usage:
+//   eyeraster_check [--seed N] [--eyes N] [--frames N] [--iterations N]
+
+#include "EyeDrawer.h"
+#include "EyePresets.h"
+#include "EyeRaster.h"
+#include "Face.h"
+#include "FrameClock.h"
+#include "I2CDisplay.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+
+namespace {
+
+const size_t FrameBytes = 128 * 64 / 8;
+
+const EyeConfig* const Presets[] = {
+	&Preset_Normal, &Preset_Angry, &Preset_Glee, &Preset_Happy, &Preset_Sad, &Preset_Worried,
+	&Preset_Worried_Alt, &Preset_Focused, &Preset_Annoyed, &Preset_Annoyed_Alt, &Preset_Surprised,
+	&Preset_Skeptic, &Preset_Skeptic_Alt, &Preset_Frustrated, &Preset_Unimpressed, &Preset_Unimpressed_Alt,
+	&Preset_Sleepy, &Preset_Sleepy_Alt, &Preset_Suspicious, &Preset_Suspicious_Alt, &Preset_Squint,
+	&Preset_Squint_Alt, &Preset_Furious, &Preset_Scared, &Preset_Awe,
+};
+
+unsigned failures = 0;
+
+// The preset as Eye::ApplyPreset stores it
+EyeConfig placed(const EyeConfig& preset, bool mirrored) {
+	EyeConfig c = preset;
+	c.OffsetX = mirrored ? -preset.OffsetX : preset.OffsetX;
+	c.OffsetY = -preset.OffsetY;
+	c.Slope_Top = mirrored ? preset.Slope_Top : -preset.Slope_Top;
+	c.Slope_Bottom = mirrored ? preset.Slope_Bottom : -preset.Slope_Bottom;
+	return c;
+}
+
+// One eye on a blank frame both ways. Each path gets its own copy, since
+// both clamp the radii in the config
+bool sameEye(U8G2& gfx, int16_t x, int16_t y, const EyeConfig& config) {
+	static uint8_t raster[FrameBytes];
+	EyeConfig a = config, b = config;
+	gfx.clearBuffer();
+	EyeDrawer::Draw(&gfx, x, y, &a);
+	memset(raster, 0, sizeof(raster));
+	if (!EyeRaster::Draw(raster, 128, 64, x, y, &b)) return false;
+	return memcmp(raster, gfx.getBufferPtr(), FrameBytes) == 0;
+}
+
+void report(const char* what, int x, int y, const EyeConfig& c) {
+	if (failures++ >= 5) return;
+	printf("  FAIL %s at %d,%d: offset %d,%d size %dx%d slope %.2f/%.2f radius %d/%d\n", what, x, y, c.OffsetX,
+		c.OffsetY, c.Width, c.Height, c.Slope_Top, c.Slope_Bottom, c.Radius_Top, c.Radius_Bottom);
+}
+
+unsigned checkPresets(U8G2& gfx) {
+	unsigned cases = 0;
+	for (const EyeConfig* preset : Presets) {
+		for (int mirrored = 0; mirrored < 2; mirrored++) {
+			EyeConfig c = placed(*preset, mirrored);
+			for (int x = -30; x <= 158; x += 11) {
+				for (int y = -30; y <= 94; y += 7) {
+					if (!sameEye(gfx, x, y, c)) report("preset", x, y, c);
+					cases++;
+				}
+			}
+		}
+	}
+	return cases;
+}
+
+EyeConfig randomConfig(std::mt19937& rng) {
+	auto r = [&](int lo, int hi) { return std::uniform_int_distribution<int>(lo, hi)(rng); };
+	EyeConfig c;
+	c.OffsetX = r(-70, 70);
+	c.OffsetY = r(-40, 40);
+	c.Height = r(1, 80);
+	c.Width = r(1, 90);
+	c.Slope_Top = r(0, 2) ? r(-10, 10) / 10.0f : 0.0f;
+	c.Slope_Bottom = r(0, 2) ? r(-10, 10) / 10.0f : 0.0f;
+	c.Radius_Top = r(0, 40);
+	c.Radius_Bottom = r(0, 40);
+	c.Inverse_Radius_Top = 0;
+	c.Inverse_Radius_Bottom = 0;
+	c.Inverse_Offset_Top = 0;
+	c.Inverse_Offset_Bottom = 0;
+	return c;
+}
+
+unsigned checkRandom(U8G2& gfx, std::mt19937& rng, int eyes) {
+	std::uniform_int_distribution<int> x(0, 127), y(0, 63);
+	unsigned bad = 0;
+	for (int i = 0; i < eyes; i++) {
+		EyeConfig c = randomConfig(rng);
+		int cx = x(rng), cy = y(rng);
+		if (!sameEye(gfx, cx, cy, c)) {
+			report("random eye", cx, cy, c);
+			bad++;
+		}
+	}
+	return bad;
+}
+
+// Two eyes close enough to overlap, both into one frame
+void checkOverlaps(U8G2& gfx, std::mt19937& rng, int pairs, unsigned* differ, unsigned* cutIns) {
+	std::uniform_int_distribution<int> x(20, 107), y(10, 53), near(-20, 20);
+	static uint8_t raster[FrameBytes];
+	uint8_t golden[FrameBytes];
+	for (int i = 0; i < pairs; i++) {
+		EyeConfig c[2] = {randomConfig(rng), randomConfig(rng)};
+		int cx[2], cy[2];
+		cx[0] = x(rng);
+		cy[0] = y(rng);
+		cx[1] = cx[0] + near(rng);
+		cy[1] = cy[0] + near(rng);
+
+		memset(golden, 0, sizeof(golden));
+		memset(raster, 0, sizeof(raster));
+		for (int e = 0; e < 2; e++) {
+			EyeConfig a = c[e], b = c[e];
+			gfx.clearBuffer();
+			EyeDrawer::Draw(&gfx, cx[e], cy[e], &a);
+			for (size_t k = 0; k < FrameBytes; k++) golden[k] |= gfx.getBufferPtr()[k];
+			EyeRaster::Draw(raster, 128, 64, cx[e], cy[e], &b);
+		}
+		if (memcmp(golden, raster, FrameBytes) != 0) {
+			report("overlapping pair", cx[0], cy[0], c[0]);
+			(*differ)++;
+		}
+
+		gfx.clearBuffer();
+		for (int e = 0; e < 2; e++) {
+			EyeConfig a = c[e];
+			EyeDrawer::Draw(&gfx, cx[e], cy[e], &a);
+		}
+		if (memcmp(golden, gfx.getBufferPtr(), FrameBytes) != 0) (*cutIns)++;
+	}
+}
+
+// The face on the virtual clock; golden frame = OR of both eyes drawn alone
+void checkReplay(uint32_t seed, int frames, unsigned* differ, unsigned* cutIns) {
+	FrameClock::UseVirtual(1000);
+	randomSeed(seed);
+	I2CDisplay display(I2CPanel::SSD1306, 0, 0);
+	I2CDisplay reference(I2CPanel::SSD1306, 0, 0);
+	display.begin();
+	reference.begin();
+	U8G2& gfx = reference.gfx();
+
+	Face* face = new Face(&display, 128, 64, 40);
+	face->SpanRaster = true;
+	face->AutoFlush = false;
+	face->Behavior.Timer.SetIntervalMillis(400);
+	face->Look.Timer.SetIntervalMillis(250);
+	face->Blink.Timer.SetIntervalMillis(700);
+	for (int e = 0; e < eEmotions::EMOTIONS_COUNT; e++) face->Behavior.SetEmotion((eEmotions)e, 1.0);
+
+	uint8_t golden[FrameBytes];
+	for (int i = 0; i < frames; i++) {
+		display.gfx().clearBuffer();
+		face->Update();
+
+		Eye* eyes[2] = {&face->LeftEye, &face->RightEye};
+		memset(golden, 0, sizeof(golden));
+		for (Eye* eye : eyes) {
+			EyeConfig c = *eye->FinalConfig;
+			gfx.clearBuffer();
+			EyeDrawer::Draw(&gfx, eye->CenterX, eye->CenterY, &c);
+			for (size_t k = 0; k < FrameBytes; k++) golden[k] |= gfx.getBufferPtr()[k];
+		}
+		if (memcmp(golden, display.buffer(), FrameBytes) != 0) {
+			if ((*differ)++ < 3) printf("  FAIL frame %d differs from the golden frame\n", i);
+		}
+
+		// What Face drew before EyeRaster: both eyes in turn on one frame
+		gfx.clearBuffer();
+		for (Eye* eye : eyes) {
+			EyeConfig c = *eye->FinalConfig;
+			EyeDrawer::Draw(&gfx, eye->CenterX, eye->CenterY, &c);
+		}
+		if (memcmp(golden, gfx.getBufferPtr(), FrameBytes) != 0) (*cutIns)++;
+
+		FrameClock::Advance(i % 3 ? 16 : 17);
+	}
+	delete face;
+}
+
+void bench(U8G2& gfx, int iterations) {
+	static uint8_t raster[FrameBytes];
+	double best[2] = {1e18, 1e18};
+	for (int mode = 0; mode < 2; mode++) {
+		for (int run = 0; run < 15; run++) {
+			auto start = std::chrono::steady_clock::now();
+			int eyes = 0;
+			for (int i = 0; i < iterations; i++) {
+				for (const EyeConfig* preset : Presets) {
+					EyeConfig c = *preset;
+					if (mode == 0) EyeDrawer::Draw(&gfx, 40, 32, &c);
+					else EyeRaster::Draw(raster, 128, 64, 40, 32, &c);
+					eyes++;
+				}
+			}
+			double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+			best[mode] = std::min(best[mode], ns / eyes);
+		}
+	}
+	printf("ns per eye over the presets (best of 15 x %d):\n", iterations);
+	printf("  EyeDrawer  %8.0f\n", best[0]);
+	printf("  EyeRaster  %8.0f  (%.1fx)\n", best[1], best[0] / best[1]);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+	uint32_t seed = 1;
+	int eyes = 200000;
+	int frames = 5000;
+	int iterations = 2000;
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		bool value = i + 1 < argc;
+		if (arg == "--seed" && value) seed = (uint32_t)atoi(argv[++i]);
+		else if (arg == "--eyes" && value) eyes = atoi(argv[++i]);
+		else if (arg == "--frames" && value) frames = atoi(argv[++i]);
+		else if (arg == "--iterations" && value) iterations = atoi(argv[++i]);
+		else {
+			fprintf(stderr, "usage: eyeraster_check [--seed N] [--eyes N] [--frames N] [--iterations N]\n");
+			return 2;
+		}
+	}
+
+	I2CDisplay display(I2CPanel::SSD1306, 0, 0);
+	display.begin();
+	U8G2& gfx = display.gfx();
+
+	unsigned cases = checkPresets(gfx);
+	printf("presets: %u placements, %u differ\n", cases, failures);
+
+	std::mt19937 rng(seed);
+	unsigned bad = checkRandom(gfx, rng, eyes);
+	printf("random eyes: %d, %u differ\n", eyes, bad);
+
+	unsigned differ = 0, cutIns = 0;
+	checkOverlaps(gfx, rng, eyes / 4, &differ, &cutIns);
+	printf("overlapping pairs: %d, %u differ from the golden frames\n", eyes / 4, differ);
+	printf("  (EyeDrawer on a shared frame cut into the other eye in %u of them)\n", cutIns);
+
+	differ = 0;
+	cutIns = 0;
+	checkReplay(seed, frames, &differ, &cutIns);
+	printf("replay: %d frames, %u differ from the golden frames\n", frames, differ);
+	printf("  (EyeDrawer on a shared frame cut into the other eye in %u of them)\n", cutIns);
+	failures += differ;
+
+	bench(gfx, iterations);
+
+	printf("%s\n", failures ? "FAIL" : "all checks passed");
+	return failures ? 1 : 0;
+}
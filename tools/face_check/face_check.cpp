@@ -0,0 +1,272 @@
+// Host check for the expression table in lib/FaceDisplay. The hand-written
+// FaceExpression::GoTo_* functions that the table replaced are kept below
+// as legacyGoTo(). Two faces on the virtual frame clock get the same
+// calls, one through FaceBehavior::GoToEmotion (the table) and one through
+// the old code:
+//   - every pair of emotions (previous -> next): both eyes' destination,
+//     start config, variation values, animation timings and start times
+//     must match
+//   - a replay of random emotion changes, looks and blinks: every rendered
+//     frame must match
+//
+// Build (from the repository root):
+//   g++ -O2 -std=gnu++17 -Itools/host -Ilib/Display/src -Ilib/FaceDisplay/src tools/face_check/face_check.cpp tools/host/host.cpp lib/FaceDisplay/src/*.cpp lib/Display/src/DisplayBackend.cpp lib/Display/src/I2CDisplay.cpp -o face_check
+//
+// Usage:
+//   face_check [--seed N] [--frames N]
+
+#include "Face.h"
+#include "FrameClock.h"
+#include "I2CDisplay.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+
+namespace {
+
+unsigned failures = 0;
+
+// FaceExpression before the table, on the public members of Face
+void clearVariations(Face& face) {
+	face.RightEye.Variation1.Clear();
+	face.RightEye.Variation2.Clear();
+	face.LeftEye.Variation1.Clear();
+	face.LeftEye.Variation2.Clear();
+	face.RightEye.Variation1.Animation.Restart();
+	face.LeftEye.Variation1.Animation.Restart();
+}
+
+void legacyGoTo(Face& face, eEmotions emotion) {
+	face.Behavior.CurrentEmotion = emotion;
+	clearVariations(face);
+
+	switch (emotion) {
+	case eEmotions::Normal:
+		face.RightEye.Variation1.Values.Height = 3;
+		face.RightEye.Variation2.Values.Width = 1;
+		face.LeftEye.Variation1.Values.Height = 2;
+		face.LeftEye.Variation2.Values.Width = 2;
+		face.RightEye.Variation1.Animation.SetTriangle(1000, 0);
+		face.LeftEye.Variation1.Animation.SetTriangle(1000, 0);
+		face.RightEye.TransitionTo(Preset_Normal);
+		face.LeftEye.TransitionTo(Preset_Normal);
+		break;
+	case eEmotions::Angry:
+		face.RightEye.Variation1.Values.OffsetY = 2;
+		face.LeftEye.Variation1.Values.OffsetY = 2;
+		face.RightEye.Variation1.Animation.SetTriangle(300, 0);
+		face.LeftEye.Variation1.Animation.SetTriangle(300, 0);
+		face.RightEye.TransitionTo(Preset_Angry);
+		face.LeftEye.TransitionTo(Preset_Angry);
+		break;
+	case eEmotions::Glee:
+		face.RightEye.Variation1.Values.OffsetY = 5;
+		face.LeftEye.Variation1.Values.OffsetY = 5;
+		face.RightEye.Variation1.Animation.SetTriangle(300, 0);
+		face.LeftEye.Variation1.Animation.SetTriangle(300, 0);
+		face.RightEye.TransitionTo(Preset_Glee);
+		face.LeftEye.TransitionTo(Preset_Glee);
+		break;
+	case eEmotions::Happy:
+		face.RightEye.TransitionTo(Preset_Happy);
+		face.LeftEye.TransitionTo(Preset_Happy);
+		break;
+	case eEmotions::Sad:
+		face.RightEye.TransitionTo(Preset_Sad);
+		face.LeftEye.TransitionTo(Preset_Sad);
+		break;
+	case eEmotions::Worried:
+		face.RightEye.TransitionTo(Preset_Worried);
+		face.LeftEye.TransitionTo(Preset_Worried_Alt);
+		break;
+	case eEmotions::Focused:
+		face.RightEye.TransitionTo(Preset_Focused);
+		face.LeftEye.TransitionTo(Preset_Focused);
+		break;
+	case eEmotions::Annoyed:
+		face.RightEye.TransitionTo(Preset_Annoyed);
+		face.LeftEye.TransitionTo(Preset_Annoyed_Alt);
+		break;
+	case eEmotions::Surprised:
+		face.RightEye.TransitionTo(Preset_Surprised);
+		face.LeftEye.TransitionTo(Preset_Surprised);
+		break;
+	case eEmotions::Skeptic:
+		face.RightEye.TransitionTo(Preset_Skeptic);
+		face.LeftEye.TransitionTo(Preset_Skeptic_Alt);
+		break;
+	case eEmotions::Frustrated:
+		face.RightEye.TransitionTo(Preset_Frustrated);
+		face.LeftEye.TransitionTo(Preset_Frustrated);
+		break;
+	case eEmotions::Unimpressed:
+		face.RightEye.TransitionTo(Preset_Unimpressed);
+		face.LeftEye.TransitionTo(Preset_Unimpressed_Alt);
+		break;
+	case eEmotions::Sleepy:
+		face.RightEye.TransitionTo(Preset_Sleepy);
+		face.LeftEye.TransitionTo(Preset_Sleepy_Alt);
+		break;
+	case eEmotions::Suspicious:
+		face.RightEye.TransitionTo(Preset_Suspicious);
+		face.LeftEye.TransitionTo(Preset_Suspicious_Alt);
+		break;
+	case eEmotions::Squint:
+		face.LeftEye.Variation1.Values.OffsetX = 6;
+		face.LeftEye.Variation2.Values.OffsetY = 6;
+		face.RightEye.TransitionTo(Preset_Squint);
+		face.LeftEye.TransitionTo(Preset_Squint_Alt);
+		break;
+	case eEmotions::Furious:
+		face.RightEye.TransitionTo(Preset_Furious);
+		face.LeftEye.TransitionTo(Preset_Furious);
+		break;
+	case eEmotions::Scared:
+		face.RightEye.TransitionTo(Preset_Scared);
+		face.LeftEye.TransitionTo(Preset_Scared);
+		break;
+	case eEmotions::Awe:
+		face.RightEye.TransitionTo(Preset_Awe);
+		face.LeftEye.TransitionTo(Preset_Awe);
+		break;
+	default:
+		break;
+	}
+}
+
+std::string describe(const EyeConfig& c) {
+	char s[160];
+	snprintf(s, sizeof(s), "%d %d %d %d %.3f %.3f %d %d %d %d %d %d", c.OffsetX, c.OffsetY, c.Height, c.Width,
+		c.Slope_Top, c.Slope_Bottom, c.Radius_Top, c.Radius_Bottom, c.Inverse_Radius_Top, c.Inverse_Radius_Bottom,
+		c.Inverse_Offset_Top, c.Inverse_Offset_Bottom);
+	return s;
+}
+
+std::string describe(const TrapeziumPulseAnimation& a) {
+	char s[120];
+	snprintf(s, sizeof(s), "%lu %lu %lu %lu %lu interval %lu start %lu", a._t0, a._t1, a._t2, a._t3, a._t4,
+		a.Interval, a.StarTime);
+	return s;
+}
+
+// Everything GoTo can change on one eye
+std::string describe(const Eye& e) {
+	const AnimationBase& transition = e.Transition.Animation;
+	return "  dest  " + describe(e.Transition.Destin) + "\n  start " + describe(e.Transition.Start) +
+		"\n  v1    " + describe(e.Variation1.Values) + "\n  v2    " + describe(e.Variation2.Values) +
+		"\n  a1    " + describe(e.Variation1.Animation) + "\n  a2    " + describe(e.Variation2.Animation) +
+		"\n  transition start " + std::to_string(transition.StarTime) + "\n";
+}
+
+bool sameState(Face& table, Face& legacy, const char* label) {
+	std::string a = "right\n" + describe(table.RightEye) + "left\n" + describe(table.LeftEye);
+	std::string b = "right\n" + describe(legacy.RightEye) + "left\n" + describe(legacy.LeftEye);
+	if (a == b && table.Behavior.CurrentEmotion == legacy.Behavior.CurrentEmotion) return true;
+	if (failures++ < 3) printf("  FAIL %s\n table:\n%s old code:\n%s", label, a.c_str(), b.c_str());
+	return false;
+}
+
+Face* makeFace(DisplayBackend& display) {
+	display.begin();
+	Face* face = new Face(&display, 128, 64, 40);
+	face->RandomBehavior = false;
+	face->RandomLook = false;
+	face->RandomBlink = false;
+	face->AutoFlush = false;
+	return face;
+}
+
+// Every (previous, next) pair, the clock moving between the calls so that
+// start times differ from pair to pair
+unsigned checkPairs(Face& table, Face& legacy) {
+	unsigned pairs = 0;
+	for (int prev = 0; prev < eEmotions::EMOTIONS_COUNT; prev++) {
+		for (int next = 0; next < eEmotions::EMOTIONS_COUNT; next++) {
+			FrameClock::Advance(7);
+			table.Behavior.GoToEmotion((eEmotions)prev);
+			legacyGoTo(legacy, (eEmotions)prev);
+			FrameClock::Advance(13 + next);
+			table.Behavior.GoToEmotion((eEmotions)next);
+			legacyGoTo(legacy, (eEmotions)next);
+
+			char label[48];
+			snprintf(label, sizeof(label), "emotion %d -> %d", prev, next);
+			sameState(table, legacy, label);
+			pairs++;
+		}
+	}
+	return pairs;
+}
+
+// Both faces driven the same way, frames compared byte for byte
+unsigned checkReplay(Face& table, Face& legacy, U8G2& tableGfx, U8G2& legacyGfx, std::mt19937& rng, int frames) {
+	std::uniform_int_distribution<int> percent(0, 99);
+	std::uniform_int_distribution<int> emotion(0, eEmotions::EMOTIONS_COUNT - 1);
+	std::uniform_real_distribution<float> look(-1.0f, 1.0f);
+	std::uniform_int_distribution<int> step(5, 40);
+	unsigned differ = 0;
+
+	for (int i = 0; i < frames; i++) {
+		int roll = percent(rng);
+		if (roll < 4) {
+			eEmotions e = (eEmotions)emotion(rng);
+			table.Behavior.GoToEmotion(e);
+			legacyGoTo(legacy, e);
+		} else if (roll < 7) {
+			float x = look(rng), y = look(rng);
+			table.Look.LookAt(x, y);
+			legacy.Look.LookAt(x, y);
+		} else if (roll < 9) {
+			table.DoBlink();
+			legacy.DoBlink();
+		}
+
+		tableGfx.clearBuffer();
+		legacyGfx.clearBuffer();
+		table.Update();
+		legacy.Update();
+		if (memcmp(tableGfx.getBufferPtr(), legacyGfx.getBufferPtr(), 128 * 64 / 8) != 0) {
+			if (differ++ < 3) printf("  FAIL frame %d differs\n", i);
+		}
+		FrameClock::Advance(step(rng));
+	}
+	return differ;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+	uint32_t seed = 1;
+	int frames = 20000;
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		bool value = i + 1 < argc;
+		if (arg == "--seed" && value) seed = (uint32_t)atoi(argv[++i]);
+		else if (arg == "--frames" && value) frames = atoi(argv[++i]);
+		else {
+			fprintf(stderr, "usage: face_check [--seed N] [--frames N]\n");
+			return 2;
+		}
+	}
+
+	FrameClock::UseVirtual(1000);
+	I2CDisplay tableDisplay(I2CPanel::SSD1306, 0, 0, 400000);
+	I2CDisplay legacyDisplay(I2CPanel::SSD1306, 0, 0, 400000);
+	Face* table = makeFace(tableDisplay);
+	Face* legacy = makeFace(legacyDisplay);
+
+	unsigned pairs = checkPairs(*table, *legacy);
+	printf("emotion pairs: %u, %u differ\n", pairs, failures);
+
+	std::mt19937 rng(seed);
+	unsigned differ = checkReplay(*table, *legacy, tableDisplay.gfx(), legacyDisplay.gfx(), rng, frames);
+	printf("replay: %d frames, %u differ\n", frames, differ);
+	failures += differ;
+
+	delete table;
+	delete legacy;
+	printf("%s\n", failures ? "FAIL" : "all checks passed");
+	return failures ? 1 : 0;
+}
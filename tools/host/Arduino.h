@@ -0,0 +1,37 @@
+#pragma once
+
+// Host stand-in for the parts of the Arduino core that the display, face
+// and page buffer libraries use, so the host tools under tools/ can build
+// them unchanged. millis() and micros() run on the monotonic clock; random()
+// is a fixed LCG so runs repeat after randomSeed().
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <algorithm>
+
+using std::max;
+using std::min;
+
+#define PROGMEM
+#define IRAM_ATTR
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+
+void randomSeed(unsigned long seed);
+long random(long howbig);
+long random(long howsmall, long howbig);
+long map(long x, long inMin, long inMax, long outMin, long outMax);
+
+class Print {
+public:
+	virtual ~Print() {}
+	virtual size_t write(uint8_t b) = 0;
+	virtual size_t write(const uint8_t* buffer, size_t size);
+};
@@ -0,0 +1,89 @@
+#pragma once
+
+// Host stand-in for U8g2: a software 128x64 full buffer in the SSD1306 page
+// layout with the drawing calls the libraries use. Pixels land where
+// U8g2's generic C code puts them: the hline / vline / box / XBM routines
+// follow u8g2_hvline.c, u8g2_box.c and u8g2_bitmap.c, and drawTriangle is
+// a port of u8g2_polygon.c, including its fill rule. Nothing is sent
+// anywhere; tools read the frame with getBufferPtr(). Unlike U8g2, every
+// display object has its own buffer.
+
+#include <Arduino.h>
+
+typedef const void* u8g2_cb_t;
+#define U8G2_R0 nullptr
+#define U8X8_PIN_NONE 255
+
+typedef struct u8x8_struct u8x8_t;
+typedef uint8_t (*u8x8_msg_cb)(u8x8_t* u8x8, uint8_t msg, uint8_t argInt, void* argPtr);
+
+struct u8x8_struct {
+	void* user_ptr;
+};
+
+struct u8g2_struct {
+	u8x8_t u8x8;
+	uint8_t tileWidth;
+	uint8_t tileHeight;
+	uint8_t drawColor;
+	uint8_t buffer[128 * 64 / 8];
+};
+typedef struct u8g2_struct u8g2_t;
+
+void u8g2_Setup_ssd1306_128x64_noname_f(u8g2_t* u8g2, u8g2_cb_t rotation, u8x8_msg_cb byteCb, u8x8_msg_cb gpioCb);
+uint8_t u8x8_byte_empty(u8x8_t* u8x8, uint8_t msg, uint8_t argInt, void* argPtr);
+uint8_t u8x8_dummy_cb(u8x8_t* u8x8, uint8_t msg, uint8_t argInt, void* argPtr);
+
+class U8G2 {
+public:
+	U8G2() { u8g2_Setup_ssd1306_128x64_noname_f(&u8g2, U8G2_R0, u8x8_byte_empty, u8x8_dummy_cb); }
+	virtual ~U8G2() {}
+
+	bool begin() { return true; }
+	void initDisplay() {}
+	void setBusClock(uint32_t) {}
+	void sendBuffer() { _sends++; }
+	void updateDisplayArea(uint8_t, uint8_t, uint8_t, uint8_t) { _sends++; }
+	void clearBuffer() { memset(u8g2.buffer, 0, sizeof(u8g2.buffer)); }
+
+	uint8_t* getBufferPtr() { return u8g2.buffer; }
+	uint8_t getBufferTileWidth() { return u8g2.tileWidth; }
+	uint8_t getBufferTileHeight() { return u8g2.tileHeight; }
+	uint16_t getDisplayWidth() { return u8g2.tileWidth * 8; }
+	uint16_t getDisplayHeight() { return u8g2.tileHeight * 8; }
+
+	void setDrawColor(uint8_t color) { u8g2.drawColor = color; }
+	uint8_t getDrawColor() { return u8g2.drawColor; }
+
+	void drawPixel(int x, int y);
+	void drawHLine(int x, int y, int w);
+	void drawVLine(int x, int y, int h);
+	void drawBox(int x, int y, int w, int h);
+	void drawFrame(int x, int y, int w, int h);
+	void drawXBMP(int x, int y, int w, int h, const uint8_t* bitmap);
+	void drawTriangle(int x0, int y0, int x1, int y1, int x2, int y2);
+
+	// sendBuffer() and updateDisplayArea() calls so far
+	unsigned long sends() const { return _sends; }
+
+protected:
+	u8g2_t u8g2;
+
+private:
+	// u8g2_ll_hvline_vertical_top_lsb on an already clipped line
+	void hvline(int x, int y, int len, bool vertical);
+
+	unsigned long _sends = 0;
+};
+
+class U8G2_SSD1306_128X64_NONAME_F_HW_I2C : public U8G2 {
+public:
+	explicit U8G2_SSD1306_128X64_NONAME_F_HW_I2C(u8g2_cb_t rotation, uint8_t reset = U8X8_PIN_NONE,
+		uint8_t clock = U8X8_PIN_NONE, uint8_t data = U8X8_PIN_NONE) : U8G2() {}
+};
+
+class U8G2_SH1106_128X64_NONAME_F_HW_I2C : public U8G2 {
+public:
+	explicit U8G2_SH1106_128X64_NONAME_F_HW_I2C(u8g2_cb_t rotation, uint8_t reset = U8X8_PIN_NONE,
+		uint8_t clock = U8X8_PIN_NONE, uint8_t data = U8X8_PIN_NONE) : U8G2() {}
+};
@@ -0,0 +1,22 @@
+#pragma once
+
+// Host stand-in for the arduino-esp32 ESP-SR wrapper: the command table
+// type and error codes only, enough for lib/CommandSets and the tables in
+// src/boot/constants.h. Nothing here recognizes speech.
+
+#include <Arduino.h>
+
+#ifndef ESP_OK
+typedef int esp_err_t;
+#define ESP_OK 0
+#define ESP_FAIL -1
+#endif
+
+#define SR_CMD_STR_LEN_MAX 64
+#define SR_CMD_PHONEME_LEN_MAX 64
+
+typedef struct sr_cmd_s {
+	int command_id;
+	char str[SR_CMD_STR_LEN_MAX];
+	char phoneme[SR_CMD_PHONEME_LEN_MAX];
+} sr_cmd_t;
@@ -0,0 +1,338 @@
+// Definitions behind tools/host/Arduino.h and tools/host/U8g2lib.h
+
+#include <Arduino.h>
+#include <U8g2lib.h>
+
+#include <time.h>
+
+// Arduino
+
+unsigned long millis() {
+	timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (unsigned long)(t.tv_sec * 1000 + t.tv_nsec / 1000000);
+}
+
+unsigned long micros() {
+	timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (unsigned long)(t.tv_sec * 1000000 + t.tv_nsec / 1000);
+}
+
+void delay(unsigned long ms) {
+	timespec t = {(time_t)(ms / 1000), (long)(ms % 1000) * 1000000};
+	nanosleep(&t, nullptr);
+}
+
+static uint32_t randomState = 1;
+
+void randomSeed(unsigned long seed) {
+	randomState = (uint32_t)seed;
+}
+
+long random(long howbig) {
+	randomState = randomState * 1103515245u + 12345u;
+	return howbig > 0 ? (long)((randomState >> 8) % (uint32_t)howbig) : 0;
+}
+
+long random(long howsmall, long howbig) {
+	return howbig > howsmall ? howsmall + random(howbig - howsmall) : howsmall;
+}
+
+long map(long x, long inMin, long inMax, long outMin, long outMax) {
+	return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+size_t Print::write(const uint8_t* buffer, size_t size) {
+	size_t n = 0;
+	while (size--) n += write(*buffer++);
+	return n;
+}
+
+// U8g2 setup
+
+void u8g2_Setup_ssd1306_128x64_noname_f(u8g2_t* u8g2, u8g2_cb_t, u8x8_msg_cb, u8x8_msg_cb) {
+	u8g2->u8x8.user_ptr = nullptr;
+	u8g2->tileWidth = 16;
+	u8g2->tileHeight = 8;
+	u8g2->drawColor = 1;
+	memset(u8g2->buffer, 0, sizeof(u8g2->buffer));
+}
+
+uint8_t u8x8_byte_empty(u8x8_t*, uint8_t, uint8_t, void*) {
+	return 1;
+}
+
+uint8_t u8x8_dummy_cb(u8x8_t*, uint8_t, uint8_t, void*) {
+	return 1;
+}
+
+// Lines, boxes, bitmaps
+
+void U8G2::hvline(int x, int y, int len, bool vertical) {
+	// Color 0 clears, 1 sets, 2 inverts
+	uint8_t bit = y & 7;
+	uint8_t mask = 1 << bit;
+	uint8_t orMask = u8g2.drawColor <= 1 ? mask : 0;
+	uint8_t xorMask = u8g2.drawColor != 1 ? mask : 0;
+	uint8_t* p = u8g2.buffer + (y / 8) * getDisplayWidth() + x;
+
+	while (len-- > 0) {
+		*p |= orMask;
+		*p ^= xorMask;
+		if (!vertical) {
+			p++;
+			continue;
+		}
+		bit = (bit + 1) & 7;
+		if (bit == 0) {
+			p += getDisplayWidth();
+			orMask = u8g2.drawColor <= 1 ? 1 : 0;
+			xorMask = u8g2.drawColor != 1 ? 1 : 0;
+		} else {
+			orMask <<= 1;
+			xorMask <<= 1;
+		}
+	}
+}
+
+void U8G2::drawPixel(int x, int y) {
+	drawHLine(x, y, 1);
+}
+
+void U8G2::drawHLine(int x, int y, int w) {
+	if (y < 0 || y >= getDisplayHeight()) return;
+	int a = std::max(x, 0);
+	int b = std::min(x + w, (int)getDisplayWidth());
+	if (a < b) hvline(a, y, b - a, false);
+}
+
+void U8G2::drawVLine(int x, int y, int h) {
+	if (x < 0 || x >= getDisplayWidth()) return;
+	int a = std::max(y, 0);
+	int b = std::min(y + h, (int)getDisplayHeight());
+	if (a < b) hvline(x, a, b - a, true);
+}
+
+void U8G2::drawBox(int x, int y, int w, int h) {
+	for (int row = 0; row < h; row++) drawHLine(x, y + row, w);
+}
+
+void U8G2::drawFrame(int x, int y, int w, int h) {
+	drawHLine(x, y, w);
+	if (h < 2) return;
+	if (h > 2) {
+		drawVLine(x, y + 1, h - 2);
+		drawVLine(x + w - 1, y + 1, h - 2);
+	}
+	drawHLine(x, y + h - 1, w);
+}
+
+void U8G2::drawXBMP(int x, int y, int w, int h, const uint8_t* bitmap) {
+	// Solid mode: 1 bits in the draw color, 0 bits in the other one
+	uint8_t color = u8g2.drawColor;
+	uint8_t background = color == 0 ? 1 : 0;
+	int stride = (w + 7) / 8;
+	for (int row = 0; row < h; row++) {
+		const uint8_t* b = bitmap + row * stride;
+		for (int col = 0; col < w; col++) {
+			u8g2.drawColor = (b[col / 8] >> (col & 7)) & 1 ? color : background;
+			drawHLine(x + col, y + row, 1);
+		}
+	}
+	u8g2.drawColor = color;
+}
+
+// Triangles: u8g2_polygon.c, two edges walked from the top vertex with
+// Bresenham steps, one hline per scan line from the left to the right edge
+
+namespace {
+
+typedef int16_t pg_word_t;
+
+struct pge_t {
+	pg_word_t x_direction;
+	pg_word_t height;
+	pg_word_t current_x_offset;
+	pg_word_t error_offset;
+	pg_word_t current_y;
+	pg_word_t max_y;
+	pg_word_t current_x;
+	pg_word_t error;
+	int8_t dir;
+	uint8_t curr_idx;
+};
+
+struct pg_t {
+	pg_word_t x[6];
+	pg_word_t y[6];
+	uint8_t cnt;
+	uint8_t is_min_y_not_flat;
+	pg_word_t total_scan_line_cnt;
+	pge_t pge[2];
+};
+
+enum { PG_LEFT = 0, PG_RIGHT = 1 };
+
+uint8_t pge_Next(pge_t* pge) {
+	if (pge->current_y >= pge->max_y) return 0;
+	pge->current_x += pge->current_x_offset;
+	pge->error += pge->error_offset;
+	if (pge->error > 0) {
+		pge->current_x += pge->x_direction;
+		pge->error -= pge->height;
+	}
+	pge->current_y++;
+	return 1;
+}
+
+void pge_Init(pge_t* pge, pg_word_t x1, pg_word_t y1, pg_word_t x2, pg_word_t y2) {
+	pg_word_t dx = x2 - x1;
+	pg_word_t width;
+
+	pge->height = y2 - y1;
+	// Flat edge: U8g2 divides by zero here, which traps on x86. The edge is
+	// skipped by the first pge_Next() anyway, so the step values are unused
+	if (pge->height == 0) pge->height = 1;
+	pge->max_y = y2;
+	pge->current_y = y1;
+	pge->current_x = x1;
+
+	if (dx >= 0) {
+		pge->x_direction = 1;
+		width = dx;
+		pge->error = 0;
+	} else {
+		pge->x_direction = -1;
+		width = -dx;
+		pge->error = 1 - pge->height;
+	}
+
+	pge->current_x_offset = dx / pge->height;
+	pge->error_offset = width % pge->height;
+}
+
+uint8_t pg_inc(pg_t* pg, uint8_t i) {
+	i++;
+	if (i >= pg->cnt) i = 0;
+	return i;
+}
+
+uint8_t pg_dec(pg_t* pg, uint8_t i) {
+	i--;
+	if (i >= pg->cnt) i = pg->cnt - 1;
+	return i;
+}
+
+void pg_expand_min_y(pg_t* pg, pg_word_t min_y, uint8_t pge_idx) {
+	uint8_t i = pg->pge[pge_idx].curr_idx;
+	for (;;) {
+		i = pg->pge[pge_idx].dir ? pg_inc(pg, i) : pg_dec(pg, i);
+		if (pg->y[i] != min_y) break;
+		pg->pge[pge_idx].curr_idx = i;
+	}
+}
+
+uint8_t pg_prepare(pg_t* pg) {
+	pg_word_t max_y;
+	pg_word_t min_y;
+	uint8_t i;
+
+	// Right edge walks the vertices forward, the left one backward
+	pg->pge[PG_RIGHT].dir = 1;
+	pg->pge[PG_LEFT].dir = 0;
+
+	max_y = pg->y[0];
+	min_y = pg->y[0];
+	pg->pge[PG_LEFT].curr_idx = 0;
+	for (i = 1; i < pg->cnt; i++) {
+		if (max_y < pg->y[i]) max_y = pg->y[i];
+		if (min_y > pg->y[i]) {
+			pg->pge[PG_LEFT].curr_idx = i;
+			min_y = pg->y[i];
+		}
+	}
+
+	pg->total_scan_line_cnt = max_y;
+	pg->total_scan_line_cnt -= min_y;
+	if (pg->total_scan_line_cnt == 0) return 0;
+
+	pg->pge[PG_RIGHT].curr_idx = pg->pge[PG_LEFT].curr_idx;
+	pg_expand_min_y(pg, min_y, PG_RIGHT);
+	pg_expand_min_y(pg, min_y, PG_LEFT);
+
+	// Pointed top: skip the first scan line, as U8g2 does
+	pg->is_min_y_not_flat = 1;
+	if (pg->y[pg->pge[PG_LEFT].curr_idx] != pg->y[pg->pge[PG_RIGHT].curr_idx]) {
+		pg->is_min_y_not_flat = 0;
+	} else if (pg->x[pg->pge[PG_LEFT].curr_idx] != pg->x[pg->pge[PG_RIGHT].curr_idx]) {
+		pg->is_min_y_not_flat = 0;
+	}
+	return 1;
+}
+
+void pg_hline(pg_t* pg, U8G2* u8g2) {
+	pg_word_t x1 = pg->pge[PG_LEFT].current_x;
+	pg_word_t x2 = pg->pge[PG_RIGHT].current_x;
+	pg_word_t y = pg->pge[PG_RIGHT].current_y;
+	pg_word_t width = u8g2->getDisplayWidth();
+
+	if (y < 0) return;
+	if (y >= u8g2->getDisplayHeight()) return;
+	if (x1 < x2) {
+		if (x2 < 0) return;
+		if (x1 >= width) return;
+		if (x1 < 0) x1 = 0;
+		if (x2 >= width) x2 = width;
+		u8g2->drawHLine(x1, y, x2 - x1);
+	} else {
+		if (x1 < 0) return;
+		if (x2 >= width) return;
+		if (x2 < 0) x2 = 0;
+		if (x1 >= width) x1 = width;
+		u8g2->drawHLine(x2, y, x1 - x2);
+	}
+}
+
+void pg_line_init(pg_t* pg, uint8_t pge_index) {
+	pge_t* pge = pg->pge + pge_index;
+	uint8_t idx = pge->curr_idx;
+	pg_word_t x1 = pg->x[idx];
+	pg_word_t y1 = pg->y[idx];
+	idx = pge->dir ? pg_inc(pg, idx) : pg_dec(pg, idx);
+	pge->curr_idx = idx;
+	pge_Init(pge, x1, y1, pg->x[idx], pg->y[idx]);
+}
+
+void pg_exec(pg_t* pg, U8G2* u8g2) {
+	pg_word_t i = pg->total_scan_line_cnt;
+
+	pg_line_init(pg, PG_LEFT);
+	pg_line_init(pg, PG_RIGHT);
+
+	if (pg->is_min_y_not_flat != 0) {
+		pge_Next(&pg->pge[PG_LEFT]);
+		pge_Next(&pg->pge[PG_RIGHT]);
+	}
+
+	do {
+		pg_hline(pg, u8g2);
+		while (pge_Next(&pg->pge[PG_LEFT]) == 0) pg_line_init(pg, PG_LEFT);
+		while (pge_Next(&pg->pge[PG_RIGHT]) == 0) pg_line_init(pg, PG_RIGHT);
+		i--;
+	} while (i > 0);
+}
+
+}  // namespace
+
+void U8G2::drawTriangle(int x0, int y0, int x1, int y1, int x2, int y2) {
+	pg_t pg;
+	pg.cnt = 3;
+	pg.x[0] = x0;
+	pg.y[0] = y0;
+	pg.x[1] = x1;
+	pg.y[1] = y1;
+	pg.x[2] = x2;
+	pg.y[2] = y2;
+	if (pg_prepare(&pg)) pg_exec(&pg, this);
+}
@@ -0,0 +1,157 @@
+// Host check for i2sDmaGeometry (lib/I2SDmaMicrophone) with the firmware's
+// settings (the 512-sample ESP-SR feed chunk at 16 kHz, MIC_DMA_* in
+// include/app_config.h):
+//   - the latency targets of the README table give its descriptors x
+//     frames, buffer length and interrupt rate
+//   - for every chunk up to 2048 samples and every latency up to 64 ms the
+//     frame count is the largest divisor of the chunk within the latency
+//     and the 4092-byte buffer, or, when that divisor is under a quarter of
+//     the limit, the limit itself (a prime chunk, say)
+//   - the ring holds the chunk plus the headroom and the buffer being
+//     filled, clamped to 2..I2S_DMA_MAX_DESC descriptors
+//
+// Build (from the repository root):
+//   g++ -O2 -std=gnu++17 -Iinclude -Ilib/I2SDmaMicrophone/src tools/i2sdma_check/i2sdma_check.cpp lib/I2SDmaMicrophone/src/I2SDmaGeometry.cpp -o i2sdma_check
+//
+// Usage:
+//   i2sdma_check
+
+#include "I2SDmaGeometry.h"
+#include "app_config.h"
+
+#include <cstdio>
+#include <string>
+
+namespace {
+
+const uint32_t SampleRate = 16000;
+// SR_FEED_CHUNK_SAMPLES in src/boot/constants.h
+const uint16_t FeedChunk = 512;
+
+unsigned failures = 0;
+
+void check(bool ok, const std::string& what, uint32_t got, uint32_t expected) {
+	if (ok) return;
+	failures++;
+	printf("  FAIL %s: %u, expected %u\n", what.c_str(), got, expected);
+}
+
+I2SDmaTarget target(uint16_t chunk, uint16_t latencyMs, uint16_t headroomMs, uint8_t bytesPerFrame = 2) {
+	I2SDmaTarget t = {SampleRate, bytesPerFrame, chunk, latencyMs, headroomMs};
+	return t;
+}
+
+void checkTable() {
+	struct Row {
+		uint16_t latencyMs;
+		uint16_t descNum;
+		uint16_t frameNum;
+		uint32_t bufferUs;
+		uint32_t interrupts;
+	};
+	const Row rows[] = {
+		{4, 25, 64, 4000, 250},
+		{8, 13, 128, 8000, 125},
+		{16, 7, 256, 16000, 62},
+		{32, 4, 512, 32000, 31},
+	};
+	for (const Row& row : rows) {
+		I2SDmaGeometry g = i2sDmaGeometry(target(FeedChunk, row.latencyMs, MIC_DMA_HEADROOM_MS));
+		std::string name = std::to_string(row.latencyMs) + " ms";
+		check(g.descNum == row.descNum, name + " descriptors", g.descNum, row.descNum);
+		check(g.frameNum == row.frameNum, name + " frames", g.frameNum, row.frameNum);
+		check(i2sDmaBufferUs(g, SampleRate) == row.bufferUs, name + " buffer us", i2sDmaBufferUs(g, SampleRate),
+			row.bufferUs);
+		check(i2sDmaInterruptsPerSec(g, SampleRate) == row.interrupts, name + " interrupts",
+			i2sDmaInterruptsPerSec(g, SampleRate), row.interrupts);
+		printf("%u ms: %u x %u\n", row.latencyMs, g.descNum, g.frameNum);
+	}
+}
+
+// The limit on frames and the largest divisor of the chunk within it
+uint32_t frameLimit(const I2SDmaTarget& t) {
+	uint32_t limit = t.sampleRate * t.latencyMs / 1000;
+	if (limit > I2S_DMA_MAX_BUFFER_BYTES / t.bytesPerFrame) limit = I2S_DMA_MAX_BUFFER_BYTES / t.bytesPerFrame;
+	return limit ? limit : 1;
+}
+
+uint32_t largestDivisor(uint32_t chunk, uint32_t limit) {
+	for (uint32_t d = limit; d > 1; d--) {
+		if (chunk % d == 0) return d;
+	}
+	return 1;
+}
+
+void checkSweep() {
+	unsigned cases = 0, fallbacks = 0, clamped = 0;
+	for (uint8_t bytes = 2; bytes <= 4; bytes += 2) {
+		for (uint16_t chunk = 1; chunk <= 2048; chunk++) {
+			for (uint16_t latencyMs = 1; latencyMs <= 64; latencyMs++) {
+				I2SDmaTarget t = target(chunk, latencyMs, MIC_DMA_HEADROOM_MS, bytes);
+				I2SDmaGeometry g = i2sDmaGeometry(t);
+				uint32_t limit = frameLimit(t);
+				uint32_t divisor = largestDivisor(chunk, limit);
+				bool fallback = divisor < limit / 4;
+				uint32_t frames = fallback ? limit : divisor;
+				std::string name = "chunk " + std::to_string(chunk) + " at " + std::to_string(latencyMs) + " ms, " +
+					std::to_string(bytes) + " bytes";
+				check(g.frameNum == frames, name + " frames", g.frameNum, frames);
+				check(g.frameNum * bytes <= I2S_DMA_MAX_BUFFER_BYTES, name + " buffer bytes", g.frameNum * bytes,
+					I2S_DMA_MAX_BUFFER_BYTES);
+
+				uint32_t ring = chunk + SampleRate * MIC_DMA_HEADROOM_MS / 1000;
+				uint32_t desc = (ring + frames - 1) / frames + 1;
+				if (desc > I2S_DMA_MAX_DESC) {
+					desc = I2S_DMA_MAX_DESC;
+					clamped++;
+				}
+				if (desc < 2) desc = 2;
+				check(g.descNum == desc, name + " descriptors", g.descNum, desc);
+				cases++;
+				if (fallback) fallbacks++;
+			}
+		}
+	}
+	printf("sweep: %u cases, %u with the fallback frame count, %u clamped to %u descriptors\n", cases, fallbacks,
+		clamped, I2S_DMA_MAX_DESC);
+}
+
+// The edges the sweep reaches only through its own model of them
+void checkEdges() {
+	// 509 is prime: one frame per interrupt would be 16000 interrupts/s
+	I2SDmaGeometry g = i2sDmaGeometry(target(509, 8, MIC_DMA_HEADROOM_MS));
+	check(g.frameNum == 128, "prime chunk falls back to the limit", g.frameNum, 128);
+	// 254 = 2 x 127: 127 frames is within a quarter of the limit, kept
+	g = i2sDmaGeometry(target(254, 8, MIC_DMA_HEADROOM_MS));
+	check(g.frameNum == 127, "divisor near the limit kept", g.frameNum, 127);
+	// 1 ms buffers and a second of headroom need 1002 descriptors
+	g = i2sDmaGeometry(target(FeedChunk, 1, 1000));
+	check(g.frameNum == 16 && g.descNum == I2S_DMA_MAX_DESC, "descriptors clamped to the maximum", g.descNum,
+		I2S_DMA_MAX_DESC);
+	// A chunk of one buffer and no headroom: that buffer and the one being filled
+	g = i2sDmaGeometry(target(FeedChunk, 32, 0));
+	check(g.frameNum == 512 && g.descNum == 2, "one chunk, no headroom", g.descNum, 2);
+	// A 4092-byte buffer holds 2046 16-bit frames; 2046 divides 4092
+	g = i2sDmaGeometry(target(4092, 1000, 0));
+	check(g.frameNum == 2046, "buffer size limit", g.frameNum, 2046);
+	// Zero chunk and frame size are treated as 1
+	g = i2sDmaGeometry(target(0, 8, 0, 0));
+	check(g.frameNum >= 1 && g.descNum >= 2, "zero chunk and frame size", g.frameNum, 1);
+	printf("edges: prime chunk, near-limit divisor, descriptor clamp, buffer limit, zero sizes\n");
+}
+
+}  // namespace
+
+int main(int argc, char**) {
+	if (argc > 1) {
+		fprintf(stderr, "usage: i2sdma_check\n");
+		return 2;
+	}
+
+	checkTable();
+	checkSweep();
+	checkEdges();
+
+	printf("%s\n", failures ? "FAIL" : "all checks passed");
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,465 @@
+// Host benchmark for lib/Kws: runs KwsEngine over a WAV corpus and reports
+// detections, accuracy and throughput. The engine sources are the ones the
+// firmware builds, nothing is stubbed.
+//
+// Build (from the repository root):
+//   g++ -O2 -std=gnu++17 -Ilib/Kws/src -Ilib/AudioFeatures/src -Ilib/NnKernels/src -Ilib/NnModel/src -Ilib/ModelPack/src
+//       tools/kws_bench/kws_bench.cpp lib/Kws/src/*.cpp lib/AudioFeatures/src/*.cpp lib/NnKernels/src/*.cpp
+//       lib/NnModel/src/*.cpp lib/ModelPack/src/ModelPack.cpp -o kws_bench
+//
+// Usage:
+//   kws_bench [--random SEED | --model model.nnm] [--threshold T] [--list corpus.txt] [--synthetic SECONDS]
+//             [--export-c kws_model.cpp] [--export-manifest DIR] [file.wav ...]
+//
+// --model runs a container from model/pack_nnm.py through the same reader
+// the firmware uses. --export-manifest writes the model as manifest.json and
+// raw tensor files for pack_nnm.py.
+//
+// corpus.txt has one "path label" pair per line; a label equal to the model's
+// keyword counts as a positive, anything else as a negative. WAV files must be
+// 16 kHz mono PCM16. Without a trained model --random builds the reference
+// DS-CNN with random weights, which is only meaningful for throughput.
+
+#include "KwsEngine.h"
+#include "KwsModelFile.h"
+#include "NnQuant.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Clip {
+	std::string path;
+	std::string label;
+	std::vector<int16_t> samples;
+};
+
+bool readWav(const std::string& path, std::vector<int16_t>& samples, std::string& error) {
+	std::ifstream f(path, std::ios::binary);
+	if (!f) {
+		error = "cannot open";
+		return false;
+	}
+	std::vector<uint8_t> data((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+	if (data.size() < 12 || memcmp(data.data(), "RIFF", 4) || memcmp(data.data() + 8, "WAVE", 4)) {
+		error = "not a RIFF/WAVE file";
+		return false;
+	}
+
+	auto u16 = [&](size_t at) { return (uint16_t)(data[at] | data[at + 1] << 8); };
+	auto u32 = [&](size_t at) { return (uint32_t)(u16(at) | (uint32_t)u16(at + 2) << 16); };
+
+	bool format = false;
+	for (size_t at = 12; at + 8 <= data.size();) {
+		uint32_t size = u32(at + 4);
+		const char* id = (const char*)&data[at];
+		size_t body = at + 8;
+		if (body + size > data.size()) size = data.size() - body;
+
+		if (!memcmp(id, "fmt ", 4) && size >= 16) {
+			if (u16(body) != 1 || u16(body + 2) != 1 || u32(body + 4) != 16000 || u16(body + 14) != 16) {
+				error = "need 16 kHz mono PCM16";
+				return false;
+			}
+			format = true;
+		} else if (!memcmp(id, "data", 4)) {
+			if (!format) break;
+			samples.resize(size / 2);
+			memcpy(samples.data(), &data[body], samples.size() * 2);
+			return true;
+		}
+		at = body + size + (size & 1);
+	}
+	error = format ? "no data chunk" : "no fmt chunk";
+	return false;
+}
+
+// Reference DS-CNN: conv 3x40->64 stride 2, three depthwise 3 + pointwise
+// 64 blocks, 1 s average pool, fc to the labels. Weights are random.
+struct RandomModel {
+	static const uint16_t MEL = 40;
+	static const uint16_t CH = 64;
+	static const uint8_t LABELS = 3;
+
+	std::vector<std::vector<int8_t>> weights;
+	std::vector<std::vector<int32_t>> bias;
+	std::vector<std::vector<int32_t>> multiplier;
+	std::vector<std::vector<int8_t>> shift;
+	std::vector<KwsLayer> layers;
+	KwsModel model;
+
+	explicit RandomModel(uint32_t seed) {
+		static const char* const LABEL_NAMES[LABELS] = {"_silence_", "_unknown_", "hi_esp"};
+		std::mt19937 rng(seed);
+
+		addLayer(rng, KWS_OP_CONV, 3, 2, true, MEL, CH, 20);
+		for (int block = 0; block < 3; block++) {
+			addLayer(rng, KWS_OP_DEPTHWISE, 3, 1, true, CH, CH, -128);
+			addLayer(rng, KWS_OP_CONV, 1, 1, true, CH, CH, -128);
+		}
+		addLayer(rng, KWS_OP_AVGPOOL, 50, 1, false, CH, CH, -128);
+		addLayer(rng, KWS_OP_FC, 1, 1, false, CH, LABELS, -128);
+
+		// Pointers are taken after every vector has its final size
+		for (size_t i = 0; i < layers.size(); i++) {
+			layers[i].weights = weights[i].empty() ? nullptr : weights[i].data();
+			layers[i].bias = bias[i].empty() ? nullptr : bias[i].data();
+			layers[i].multiplier = multiplier[i].empty() ? nullptr : multiplier[i].data();
+			layers[i].shift = shift[i].empty() ? nullptr : shift[i].data();
+		}
+
+		model = {};
+		model.sampleRate = 16000;
+		model.windowSamples = 480;
+		model.hopSamples = 160;
+		model.melBins = MEL;
+		model.melLowHz = 20.0f;
+		model.melHighHz = 7600.0f;
+		model.inputScale = 0.1f;
+		model.inputZero = 20;
+		model.layers = layers.data();
+		model.layerCount = (uint8_t)layers.size();
+		model.outputScale = 0.05f;
+		model.outputZero = 0;
+		model.labelCount = LABELS;
+		model.labels = LABEL_NAMES;
+	}
+
+	void addLayer(std::mt19937& rng, KwsOp op, uint8_t kernel, uint8_t stride, bool relu, uint16_t in, uint16_t out, int8_t inputZero) {
+		KwsLayer layer = {};
+		layer.op = op;
+		layer.kernel = kernel;
+		layer.stride = stride;
+		layer.relu = relu;
+		layer.inChannels = in;
+		layer.outChannels = out;
+		layer.inputZero = inputZero;
+		layer.outputZero = op == KWS_OP_FC ? 0 : -128;
+
+		size_t count = 0, fanIn = 0;
+		switch (op) {
+		case KWS_OP_CONV: count = (size_t)out * kernel * in; fanIn = (size_t)kernel * in; break;
+		case KWS_OP_DEPTHWISE: count = (size_t)out * kernel; fanIn = kernel; break;
+		case KWS_OP_FC: count = (size_t)out * in; fanIn = in; break;
+		case KWS_OP_AVGPOOL: break;
+		}
+
+		std::uniform_int_distribution<int> w(-127, 127);
+		std::vector<int8_t> wv(count);
+		for (auto& v : wv) v = (int8_t)w(rng);
+		std::vector<int32_t> bv, mv;
+		std::vector<int8_t> sv;
+		if (count) {
+			std::uniform_int_distribution<int32_t> b(-2000, 2000);
+			for (uint16_t o = 0; o < out; o++) {
+				int32_t m;
+				int8_t s;
+				NnQuant::quantizeMultiplier(3.0 / (127.0 * std::sqrt((double)fanIn)), &m, &s);
+				bv.push_back(b(rng));
+				mv.push_back(m);
+				sv.push_back(s);
+			}
+		}
+		weights.push_back(std::move(wv));
+		bias.push_back(std::move(bv));
+		multiplier.push_back(std::move(mv));
+		shift.push_back(std::move(sv));
+		layers.push_back(layer);
+	}
+};
+
+template <typename T>
+void writeArray(FILE* f, const char* type, const std::string& name, const T* data, size_t count) {
+	fprintf(f, "static const %s %s[%zu] __attribute__((aligned(16))) = {", type, name.c_str(), count);
+	for (size_t i = 0; i < count; i++) fprintf(f, "%s%ld", !i ? "\n\t" : i % 24 ? ", " : ",\n\t", (long)data[i]);
+	fprintf(f, "\n};\n\n");
+}
+
+// C source defining kwsModel() for the firmware (src/app/kws/kws_model.cpp)
+bool exportC(const KwsModel& model, const char* path) {
+	FILE* f = fopen(path, "w");
+	if (!f) return false;
+	fprintf(f, "// Generated by tools/kws_bench --export-c, do not edit\n#include \"KwsModel.h\"\n\n");
+
+	for (uint8_t i = 0; i < model.layerCount; i++) {
+		const KwsLayer& l = model.layers[i];
+		size_t count = l.op == KWS_OP_CONV ? (size_t)l.outChannels * l.kernel * l.inChannels
+			: l.op == KWS_OP_DEPTHWISE ? (size_t)l.outChannels * l.kernel
+			: l.op == KWS_OP_FC ? (size_t)l.outChannels * l.inChannels : 0;
+		std::string n = std::to_string(i);
+		if (l.weights) writeArray(f, "int8_t", "weights" + n, l.weights, count);
+		if (l.bias) writeArray(f, "int32_t", "bias" + n, l.bias, l.outChannels);
+		if (l.multiplier) writeArray(f, "int32_t", "multiplier" + n, l.multiplier, l.outChannels);
+		if (l.shift) writeArray(f, "int8_t", "shift" + n, l.shift, l.outChannels);
+	}
+
+	fprintf(f, "static const KwsLayer LAYERS[%u] = {\n", model.layerCount);
+	for (uint8_t i = 0; i < model.layerCount; i++) {
+		const KwsLayer& l = model.layers[i];
+		std::string n = std::to_string(i);
+		fprintf(f, "\t{(KwsOp)%u, %u, %u, %u, %u, %u, %s, %s, %s, %s, %d, %d},\n",
+			l.op, l.kernel, l.stride, l.relu, l.inChannels, l.outChannels,
+			l.weights ? ("weights" + n).c_str() : "nullptr", l.bias ? ("bias" + n).c_str() : "nullptr",
+			l.multiplier ? ("multiplier" + n).c_str() : "nullptr", l.shift ? ("shift" + n).c_str() : "nullptr",
+			l.inputZero, l.outputZero);
+	}
+	fprintf(f, "};\n\nstatic const char* const LABELS[%u] = {", model.labelCount);
+	for (uint8_t i = 0; i < model.labelCount; i++) fprintf(f, "%s\"%s\"", i ? ", " : "", model.labels[i]);
+	fprintf(f, "};\n\nstatic const KwsModel MODEL = {\n\t%u, %u, %u, %u, (float)%.9g, (float)%.9g, (float)%.9g, %d,\n\tLAYERS, %u, (float)%.9g, %d, %u, LABELS,\n};\n\n",
+		model.sampleRate, model.windowSamples, model.hopSamples, model.melBins, model.melLowHz, model.melHighHz,
+		model.inputScale, model.inputZero, model.layerCount, model.outputScale, model.outputZero, model.labelCount);
+	fprintf(f, "const KwsModel* kwsModel() {\n\treturn &MODEL;\n}\n");
+	fclose(f);
+	return true;
+}
+
+template <typename T>
+bool writeTensor(FILE* manifest, const std::string& dir, const std::string& name, const char* type,
+	const std::vector<uint32_t>& shape, const T* data, float scale = 0.0f, int zero = 0) {
+	fprintf(manifest, "    {\"name\": \"%s\", \"type\": \"%s\", \"shape\": [", name.c_str(), type);
+	size_t count = 1;
+	for (size_t i = 0; i < shape.size(); i++) {
+		fprintf(manifest, "%s%u", i ? ", " : "", shape[i]);
+		count *= shape[i];
+	}
+	fprintf(manifest, "], \"scale\": %.9g, \"zero_point\": %d", scale, zero);
+	if (data) {
+		FILE* f = fopen((dir + "/" + name + ".bin").c_str(), "wb");
+		if (!f) return false;
+		fwrite(data, sizeof(T), count, f);
+		fclose(f);
+		fprintf(manifest, ", \"data\": \"%s.bin\"", name.c_str());
+	}
+	fprintf(manifest, "},\n");
+	return true;
+}
+
+// manifest.json plus one raw little endian file per constant, the input of
+// model/pack_nnm.py. Activation scales other than the model input and the
+// logits are not tracked by KwsModel and are written as 0
+bool exportManifest(const KwsModel& model, const std::string& dir) {
+	FILE* f = fopen((dir + "/manifest.json").c_str(), "w");
+	if (!f) return false;
+	fprintf(f, "{\n  \"meta\": {\"mel.sample_rate\": %u, \"mel.window\": %u, \"mel.hop\": %u, "
+		"\"mel.low_hz\": %.9g, \"mel.high_hz\": %.9g},\n  \"labels\": [",
+		model.sampleRate, model.windowSamples, model.hopSamples, model.melLowHz, model.melHighHz);
+	for (uint8_t i = 0; i < model.labelCount; i++) fprintf(f, "%s\"%s\"", i ? ", " : "", model.labels[i]);
+	fprintf(f, "],\n  \"tensors\": [\n");
+
+	bool ok = writeTensor<int8_t>(f, dir, "input", "int8", {model.melBins}, nullptr, model.inputScale, model.inputZero);
+	for (uint8_t i = 0; i < model.layerCount; i++) {
+		const KwsLayer& l = model.layers[i];
+		std::string n = "layer" + std::to_string(i);
+		bool last = i + 1 == model.layerCount;
+		ok = ok && writeTensor<int8_t>(f, dir, n, "int8", {l.outChannels}, nullptr, last ? model.outputScale : 0.0f, l.outputZero);
+		if (l.op == KWS_OP_AVGPOOL) continue;
+		std::vector<uint32_t> shape = l.op == KWS_OP_CONV ? std::vector<uint32_t>{l.outChannels, l.kernel, l.inChannels}
+			: l.op == KWS_OP_DEPTHWISE ? std::vector<uint32_t>{l.outChannels, l.kernel}
+			: std::vector<uint32_t>{l.outChannels, l.inChannels};
+		ok = ok && writeTensor(f, dir, n + ".weights", "int8", shape, l.weights);
+		if (l.bias) ok = ok && writeTensor(f, dir, n + ".bias", "int32", {l.outChannels}, l.bias);
+		ok = ok && writeTensor(f, dir, n + ".multiplier", "int32", {l.outChannels}, l.multiplier);
+		ok = ok && writeTensor(f, dir, n + ".shift", "int8", {l.outChannels}, l.shift);
+	}
+	// JSON has no trailing commas: back over the last ",\n"
+	fseek(f, -2, SEEK_CUR);
+	fprintf(f, "\n  ],\n  \"ops\": [\n");
+
+	static const char* const OPS[] = {"conv", "depthwise", "avgpool", "fc"};
+	for (uint8_t i = 0; i < model.layerCount; i++) {
+		const KwsLayer& l = model.layers[i];
+		std::string n = "layer" + std::to_string(i);
+		std::string in = i ? "layer" + std::to_string(i - 1) : "input";
+		fprintf(f, "    {\"op\": \"%s\", \"kernel\": %u, \"stride\": %u, \"relu\": %s, \"inputs\": [\"%s\"",
+			OPS[l.op], l.kernel, l.stride, l.relu ? "true" : "false", in.c_str());
+		if (l.op != KWS_OP_AVGPOOL) {
+			fprintf(f, ", \"%s.weights\", ", n.c_str());
+			if (l.bias) fprintf(f, "\"%s.bias\"", n.c_str());
+			else fprintf(f, "null");
+			fprintf(f, ", \"%s.multiplier\", \"%s.shift\"", n.c_str(), n.c_str());
+		}
+		fprintf(f, "], \"output\": \"%s\"}%s\n", n.c_str(), i + 1 < model.layerCount ? "," : "");
+	}
+	fprintf(f, "  ]\n}\n");
+	fclose(f);
+	return ok;
+}
+
+void usage() {
+	fprintf(stderr, "usage: kws_bench [--random SEED | --model model.nnm] [--threshold T] [--list corpus.txt] [--synthetic SECONDS]\n"
+		"                 [--export-c file.cpp] [--export-manifest DIR] [file.wav ...]\n");
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+	uint32_t seed = 1;
+	float threshold = 0.8f;
+	double synthetic = 0.0;
+	const char* exportPath = nullptr;
+	const char* manifestDir = nullptr;
+	const char* modelPath = nullptr;
+	std::vector<Clip> clips;
+
+	for (int i = 1; i < argc; i++) {
+		std::string a = argv[i];
+		bool hasValue = i + 1 < argc;
+		if (a == "--random" && hasValue) {
+			seed = (uint32_t)strtoul(argv[++i], nullptr, 0);
+		} else if (a == "--threshold" && hasValue) {
+			threshold = strtof(argv[++i], nullptr);
+		} else if (a == "--synthetic" && hasValue) {
+			synthetic = strtod(argv[++i], nullptr);
+		} else if (a == "--export-c" && hasValue) {
+			exportPath = argv[++i];
+		} else if (a == "--export-manifest" && hasValue) {
+			manifestDir = argv[++i];
+		} else if (a == "--model" && hasValue) {
+			modelPath = argv[++i];
+		} else if (a == "--list" && hasValue) {
+			std::ifstream list(argv[++i]);
+			if (!list) {
+				fprintf(stderr, "cannot open %s\n", argv[i]);
+				return 1;
+			}
+			std::string line;
+			while (std::getline(list, line)) {
+				std::istringstream fields(line);
+				Clip clip;
+				if (fields >> clip.path >> clip.label && clip.path[0] != '#') clips.push_back(clip);
+			}
+		} else if (a[0] == '-') {
+			usage();
+			return 1;
+		} else {
+			clips.push_back({a, "", {}});
+		}
+	}
+
+	RandomModel random(seed);
+	NnModelFile file;
+	KwsModelStorage storage;
+	if (modelPath) {
+		esp_err_t err = file.load(modelPath);
+		if (err == ESP_OK) err = file.verify();
+		int bad = -1;
+		if (err == ESP_OK) err = kwsModelFromFile(file, storage, &bad);
+		if (err != ESP_OK) {
+			fprintf(stderr, "%s: error 0x%x (op %d)\n", modelPath, err, bad);
+			return 1;
+		}
+		printf("%s: %zu bytes, %u tensors, %u ops\n", modelPath, file.size(), file.tensorCount(), file.opCount());
+	}
+	const KwsModel& model = modelPath ? storage.model : random.model;
+
+	if (manifestDir) {
+		if (!exportManifest(model, manifestDir)) {
+			fprintf(stderr, "cannot write %s/manifest.json\n", manifestDir);
+			return 1;
+		}
+		printf("wrote %s/manifest.json\n", manifestDir);
+	}
+
+	if (exportPath) {
+		if (!exportC(model, exportPath)) {
+			fprintf(stderr, "cannot write %s\n", exportPath);
+			return 1;
+		}
+		printf("wrote %s\n", exportPath);
+	}
+
+	if (synthetic > 0.0) {
+		// Noise with a tone burst every second, for throughput without a corpus
+		std::mt19937 rng(seed);
+		std::normal_distribution<float> noise(0.0f, 300.0f);
+		Clip clip = {"<synthetic>", "", {}};
+		clip.samples.resize((size_t)(synthetic * model.sampleRate));
+		for (size_t i = 0; i < clip.samples.size(); i++) {
+			float v = noise(rng);
+			if (i % model.sampleRate < 4000) v += 6000.0f * std::sin(2.0 * M_PI * 440.0 * i / model.sampleRate);
+			clip.samples[i] = (int16_t)std::max(-32768.0f, std::min(32767.0f, v));
+		}
+		clips.push_back(clip);
+	}
+
+	if (clips.empty()) {
+		if (exportPath || manifestDir) return 0;
+		usage();
+		return 1;
+	}
+
+	size_t arenaBytes = KwsEngine::arenaSize(model);
+	std::vector<uint8_t> arena(arenaBytes);
+	KwsConfig config = {0, threshold, 10, 100};
+	while (config.keyword + 1 < model.labelCount && strcmp(model.labels[config.keyword], "hi_esp") != 0) config.keyword++;
+	KwsEngine engine;
+	esp_err_t err = engine.begin(model, config, arena.data(), arena.size());
+	if (err != ESP_OK) {
+		fprintf(stderr, "engine begin failed: %d\n", err);
+		return 1;
+	}
+
+	const char* keyword = model.labels[config.keyword];
+	uint32_t positives = 0, hits = 0, negatives = 0, falseAccepts = 0;
+	double negativeSeconds = 0.0, audioSeconds = 0.0, processSeconds = 0.0;
+	uint64_t frames = 0, outputs = 0;
+
+	for (Clip& clip : clips) {
+		if (clip.samples.empty()) {
+			std::string error;
+			if (!readWav(clip.path, clip.samples, error)) {
+				fprintf(stderr, "%s: %s, skipped\n", clip.path.c_str(), error.c_str());
+				continue;
+			}
+		}
+
+		engine.reset();
+		// Feed in 10 ms chunks like the device fill path
+		auto start = std::chrono::steady_clock::now();
+		uint32_t detections = 0;
+		for (size_t at = 0; at < clip.samples.size(); at += model.hopSamples) {
+			size_t n = std::min<size_t>(model.hopSamples, clip.samples.size() - at);
+			if (engine.process(&clip.samples[at], n)) detections++;
+		}
+		processSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		double seconds = (double)clip.samples.size() / model.sampleRate;
+		audioSeconds += seconds;
+		frames += engine.stats().frames;
+		outputs += engine.stats().outputs;
+
+		bool positive = clip.label == keyword;
+		if (!clip.label.empty()) {
+			if (positive) {
+				positives++;
+				hits += detections > 0;
+			} else {
+				negatives++;
+				negativeSeconds += seconds;
+				falseAccepts += detections;
+			}
+		}
+		printf("%-40s %-12s %6.2f s  detections %u\n", clip.path.c_str(), clip.label.c_str(), seconds, detections);
+	}
+
+	printf("\narena %zu bytes, %llu frames, %llu network outputs, %.2f s of audio\n",
+		arenaBytes, (unsigned long long)frames, (unsigned long long)outputs, audioSeconds);
+	if (frames) {
+		printf("throughput: %.2f us/frame, %.0fx real time\n", processSeconds * 1e6 / frames, audioSeconds / processSeconds);
+	}
+	if (positives) printf("recall: %u/%u (%.1f%%) for '%s'\n", hits, positives, 100.0 * hits / positives, keyword);
+	if (negatives) {
+		printf("false accepts: %u in %.1f s of negatives (%.2f per hour)\n",
+			falseAccepts, negativeSeconds, negativeSeconds > 0 ? falseAccepts * 3600.0 / negativeSeconds : 0.0);
+	}
+	return 0;
+}
@@ -0,0 +1,274 @@
+// Host benchmark for lib/AudioFeatures: runs MelFrontend over WAV files or a
+// synthetic signal, reports microseconds per frame and compares every frame
+// against a double precision reference of the same definition.
+//
+// Build (from the repository root):
+//   g++ -O2 -std=gnu++17 -Ilib/AudioFeatures/src tools/mel_bench/mel_bench.cpp lib/AudioFeatures/src/*.cpp -o mel_bench
+//
+// Usage:
+//   mel_bench [--window N] [--hop N] [--mel N] [--mfcc N] [--preemph A]
+//             [--low HZ] [--high HZ] [--seconds S] [file.wav ...]
+//
+// WAV files must be 16 kHz mono PCM16. Without files a 10 s test signal
+// (sweep, tones and noise with silent gaps) is used.
+
+#include "MelFrontend.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+bool readWav(const std::string& path, std::vector<int16_t>& samples, std::string& error) {
+	std::ifstream f(path, std::ios::binary);
+	if (!f) {
+		error = "cannot open";
+		return false;
+	}
+	std::vector<uint8_t> data((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+	if (data.size() < 12 || memcmp(data.data(), "RIFF", 4) || memcmp(data.data() + 8, "WAVE", 4)) {
+		error = "not a RIFF/WAVE file";
+		return false;
+	}
+
+	auto u16 = [&](size_t at) { return (uint16_t)(data[at] | data[at + 1] << 8); };
+	auto u32 = [&](size_t at) { return (uint32_t)(u16(at) | (uint32_t)u16(at + 2) << 16); };
+
+	bool format = false;
+	for (size_t at = 12; at + 8 <= data.size();) {
+		uint32_t size = u32(at + 4);
+		const char* id = (const char*)&data[at];
+		size_t body = at + 8;
+		if (body + size > data.size()) size = data.size() - body;
+
+		if (!memcmp(id, "fmt ", 4) && size >= 16) {
+			if (u16(body) != 1 || u16(body + 2) != 1 || u32(body + 4) != 16000 || u16(body + 14) != 16) {
+				error = "need 16 kHz mono PCM16";
+				return false;
+			}
+			format = true;
+		} else if (!memcmp(id, "data", 4)) {
+			if (!format) break;
+			samples.resize(size / 2);
+			memcpy(samples.data(), &data[body], samples.size() * 2);
+			return true;
+		}
+		at = body + size + (size & 1);
+	}
+	error = format ? "no data chunk" : "no fmt chunk";
+	return false;
+}
+
+std::vector<int16_t> testSignal(double seconds, uint16_t rate) {
+	std::vector<int16_t> out((size_t)(seconds * rate));
+	std::mt19937 rng(7);
+	std::normal_distribution<double> noise(0.0, 300.0);
+	for (size_t i = 0; i < out.size(); i++) {
+		double t = (double)i / rate;
+		double second = fmod(t, 1.0);
+		double v = 0.0;
+		if (second < 0.6) {
+			// Sweep 100 Hz -> 7 kHz over each second plus two tones
+			double f = 100.0 + 6900.0 * second / 0.6;
+			v = 8000.0 * sin(2.0 * M_PI * f * t) + 3000.0 * sin(2.0 * M_PI * 440.0 * t) + 1500.0 * sin(2.0 * M_PI * 3100.0 * t);
+			v += noise(rng);
+		} else if (second < 0.8) {
+			v = noise(rng);
+		}
+		out[i] = (int16_t)std::max(-32768.0, std::min(32767.0, v));
+	}
+	return out;
+}
+
+// Same definition as MelFrontend, in double precision with a direct DFT
+struct Reference {
+	MelConfig config;
+	uint16_t fftSize;
+	std::vector<double> window;
+	std::vector<uint16_t> edges;
+
+	explicit Reference(const MelConfig& c) : config(c) {
+		fftSize = 2;
+		while (fftSize < c.windowSamples) fftSize <<= 1;
+		for (uint16_t i = 0; i < c.windowSamples; i++) {
+			window.push_back(0.5 - 0.5 * cos(2.0 * M_PI * i / c.windowSamples));
+		}
+		double low = 1127.0 * log(1.0 + c.lowHz / 700.0);
+		double high = 1127.0 * log(1.0 + c.highHz / 700.0);
+		for (uint16_t m = 0; m < c.melBins + 2; m++) {
+			double mel = low + (high - low) * m / (c.melBins + 1);
+			double hz = 700.0 * (exp(mel / 1127.0) - 1.0);
+			long bin = lround(hz * fftSize / c.sampleRate);
+			edges.push_back((uint16_t)std::min<long>(bin, fftSize / 2));
+		}
+	}
+
+	// history: windowSamples + 1 samples, the one before the window first
+	void frame(const int16_t* history, std::vector<double>& logMel, std::vector<double>& mfcc) const {
+		uint16_t n = config.windowSamples;
+		std::vector<double> x(n);
+		for (uint16_t i = 0; i < n; i++) {
+			double v = history[i + 1] - config.preEmphasis * history[i];
+			x[i] = v * window[i] / 32768.0;
+		}
+
+		uint16_t half = fftSize / 2;
+		std::vector<double> power(half + 1);
+		for (uint16_t k = 0; k <= half; k++) {
+			double re = 0.0, im = 0.0;
+			for (uint16_t i = 0; i < n; i++) {
+				double a = 2.0 * M_PI * k * i / fftSize;
+				re += x[i] * cos(a);
+				im -= x[i] * sin(a);
+			}
+			power[k] = re * re + im * im;
+		}
+
+		logMel.assign(config.melBins, 0.0);
+		for (uint16_t m = 0; m < config.melBins; m++) {
+			uint16_t left = edges[m], center = edges[m + 1], right = edges[m + 2];
+			double energy = 0.0;
+			for (uint16_t k = left; k < center; k++) energy += power[k] * (k - left) / (center - left);
+			for (uint16_t k = center; k < right; k++) energy += power[k] * (right - k) / (right - center);
+			logMel[m] = log(energy + 1e-6);
+		}
+
+		mfcc.assign(config.mfccCount, 0.0);
+		for (uint8_t i = 0; i < config.mfccCount; i++) {
+			double scale = sqrt((i ? 2.0 : 1.0) / config.melBins);
+			for (uint16_t m = 0; m < config.melBins; m++) {
+				mfcc[i] += logMel[m] * scale * cos(M_PI * i * (m + 0.5) / config.melBins);
+			}
+		}
+	}
+};
+
+// ln energy about 80 dB under a full-scale tone; below it the int16 input
+// step and the 1e-6 floor dominate both implementations
+const double QUIET = -9.0;
+
+struct Result {
+	uint32_t frames = 0;
+	double seconds = 0.0;
+	double melError = 0.0;
+	double melErrorAudible = 0.0;  // bands above QUIET
+	double mfccError = 0.0;
+};
+
+// Times the front-end alone first, then replays the clip to compare frames
+Result run(const MelConfig& config, const std::vector<int16_t>& samples, bool compare) {
+	Result result;
+	std::vector<uint8_t> memory(MelFrontend::memorySize(config));
+	MelFrontend mel;
+	if (mel.begin(config, memory.data(), memory.size()) != ESP_OK) return result;
+
+	auto start = std::chrono::steady_clock::now();
+	for (int pass = 0; pass < 5; pass++) {
+		mel.reset();
+		for (size_t at = 0; at < samples.size();) {
+			at += mel.push(samples.data() + at, samples.size() - at);
+		}
+		result.frames += mel.frames();
+	}
+	result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	if (!compare) return result;
+
+	Reference reference(config);
+	std::vector<int16_t> history(config.windowSamples + 1, 0);
+	std::vector<double> logMel, mfcc;
+	mel.reset();
+	for (size_t at = 0; at < samples.size();) {
+		size_t used = mel.push(samples.data() + at, samples.size() - at);
+		for (size_t i = 0; i < used; i++) {
+			history.erase(history.begin());
+			history.push_back(samples[at + i]);
+		}
+		at += used;
+		if (!mel.frameReady()) continue;
+
+		reference.frame(history.data(), logMel, mfcc);
+		for (uint16_t m = 0; m < config.melBins; m++) {
+			double error = fabs(mel.logMel()[m] / 256.0 - logMel[m]);
+			result.melError = std::max(result.melError, error);
+			if (logMel[m] > QUIET) result.melErrorAudible = std::max(result.melErrorAudible, error);
+		}
+		for (uint8_t i = 0; i < config.mfccCount; i++) {
+			result.mfccError = std::max(result.mfccError, fabs(mel.mfcc()[i] / 256.0 - mfcc[i]));
+		}
+	}
+	return result;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+	MelConfig config = {16000, 400, 160, 40, 20.0f, 7600.0f, 0.97f, 13};
+	double seconds = 10.0;
+	std::vector<std::string> files;
+
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		bool value = i + 1 < argc;
+		if (arg == "--window" && value) config.windowSamples = (uint16_t)atoi(argv[++i]);
+		else if (arg == "--hop" && value) config.hopSamples = (uint16_t)atoi(argv[++i]);
+		else if (arg == "--mel" && value) config.melBins = (uint16_t)atoi(argv[++i]);
+		else if (arg == "--mfcc" && value) config.mfccCount = (uint8_t)atoi(argv[++i]);
+		else if (arg == "--preemph" && value) config.preEmphasis = (float)atof(argv[++i]);
+		else if (arg == "--low" && value) config.lowHz = (float)atof(argv[++i]);
+		else if (arg == "--high" && value) config.highHz = (float)atof(argv[++i]);
+		else if (arg == "--seconds" && value) seconds = atof(argv[++i]);
+		else if (arg[0] != '-') files.push_back(arg);
+		else {
+			fprintf(stderr, "usage: mel_bench [--window N] [--hop N] [--mel N] [--mfcc N] [--preemph A] [--low HZ] [--high HZ] [--seconds S] [file.wav ...]\n");
+			return 2;
+		}
+	}
+	if (MelFrontend::validate(config) != ESP_OK) {
+		fprintf(stderr, "invalid front-end configuration\n");
+		return 2;
+	}
+
+	std::vector<int16_t> samples;
+	if (files.empty()) {
+		samples = testSignal(seconds, config.sampleRate);
+	}
+	for (const std::string& path : files) {
+		std::vector<int16_t> clip;
+		std::string error;
+		if (!readWav(path, clip, error)) {
+			fprintf(stderr, "%s: %s, skipped\n", path.c_str(), error.c_str());
+			continue;
+		}
+		samples.insert(samples.end(), clip.begin(), clip.end());
+	}
+	if (samples.empty()) return 1;
+
+	MelFrontend probe;
+	std::vector<uint8_t> memory(MelFrontend::memorySize(config));
+	probe.begin(config, memory.data(), memory.size());
+	printf("window %u, hop %u, FFT %u, %u mel bins %.0f-%.0f Hz, pre-emphasis %.2f, %u MFCC\n",
+		config.windowSamples, config.hopSamples, probe.fftSize(), config.melBins, config.lowHz, config.highHz,
+		config.preEmphasis, config.mfccCount);
+	printf("memory %zu bytes, int16 stages: %s\n", memory.size(), probe.vectorized() ? "PIE" : "portable");
+
+	MelConfig melOnly = config;
+	melOnly.mfccCount = 0;
+	Result mel = run(melOnly, samples, false);
+	Result full = run(config, samples, true);
+	double audio = (double)samples.size() / config.sampleRate;
+
+	printf("%.2f s of audio, %u frames\n", audio, full.frames / 5);
+	printf("log-mel:        %.2f us/frame\n", mel.seconds * 1e6 / mel.frames);
+	printf("log-mel + MFCC: %.2f us/frame, %.0fx real time\n", full.seconds * 1e6 / full.frames, audio * 5 / full.seconds);
+	printf("max error vs double reference: log-mel %.4f (%.4f above ln E = %.0f), MFCC %.4f, Q8 step %.4f\n",
+		full.melError, full.melErrorAudible, QUIET, full.mfccError, 1.0 / 256);
+	return 0;
+}
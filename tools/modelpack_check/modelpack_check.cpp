@@ -0,0 +1,239 @@
+// Host check for lib/ModelPack against images written by model/pack_model.py.
+// Builds a small model tree, packs it as version 1 (-a 0) and version 2,
+// and checks that every file is found with the right bytes, that lookups of
+// absent or prefix names fail, that per-file CRCs verify, and that a
+// corrupted file or index is reported. Extra images given on the command
+// line (e.g. model/target/srmodels.bin) get every file verified.
+//
+// Build (from the repository root):
+//   g++ -O2 -std=gnu++17 -Ilib/ModelPack/src tools/modelpack_check/modelpack_check.cpp lib/ModelPack/src/ModelPack.cpp -o modelpack_check
+//
+// Usage:
+//   modelpack_check [--python CMD] [--packer model/pack_model.py] [--seed N] [srmodels.bin ...]
+
+#include "ModelPack.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+typedef std::map<std::pair<std::string, std::string>, std::vector<uint8_t>> Tree;
+
+unsigned failures = 0;
+
+void check(bool ok, const char* what, const std::string& detail = "") {
+	if (ok) return;
+	failures++;
+	printf("  FAIL %s %s\n", what, detail.c_str());
+}
+
+std::vector<uint8_t> readFile(const std::string& path) {
+	std::vector<uint8_t> data;
+	FILE* f = fopen(path.c_str(), "rb");
+	if (!f) return data;
+	fseek(f, 0, SEEK_END);
+	data.resize(ftell(f));
+	fseek(f, 0, SEEK_SET);
+	if (fread(data.data(), 1, data.size(), f) != data.size()) data.clear();
+	fclose(f);
+	return data;
+}
+
+// Names out of order and sharing prefixes, sizes around the page size
+Tree makeTree(std::mt19937& rng) {
+	const struct {
+		const char* model;
+		const char* file;
+		size_t size;
+	} layout[] = {
+		{"wn9_hiesp", "wn9_index", 37},
+		{"wn9_hiesp", "wn9_data", 70000},
+		{"wn9_hiesp", "_MODEL_INFO_", 120},
+		{"wn9", "wn9_data", 1},
+		{"nsnet2", "nsnet2_data", ModelPack::MMU_PAGE_SIZE},
+		{"nsnet2", "_MODEL_INFO_", 64},
+		{"mn5q8_en", "mn5q8_data", 150000},
+		{"a_31_characters_long_model_name", "a_31_characters_long_file_name_", 3},
+	};
+	std::uniform_int_distribution<int> byte(0, 255);
+	Tree tree;
+	for (const auto& l : layout) {
+		std::vector<uint8_t> data(l.size);
+		for (uint8_t& b : data) b = (uint8_t)byte(rng);
+		tree[{l.model, l.file}] = data;
+	}
+	return tree;
+}
+
+bool writeTree(const std::string& dir, const Tree& tree) {
+	for (const auto& item : tree) {
+		std::string modelDir = dir + "/" + item.first.first;
+		mkdir(modelDir.c_str(), 0755);
+		FILE* f = fopen((modelDir + "/" + item.first.second).c_str(), "wb");
+		if (!f) return false;
+		fwrite(item.second.data(), 1, item.second.size(), f);
+		fclose(f);
+	}
+	return true;
+}
+
+std::vector<uint8_t> pack(const std::string& python, const std::string& packer, const std::string& dir,
+	const char* name, unsigned alignment) {
+	char cmd[1024];
+	snprintf(cmd, sizeof(cmd), "%s %s -m %s -o %s -a %u > /dev/null", python.c_str(), packer.c_str(), dir.c_str(),
+		name, alignment);
+	if (system(cmd) != 0) return std::vector<uint8_t>();
+	return readFile(dir + "/" + name);
+}
+
+void checkLookups(const ModelPack& pack, const Tree& tree) {
+	for (const auto& item : tree) {
+		const char* model = item.first.first.c_str();
+		const char* file = item.first.second.c_str();
+		ModelSpan span = pack.find(model, file);
+		check(!span.empty() && span.size == item.second.size() && !memcmp(span.data, item.second.data(), span.size),
+			"find", item.first.first + "/" + item.first.second);
+		if (pack.alignment() > 1) {
+			uint32_t offset, size;
+			check(pack.locate(model, file, &offset, &size) && offset % pack.alignment() == 0, "alignment", file);
+			check(pack.verify(model, file) == ESP_OK, "verify", file);
+		}
+	}
+
+	size_t hiesp = 0;
+	for (const auto& item : tree) {
+		if (item.first.first == "wn9_hiesp") hiesp += item.second.size();
+	}
+	check(pack.modelSize("wn9_hiesp") == hiesp, "modelSize");
+	check(pack.modelCount() == 5 && pack.fileCount() == tree.size(), "counts");
+
+	// Absent names, and names that are a prefix of or extend a real one
+	check(pack.find("wn9_hies", "wn9_data").empty(), "prefix model");
+	check(pack.find("wn9_hiesp", "wn9_dat").empty(), "prefix file");
+	check(pack.find("wn9_hiesp2", "wn9_data").empty(), "longer model");
+	check(pack.find("nsnet2", "wn9_data").empty(), "file of another model");
+	check(pack.find("missing", "_MODEL_INFO_").empty(), "missing model");
+	check(pack.modelSize("missing") == 0, "missing modelSize");
+}
+
+void checkImage(const char* label, std::vector<uint8_t> image, const Tree& tree, uint16_t version) {
+	printf("%s: %zu bytes\n", label, image.size());
+	ModelPack pack;
+	esp_err_t err = pack.open(image.data(), image.size());
+	check(err == ESP_OK, "open");
+	if (err != ESP_OK) return;
+	check(pack.version() == version, "version");
+	checkLookups(pack, tree);
+
+	if (version == 1) {
+		check(pack.verify("wn9_hiesp", "wn9_data") == ESP_ERR_NOT_SUPPORTED, "v1 verify");
+		check(pack.findEntry("wn9_hiesp", "wn9_data") == nullptr, "v1 index");
+		return;
+	}
+	check(pack.alignment() == ModelPack::MMU_PAGE_SIZE, "alignment");
+	check(pack.verifyModel("wn9_hiesp") == ESP_OK, "verifyModel");
+	check(pack.verifyModel("missing") == ESP_ERR_NOT_FOUND, "verifyModel missing");
+	for (size_t i = 1; i < pack.fileCount(); i++) {
+		const ModelPackEntry* a = pack.entry(i - 1);
+		const ModelPackEntry* b = pack.entry(i);
+		int cmp = strncmp(a->model, b->model, 32);
+		check(cmp < 0 || (cmp == 0 && strncmp(a->file, b->file, 32) < 0), "index order");
+	}
+
+	// One flipped bit in a file: that file fails, its neighbours do not
+	uint32_t offset, size;
+	pack.locate("mn5q8_en", "mn5q8_data", &offset, &size);
+	image[offset + size / 2] ^= 0x10;
+	check(pack.verify("mn5q8_en", "mn5q8_data") == ESP_ERR_INVALID_CRC, "corrupt file");
+	check(pack.verifyModel("mn5q8_en") == ESP_ERR_INVALID_CRC, "corrupt model");
+	check(pack.verifyModel("nsnet2") == ESP_OK, "neighbour of corrupt file");
+	image[offset + size / 2] ^= 0x10;
+
+	// One flipped bit in the index: the pack does not open
+	const ModelPackEntry* e = pack.entry(0);
+	size_t at = (const uint8_t*)&e->size - image.data();
+	pack.close();
+	image[at] ^= 0x01;
+	check(pack.open(image.data(), image.size()) == ESP_ERR_INVALID_CRC, "corrupt index");
+	image[at] ^= 0x01;
+
+	// Truncated image: file offsets past the end
+	check(pack.open(image.data(), image.size() / 2) != ESP_OK, "truncated");
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+	std::string python = "python3";
+	std::string packer = "model/pack_model.py";
+	uint32_t seed = 1;
+	std::vector<std::string> images;
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		bool value = i + 1 < argc;
+		if (arg == "--python" && value) python = argv[++i];
+		else if (arg == "--packer" && value) packer = argv[++i];
+		else if (arg == "--seed" && value) seed = (uint32_t)atoi(argv[++i]);
+		else if (arg[0] == '-') {
+			fprintf(stderr, "usage: modelpack_check [--python CMD] [--packer model/pack_model.py] [--seed N] [srmodels.bin ...]\n");
+			return 2;
+		} else images.push_back(arg);
+	}
+
+	char dir[] = "/tmp/modelpack_check.XXXXXX";
+	if (!mkdtemp(dir)) {
+		perror("mkdtemp");
+		return 1;
+	}
+	std::mt19937 rng(seed);
+	Tree tree = makeTree(rng);
+	if (!writeTree(dir, tree)) {
+		fprintf(stderr, "cannot write the model tree in %s\n", dir);
+		return 1;
+	}
+
+	std::vector<uint8_t> v1 = pack(python, packer, dir, "v1.bin", 0);
+	std::vector<uint8_t> v2 = pack(python, packer, dir, "v2.bin", ModelPack::MMU_PAGE_SIZE);
+	if (v1.empty() || v2.empty()) {
+		fprintf(stderr, "%s %s failed\n", python.c_str(), packer.c_str());
+		return 1;
+	}
+	checkImage("version 1 (unaligned)", v1, tree, 1);
+	checkImage("version 2 (64 KB aligned)", v2, tree, 2);
+
+	for (const std::string& path : images) {
+		std::vector<uint8_t> image = readFile(path);
+		ModelPack pack;
+		esp_err_t err = pack.open(image.data(), image.size());
+		printf("%s: %zu bytes, ", path.c_str(), image.size());
+		if (err != ESP_OK) {
+			printf("open failed (0x%x)\n", err);
+			failures++;
+			continue;
+		}
+		printf("version %u, %zu models, %zu files\n", pack.version(), pack.modelCount(), pack.fileCount());
+		for (size_t i = 0; i < pack.fileCount() && pack.version() > 1; i++) {
+			const ModelPackEntry* e = pack.entry(i);
+			esp_err_t v = pack.verify(e);
+			printf("  %-24.32s %-24.32s %8u bytes @ 0x%06x %s\n", e->model, e->file, e->size, e->offset,
+				v == ESP_OK ? "ok" : "CRC MISMATCH");
+			if (v != ESP_OK) failures++;
+		}
+	}
+
+	char cleanup[128];
+	snprintf(cleanup, sizeof(cleanup), "rm -rf %s", dir);
+	if (system(cleanup) != 0) fprintf(stderr, "could not remove %s\n", dir);
+	printf("%s\n", failures ? "FAIL" : "all checks passed");
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,258 @@
+// Host check and benchmark for lib/NnKernels: runs every kernel on random
+// tensors through the fast path and the reference, counts outputs that
+// differ (they must not), and times both.
+//
+// Build (from the repository root):
+//   g++ -O2 -std=gnu++17 -march=native -Ilib/NnKernels/src tools/nn_bench/nn_bench.cpp lib/NnKernels/src/*.cpp -o nn_bench
+//
+// Without -march=native (or -msse4.1) the fast path uses the C dot product.
+//
+// Usage:
+//   nn_bench [--seed N] [--iterations N]
+
+#include "NnKernels.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::mt19937 rng;
+
+std::vector<int8_t> randomInt8(size_t n) {
+	std::uniform_int_distribution<int> d(-128, 127);
+	std::vector<int8_t> v(n);
+	for (int8_t& x : v) x = (int8_t)d(rng);
+	return v;
+}
+
+std::vector<int32_t> randomInt32(size_t n, int32_t range) {
+	std::uniform_int_distribution<int32_t> d(-range, range);
+	std::vector<int32_t> v(n);
+	for (int32_t& x : v) x = d(rng);
+	return v;
+}
+
+// Per-channel requantization that maps the accumulator range of a
+// rowLength long dot product onto about the output range
+struct Requant {
+	std::vector<int32_t> multiplier;
+	std::vector<int8_t> shift;
+
+	Requant(size_t channels, size_t rowLength, double target) {
+		std::uniform_real_distribution<double> spread(0.5, 2.0);
+		for (size_t i = 0; i < channels; i++) {
+			int32_t m;
+			int8_t s;
+			NnQuant::quantizeMultiplier(target * spread(rng) / (128.0 * 64.0 * sqrt((double)rowLength)), &m, &s);
+			multiplier.push_back(m);
+			shift.push_back(s);
+		}
+	}
+};
+
+// One layer with its own storage, weights at an offset from 16-byte
+// alignment so both PIE cases are exercised on the device
+struct ConvCase {
+	std::string name;
+	NnConv p;
+	bool depthwise;
+	std::vector<int8_t> weights;
+	std::vector<int32_t> bias, kernelSum;
+	Requant requant;
+	std::vector<int8_t> input;  // [kernel][inChannels]
+
+	ConvCase(const char* n, uint16_t in, uint16_t out, uint8_t kernel, bool dw, bool relu)
+		: name(n), p(), depthwise(dw), requant(out, dw ? kernel : (size_t)kernel * in, 40.0) {
+		size_t count = dw ? (size_t)in * kernel : (size_t)out * kernel * in;
+		weights = randomInt8(count);
+		bias = randomInt32(out, 2000);
+		input = randomInt8((size_t)kernel * in);
+		kernelSum.resize(out);
+
+		p.inChannels = in;
+		p.outChannels = out;
+		p.kernel = kernel;
+		p.weights = weights.data();
+		p.bias = bias.data();
+		p.multiplier = requant.multiplier.data();
+		p.shift = requant.shift.data();
+		p.inputZero = std::uniform_int_distribution<int>(-128, 127)(rng);
+		p.outputZero = std::uniform_int_distribution<int>(-20, 20)(rng);
+		p.activationMin = relu ? p.outputZero : -128;
+		p.activationMax = 127;
+		if (dw) nnDepthwiseKernelSums(p, kernelSum.data());
+		else nnKernelSums(p.weights, out, (uint32_t)kernel * in, p.bias, p.inputZero, kernelSum.data());
+	}
+
+	void run(bool fast, int8_t* out) {
+		std::vector<const int8_t*> rows;
+		for (uint8_t k = 0; k < p.kernel; k++) rows.push_back(input.data() + (size_t)k * p.inChannels);
+		NnConv q = p;
+		q.kernelSum = fast ? kernelSum.data() : nullptr;
+		if (depthwise) nnDepthwiseFrame(q, rows.data(), out);
+		else nnConvFrame(q, rows.data(), out);
+	}
+};
+
+struct GruCase {
+	NnGru p;
+	std::vector<int8_t> inputWeights, hiddenWeights, x, h;
+	std::vector<int32_t> inputBias, hiddenBias, kernelSum;
+	Requant inputRequant, hiddenRequant;
+
+	GruCase(uint16_t in, uint16_t hidden)
+		: p(), inputRequant(3 * hidden, in, 4096.0 * 64.0), hiddenRequant(3 * hidden, hidden, 4096.0 * 64.0) {
+		inputWeights = randomInt8((size_t)3 * hidden * in);
+		hiddenWeights = randomInt8((size_t)3 * hidden * hidden);
+		inputBias = randomInt32(3 * hidden, 2000);
+		hiddenBias = randomInt32(3 * hidden, 2000);
+		x = randomInt8(in);
+		h = randomInt8(hidden);
+		kernelSum.resize(3 * hidden);
+
+		p.inputSize = in;
+		p.hiddenSize = hidden;
+		p.inputWeights = inputWeights.data();
+		p.hiddenWeights = hiddenWeights.data();
+		p.inputBias = inputBias.data();
+		p.hiddenBias = hiddenBias.data();
+		p.inputMultiplier = inputRequant.multiplier.data();
+		p.inputShift = inputRequant.shift.data();
+		p.hiddenMultiplier = hiddenRequant.multiplier.data();
+		p.hiddenShift = hiddenRequant.shift.data();
+		p.inputZero = std::uniform_int_distribution<int>(-128, 127)(rng);
+		nnKernelSums(p.inputWeights, 3 * hidden, in, p.inputBias, p.inputZero, kernelSum.data());
+	}
+
+	// Several steps so the state feeds back
+	void run(bool fast, int8_t* out, int steps) {
+		NnGru q = p;
+		q.inputKernelSum = fast ? kernelSum.data() : nullptr;
+		std::vector<int16_t> scratch(6 * p.hiddenSize);
+		memcpy(out, h.data(), p.hiddenSize);
+		for (int i = 0; i < steps; i++) nnGruStep(q, x.data(), out, scratch.data());
+	}
+};
+
+double microseconds(int iterations, const std::function<void()>& body) {
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < iterations; i++) body();
+	return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / iterations;
+}
+
+uint32_t mismatches(const int8_t* a, const int8_t* b, size_t n) {
+	uint32_t count = 0;
+	for (size_t i = 0; i < n; i++) count += a[i] != b[i];
+	return count;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+	uint32_t seed = 1;
+	int iterations = 20000;
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		bool value = i + 1 < argc;
+		if (arg == "--seed" && value) seed = (uint32_t)atoi(argv[++i]);
+		else if (arg == "--iterations" && value) iterations = atoi(argv[++i]);
+		else {
+			fprintf(stderr, "usage: nn_bench [--seed N] [--iterations N]\n");
+			return 2;
+		}
+	}
+	rng.seed(seed);
+	printf("fast path backend: %s\n", nnBackendName(nnInit()));
+	uint32_t failures = 0;
+
+	// Dot product over every length and alignment up to 80
+	uint32_t dotErrors = 0;
+	std::vector<int8_t> a = randomInt8(128), b = randomInt8(128);
+	for (size_t offset = 0; offset < 16; offset++) {
+		for (size_t n = 0; n <= 80; n++) {
+			dotErrors += nnDot(a.data() + offset, b.data() + 16 - offset, n) != nnDotReference(a.data() + offset, b.data() + 16 - offset, n);
+		}
+	}
+	printf("dot product, 1296 length/offset pairs: %u mismatches\n", dotErrors);
+	failures += dotErrors;
+
+	// Activations against libm
+	double tanhError = 0.0, sigmoidError = 0.0;
+	for (int32_t q = -40000; q <= 40000; q++) {
+		double x = q / 4096.0;
+		tanhError = std::max(tanhError, fabs(nnTanhQ15(q) / 32768.0 - tanh(x)));
+		sigmoidError = std::max(sigmoidError, fabs(nnSigmoidQ15(q) / 32768.0 - 1.0 / (1.0 + exp(-x))));
+	}
+	printf("activations, max error: tanh %.5f, sigmoid %.5f\n", tanhError, sigmoidError);
+
+	// Shapes of the DS-CNN keyword spotter plus odd sizes for the tails
+	ConvCase convs[] = {
+		ConvCase("conv 3x40->64", 40, 64, 3, false, true),
+		ConvCase("pointwise 64->64", 64, 64, 1, false, true),
+		ConvCase("conv 5x27->33", 27, 33, 5, false, false),
+		ConvCase("depthwise 3x64", 64, 64, 3, true, true),
+		ConvCase("depthwise 9x37", 37, 37, 9, true, false),
+		ConvCase("fc 64->12", 64, 12, 1, false, false),
+		ConvCase("fc 250->10", 250, 10, 1, false, false),
+	};
+
+	printf("%-20s %10s %10s %8s %s\n", "kernel", "ref us", "fast us", "speedup", "mismatches");
+	for (ConvCase& c : convs) {
+		std::vector<int8_t> expected(c.p.outChannels), actual(c.p.outChannels);
+		c.run(false, expected.data());
+		c.run(true, actual.data());
+		uint32_t bad = mismatches(expected.data(), actual.data(), expected.size());
+		failures += bad;
+
+		double reference = microseconds(iterations, [&] { c.run(false, expected.data()); });
+		double fast = microseconds(iterations, [&] { c.run(true, actual.data()); });
+		printf("%-20s %10.3f %10.3f %7.2fx %u/%zu\n", c.name.c_str(), reference, fast, reference / fast, bad, expected.size());
+	}
+
+	// Whole sequence helper against frame by frame reference
+	{
+		ConvCase& c = convs[0];
+		const size_t frames = 49;
+		std::vector<int8_t> sequence = randomInt8(frames * c.p.inChannels);
+		NnConv fast = c.p;
+		fast.kernelSum = c.kernelSum.data();
+		size_t outputs = (frames - c.p.kernel) / 2 + 1;
+		std::vector<int8_t> actual(outputs * c.p.outChannels), expected(actual.size());
+		size_t produced = nnConv1d(fast, sequence.data(), frames, 2, actual.data());
+		for (size_t t = 0; t < outputs; t++) {
+			const int8_t* rows[3];
+			for (uint8_t k = 0; k < 3; k++) rows[k] = sequence.data() + (t * 2 + k) * c.p.inChannels;
+			nnConvFrameReference(c.p, rows, expected.data() + t * c.p.outChannels);
+		}
+		uint32_t bad = mismatches(expected.data(), actual.data(), actual.size()) + (produced != outputs);
+		failures += bad;
+		printf("conv1d 49 frames, stride 2: %zu outputs, %u mismatches\n", produced, bad);
+	}
+
+	GruCase grus[] = {GruCase(64, 64), GruCase(40, 48), GruCase(33, 17)};
+	for (GruCase& g : grus) {
+		const int steps = 8;
+		std::vector<int8_t> expected(g.p.hiddenSize), actual(g.p.hiddenSize);
+		g.run(false, expected.data(), steps);
+		g.run(true, actual.data(), steps);
+		uint32_t bad = mismatches(expected.data(), actual.data(), expected.size());
+		failures += bad;
+
+		double reference = microseconds(iterations / 4, [&] { g.run(false, expected.data(), 1); });
+		double fast = microseconds(iterations / 4, [&] { g.run(true, actual.data(), 1); });
+		char name[32];
+		snprintf(name, sizeof(name), "gru %u->%u", g.p.inputSize, g.p.hiddenSize);
+		printf("%-20s %10.3f %10.3f %7.2fx %u/%u\n", name, reference, fast, reference / fast, bad, g.p.hiddenSize);
+	}
+
+	printf("%s\n", failures ? "FAIL" : "all kernels bit exact");
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,154 @@
+// Host check for NoiseFloor (lib/AudioFeatures) with the firmware's
+// settings (the default constructor, as in callback/sr_profile.cpp: 32 ms
+// frames, blocks of 32 frames, floor over 8 blocks) on synthetic audio:
+//   - digital silence and a full-scale square wave read SILENCE_DB and
+//     0 dBFS, nothing is reported before the first block and ready() only
+//     once the window is full
+//   - steady noise at -70..-30 dBFS is measured within 3 dB
+//   - speech bursts over quiet noise leave the floor where it was
+//   - a lasting rise in noise only shows once it has filled the window, a
+//     drop shows with the next block
+//   - the result does not depend on how the stream is chunked
+//
+// Build (from the repository root):
+//   g++ -O2 -std=gnu++17 -Ilib/AudioFeatures/src tools/noisefloor_check/noisefloor_check.cpp lib/AudioFeatures/src/NoiseFloor.cpp -o noisefloor_check
+//
+// Usage:
+//   noisefloor_check [--seed N]
+
+#include "NoiseFloor.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+const int SampleRate = 16000;
+// What the firmware's NoiseFloor needs for one block (512 x 32 samples)
+const int BlockSamples = 512 * 32;
+const int WindowBlocks = 8;
+
+unsigned failures = 0;
+
+void check(bool ok, const char* what, float got, float expected) {
+	if (ok) return;
+	failures++;
+	printf("  FAIL %s: %.1f, expected %.1f\n", what, got, expected);
+}
+
+// Uniform noise at levelDb dBFS RMS, with a loud tone over 60 % of each
+// 0.4 s if speech is set
+std::vector<int16_t> noise(std::mt19937& rng, float levelDb, float seconds, bool speech) {
+	float amplitude = powf(10.0f, levelDb / 20.0f) * 32768.0f * sqrtf(3.0f);
+	std::uniform_real_distribution<float> uniform(-amplitude, amplitude);
+	std::vector<int16_t> samples((size_t)(seconds * SampleRate));
+	for (size_t i = 0; i < samples.size(); i++) {
+		float v = uniform(rng);
+		if (speech && i % 6400 < 3840) v += 8000.0f * sinf(i * 0.3f);
+		samples[i] = (int16_t)v;
+	}
+	return samples;
+}
+
+// Duration of n whole blocks, so a level change starts a block
+float blocks(int n) {
+	return n * BlockSamples / (float)SampleRate;
+}
+
+void feed(NoiseFloor& floor, const std::vector<int16_t>& samples, size_t chunk = 480) {
+	for (size_t i = 0; i < samples.size(); i += chunk) {
+		floor.update(samples.data() + i, samples.size() - i < chunk ? samples.size() - i : chunk);
+	}
+}
+
+void checkLimits() {
+	NoiseFloor floor;
+	check(floor.floorDb() == NoiseFloor::SILENCE_DB, "before any audio", floor.floorDb(), NoiseFloor::SILENCE_DB);
+	std::vector<int16_t> silence(BlockSamples - 1, 0);
+	feed(floor, silence);
+	check(floor.blocks() == 0 && floor.floorDb() == NoiseFloor::SILENCE_DB, "before the first block", floor.floorDb(),
+		NoiseFloor::SILENCE_DB);
+	feed(floor, std::vector<int16_t>(1, 0));
+	check(floor.blocks() == 1 && !floor.ready(), "first block, not ready", floor.blocks(), 1);
+	check(floor.floorDb() == NoiseFloor::SILENCE_DB, "digital silence", floor.floorDb(), NoiseFloor::SILENCE_DB);
+
+	std::vector<int16_t> square(BlockSamples * (WindowBlocks - 1));
+	for (size_t i = 0; i < square.size(); i++) square[i] = i & 1 ? 32767 : -32768;
+	NoiseFloor loud;
+	feed(loud, square);
+	check(!loud.ready(), "ready one block early", loud.blocks(), WindowBlocks);
+	feed(loud, std::vector<int16_t>(square.begin(), square.begin() + BlockSamples));
+	check(loud.ready(), "ready with a full window", loud.blocks(), WindowBlocks);
+	check(fabsf(loud.floorDb()) < 0.01f, "full-scale square", loud.floorDb(), 0.0f);
+	printf("limits: silence %.0f dBFS, full-scale square %.2f dBFS\n", floor.floorDb(), loud.floorDb());
+}
+
+void checkLevels(std::mt19937& rng) {
+	for (float level = -70.0f; level <= -30.0f; level += 10.0f) {
+		NoiseFloor floor;
+		feed(floor, noise(rng, level, 10.0f, false));
+		check(fabsf(floor.floorDb() - level) < 3.0f, "steady noise", floor.floorDb(), level);
+		printf("steady %.0f dBFS: floor %.1f, last block %.1f\n", level, floor.floorDb(), floor.blockDb());
+	}
+}
+
+void checkTracking(std::mt19937& rng) {
+	NoiseFloor floor;
+	feed(floor, noise(rng, -60.0f, blocks(10), false));
+	feed(floor, noise(rng, -60.0f, blocks(10), true));
+	check(fabsf(floor.floorDb() + 60.0f) < 3.0f, "speech over quiet noise", floor.floorDb(), -60.0f);
+	printf("speech over -60 dBFS: floor %.1f, last block %.1f\n", floor.floorDb(), floor.blockDb());
+
+	// A rise only counts once it fills the window
+	feed(floor, noise(rng, -35.0f, blocks(WindowBlocks - 1), false));
+	check(floor.floorDb() < -50.0f, "rise shown before the window is full", floor.floorDb(), -60.0f);
+	feed(floor, noise(rng, -35.0f, blocks(1), false));
+	check(fabsf(floor.floorDb() + 35.0f) < 3.0f, "rise after a full window", floor.floorDb(), -35.0f);
+	printf("rise to -35 dBFS: floor %.1f after %d blocks\n", floor.floorDb(), WindowBlocks);
+
+	feed(floor, noise(rng, -65.0f, blocks(1), false));
+	check(fabsf(floor.floorDb() + 65.0f) < 3.0f, "drop after one block", floor.floorDb(), -65.0f);
+	printf("drop to -65 dBFS: floor %.1f after 1 block\n", floor.floorDb());
+}
+
+void checkChunking(std::mt19937& rng) {
+	std::vector<int16_t> samples = noise(rng, -50.0f, 12.0f, true);
+	NoiseFloor reference;
+	feed(reference, samples);
+	for (size_t chunk : {1, 7, 512, 4096}) {
+		NoiseFloor floor;
+		feed(floor, samples, chunk);
+		bool same = floor.floorDb() == reference.floorDb() && floor.blockDb() == reference.blockDb() &&
+			floor.blocks() == reference.blocks();
+		check(same, ("chunks of " + std::to_string(chunk)).c_str(), floor.floorDb(), reference.floorDb());
+	}
+	printf("chunking: 1, 7, 512 and 4096 samples agree with 480\n");
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+	uint32_t seed = 1;
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		bool value = i + 1 < argc;
+		if (arg == "--seed" && value) seed = (uint32_t)atoi(argv[++i]);
+		else {
+			fprintf(stderr, "usage: noisefloor_check [--seed N]\n");
+			return 2;
+		}
+	}
+
+	std::mt19937 rng(seed);
+	checkLimits();
+	checkLevels(rng);
+	checkTracking(rng);
+	checkChunking(rng);
+
+	printf("%s\n", failures ? "FAIL" : "all checks passed");
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,207 @@
+// Host check and benchmark for PageBuffer (lib/PageBuffer). The U8g2 draw
+// routines in tools/host follow U8g2's generic full buffer code
+// (u8g2_ll_hvline_vertical_top_lsb, DrawBox, DrawXBMP) and are the
+// reference:
+//   - random boxes, horizontal and vertical lines in all three draw colors,
+//     clipped and unclipped, on random frames: fillRect / hspan / vspan must
+//     leave the same bytes as drawBox / drawHLine / drawVLine
+//   - loadXbm must match clearBuffer() followed by drawXBMP at (0, 0)
+//   - xorWith and blitMasked must match a byte loop, with source and mask
+//     at every alignment mod 16 (the vector path needs 16-byte alignment)
+// Then both ways are timed per frame operation. On the host the spans run
+// the word path and the frame operations the 16-byte C++ blocks; the PIE
+// path needs the ESP32-S3.
+//
+// Build (from the repository root):
+//   g++ -O2 -std=gnu++17 -Itools/host -Ilib/PageBuffer/src tools/pagebuffer_bench/pagebuffer_bench.cpp tools/host/host.cpp lib/PageBuffer/src/PageBuffer.cpp -o pagebuffer_bench
+//
+// Usage:
+//   pagebuffer_bench [--seed N] [--cases N] [--iterations N]
+
+#include "PageBuffer.h"
+#include "U8g2lib.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+
+namespace {
+
+const size_t FrameBytes = 128 * 64 / 8;
+
+unsigned failures = 0;
+
+void randomFrame(std::mt19937& rng, uint8_t* frame) {
+	for (size_t i = 0; i < FrameBytes; i++) frame[i] = (uint8_t)rng();
+}
+
+void checkDrawing(U8G2& gfx, std::mt19937& rng, int cases) {
+	alignas(16) uint8_t pages[FrameBytes];
+	PageBuffer pb(pages, 128, 64);
+	std::uniform_int_distribution<int> pos(-20, 140);
+	std::uniform_int_distribution<int> size(0, 150);
+	unsigned differ = 0;
+
+	for (int i = 0; i < cases; i++) {
+		randomFrame(rng, gfx.getBufferPtr());
+		memcpy(pages, gfx.getBufferPtr(), FrameBytes);
+		int kind = rng() % 3;
+		int color = rng() % 3;
+		int x = pos(rng), y = pos(rng) / 2, w = size(rng), h = size(rng) / 2;
+		gfx.setDrawColor(color);
+		if (kind == 0) {
+			gfx.drawBox(x, y, w, h);
+			pb.fillRect(x, y, w, h, (PageOp)color);
+		} else if (kind == 1) {
+			gfx.drawHLine(x, y, w);
+			pb.hspan(x, y, w, (PageOp)color);
+		} else {
+			gfx.drawVLine(x, y, h);
+			pb.vspan(x, y, h, (PageOp)color);
+		}
+		if (memcmp(pages, gfx.getBufferPtr(), FrameBytes) != 0 && differ++ < 3) {
+			printf("  FAIL %s color %d at %d,%d %dx%d\n", kind == 0 ? "box" : kind == 1 ? "hline" : "vline", color,
+				x, y, w, h);
+		}
+	}
+	gfx.setDrawColor(1);
+	printf("boxes and lines: %d cases, %u differ\n", cases, differ);
+	failures += differ;
+}
+
+void checkXbm(U8G2& gfx, std::mt19937& rng, int cases) {
+	alignas(16) uint8_t pages[FrameBytes];
+	uint8_t xbm[FrameBytes];
+	PageBuffer pb(pages, 128, 64);
+	unsigned differ = 0;
+
+	for (int i = 0; i < cases; i++) {
+		uint16_t w = 1 + rng() % 128;
+		uint16_t h = 1 + rng() % 64;
+		randomFrame(rng, xbm);
+		randomFrame(rng, pages);
+		gfx.clearBuffer();
+		gfx.drawXBMP(0, 0, w, h, xbm);
+		pb.loadXbm(xbm, w, h);
+		if (memcmp(pages, gfx.getBufferPtr(), FrameBytes) != 0 && differ++ < 3) printf("  FAIL xbm %ux%u\n", w, h);
+	}
+	printf("loadXbm: %d sizes, %u differ\n", cases, differ);
+	failures += differ;
+}
+
+void checkFrameOps(std::mt19937& rng) {
+	alignas(16) uint8_t pages[FrameBytes];
+	alignas(16) uint8_t before[FrameBytes];
+	alignas(16) uint8_t src[FrameBytes + 16];
+	alignas(16) uint8_t mask[FrameBytes + 16];
+	PageBuffer pb(pages, 128, 64);
+	unsigned differ = 0;
+
+	for (int offset = 0; offset < 16; offset++) {
+		uint8_t* s = src + offset;
+		uint8_t* m = mask + offset;
+		randomFrame(rng, before);
+		randomFrame(rng, s);
+		randomFrame(rng, m);
+
+		memcpy(pages, before, FrameBytes);
+		pb.xorWith(s);
+		for (size_t i = 0; i < FrameBytes; i++) {
+			if (pages[i] != (uint8_t)(before[i] ^ s[i]) && differ++ < 3) printf("  FAIL xorWith offset %d byte %zu\n", offset, i);
+		}
+
+		memcpy(pages, before, FrameBytes);
+		pb.blitMasked(s, m);
+		for (size_t i = 0; i < FrameBytes; i++) {
+			uint8_t want = (before[i] & ~m[i]) | (s[i] & m[i]);
+			if (pages[i] != want && differ++ < 3) printf("  FAIL blitMasked offset %d byte %zu\n", offset, i);
+		}
+	}
+	printf("xorWith / blitMasked: 16 alignments, %u bytes differ\n", differ);
+	failures += differ;
+}
+
+// Best of several runs, ns per call of fn
+template <typename Fn>
+double timeIt(int iterations, Fn fn) {
+	double best = 1e18;
+	for (int run = 0; run < 15; run++) {
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < iterations; i++) {
+			fn();
+			asm volatile("" ::: "memory");
+		}
+		double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+		best = std::min(best, ns / iterations);
+	}
+	return best;
+}
+
+void row(const char* name, double u8g2, double pb) {
+	printf("  %-28s %8.0f %8.0f  (%.1fx)\n", name, u8g2, pb, u8g2 / pb);
+}
+
+void bench(U8G2& gfx, std::mt19937& rng, int iterations) {
+	alignas(16) uint8_t pages[FrameBytes];
+	alignas(16) uint8_t src[FrameBytes];
+	uint8_t xbm[FrameBytes];
+	PageBuffer pb(pages, 128, 64);
+	uint8_t* buffer = gfx.getBufferPtr();
+	randomFrame(rng, pages);
+	randomFrame(rng, src);
+	randomFrame(rng, xbm);
+
+	printf("ns per operation, U8g2 / PageBuffer (best of 15 x %d):\n", iterations);
+	row("clear", timeIt(iterations, [&] { gfx.clearBuffer(); }), timeIt(iterations, [&] { pb.clear(); }));
+	gfx.setDrawColor(1);
+	row("box 100x40", timeIt(iterations, [&] { gfx.drawBox(3, 5, 100, 40); }),
+		timeIt(iterations, [&] { pb.fillRect(3, 5, 100, 40); }));
+	gfx.setDrawColor(2);
+	row("box 100x40 xor", timeIt(iterations, [&] { gfx.drawBox(3, 5, 100, 40); }),
+		timeIt(iterations, [&] { pb.fillRect(3, 5, 100, 40, PageOp::Xor); }));
+	gfx.setDrawColor(1);
+	row("64 hlines, width 100", timeIt(iterations, [&] { for (int y = 0; y < 64; y++) gfx.drawHLine(10, y, 100); }),
+		timeIt(iterations, [&] { for (int y = 0; y < 64; y++) pb.hspan(10, y, 100); }));
+	row("128 vlines, height 64", timeIt(iterations, [&] { for (int x = 0; x < 128; x++) gfx.drawVLine(x, 0, 64); }),
+		timeIt(iterations, [&] { for (int x = 0; x < 128; x++) pb.vspan(x, 0, 64); }));
+	row("clear + xbm 128x64", timeIt(iterations, [&] {
+			gfx.clearBuffer();
+			gfx.drawXBMP(0, 0, 128, 64, xbm);
+		}),
+		timeIt(iterations, [&] { pb.loadXbm(xbm, 128, 64); }));
+	row("xor frame (byte loop)", timeIt(iterations, [&] { for (size_t i = 0; i < FrameBytes; i++) buffer[i] ^= src[i]; }),
+		timeIt(iterations, [&] { pb.xorWith(src); }));
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+	uint32_t seed = 7;
+	int cases = 200000;
+	int iterations = 200;
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		bool value = i + 1 < argc;
+		if (arg == "--seed" && value) seed = (uint32_t)atoi(argv[++i]);
+		else if (arg == "--cases" && value) cases = atoi(argv[++i]);
+		else if (arg == "--iterations" && value) iterations = atoi(argv[++i]);
+		else {
+			fprintf(stderr, "usage: pagebuffer_bench [--seed N] [--cases N] [--iterations N]\n");
+			return 2;
+		}
+	}
+
+	std::mt19937 rng(seed);
+	U8G2_SSD1306_128X64_NONAME_F_HW_I2C gfx(U8G2_R0);
+	checkDrawing(gfx, rng, cases);
+	checkXbm(gfx, rng, cases / 100);
+	checkFrameOps(rng);
+	bench(gfx, rng, iterations);
+
+	printf("%s\n", failures ? "FAIL" : "all checks passed");
+	return failures ? 1 : 0;
+}
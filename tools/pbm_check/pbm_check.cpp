@@ -0,0 +1,252 @@
+// Host check for PbmSink (lib/Display). The face is replayed on the virtual
+// frame clock with PbmSink as its display, and every flush goes to an
+// in-memory stream together with TokenLog frames and plain text, the way
+// they share Serial on the device. The stream is then taken apart again:
+//   - every log frame and text line must come back whole, nothing may be
+//     lost between the images
+//   - every image must be a valid P4 file that decodes to the page buffer
+//     it was flushed from, bit for bit
+// With --golden FILE the images are also compared with a capture saved by
+// an earlier run (the file is written if it does not exist yet), which
+// catches rendering changes in lib/FaceDisplay. --out FILE saves the
+// stream for `tools/tokenlog.py decode -f FILE --pbm-dir DIR`.
+//
+// Build (from the repository root):
+//   g++ -O2 -std=gnu++17 -Itools/host -Ilib/Display/src -Ilib/FaceDisplay/src -Ilib/PageBuffer/src tools/pbm_check/pbm_check.cpp tools/host/host.cpp lib/FaceDisplay/src/*.cpp lib/Display/src/DisplayBackend.cpp lib/Display/src/PbmSink.cpp -o pbm_check
+//
+// Usage:
+//   pbm_check [--seed N] [--frames N] [--out FILE] [--golden FILE]
+
+#include "Face.h"
+#include "FrameClock.h"
+#include "PbmSink.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+const size_t FrameBytes = 128 * 64 / 8;
+// Not in any map, tokenlog.py prints it as an unknown id with its argument
+const uint32_t LogId = 0x12345678;
+
+unsigned failures = 0;
+
+class Capture : public Print {
+public:
+	size_t write(uint8_t b) override {
+		bytes.push_back(b);
+		return 1;
+	}
+	size_t write(const uint8_t* buffer, size_t size) override {
+		bytes.insert(bytes.end(), buffer, buffer + size);
+		return size;
+	}
+
+	std::vector<uint8_t> bytes;
+};
+
+// One TokenLog frame with a single unsigned argument, as TokenLog::emit
+// writes it
+void writeLogFrame(Print& out, uint32_t timestamp, uint32_t value) {
+	uint8_t frame[4 + 16 + 1] = {0xFE, 0xFF, 16, 0};
+	uint8_t* p = frame + 4;
+	memcpy(p, &LogId, 4);
+	memcpy(p + 4, &timestamp, 4);
+	p[8] = 1;  // core
+	p[9] = 1;  // argc
+	p[10] = 1;  // ARG_UINT
+	p[11] = 0;
+	memcpy(p + 12, &value, 4);
+	uint8_t sum = 0;
+	for (size_t i = 2; i < sizeof(frame) - 1; i++) sum ^= frame[i];
+	frame[sizeof(frame) - 1] = sum;
+	out.write(frame, sizeof(frame));
+}
+
+bool checksum(const std::vector<uint8_t>& s, size_t start, size_t len) {
+	uint8_t sum = 0;
+	for (size_t i = start + 2; i < start + 4 + len; i++) sum ^= s[i];
+	return sum == s[start + 4 + len];
+}
+
+// P4 back to the page layout, false if the header is not 128x64
+bool decodeP4(const uint8_t* image, size_t len, uint8_t* pages) {
+	const char header[] = "P4\n128 64\n";
+	size_t headerLen = sizeof(header) - 1;
+	if (len != headerLen + FrameBytes || memcmp(image, header, headerLen) != 0) return false;
+	const uint8_t* rows = image + headerLen;
+	memset(pages, 0, FrameBytes);
+	for (int y = 0; y < 64; y++) {
+		for (int x = 0; x < 128; x++) {
+			// MSB first, 1 is black and lit pixels are white
+			bool lit = !(rows[y * 16 + x / 8] & (0x80 >> (x & 7)));
+			if (lit) pages[(y / 8) * 128 + x] |= 1 << (y & 7);
+		}
+	}
+	return true;
+}
+
+struct Parsed {
+	std::vector<std::vector<uint8_t>> images;
+	std::vector<uint32_t> logValues;
+	std::string text;
+};
+
+Parsed parse(const std::vector<uint8_t>& s) {
+	Parsed parsed;
+	size_t i = 0;
+	while (i < s.size()) {
+		bool log = i + 1 < s.size() && s[i] == 0xFE && s[i + 1] == 0xFF;
+		bool image = i + 1 < s.size() && s[i] == 0xFE && s[i + 1] == 0xFB;
+		if (!log && !image) {
+			parsed.text += (char)s[i++];
+			continue;
+		}
+		if (i + 4 > s.size()) break;
+		size_t len = s[i + 2] | s[i + 3] << 8;
+		if (i + 4 + len + 1 > s.size() || !checksum(s, i, len)) {
+			if (failures++ < 3) printf("  FAIL bad frame at byte %zu\n", i);
+			break;
+		}
+		if (image) {
+			parsed.images.emplace_back(s.begin() + i + 4, s.begin() + i + 4 + len);
+		} else {
+			uint32_t value;
+			memcpy(&value, &s[i + 4 + 12], 4);
+			parsed.logValues.push_back(value);
+		}
+		i += 4 + len + 1;
+	}
+	return parsed;
+}
+
+std::vector<uint8_t> readFile(const std::string& path, bool& found) {
+	std::vector<uint8_t> data;
+	FILE* f = fopen(path.c_str(), "rb");
+	found = f != nullptr;
+	if (!f) return data;
+	uint8_t chunk[4096];
+	size_t n;
+	while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) data.insert(data.end(), chunk, chunk + n);
+	fclose(f);
+	return data;
+}
+
+bool writeFile(const std::string& path, const std::vector<uint8_t>& data) {
+	FILE* f = fopen(path.c_str(), "wb");
+	if (!f) return false;
+	bool ok = fwrite(data.data(), 1, data.size(), f) == data.size();
+	return fclose(f) == 0 && ok;
+}
+
+void checkGolden(const std::string& path, const std::vector<uint8_t>& capture, const Parsed& parsed) {
+	bool found;
+	std::vector<uint8_t> golden = readFile(path, found);
+	if (!found) {
+		if (!writeFile(path, capture)) {
+			failures++;
+			printf("  FAIL cannot write %s\n", path.c_str());
+		} else {
+			printf("golden: written to %s\n", path.c_str());
+		}
+		return;
+	}
+	Parsed expected = parse(golden);
+	if (expected.images.size() != parsed.images.size()) {
+		failures++;
+		printf("  FAIL golden has %zu images, this run %zu\n", expected.images.size(), parsed.images.size());
+		return;
+	}
+	unsigned differ = 0;
+	for (size_t i = 0; i < parsed.images.size(); i++) {
+		if (parsed.images[i] != expected.images[i] && differ++ < 3) printf("  FAIL frame %zu differs from golden\n", i);
+	}
+	printf("golden: %zu images, %u differ\n", parsed.images.size(), differ);
+	failures += differ;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+	uint32_t seed = 7;
+	int frames = 2000;
+	std::string out, golden;
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		bool value = i + 1 < argc;
+		if (arg == "--seed" && value) seed = (uint32_t)atoi(argv[++i]);
+		else if (arg == "--frames" && value) frames = atoi(argv[++i]);
+		else if (arg == "--out" && value) out = argv[++i];
+		else if (arg == "--golden" && value) golden = argv[++i];
+		else {
+			fprintf(stderr, "usage: pbm_check [--seed N] [--frames N] [--out FILE] [--golden FILE]\n");
+			return 2;
+		}
+	}
+
+	FrameClock::UseVirtual(1000);
+	randomSeed(seed);
+	Capture capture;
+	PbmSink sink(capture);
+	if (!sink.begin()) {
+		printf("FAIL PbmSink::begin\n");
+		return 1;
+	}
+	Face* face = new Face(&sink, 128, 64, 40);
+	face->Behavior.Timer.SetIntervalMillis(400);
+	face->Look.Timer.SetIntervalMillis(250);
+	face->Blink.Timer.SetIntervalMillis(700);
+	for (int e = 0; e < eEmotions::EMOTIONS_COUNT; e++) face->Behavior.SetEmotion((eEmotions)e, 1.0);
+
+	std::vector<std::vector<uint8_t>> flushed;
+	std::string text;
+	for (int i = 0; i < frames; i++) {
+		sink.gfx().clearBuffer();
+		face->Update();
+		flushed.emplace_back(sink.buffer(), sink.buffer() + FrameBytes);
+		writeLogFrame(capture, millis(), i);
+		if (i % 10 == 0) {
+			std::string line = "text line " + std::to_string(i) + "\n";
+			capture.write((const uint8_t*)line.data(), line.size());
+			text += line;
+		}
+		FrameClock::Advance(i % 3 ? 16 : 17);
+	}
+	delete face;
+
+	Parsed parsed = parse(capture.bytes);
+	bool logsWhole = parsed.logValues.size() == (size_t)frames;
+	for (size_t i = 0; logsWhole && i < parsed.logValues.size(); i++) logsWhole = parsed.logValues[i] == i;
+	if (!logsWhole || parsed.text != text) {
+		failures++;
+		printf("  FAIL log frames or text lost: %zu of %d frames\n", parsed.logValues.size(), frames);
+	}
+
+	unsigned differ = 0;
+	if (parsed.images.size() != flushed.size()) {
+		differ++;
+		printf("  FAIL %zu images for %zu flushes\n", parsed.images.size(), flushed.size());
+	}
+	uint8_t pages[FrameBytes];
+	for (size_t i = 0; i < parsed.images.size() && i < flushed.size(); i++) {
+		const std::vector<uint8_t>& image = parsed.images[i];
+		bool same = decodeP4(image.data(), image.size(), pages) && memcmp(pages, flushed[i].data(), FrameBytes) == 0;
+		if (!same && differ++ < 3) printf("  FAIL image %zu does not match its frame\n", i);
+	}
+	printf("stream: %zu bytes, %zu images, %zu log frames, %u differ\n", capture.bytes.size(), parsed.images.size(),
+		parsed.logValues.size(), differ);
+	failures += differ;
+
+	if (!golden.empty()) checkGolden(golden, capture.bytes, parsed);
+	if (!out.empty() && !writeFile(out, capture.bytes)) {
+		failures++;
+		printf("  FAIL cannot write %s\n", out.c_str());
+	}
+
+	printf("%s\n", failures ? "FAIL" : "all checks passed");
+	return failures ? 1 : 0;
+}
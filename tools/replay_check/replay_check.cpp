@@ -0,0 +1,249 @@
+// Host check for AudioReplay (lib/AudioReplay). Sample n of the simulated
+// microphone has the value (int16_t)n, so every sample that comes out names
+// its stream position. The fill path is driven the way srFill in
+// src/app/callback/handoff.cpp drives it: write the live chunk, then read
+// the backlog while a handoff is active, else pass the live chunk on.
+//   - random chunk sizes and random handoffs (inside the history, past its
+//     oldest sample, in the future): what the recognizer gets must be the
+//     live stream, rewound at each handoff to the requested sample (or the
+//     oldest one kept) and contiguous from there, and the statistics must
+//     agree with a model of the history
+//   - a consumer that reads less than is written: backlog that falls out of
+//     the history is skipped and counted as overrun, what is served stays
+//     in order
+//   - requests one or two samples around the oldest sample kept and the
+//     live position
+//   - no storage: a request completes at once with nothing replayed
+//
+// Build (from the repository root):
+//   g++ -O2 -std=gnu++17 -Ilib/AudioReplay/src tools/replay_check/replay_check.cpp lib/AudioReplay/src/AudioReplay.cpp -o replay_check
+//
+// Usage:
+//   replay_check [--seed N] [--chunks N]
+
+#include "AudioReplay.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+const size_t Capacity = 4000;
+const size_t Wanted = 512;
+
+unsigned failures = 0;
+
+void check(bool ok, const char* what, uint32_t a, uint32_t b) {
+	if (ok) return;
+	if (failures++ < 5) printf("  FAIL %s: %u, expected %u\n", what, a, b);
+}
+
+// Simulated microphone, sample n is (int16_t)n
+struct Microphone {
+	uint32_t next = 0;
+
+	size_t read(int16_t* out, size_t count) {
+		for (size_t i = 0; i < count; i++) out[i] = (int16_t)next++;
+		return count;
+	}
+};
+
+// Samples the recognizer got must follow each other, first must be expected
+void checkRun(const int16_t* samples, size_t n, uint32_t& expected, const char* what) {
+	for (size_t i = 0; i < n; i++, expected++) {
+		if (samples[i] != (int16_t)expected) {
+			check(false, what, (uint16_t)samples[i], (uint16_t)expected);
+			expected = (uint16_t)samples[i];
+		}
+	}
+}
+
+void checkHandoffs(std::mt19937& rng, int chunks) {
+	std::vector<int16_t> storage(Capacity);
+	AudioReplay replay;
+	replay.begin(storage.data(), storage.size());
+	Microphone mic;
+	std::uniform_int_distribution<size_t> chunkSize(1, Wanted);
+	std::uniform_int_distribution<int> percent(0, 99);
+	std::uniform_int_distribution<uint32_t> back(0, Capacity * 3 / 2);
+
+	int16_t buffer[Wanted];
+	uint32_t expected = 0;  // next stream position the recognizer must get
+	uint32_t nowUs = 0;
+	uint32_t handoffs = 0, clipped = 0;
+	bool pending = false;
+	uint32_t requestFrom = 0, requestUs = 0;
+
+	for (int c = 0; c < chunks; c++) {
+		nowUs += 10000;
+		if (!pending && !replay.active() && percent(rng) < 3) {
+			// Mostly behind the live stream, sometimes past the history or ahead
+			uint32_t from = replay.position() - back(rng);
+			if (percent(rng) < 10) from = replay.position() + 100;
+			replay.request(from, nowUs);
+			pending = true;
+			requestFrom = from;
+			requestUs = nowUs;
+		}
+
+		size_t live = mic.read(buffer, chunkSize(rng));
+		if (!replay.active()) {
+			replay.write(buffer, live);
+			checkRun(buffer, live, expected, "live sample");
+			continue;
+		}
+
+		replay.write(buffer, live);
+		if (pending) {
+			// What the next read() applies, worked out from the request
+			uint32_t kept = replay.position() < Capacity ? replay.position() : Capacity;
+			int32_t lookback = (int32_t)(replay.position() - requestFrom);
+			if (lookback < 0) lookback = 0;
+			if ((uint32_t)lookback > kept) {
+				lookback = kept;
+				clipped++;
+			}
+			expected = replay.position() - lookback;
+			handoffs++;
+		}
+		size_t n = replay.read(buffer, Wanted, nowUs);
+		if (pending) {
+			check(replay.stats().handoffs == handoffs, "handoffs", replay.stats().handoffs, handoffs);
+			check(replay.stats().lookback == replay.position() - expected, "lookback", replay.stats().lookback,
+				replay.position() - expected);
+			if (n) check(replay.stats().switchUs == nowUs - requestUs, "switchUs", replay.stats().switchUs, nowUs - requestUs);
+			pending = false;
+		}
+		if (n) {
+			checkRun(buffer, n, expected, "replayed sample");
+		} else {
+			// Nothing to go back to, the live chunk goes on as it is
+			checkRun(buffer, live, expected = replay.position() - live, "live sample");
+		}
+		if (replay.finished()) {
+			check(expected == replay.position(), "caught up at", expected, replay.position());
+			check(replay.stats().drainUs == nowUs - requestUs, "drainUs", replay.stats().drainUs, nowUs - requestUs);
+		}
+	}
+
+	const AudioReplayStats& stats = replay.stats();
+	check(stats.clipped == clipped, "clipped", stats.clipped, clipped);
+	check(stats.overruns == 0, "overruns", stats.overruns, 0);
+	printf("handoffs: %d chunks, %u handoffs, %u clipped, %u samples\n", chunks, stats.handoffs, stats.clipped,
+		replay.position());
+}
+
+void checkOverrun() {
+	std::vector<int16_t> storage(Capacity);
+	AudioReplay replay;
+	replay.begin(storage.data(), storage.size());
+	Microphone mic;
+	int16_t buffer[3 * Wanted];
+
+	for (int i = 0; i < 20; i++) replay.write(buffer, mic.read(buffer, Wanted));
+	// The oldest sample still kept when the first read() applies the request
+	uint32_t expected = replay.position() + 3 * Wanted - (uint32_t)Capacity;
+	replay.request(expected, 0);
+
+	// Three chunks in for each one out until the backlog has fallen out of
+	// the history a few times, then the other way round until it drains
+	uint32_t skipped = 0;
+	for (int round = 0; replay.active(); round++) {
+		bool behind = round < 10;
+		for (int i = 0; i < (behind ? 3 : 1); i++) replay.write(buffer, mic.read(buffer, Wanted));
+		size_t n = replay.read(buffer, behind ? Wanted : 3 * Wanted, 0);
+		if (n && buffer[0] != (int16_t)expected) {
+			// A skip, it must add up to the overrun count
+			uint16_t skip = (uint16_t)(buffer[0] - (int16_t)expected);
+			skipped += skip;
+			expected += skip;
+		}
+		checkRun(buffer, n, expected, "overrun sample");
+		if (round > 1000) {
+			check(false, "backlog never drained", replay.pending(), 0);
+			break;
+		}
+	}
+	check(expected == replay.position(), "caught up at", expected, replay.position());
+	check(replay.stats().overruns == skipped, "overruns", replay.stats().overruns, skipped);
+	check(replay.stats().overruns > 0, "overruns happened", replay.stats().overruns, 1);
+	check(replay.stats().clipped == 0, "clipped", replay.stats().clipped, 0);
+	printf("overrun: %u samples skipped, the rest served in order\n", replay.stats().overruns);
+}
+
+// Requests right around the oldest sample kept and the live position
+void checkEdges() {
+	const int32_t offsets[] = {-2, -1, 0, 1, 2};
+	unsigned cases = 0;
+	for (uint32_t fill : {1000u, (uint32_t)Capacity, 3u * (uint32_t)Capacity}) {
+		for (int atLive = 0; atLive < 2; atLive++) {
+			for (int32_t offset : offsets) {
+				std::vector<int16_t> storage(Capacity);
+				AudioReplay replay;
+				replay.begin(storage.data(), storage.size());
+				Microphone mic;
+				int16_t buffer[Capacity + 8];
+				for (uint32_t done = 0; done < fill; done += Wanted) {
+					replay.write(buffer, mic.read(buffer, fill - done < Wanted ? fill - done : Wanted));
+				}
+				uint32_t oldest = fill < Capacity ? 0 : fill - (uint32_t)Capacity;
+				uint32_t from = (atLive ? fill : oldest) + offset;
+				replay.request(from, 0);
+
+				// Before the oldest sample clamps to it, past the live one means now
+				uint32_t expected = from;
+				if ((int32_t)(from - oldest) < 0) expected = oldest;
+				if ((int32_t)(from - fill) > 0) expected = fill;
+				size_t n = replay.read(buffer, Capacity + 8, 0);
+				check(n == fill - expected, "edge replayed", (uint32_t)n, fill - expected);
+				checkRun(buffer, n, expected, "edge sample");
+				check(replay.finished() && !replay.active(), "edge finished", replay.active(), 0);
+				cases++;
+			}
+		}
+	}
+	printf("edges: %u requests around the oldest and the live sample\n", cases);
+}
+
+void checkNoStorage() {
+	AudioReplay replay;
+	replay.begin(nullptr, 1000);
+	Microphone mic;
+	int16_t buffer[Wanted];
+	replay.write(buffer, mic.read(buffer, Wanted));
+	replay.request(0, 0);
+	check(replay.read(buffer, Wanted, 5) == 0, "replayed without storage", 1, 0);
+	check(replay.finished(), "finished without storage", 0, 1);
+	check(!replay.active(), "active without storage", 1, 0);
+	check(replay.stats().clipped == 1, "clipped without storage", replay.stats().clipped, 1);
+	printf("no storage: request completes at once\n");
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+	uint32_t seed = 3;
+	int chunks = 200000;
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		bool value = i + 1 < argc;
+		if (arg == "--seed" && value) seed = (uint32_t)atoi(argv[++i]);
+		else if (arg == "--chunks" && value) chunks = atoi(argv[++i]);
+		else {
+			fprintf(stderr, "usage: replay_check [--seed N] [--chunks N]\n");
+			return 2;
+		}
+	}
+
+	std::mt19937 rng(seed);
+	checkHandoffs(rng, chunks);
+	checkEdges();
+	checkOverrun();
+	checkNoStorage();
+
+	printf("%s\n", failures ? "FAIL" : "all checks passed");
+	return failures ? 1 : 0;
+}
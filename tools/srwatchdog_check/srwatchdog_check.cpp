@@ -0,0 +1,240 @@
+// Host check for SrWatchdog (lib/SrWatchdog) with the firmware's settings
+// (SR_WATCHDOG_* in include/app_config.h). A simulated feed task calls
+// fill() every 32 ms and speechRecognitionTask calls check() once a second:
+//   - a healthy stream, a slow but acceptable one and an intentional pause
+//     followed by rearm() raise nothing
+//   - a microphone that stops delivering, a feed task that stops calling
+//     and a starved stream are detected within their bound
+//   - the ladder is microphone, pipeline SR_WATCHDOG_ATTEMPTS times, then
+//     reboot, each step SR_WATCHDOG_GRACE_MS after the one before, and the
+//     reboot comes within stallMs + (1 + attempts) * graceMs plus a check
+//   - audio back after any step ends the outage with the right outage and
+//     recovery times; audio that comes back only briefly does not
+//
+// Build (from the repository root):
+//   g++ -O2 -std=gnu++17 -Iinclude -Ilib/SrWatchdog/src tools/srwatchdog_check/srwatchdog_check.cpp lib/SrWatchdog/src/SrWatchdog.cpp -o srwatchdog_check
+//
+// Usage:
+//   srwatchdog_check
+
+#include "SrWatchdog.h"
+#include "app_config.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+
+const uint32_t SampleRate = 16000;
+const uint32_t ChunkMs = 32;
+const uint32_t CheckMs = 1000;
+const SrWatchdogConfig Config = {SampleRate, SR_WATCHDOG_STALL_MS, SR_WATCHDOG_MIN_RATE, SR_WATCHDOG_GRACE_MS,
+	SR_WATCHDOG_ATTEMPTS};
+
+unsigned failures = 0;
+
+void check(bool ok, const std::string& what, uint32_t got, uint32_t expected) {
+	if (ok) return;
+	failures++;
+	printf("  FAIL %s: %u, expected %u\n", what.c_str(), got, expected);
+}
+
+struct Step {
+	SrWatchdogAction action;
+	uint32_t atMs;
+};
+
+// Feed task and monitor task, each on its own period. ratePercent is the
+// share of the 16 kHz the microphone delivers, fills whether the feed task
+// runs at all. A reboot ends the run
+struct Pipeline {
+	SrWatchdog watchdog{Config};
+	uint32_t nowMs = 1000;
+	uint32_t nextFillMs = 1000 + ChunkMs;
+	uint32_t nextCheckMs = 1000 + CheckMs;
+	uint32_t ratePercent = 100;
+	bool fills = true;
+	bool rebooted = false;
+	uint32_t lastAudioMs = 0;   // last chunk with samples
+	uint32_t firstAudioMs = 0;  // first chunk with samples after a stall
+	std::vector<Step> steps;
+
+	Pipeline() { watchdog.rearm(nowMs); }
+
+	void run(uint32_t ms) {
+		uint32_t end = nowMs + ms;
+		while (!rebooted) {
+			bool fillNext = nextFillMs <= nextCheckMs;
+			uint32_t next = fillNext ? nextFillMs : nextCheckMs;
+			if (next > end) break;
+			nowMs = next;
+			if (fillNext) {
+				nextFillMs += ChunkMs;
+				if (!fills) continue;
+				size_t live = SampleRate * ChunkMs / 1000 * ratePercent / 100;
+				watchdog.fill(live, nowMs);
+				if (!live) continue;
+				if (watchdog.recovering() && !firstAudioMs) firstAudioMs = nowMs;
+				lastAudioMs = nowMs;
+			} else {
+				nextCheckMs += CheckMs;
+				SrWatchdogAction action = watchdog.check(nowMs);
+				if (action != SR_WATCHDOG_NONE) steps.push_back({action, nowMs});
+				rebooted = action == SR_WATCHDOG_REBOOT;
+			}
+		}
+		if (!rebooted) nowMs = end;
+	}
+
+	// Nothing runs for ms, as under sr_pause()
+	void skip(uint32_t ms) {
+		nowMs += ms;
+		nextFillMs = nowMs + ChunkMs;
+		nextCheckMs = nowMs + CheckMs;
+	}
+};
+
+const char* actionName(SrWatchdogAction action) {
+	switch (action) {
+		case SR_WATCHDOG_RESTART_MIC: return "microphone";
+		case SR_WATCHDOG_RESTART_PIPELINE: return "pipeline";
+		case SR_WATCHDOG_REBOOT: return "reboot";
+		default: return "none";
+	}
+}
+
+void checkQuiet() {
+	Pipeline healthy;
+	healthy.run(60000);
+	check(healthy.steps.empty() && healthy.watchdog.stats().stalls == 0, "healthy stream stalls", (uint32_t)healthy.steps.size(), 0);
+	uint32_t rate = healthy.watchdog.stats().samplesPerSec;
+	check(rate > SampleRate * 95 / 100 && rate < SampleRate * 105 / 100, "healthy samples/s", rate, SampleRate);
+
+	Pipeline slow;
+	slow.ratePercent = SR_WATCHDOG_MIN_RATE + 10;
+	slow.run(60000);
+	check(slow.steps.empty(), "stream above the minimum rate stalls", (uint32_t)slow.steps.size(), 0);
+
+	// sr_pause(): no fills on purpose, then rearm() on resume
+	Pipeline paused;
+	paused.run(5000);
+	paused.skip(30000);
+	paused.watchdog.rearm(paused.nowMs);
+	paused.run(10000);
+	check(paused.steps.empty(), "stall after rearm", (uint32_t)paused.steps.size(), 0);
+	printf("quiet: healthy %u samples/s, %u%% rate and a rearmed pause raise nothing\n", rate, SR_WATCHDOG_MIN_RATE + 10);
+}
+
+// Detection bound: stallMs after the last audio, plus the check period
+void checkMicStall() {
+	Pipeline p;
+	p.run(5000);
+	uint32_t lastAudio = p.lastAudioMs;
+	p.ratePercent = 0;
+	p.run(SR_WATCHDOG_STALL_MS + 2 * CheckMs);
+	bool detected = p.steps.size() == 1 && p.steps[0].action == SR_WATCHDOG_RESTART_MIC;
+	check(detected, "silent microphone: steps", (uint32_t)p.steps.size(), 1);
+	if (!detected) return;
+	uint32_t after = p.steps[0].atMs - lastAudio;
+	check(after > SR_WATCHDOG_STALL_MS && after <= SR_WATCHDOG_STALL_MS + CheckMs, "silent microphone detected after", after,
+		SR_WATCHDOG_STALL_MS);
+
+	// The microphone restart works
+	p.ratePercent = 100;
+	p.run(3000);
+	const SrWatchdogStats& stats = p.watchdog.stats();
+	check(!p.watchdog.recovering() && stats.recoveries == 1 && p.steps.size() == 1, "recovered after the microphone",
+		stats.recoveries, 1);
+	check(stats.lastOutageMs == p.firstAudioMs - lastAudio, "outage", stats.lastOutageMs, p.firstAudioMs - lastAudio);
+	check(stats.lastRecoveryMs == p.firstAudioMs - p.steps[0].atMs, "recovery", stats.lastRecoveryMs,
+		p.firstAudioMs - p.steps[0].atMs);
+	printf("silent microphone: detected %u ms after the last audio, outage %u ms, recovery %u ms\n", after,
+		stats.lastOutageMs, stats.lastRecoveryMs);
+}
+
+void checkLadder() {
+	Pipeline p;
+	p.run(5000);
+	uint32_t lastAudio = p.lastAudioMs;
+	p.fills = false;
+	p.run(2 * (SR_WATCHDOG_STALL_MS + (2 + SR_WATCHDOG_ATTEMPTS) * (SR_WATCHDOG_GRACE_MS + CheckMs)));
+
+	std::string ladder;
+	for (const Step& step : p.steps) ladder += std::string(ladder.empty() ? "" : ", ") + actionName(step.action);
+	bool shape = p.steps.size() == 2u + SR_WATCHDOG_ATTEMPTS && p.steps.front().action == SR_WATCHDOG_RESTART_MIC &&
+		p.steps.back().action == SR_WATCHDOG_REBOOT;
+	for (size_t i = 1; shape && i + 1 < p.steps.size(); i++) shape = p.steps[i].action == SR_WATCHDOG_RESTART_PIPELINE;
+	check(shape, "ladder " + ladder, (uint32_t)p.steps.size(), 2 + SR_WATCHDOG_ATTEMPTS);
+	for (size_t i = 1; i < p.steps.size(); i++) {
+		uint32_t gap = p.steps[i].atMs - p.steps[i - 1].atMs;
+		check(gap >= SR_WATCHDOG_GRACE_MS && gap <= SR_WATCHDOG_GRACE_MS + CheckMs, "step gap", gap, SR_WATCHDOG_GRACE_MS);
+	}
+	// Detection and each step may wait up to one check period
+	uint32_t bound = SR_WATCHDOG_STALL_MS + (1 + SR_WATCHDOG_ATTEMPTS) * SR_WATCHDOG_GRACE_MS + (2 + SR_WATCHDOG_ATTEMPTS) * CheckMs;
+	uint32_t reboot = p.steps.empty() ? 0 : p.steps.back().atMs - lastAudio;
+	check(reboot <= bound, "reboot after", reboot, bound);
+	check(p.watchdog.stats().micRestarts == 1 && p.watchdog.stats().pipelineRestarts == SR_WATCHDOG_ATTEMPTS, "restarts counted",
+		p.watchdog.stats().pipelineRestarts, SR_WATCHDOG_ATTEMPTS);
+	printf("dead feed task: %s, reboot %u ms after the last audio\n", ladder.c_str(), reboot);
+}
+
+void checkStarved() {
+	Pipeline p;
+	p.run(5000);
+	uint32_t start = p.nowMs;
+	p.ratePercent = SR_WATCHDOG_MIN_RATE / 2;
+	p.run(5 * CheckMs);
+	bool detected = !p.steps.empty() && p.steps[0].action == SR_WATCHDOG_RESTART_MIC;
+	check(detected, "starved stream detected", (uint32_t)p.steps.size(), 1);
+	if (!detected) return;
+	// The drop came with a check, so the next two windows are all slow
+	uint32_t after = p.steps[0].atMs - start;
+	check(after <= 2 * CheckMs, "starved stream detected after", after, 2 * CheckMs);
+	printf("starved at %u%%: detected after %u ms\n", SR_WATCHDOG_MIN_RATE / 2, after);
+}
+
+// Audio returns after the first pipeline restart, but the first time only
+// for the last 160 ms before a check: at the full rate, yet too short to
+// count
+void checkLateRecovery() {
+	Pipeline p;
+	p.run(5000);
+	p.fills = false;
+	while (p.watchdog.stats().pipelineRestarts == 0 && !p.rebooted) p.run(ChunkMs);
+	p.run(p.nextCheckMs - p.nowMs - 160);
+	p.fills = true;
+	p.run(160);
+	p.fills = false;
+	p.run(SR_WATCHDOG_GRACE_MS + CheckMs);
+	check(p.watchdog.recovering() && p.watchdog.stats().recoveries == 0, "brief audio counted as recovery",
+		p.watchdog.stats().recoveries, 0);
+
+	uint32_t restarts = p.watchdog.stats().pipelineRestarts;
+	p.fills = true;
+	p.firstAudioMs = 0;
+	p.run(3000);
+	const SrWatchdogStats& stats = p.watchdog.stats();
+	check(!p.watchdog.recovering() && stats.recoveries == 1, "recovered after the pipeline", stats.recoveries, 1);
+	check(stats.pipelineRestarts == restarts && p.steps.back().action != SR_WATCHDOG_REBOOT, "no step after recovery",
+		stats.pipelineRestarts, restarts);
+	printf("pipeline restart: recovered after %u restarts, outage %u ms\n", restarts, stats.lastOutageMs);
+}
+
+}  // namespace
+
+int main(int argc, char**) {
+	if (argc > 1) {
+		fprintf(stderr, "usage: srwatchdog_check\n");
+		return 2;
+	}
+
+	checkQuiet();
+	checkMicStall();
+	checkLadder();
+	checkStarved();
+	checkLateRecovery();
+
+	printf("%s\n", failures ? "FAIL" : "all checks passed");
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,352 @@
+"""
+Host side of the TokenLog facility (lib/TokenLog).
+
+  map     scan sources for TLOG("...") call sites and write the id -> format map
+  decode  read the binary log stream (serial port, file or stdin) and print text,
+          PbmSink images on the same stream are skipped or saved (--pbm-dir)
+
+The id of a call site is the 32-bit FNV-1a hash of its format string, see
+TokenLog::hash() in lib/TokenLog/src/TokenLog.h.
+"""
+
+import argparse
+import json
+import os
+import re
+import struct
+import sys
+
+SYNC = b"\xfe\xff"
+PBM_SYNC = b"\xfe\xfb"  # PbmSink frame, see lib/Display/src/PbmSink.h
+DROP_ID = 0
+ARG_INT, ARG_UINT, ARG_FLOAT, ARG_STR = range(4)
+
+SOURCE_EXT = (".c", ".cpp", ".h", ".hpp")
+TLOG_CALL = re.compile(r'\bTLOG\s*\(\s*((?:"(?:[^"\\\n]|\\.)*"\s*)+)')
+STRING_LITERAL = re.compile(r'"((?:[^"\\\n]|\\.)*)"')
+SIMPLE_ESCAPES = {"n": "\n", "t": "\t", "r": "\r", "\\": "\\", '"': '"', "'": "'", "0": "\0", "a": "\a", "b": "\b", "f": "\f", "v": "\v", "?": "?"}
+FORMAT_SPEC = re.compile(r"%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d+))?(hh|h|ll|l|z|j|t|L)?([diouxXeEfgGcspn%])")
+
+
+def fnv1a(data):
+    h = 2166136261
+    for b in data:
+        h = ((h ^ b) * 16777619) & 0xFFFFFFFF
+    return h
+
+
+def unescape_c(literal):
+    """
+    Turn the body of a C string literal into the bytes the compiler emits
+    """
+    out = bytearray()
+    i = 0
+    while i < len(literal):
+        c = literal[i]
+        if c != "\\":
+            out += c.encode("utf-8")
+            i += 1
+            continue
+        nxt = literal[i + 1]
+        if nxt == "x":
+            m = re.match(r"[0-9a-fA-F]+", literal[i + 2:])
+            out.append(int(m.group(0), 16) & 0xFF)
+            i += 2 + len(m.group(0))
+        elif nxt in "01234567":
+            m = re.match(r"[0-7]{1,3}", literal[i + 1:])
+            out.append(int(m.group(0), 8) & 0xFF)
+            i += 1 + len(m.group(0))
+        else:
+            out += SIMPLE_ESCAPES.get(nxt, nxt).encode("utf-8")
+            i += 2
+    return bytes(out)
+
+
+def scan_sources(paths):
+    """
+    Return {id: format} for every TLOG call site under paths
+    """
+    entries = {}
+    origins = {}
+    for base in paths:
+        for root, _, files in os.walk(base):
+            for file_name in sorted(files):
+                if not file_name.endswith(SOURCE_EXT):
+                    continue
+                file_path = os.path.join(root, file_name)
+                with open(file_path, "r", encoding="utf-8", errors="replace") as f:
+                    source = f.read()
+                for call in TLOG_CALL.finditer(source):
+                    fmt = b"".join(unescape_c(s) for s in STRING_LITERAL.findall(call.group(1)))
+                    token = fnv1a(fmt)
+                    text = fmt.decode("utf-8", errors="replace")
+                    line = source.count("\n", 0, call.start()) + 1
+                    if token in entries and entries[token] != text:
+                        raise ValueError("TLOG id collision 0x%08x: %s and %s:%d" % (token, origins[token], file_path, line))
+                    entries[token] = text
+                    origins[token] = "%s:%d" % (file_path, line)
+    return entries
+
+
+def write_map(paths, out_file):
+    entries = scan_sources(paths)
+    data = {
+        "version": 1,
+        "hash": "fnv1a32",
+        "entries": {"0x%08x" % k: v for k, v in sorted(entries.items())},
+    }
+    out_dir = os.path.dirname(out_file)
+    if out_dir and not os.path.exists(out_dir):
+        os.makedirs(out_dir)
+    with open(out_file, "w", encoding="utf-8") as f:
+        json.dump(data, f, indent=1, ensure_ascii=False)
+    return len(entries)
+
+
+def load_map(map_file):
+    with open(map_file, "r", encoding="utf-8") as f:
+        data = json.load(f)
+    return {int(k, 16): v for k, v in data["entries"].items()}
+
+
+def format_record(fmt, args):
+    """
+    printf-style formatting of the raw 32-bit arguments
+    """
+    values = list(args)
+
+    def convert(m):
+        flags, width, precision, _, conv = m.groups()
+        if conv == "%":
+            return "%"
+        if width == "*":
+            width = str(values.pop(0) if values else 0)
+        if precision == "*":
+            precision = str(values.pop(0) if values else 0)
+        if not values:
+            return m.group(0)
+        value = values.pop(0)
+        spec = "%" + flags + (width or "") + ("." + precision if precision else "")
+        if conv == "s":
+            return (spec + "s") % (value if isinstance(value, str) else "0x%08x" % value)
+        if isinstance(value, str):
+            return value
+        if conv in "di":
+            signed = value - (1 << 32) if value & 0x80000000 else value
+            return (spec + "d") % signed
+        if conv in "ouxX":
+            return (spec + conv) % value
+        if conv in "eEfgG":
+            return (spec + conv) % struct.unpack("<f", struct.pack("<I", value))[0]
+        if conv == "c":
+            return (spec + "c") % chr(value & 0xFF)
+        if conv == "p":
+            return "0x%08x" % value
+        return m.group(0)
+
+    return FORMAT_SPEC.sub(convert, fmt)
+
+
+class Decoder:
+    """
+    Splits a byte stream into TokenLog frames, PbmSink images and plain text
+    """
+
+    def __init__(self, entries, timestamps=True, on_image=None):
+        self.entries = entries
+        self.timestamps = timestamps
+        self.on_image = on_image
+        self.images = 0
+        self.buffer = bytearray()
+        self.text = bytearray()
+
+    def find_sync(self):
+        found = [p for p in (self.buffer.find(SYNC), self.buffer.find(PBM_SYNC)) if p >= 0]
+        return min(found) if found else -1
+
+    def feed(self, data):
+        self.buffer += data
+        lines = []
+        while True:
+            pos = self.find_sync()
+            if pos < 0:
+                # Keep a trailing 0xFE, it may be the start of the next sync
+                keep = 1 if self.buffer.endswith(SYNC[:1]) else 0
+                self.text += self.buffer[:len(self.buffer) - keep]
+                del self.buffer[:len(self.buffer) - keep]
+                break
+            self.text += self.buffer[:pos]
+            del self.buffer[:pos]
+            if self.buffer.startswith(PBM_SYNC):
+                frame = self.parse_image()
+            else:
+                frame = self.parse_frame()
+            if frame is None:
+                break  # need more data
+            if frame is False:
+                # Not a frame after all, pass the sync bytes through as text
+                self.text += self.buffer[:1]
+                del self.buffer[:1]
+                continue
+            if frame is True:
+                continue  # image, nothing to print
+            lines.extend(self.flush_text())
+            lines.append(frame)
+        lines.extend(self.flush_text())
+        return lines
+
+    def flush_text(self):
+        out = []
+        while b"\n" in self.text:
+            line, _, rest = self.text.partition(b"\n")
+            out.append(line.decode("utf-8", errors="replace").rstrip("\r"))
+            self.text = bytearray(rest)
+        return out
+
+    def parse_image(self):
+        buf = self.buffer
+        if len(buf) < 7:
+            return None
+        length = struct.unpack_from("<H", buf, 2)[0]
+        if not buf.startswith(b"P4\n", 4) or length < 8:
+            return False
+        if len(buf) < 4 + length + 1:
+            return None
+        checksum = 0
+        for b in buf[2:4 + length]:
+            checksum ^= b
+        if checksum != buf[4 + length]:
+            return False
+        image = bytes(buf[4:4 + length])
+        del buf[:4 + length + 1]
+        self.images += 1
+        if self.on_image:
+            self.on_image(image)
+        return True
+
+    def parse_frame(self):
+        buf = self.buffer
+        if len(buf) < 4:
+            return None
+        length = struct.unpack_from("<H", buf, 2)[0]
+        if length < 12 or length > 12 + 5 * 256:
+            return False
+        if len(buf) < 4 + length + 1:
+            return None
+        payload = bytes(buf[2:4 + length])
+        checksum = 0
+        for b in payload:
+            checksum ^= b
+        if checksum != buf[4 + length]:
+            return False
+
+        token, timestamp, core, argc, tags = struct.unpack_from("<IIBBH", payload, 2)
+        offset = 14
+        args = []
+        try:
+            for i in range(argc):
+                arg_type = (tags >> (2 * i)) & 0x3
+                if arg_type == ARG_STR:
+                    n = payload[offset]
+                    args.append(payload[offset + 1:offset + 1 + n].decode("utf-8", errors="replace"))
+                    offset += 1 + n
+                else:
+                    args.append(struct.unpack_from("<I", payload, offset)[0])
+                    offset += 4
+        except (IndexError, struct.error):
+            return False
+        del buf[:4 + length + 1]
+
+        if token == DROP_ID:
+            text = "[tokenlog] %d records dropped" % (args[0] if args else 0)
+        elif token in self.entries:
+            text = format_record(self.entries[token], args)
+        else:
+            text = "[tokenlog] unknown id 0x%08x args=%s" % (token, args)
+        if self.timestamps:
+            text = "[%10.3f][%d] %s" % (timestamp / 1000.0, core, text)
+        return text
+
+
+def default_map():
+    build_dir = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", ".pio", "build")
+    if os.path.isdir(build_dir):
+        for env_name in sorted(os.listdir(build_dir)):
+            candidate = os.path.join(build_dir, env_name, "tokenlog_map.json")
+            if os.path.exists(candidate):
+                return candidate
+    return None
+
+
+def open_stream(args):
+    if args.port:
+        import serial  # pyserial, shipped with PlatformIO
+        return serial.Serial(args.port, args.baud, timeout=0.1)
+    if args.file:
+        return open(args.file, "rb")
+    return sys.stdin.buffer
+
+
+def decode(args):
+    map_file = args.map or default_map()
+    if map_file:
+        entries = load_map(map_file)
+    else:
+        root = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..")
+        entries = scan_sources([os.path.join(root, "src"), os.path.join(root, "lib")])
+
+    on_image = None
+    if args.pbm_dir:
+        if not os.path.exists(args.pbm_dir):
+            os.makedirs(args.pbm_dir)
+
+        def on_image(image):
+            with open(os.path.join(args.pbm_dir, "frame_%05d.pbm" % decoder.images), "wb") as f:
+                f.write(image)
+
+    decoder = Decoder(entries, timestamps=not args.no_timestamps, on_image=on_image)
+    stream = open_stream(args)
+    try:
+        while True:
+            data = stream.read(256)
+            if not data:
+                if args.port:
+                    continue
+                break
+            for line in decoder.feed(data):
+                print(line, flush=True)
+    except KeyboardInterrupt:
+        pass
+    for line in decoder.feed(b"\n"):
+        if line:
+            print(line)
+    if decoder.images:
+        action = "saved to %s" % args.pbm_dir if args.pbm_dir else "skipped"
+        print("[pbm] %d images %s" % (decoder.images, action), file=sys.stderr)
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="TokenLog map generator and decoder")
+    sub = parser.add_subparsers(dest="command")
+
+    map_parser = sub.add_parser("map", help="generate id map from TLOG call sites")
+    map_parser.add_argument("-s", "--source", action="append", help="source directory (repeatable, default: src and lib)")
+    map_parser.add_argument("-o", "--out_file", default="tokenlog_map.json", help="output map file")
+
+    decode_parser = sub.add_parser("decode", help="decode a binary log stream")
+    decode_parser.add_argument("-m", "--map", help="id map (default: .pio/build/*/tokenlog_map.json, else scan sources)")
+    decode_parser.add_argument("-p", "--port", help="serial port to read from")
+    decode_parser.add_argument("-b", "--baud", type=int, default=115200, help="serial baud rate")
+    decode_parser.add_argument("-f", "--file", help="captured log file (default: stdin)")
+    decode_parser.add_argument("--no-timestamps", action="store_true", help="omit [ms][core] prefix")
+    decode_parser.add_argument("--pbm-dir", help="save PbmSink images as frame_NNNNN.pbm in this directory")
+
+    args = parser.parse_args()
+    if args.command == "map":
+        sources = args.source or ["src", "lib"]
+        count = write_map(sources, args.out_file)
+        print("TokenLog: %d format strings -> %s" % (count, args.out_file))
+    elif args.command == "decode":
+        decode(args)
+    else:
+        parser.print_help()
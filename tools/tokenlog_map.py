@@ -0,0 +1,12 @@
+Import('env')
+import os.path
+import sys
+
+# regenerate the TokenLog id map next to firmware.elf on every build
+sys.path.append(os.path.join(env.subst("$PROJECT_DIR"), "tools"))
+from tokenlog import write_map
+
+sources = [env.subst("$PROJECT_SRC_DIR"), os.path.join(env.subst("$PROJECT_DIR"), "lib")]
+out_file = os.path.join(env.subst("$BUILD_DIR"), "tokenlog_map.json")
+count = write_map(sources, out_file)
+print("TokenLog: %d format strings -> %s" % (count, out_file))
@@ -0,0 +1,131 @@
+// Host check that the face animates the same at any frame rate
+// (lib/FaceDisplay). One scripted run on the virtual frame clock, an
+// expression change every 500 ms, a look and a blink, is drawn at 100, 50,
+// 20 and 10 fps. Every 100 ms, a time all rates draw, the frame buffer and
+// both eyes' Config and FinalConfig are kept; they must match the 100 fps
+// run at every rate, through Eye::Update and through EyeChain
+// (Face::FusedChain), and the two must match each other.
+//
+// Build (from the repository root):
+//   g++ -O2 -std=gnu++17 -Itools/host -Ilib/Display/src -Ilib/FaceDisplay/src tools/transition_check/transition_check.cpp tools/host/host.cpp lib/FaceDisplay/src/*.cpp lib/Display/src/DisplayBackend.cpp lib/Display/src/I2CDisplay.cpp -o transition_check
+//
+// Usage:
+//   transition_check [--duration MS]
+
+#include "Face.h"
+#include "FrameClock.h"
+#include "I2CDisplay.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+const unsigned long SampleMs = 100;
+const unsigned long ExpressionMs = 500;
+const unsigned long LookAtMs = 1700;
+const unsigned long BlinkAtMs = 2300;
+
+const eEmotions Script[] = {
+	eEmotions::Angry, eEmotions::Happy, eEmotions::Sad, eEmotions::Surprised,
+	eEmotions::Sleepy, eEmotions::Squint, eEmotions::Normal,
+};
+
+struct Sample {
+	uint8_t pixels[128 * 64 / 8];
+	EyeConfig config[2];
+	EyeConfig final[2];
+};
+
+bool sameSample(const Sample& a, const Sample& b) {
+	return memcmp(&a, &b, sizeof(Sample)) == 0;
+}
+
+// The script drawn every periodMs, both multiples of SampleMs apart
+std::vector<Sample> run(unsigned long periodMs, bool fused, unsigned long durationMs) {
+	FrameClock::UseVirtual(1000);
+	I2CDisplay display(I2CPanel::SSD1306, 0, 0);
+	display.begin();
+	Face* face = new Face(&display, 128, 64, 40);
+	face->RandomBehavior = false;
+	face->RandomLook = false;
+	face->RandomBlink = false;
+	face->AutoFlush = false;
+	face->FusedChain = fused;
+
+	std::vector<Sample> samples;
+	for (unsigned long now = 0; now <= durationMs; now += periodMs) {
+		if (now % ExpressionMs == 0) {
+			face->Behavior.GoToEmotion(Script[(now / ExpressionMs) % (sizeof(Script) / sizeof(Script[0]))]);
+		}
+		if (now == LookAtMs) face->Look.LookAt(0.5f, -0.3f);
+		if (now == BlinkAtMs) face->DoBlink();
+
+		display.gfx().clearBuffer();
+		face->Update();
+		if (now % SampleMs == 0) {
+			Sample s;
+			memcpy(s.pixels, display.buffer(), sizeof(s.pixels));
+			s.config[0] = face->LeftEye.Config;
+			s.config[1] = face->RightEye.Config;
+			s.final[0] = *face->LeftEye.FinalConfig;
+			s.final[1] = *face->RightEye.FinalConfig;
+			samples.push_back(s);
+		}
+		FrameClock::Advance(periodMs);
+	}
+	delete face;
+	return samples;
+}
+
+unsigned compare(const std::vector<Sample>& reference, const std::vector<Sample>& samples, const char* label) {
+	unsigned differ = 0;
+	for (size_t i = 0; i < reference.size(); i++) {
+		if (i < samples.size() && sameSample(reference[i], samples[i])) continue;
+		if (differ++ < 3) printf("  FAIL %s: %lu ms differs\n", label, (unsigned long)i * SampleMs);
+	}
+	return differ;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+	unsigned long durationMs = 4000;
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		bool value = i + 1 < argc;
+		if (arg == "--duration" && value) durationMs = strtoul(argv[++i], nullptr, 10);
+		else {
+			fprintf(stderr, "usage: transition_check [--duration MS]\n");
+			return 2;
+		}
+	}
+
+	const unsigned long periods[] = {10, 20, 50, 100};
+	unsigned failures = 0;
+	std::vector<Sample> updateReference;
+	for (int fused = 0; fused < 2; fused++) {
+		const char* mode = fused ? "EyeChain" : "Eye::Update";
+		std::vector<Sample> reference = run(periods[0], fused, durationMs);
+		for (size_t p = 1; p < sizeof(periods) / sizeof(periods[0]); p++) {
+			char label[48];
+			snprintf(label, sizeof(label), "%s at %lu fps", mode, 1000 / periods[p]);
+			unsigned differ = compare(reference, run(periods[p], fused, durationMs), label);
+			printf("%s: %zu samples, %u differ\n", label, reference.size(), differ);
+			failures += differ;
+		}
+		if (!fused) {
+			updateReference = reference;
+			continue;
+		}
+		unsigned differ = compare(updateReference, reference, "EyeChain against Eye::Update");
+		printf("EyeChain against Eye::Update at 100 fps: %zu samples, %u differ\n", reference.size(), differ);
+		failures += differ;
+	}
+
+	printf("%s\n", failures ? "FAIL" : "all checks passed");
+	return failures ? 1 : 0;
+}